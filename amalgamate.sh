@@ -5,25 +5,58 @@ OUT="meantonal.h"
 
 # start fresh
 printf "#include <stdlib.h>\n" > "$OUT"
-printf "#include <stdbool.h>\n\n" >> "$OUT"
+printf "#include <stdbool.h>\n" >> "$OUT"
+printf "#include <stdio.h>\n" >> "$OUT"
+printf "#include <stdint.h>\n\n" >> "$OUT"
 printf "// -----------------------------------------\n" >> "$OUT"
 printf "// HEADER DECLARATIONS ---------------------\n" >> "$OUT"
 printf "// -----------------------------------------\n\n" >> "$OUT"
 printf "#ifndef MEANTONAL_HEADER\n" >> "$OUT"
 printf "#define MEANTONAL_HEADER\n" >> "$OUT"
 
-# helper: strip include guards and local includes
+# helper: strip include guards and local includes, keeping any other
+# preprocessor lines (e.g. #ifdef __AVX2__ blocks)
 strip_headers() {
-    sed -E '/^#ifndef|^#define|^#endif|^#include/d'
+    awk '
+        /^#include/ { next }
+        /^#ifndef [A-Z0-9_]+_H$/ && !guard { guard = 1; next }
+        /^#define [A-Z0-9_]+_H$/ && guard == 1 { guard = 2; next }
+        { lines[n++] = $0 }
+        END {
+            last = -1
+            for (i = n - 1; guard && i >= 0; i--)
+                if (lines[i] ~ /^#endif/) { last = i; break }
+            for (i = 0; i < n; i++)
+                if (i != last) print lines[i]
+        }'
 }
 
 strip_headers < "include/types.h" >> "$OUT"
+strip_headers < "include/arith.h" >> "$OUT"
+strip_headers < "include/parallel.h" >> "$OUT"
 strip_headers < "include/constants.h" >> "$OUT"
 strip_headers < "include/pitch.h" >> "$OUT"
 strip_headers < "include/interval.h" >> "$OUT"
 strip_headers < "include/tonality.h" >> "$OUT"
 strip_headers < "include/pc_set.h" >> "$OUT"
 strip_headers < "include/map.h" >> "$OUT"
+strip_headers < "include/layout.h" >> "$OUT"
+strip_headers < "include/optimize.h" >> "$OUT"
+strip_headers < "include/adaptive.h" >> "$OUT"
+strip_headers < "include/osc.h" >> "$OUT"
+strip_headers < "include/morph.h" >> "$OUT"
+strip_headers < "include/wav.h" >> "$OUT"
+strip_headers < "include/render.h" >> "$OUT"
+strip_headers < "include/zone.h" >> "$OUT"
+strip_headers < "include/fft.h" >> "$OUT"
+strip_headers < "include/track.h" >> "$OUT"
+strip_headers < "include/chroma.h" >> "$OUT"
+strip_headers < "include/buffer.h" >> "$OUT"
+strip_headers < "include/packed.h" >> "$OUT"
+strip_headers < "include/width.h" >> "$OUT"
+strip_headers < "include/hash.h" >> "$OUT"
+strip_headers < "include/sort.h" >> "$OUT"
+strip_headers < "include/range.h" >> "$OUT"
 strip_headers < "include/parse.h" >> "$OUT"
 
 printf "#endif // MEANTONAL_HEADER\n\n" >> "$OUT"
@@ -35,15 +68,37 @@ printf "#undef MEANTONAL\n" >> "$OUT"
 
 printf "#include <stdio.h>\n" >> "$OUT"
 printf "#include <stdint.h>\n" >> "$OUT"
+printf "#include <limits.h>\n" >> "$OUT"
 printf "#include <math.h>\n" >> "$OUT"
 printf "#include <string.h>\n" >> "$OUT"
+printf "#ifdef __AVX2__\n#include <immintrin.h>\n#endif\n" >> "$OUT"
+printf "#ifdef MEANTONAL_THREADS\n#include <pthread.h>\n#include <unistd.h>\n#endif\n" >> "$OUT"
 
 strip_headers < "src/constants.c" >> "$OUT"
+strip_headers < "src/parallel.c" >> "$OUT"
+strip_headers < "src/edo_catalog.c" >> "$OUT"
 strip_headers < "src/pitch.c" >> "$OUT"
 strip_headers < "src/interval.c" >> "$OUT"
 strip_headers < "src/tonality.c" >> "$OUT"
 strip_headers < "src/pc_set.c" >> "$OUT"
 strip_headers < "src/map.c" >> "$OUT"
+strip_headers < "src/layout.c" >> "$OUT"
+strip_headers < "src/optimize.c" >> "$OUT"
+strip_headers < "src/adaptive.c" >> "$OUT"
+strip_headers < "src/osc.c" >> "$OUT"
+strip_headers < "src/morph.c" >> "$OUT"
+strip_headers < "src/wav.c" >> "$OUT"
+strip_headers < "src/render.c" >> "$OUT"
+strip_headers < "src/zone.c" >> "$OUT"
+strip_headers < "src/fft.c" >> "$OUT"
+strip_headers < "src/track.c" >> "$OUT"
+strip_headers < "src/chroma.c" >> "$OUT"
+strip_headers < "src/buffer.c" >> "$OUT"
+strip_headers < "src/packed.c" >> "$OUT"
+strip_headers < "src/width.c" >> "$OUT"
+strip_headers < "src/hash.c" >> "$OUT"
+strip_headers < "src/sort.c" >> "$OUT"
+strip_headers < "src/range.c" >> "$OUT"
 strip_headers < "src/parse.c" >> "$OUT"
 # for src in src/*.c; do
 #     sed -E '/^#include/d' "$src" >> "$OUT"
@@ -0,0 +1,25 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include <time.h>
+
+/**
+ * Seconds on a monotonic clock, for timing a block of work.
+ */
+static inline double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+#define BENCH_REPORT(name, seconds, ops)                                       \
+    printf("    %-40s %10.2f ns/op\n", name, (seconds) * 1e9 / (ops))
+
+#define RUN_BENCH(benchfunc)                                                   \
+    do {                                                                       \
+        printf("Running %s...\n", #benchfunc);                                 \
+        benchfunc();                                                           \
+    } while (0)
+
+#endif
@@ -0,0 +1,83 @@
+#include "../include/buffer.h"
+#include "../include/map.h"
+#include "../include/pitch.h"
+#include "../include/range.h"
+#include "bench.h"
+#include <stdlib.h>
+
+void bench_buffer(void) {
+    const int len = 1 << 16, reps = 200;
+    Pitch *arr = malloc(len * sizeof(Pitch));
+    int *out = malloc(len * sizeof(int));
+    for (int i = 0; i < len; i++)
+        arr[i] = (Pitch){i % 97 - 40, i % 41 - 20};
+    PitchBuffer b;
+    pitch_buffer_create(len, &b);
+    pitch_buffer_from_pitches(&b, arr, len);
+
+    double start = bench_now();
+    for (int r = 0; r < reps; r++) {
+        for (int i = 0; i < len; i++)
+            out[i] = pitch_accidental(arr[i]);
+        arr[r % len].w ^= out[len - 1] & 1; // keep the loop alive
+    }
+    BENCH_REPORT("pitch_accidental, Pitch array", bench_now() - start,
+                 (long)reps * len);
+
+    start = bench_now();
+    for (int r = 0; r < reps; r++) {
+        pitch_buffer_accidentals(&b, out);
+        b.w[r % len] ^= out[len - 1] & 1;
+    }
+    BENCH_REPORT("pitch_buffer_accidentals", bench_now() - start,
+                 (long)reps * len);
+
+    start = bench_now();
+    for (int r = 0; r < reps; r++)
+        pitch_buffer_transpose(&b, (Interval){1, r & 1});
+    BENCH_REPORT("pitch_buffer_transpose", bench_now() - start,
+                 (long)reps * len);
+
+    Pitch *melody = malloc(len * sizeof(Pitch));
+    start = bench_now();
+    for (int r = 0; r < reps; r++)
+        pitches_from_intervals((Pitch){r, 0}, arr, len, melody);
+    BENCH_REPORT("pitches_from_intervals", bench_now() - start,
+                 (long)reps * len);
+
+    start = bench_now();
+    for (int r = 0; r < reps; r++) {
+        pitch_buffer_scan(&b, (Pitch){0, 0});
+        pitch_buffer_differences(&b, (Pitch){0, 0});
+    }
+    BENCH_REPORT("pitch_buffer_scan + differences", bench_now() - start,
+                 (long)reps * len);
+    free(melody);
+
+    // Undo the transposes so the range check sees a realistic mix of Pitches.
+    pitch_buffer_from_pitches(&b, arr, len);
+    TuningMap T;
+    tuning_map_from_fifth(696.578, (Pitch){29, 11}, 440, &T);
+    bool *in = malloc(len * sizeof(bool));
+    int count = 0;
+    start = bench_now();
+    for (int r = 0; r < reps; r++)
+        for (int i = 0; i < len; i++)
+            count += in[i] = pitch_audible(arr[i], T);
+    BENCH_REPORT("pitch_audible, Pitch array", bench_now() - start,
+                 (long)reps * len);
+
+    PitchRange audible = pitch_range_audible(T);
+    start = bench_now();
+    for (int r = 0; r < reps; r++)
+        count -= pitch_buffer_in_range(&b, audible, in);
+    BENCH_REPORT("pitch_buffer_in_range", bench_now() - start,
+                 (long)reps * len);
+    if (count != 0)
+        printf("pitch_buffer_in_range disagrees with pitch_audible\n");
+    free(in);
+
+    pitch_buffer_destroy(&b);
+    free(arr);
+    free(out);
+}
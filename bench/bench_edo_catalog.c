@@ -0,0 +1,55 @@
+#include "../include/map.h"
+#include "../include/parse.h"
+#include "bench.h"
+#include <math.h>
+
+// What create_edo_map and tuning_map_from_edo did per call before the
+// catalog: the fifth is rederived through libm every time.
+static int create_edo_map_libm(int edo, EDOMap *out) {
+    int fifth_steps = (int)round(log2(1.5) * edo);
+    double fifth = (double)fifth_steps * 1200 / edo;
+    if (fifth < 1200.0 * 4 / 7 || fifth > 1200.0 * 3 / 5)
+        return 1;
+    *out = (EDOMap){((fifth_steps * 2) % edo + edo) % edo,
+                    ((fifth_steps * -5) % edo + edo) % edo};
+    return 0;
+}
+
+static int tuning_map_from_edo_libm(int edo, Pitch ref_pitch, double ref_freq,
+                                    TuningMap *out) {
+    int fifth_steps = round(log2(1.5) * edo);
+    double fifth = (double)fifth_steps * 1200 / edo;
+    return tuning_map_from_fifth(fifth, ref_pitch, ref_freq, out);
+}
+
+void bench_edo_catalog(void) {
+    // A tuning browser's startup: every EDO from 5 to 311.
+    const int reps = 20000, lo = 5, hi = 311;
+    const long ops = (long)reps * (hi - lo + 1);
+    Pitch ref;
+    pitch_from_spn("A4", &ref);
+    volatile double sink = 0;
+    EDOMap E;
+    TuningMap T;
+
+    double start = bench_now();
+    for (int r = 0; r < reps; r++) {
+        for (int edo = lo; edo <= hi; edo++) {
+            if (!create_edo_map_libm(edo, &E) &&
+                !tuning_map_from_edo_libm(edo, ref, 440, &T))
+                sink += E.m0 + T.centmap.m0;
+        }
+    }
+    BENCH_REPORT("EDO scan, derived with libm", bench_now() - start, ops);
+
+    start = bench_now();
+    for (int r = 0; r < reps; r++) {
+        for (int edo = lo; edo <= hi; edo++) {
+            if (!create_edo_map(edo, &E) &&
+                !tuning_map_from_edo(edo, ref, 440, &T))
+                sink += E.m0 + T.centmap.m0;
+        }
+    }
+    BENCH_REPORT("EDO scan, from the catalog", bench_now() - start, ops);
+    (void)sink;
+}
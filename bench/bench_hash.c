@@ -0,0 +1,86 @@
+#include "../include/hash.h"
+#include "bench.h"
+#include <stdlib.h>
+
+// The kind of map people write by hand: a prime number of buckets, each a
+// linked list of separately allocated nodes.
+
+typedef struct node {
+    Pitch key;
+    long long count;
+    struct node *next;
+} ChainNode;
+
+enum { CHAIN_BUCKETS = 1021 };
+
+static void chain_increment(ChainNode *buckets[], Pitch p) {
+    unsigned b = (unsigned)(p.w * 31 + p.h) % CHAIN_BUCKETS;
+    for (ChainNode *n = buckets[b]; n; n = n->next) {
+        if (n->key.w == p.w && n->key.h == p.h) {
+            n->count++;
+            return;
+        }
+    }
+    ChainNode *n = malloc(sizeof(ChainNode));
+    *n = (ChainNode){p, 1, buckets[b]};
+    buckets[b] = n;
+}
+
+static long long chain_get(ChainNode *buckets[], Pitch p) {
+    unsigned b = (unsigned)(p.w * 31 + p.h) % CHAIN_BUCKETS;
+    for (ChainNode *n = buckets[b]; n; n = n->next)
+        if (n->key.w == p.w && n->key.h == p.h)
+            return n->count;
+    return 0;
+}
+
+static void chain_free(ChainNode *buckets[]) {
+    for (int b = 0; b < CHAIN_BUCKETS; b++) {
+        while (buckets[b]) {
+            ChainNode *next = buckets[b]->next;
+            free(buckets[b]);
+            buckets[b] = next;
+        }
+    }
+}
+
+// A histogram of a million notes drawn from a few thousand spellings, then a
+// million lookups.
+void bench_hash(void) {
+    const int len = 1 << 20;
+    Pitch *notes = malloc(len * sizeof(Pitch));
+    unsigned seed = 3;
+    for (int i = 0; i < len; i++) {
+        seed = seed * 1103515245 + 12345;
+        notes[i] = (Pitch){(int)(seed >> 16) % 60, (int)(seed >> 8) % 60 - 30};
+    }
+
+    static ChainNode *buckets[CHAIN_BUCKETS];
+    double start = bench_now();
+    for (int i = 0; i < len; i++)
+        chain_increment(buckets, notes[i]);
+    BENCH_REPORT("chained map, increment", bench_now() - start, len);
+
+    long long sum = 0;
+    start = bench_now();
+    for (int i = 0; i < len; i++)
+        sum += chain_get(buckets, notes[len - 1 - i]);
+    BENCH_REPORT("chained map, lookup", bench_now() - start, len);
+
+    PitchMap m;
+    pitch_map_create(0, &m);
+    start = bench_now();
+    pitch_map_increment_all(&m, notes, len);
+    BENCH_REPORT("pitch_map_increment_all", bench_now() - start, len);
+
+    start = bench_now();
+    for (int i = 0; i < len; i++)
+        sum -= pitch_map_get(&m, notes[len - 1 - i])->i;
+    BENCH_REPORT("pitch_map_get", bench_now() - start, len);
+
+    if (sum != 0)
+        printf("    counts disagree!\n");
+    pitch_map_destroy(&m);
+    chain_free(buckets);
+    free(notes);
+}
@@ -0,0 +1,18 @@
+#include "bench.h"
+
+void bench_edo_catalog(void);
+void bench_track(void);
+void bench_buffer(void);
+void bench_packed(void);
+void bench_hash(void);
+void bench_sort(void);
+
+int main(void) {
+    RUN_BENCH(bench_edo_catalog);
+    RUN_BENCH(bench_track);
+    RUN_BENCH(bench_buffer);
+    RUN_BENCH(bench_packed);
+    RUN_BENCH(bench_hash);
+    RUN_BENCH(bench_sort);
+    return 0;
+}
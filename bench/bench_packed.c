@@ -0,0 +1,32 @@
+#include "../include/packed.h"
+#include "../include/pitch.h"
+#include "bench.h"
+#include <stdlib.h>
+
+// Arrays much larger than cache, so the loops are bound by memory bandwidth.
+void bench_packed(void) {
+    const int len = 1 << 24, reps = 10;
+    Pitch *arr = malloc(len * sizeof(Pitch));
+    Pitch16 *packed = malloc(len * sizeof(Pitch16));
+    for (int i = 0; i < len; i++)
+        arr[i] = (Pitch){i % 97 - 40, i % 41 - 20};
+    pitches_to_pitch16(arr, len, packed);
+
+    double start = bench_now();
+    for (int r = 0; r < reps; r++)
+        for (int i = 0; i < len; i++)
+            arr[i] = transpose_real(arr[i], (Interval){1, r & 1});
+    BENCH_REPORT("transpose_real, Pitch array", bench_now() - start,
+                 (long)reps * len);
+
+    Pitch16 m[2];
+    pitch16_from_pitch((Pitch){1, 0}, &m[0]);
+    pitch16_from_pitch((Pitch){1, 1}, &m[1]);
+    start = bench_now();
+    for (int r = 0; r < reps; r++)
+        pitches16_transpose(packed, len, m[r & 1]);
+    BENCH_REPORT("pitches16_transpose", bench_now() - start, (long)reps * len);
+
+    free(arr);
+    free(packed);
+}
@@ -0,0 +1,41 @@
+#include "../include/map.h"
+#include "../include/pitch.h"
+#include "../include/sort.h"
+#include "bench.h"
+#include <stdlib.h>
+#include <string.h>
+
+static EDOMap qsort_map;
+
+// The comparator people write for qsort, with the same tie-break as
+// pitch_radix_sort.
+static int compare_pitches(const void *a, const void *b) {
+    Pitch p = *(const Pitch *)a, q = *(const Pitch *)b;
+    int c = pitches_compare(p, q, qsort_map);
+    return c ? c : steps_between(q, p);
+}
+
+void bench_sort(void) {
+    const int len = 1 << 20;
+    Pitch *notes = malloc(len * sizeof(Pitch));
+    Pitch *arr = malloc(len * sizeof(Pitch));
+    unsigned seed = 9;
+    for (int i = 0; i < len; i++) {
+        seed = seed * 1103515245 + 12345;
+        notes[i] = (Pitch){(int)(seed >> 16) % 40, (int)(seed >> 8) % 20};
+    }
+    create_edo_map(31, &qsort_map);
+
+    memcpy(arr, notes, len * sizeof(Pitch));
+    double start = bench_now();
+    qsort(arr, len, sizeof(Pitch), compare_pitches);
+    BENCH_REPORT("qsort with pitches_compare", bench_now() - start, len);
+
+    memcpy(arr, notes, len * sizeof(Pitch));
+    start = bench_now();
+    pitch_radix_sort(arr, len, qsort_map);
+    BENCH_REPORT("pitch_radix_sort", bench_now() - start, len);
+
+    free(notes);
+    free(arr);
+}
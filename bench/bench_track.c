@@ -0,0 +1,30 @@
+#include "../include/track.h"
+#include "bench.h"
+#include <math.h>
+#include <stdlib.h>
+
+void bench_track(void) {
+    // Ten seconds of a two-partial tone at 44.1kHz, 2048-sample frames every
+    // 256 samples.
+    const int rate = 44100;
+    const long len = 10L * rate;
+    float *x = malloc(len * sizeof(float));
+    for (long i = 0; i < len; i++)
+        x[i] = sin(6.283185307179586 * 220 * i / rate) +
+               0.3 * sin(6.283185307179586 * 440 * i / rate);
+
+    PitchTracker t;
+    pitch_tracker_create(rate, 2048, 256, 0.1, &t);
+    long frames = pitch_tracker_frames(&t, len);
+    double *hz = malloc(frames * sizeof(double));
+
+    double start = bench_now();
+    pitch_tracker_run(&t, x, len, hz, NULL, NULL, NULL);
+    double elapsed = bench_now() - start;
+    BENCH_REPORT("pitch_tracker_run (per frame)", elapsed, frames);
+    printf("    %-40s %10.1f x\n", "real-time factor", 10 / elapsed);
+
+    pitch_tracker_destroy(&t);
+    free(hz);
+    free(x);
+}
@@ -0,0 +1,49 @@
+#ifndef ADAPTIVE_H
+#define ADAPTIVE_H
+
+#include "types.h"
+
+/**
+ * Creates an AdaptiveTuner that retunes chords played in the tuning system
+ * defined by the passed-in TuningMap.
+ *
+ * Intervals are made just in 5-limit terms: every interval is read as a number
+ * of pure fifths and pure major thirds (so a minor third is 6/5 and an
+ * augmented fourth 45/32), with octaves left as they are.
+ * @param max_drift
+ * How far in cents the average offset of a chord may wander from the base
+ * tuning as common tones are held over comma pumps. 0 keeps every chord
+ * centred on the base tuning.
+ * @param out
+ * Pointer to an AdaptiveTuner to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if max_drift is negative or not
+ * finite.
+ */
+int adaptive_tuner_create(TuningMap T, double max_drift, AdaptiveTuner *out);
+
+/**
+ * Forgets the current chord and any drift, as if the tuner were newly
+ * created.
+ */
+void adaptive_tuner_reset(AdaptiveTuner *t);
+
+/**
+ * Moves the tuner on to the next chord, writing the cent offset from the base
+ * tuning of each of its Pitches to out.
+ *
+ * Offsets make every interval in the chord as close to just as possible (in
+ * the least-squares sense). The chord as a whole is then shifted so held-over
+ * common tones stay where they were, as far as max_drift allows. Each call
+ * costs at most a few hundred operations and allocates nothing.
+ * @param len
+ * The number of Pitches in chord, at most ADAPTIVE_MAX_VOICES. 0 means
+ * silence: the drift is kept, but there are no common tones to hold.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if len is out of range, leaving the
+ * tuner untouched.
+ */
+int adaptive_tuner_update(AdaptiveTuner *t, const Pitch chord[], int len,
+                          double out[]);
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef ARITH_H
+#define ARITH_H
+
+#include <stdint.h>
+
+// Floored division by the two moduli music keeps reaching for, exact for every
+// int. Each divides the magnitude of x as a uint32_t by multiplying with a
+// fixed-point reciprocal and shifting (Granlund & Montgomery, "Division by
+// Invariant Integers using Multiplication", 1994), then restores the sign, so
+// there is no division instruction, signed overflow or shift of a negative
+// value. The AVX2 kernels in buffer.c use the same reciprocals.
+
+/**
+ * n / 7 for any uint32_t. 7's reciprocal needs 33 bits, so the multiply-high
+ * by its low 32 bits is followed by an add-and-halve step.
+ */
+static inline uint32_t udiv7(uint32_t n) {
+    uint32_t q = (uint32_t)((uint64_t)n * 0x24924925u >> 32);
+    return (q + ((n - q) >> 1)) >> 2;
+}
+
+/**
+ * n / 12 for any uint32_t.
+ */
+static inline uint32_t udiv12(uint32_t n) {
+    return (uint32_t)((uint64_t)n * 0xaaaaaaabu >> 35);
+}
+
+/**
+ * floor(x / 7), without a division.
+ */
+static inline int floor_div7(int x) {
+    return x < 0 ? -(int)udiv7(6u - (uint32_t)x) : (int)udiv7((uint32_t)x);
+}
+
+/**
+ * x mod 7 in the range 0 to 6, without a division.
+ */
+static inline int floor_mod7(int x) {
+    return (int)((uint32_t)x - 7u * (uint32_t)floor_div7(x));
+}
+
+/**
+ * floor(x / 12), without a division.
+ */
+static inline int floor_div12(int x) {
+    return x < 0 ? -(int)udiv12(11u - (uint32_t)x) : (int)udiv12((uint32_t)x);
+}
+
+/**
+ * x mod 12 in the range 0 to 11, without a division.
+ */
+static inline int floor_mod12(int x) {
+    return (int)((uint32_t)x - 12u * (uint32_t)floor_div12(x));
+}
+
+/**
+ * x % 12 as C defines it (negative when x is), without a division.
+ */
+static inline int trunc_mod12(int x) {
+    uint32_t n = x < 0 ? 0u - (uint32_t)x : (uint32_t)x;
+    int r = (int)(n - 12 * udiv12(n));
+    return x < 0 ? -r : r;
+}
+
+// The same for long long, used where an int intermediate could overflow.
+// These divide by a constant and leave the multiply-high to the compiler.
+
+/**
+ * floor(x / 7) for a long long.
+ */
+static inline long long floor_div7_ll(long long x) {
+    return x / 7 - (x % 7 < 0);
+}
+
+/**
+ * x mod 7 in the range 0 to 6, for a long long.
+ */
+static inline long long floor_mod7_ll(long long x) {
+    return x - 7 * floor_div7_ll(x);
+}
+
+/**
+ * x % 12 as C defines it, for a long long.
+ */
+static inline long long trunc_mod12_ll(long long x) { return x % 12; }
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef BUFFER_H
+#define BUFFER_H
+
+#include "types.h"
+
+/**
+ * Creates an empty PitchBuffer with room for capacity Pitches.
+ * @param out
+ * Pointer to a PitchBuffer to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if capacity is negative or memory
+ * couldn't be allocated.
+ */
+int pitch_buffer_create(int capacity, PitchBuffer *out);
+
+/**
+ * Frees the memory previously allocated by a PitchBuffer.
+ */
+void pitch_buffer_destroy(PitchBuffer *b);
+
+/**
+ * Replaces the contents of a PitchBuffer with an array of Pitches.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if len is negative or more than the
+ * buffer's capacity.
+ */
+int pitch_buffer_from_pitches(PitchBuffer *b, const Pitch arr[], int len);
+
+/**
+ * Copies the contents of a PitchBuffer out to an array of b->len Pitches.
+ */
+void pitch_buffer_to_pitches(const PitchBuffer *b, Pitch out[]);
+
+/**
+ * Shifts every Pitch in the buffer by an Interval, as transpose_real does.
+ */
+void pitch_buffer_transpose(PitchBuffer *b, Interval m);
+
+/**
+ * Inverts every Pitch in the buffer about a MirrorAxis, as pitch_invert does.
+ */
+void pitch_buffer_invert(PitchBuffer *b, MirrorAxis a);
+
+/**
+ * Finds the Interval from each Pitch in p to the Pitch at the same position in
+ * q, as interval_between does, storing them in out.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if p and q have different lengths or
+ * out doesn't have room for them.
+ */
+int pitch_buffer_intervals(const PitchBuffer *p, const PitchBuffer *q,
+                           PitchBuffer *out);
+
+/**
+ * Writes the pitch_chroma of every Pitch in the buffer to out.
+ */
+void pitch_buffer_chromas(const PitchBuffer *b, int out[]);
+
+/**
+ * Writes the pitch_midi of every Pitch in the buffer to out.
+ */
+void pitch_buffer_midis(const PitchBuffer *b, int out[]);
+
+/**
+ * Writes the pitch_letter of every Pitch in the buffer to out.
+ */
+void pitch_buffer_letters(const PitchBuffer *b, int out[]);
+
+/**
+ * Writes the pitch_accidental of every Pitch in the buffer to out.
+ */
+void pitch_buffer_accidentals(const PitchBuffer *b, int out[]);
+
+/**
+ * Writes the pitch_octave of every Pitch in the buffer to out.
+ */
+void pitch_buffer_octaves(const PitchBuffer *b, int out[]);
+
+/**
+ * Writes the pitch_to_standard of every Pitch in the buffer to out.
+ */
+void pitch_buffer_to_standard(const PitchBuffer *b, StandardPitch out[]);
+
+/**
+ * Writes the pitch_pc12 of every Pitch in the buffer to out.
+ */
+void pitch_buffer_pc12s(const PitchBuffer *b, int out[]);
+
+/**
+ * Writes the degree_number of every Pitch in the buffer in a given
+ * TonalContext to out.
+ */
+void pitch_buffer_degrees(const PitchBuffer *b, TonalContext key, int out[]);
+
+/**
+ * Checks each pair of Pitches at the same position in p and q with
+ * pitches_enharmonic, writing the results to out. The edo is only divided by
+ * once, however long the buffers are.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if the buffers differ in length or edo
+ * isn't positive.
+ */
+int pitch_buffer_enharmonic(const PitchBuffer *p, const PitchBuffer *q,
+                            int edo, bool out[]);
+
+/**
+ * Turns a buffer of Intervals into the melody they step through from start,
+ * in place, as pitches_from_intervals does. When the library is built with
+ * MEANTONAL_THREADS (see parallel.h), long buffers are split over several
+ * threads, with the same result.
+ * @return
+ * The last Pitch of the melody (start if the buffer is empty), which is the
+ * start of the next chunk.
+ */
+Pitch pitch_buffer_scan(PitchBuffer *b, Pitch start);
+
+/**
+ * Turns a buffer of Pitches into the Intervals between them, in place, as
+ * intervals_from_pitches does. The inverse of pitch_buffer_scan. Long buffers
+ * are split over threads as pitch_buffer_scan does.
+ */
+void pitch_buffer_differences(PitchBuffer *b, Pitch start);
+
+/**
+ * Returns the sum of a buffer of Intervals.
+ */
+Interval pitch_buffer_sum(const PitchBuffer *b);
+
+/**
+ * Checks every Pitch in the buffer with pitch_in_range, writing the results to
+ * out.
+ * @return
+ * The number of Pitches in range.
+ */
+int pitch_buffer_in_range(const PitchBuffer *b, PitchRange r, bool out[]);
+
+/**
+ * Removes the Pitches outside a PitchRange from the buffer, keeping the rest
+ * in order.
+ * @return
+ * The number of Pitches kept, which is also the buffer's new len.
+ */
+int pitch_buffer_filter_range(PitchBuffer *b, PitchRange r);
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef CHROMA_H
+#define CHROMA_H
+
+#include "types.h"
+
+/**
+ * Creates a Chromagram for audio at the given sample rate, with one class for
+ * every chroma from chroma_min to chroma_max. Each FFT bin between min_hz and
+ * max_hz is assigned once, here, to the class whose pitch class in the tuning
+ * system defined by the passed-in TuningMap is nearest to it. Bins equally near
+ * two classes (e.g. C# and Db in 12-EDO) go to the class with the smaller
+ * |chroma|, and then to the flatter one.
+ * @param window
+ * Frame length in samples, a power of two.
+ * @param hop
+ * Samples between the starts of consecutive frames.
+ * @param out
+ * Pointer to a Chromagram to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if sample_rate or hop isn't positive,
+ * window isn't a power of two, chroma_max < chroma_min, the frequency range is
+ * empty, or memory couldn't be allocated.
+ */
+int chromagram_create(TuningMap T, int sample_rate, int window, int hop,
+                      int chroma_min, int chroma_max, double min_hz,
+                      double max_hz, Chromagram *out);
+
+/**
+ * Frees the memory previously allocated by a Chromagram.
+ */
+void chromagram_destroy(Chromagram *c);
+
+/**
+ * Measures one frame of c->window samples, writing the spectral energy of each
+ * chroma class to out, so out[i] is the energy of chroma c->chroma_min + i.
+ */
+void chromagram_frame(Chromagram *c, const float frame[], double out[]);
+
+/**
+ * Returns the number of frames chromagram_run finds in len samples.
+ */
+long chromagram_frames(const Chromagram *c, long len);
+
+/**
+ * Measures every frame of a signal, writing c->classes values per frame to out
+ * in row-major order. Frame i starts at sample i * c->hop.
+ *
+ * A Chromagram's workspace belongs to one thread at a time. When the library
+ * is built with MEANTONAL_THREADS (see parallel.h), long recordings are split
+ * over several threads here, each with its own workspace; otherwise, give
+ * each thread its own Chromagram and pass it samples + first * c->hop to
+ * start at frame first.
+ * @return
+ * The number of frames written.
+ */
+long chromagram_run(Chromagram *c, const float samples[], long len,
+                    double out[]);
+
+#endif
@@ -7,4 +7,7 @@ extern const Map2D WICKI_TO, WICKI_FROM, GENERATORS_TO, GENERATORS_FROM;
 
 extern const double CONCERT_C4;
 
+extern const int EDO_CATALOG_MAX;
+extern const EDOCatalogEntry EDO_CATALOG[];
+
 #endif
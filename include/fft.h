@@ -0,0 +1,33 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include "types.h"
+
+/**
+ * Creates an FFTPlan for transforms of length n.
+ * @param out
+ * Pointer to an FFTPlan to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if n isn't a power of two, or memory
+ * couldn't be allocated.
+ */
+int fft_plan_create(int n, FFTPlan *out);
+
+/**
+ * Frees the memory previously allocated by an FFTPlan.
+ */
+void fft_plan_destroy(FFTPlan *p);
+
+/**
+ * Transforms a complex signal of p->n samples, stored as separate real and
+ * imaginary arrays, into its spectrum in place:
+ * X[k] = sum of x[j] * e^(-2 pi i j k / n).
+ */
+void fft_forward(const FFTPlan *p, double re[], double im[]);
+
+/**
+ * The inverse of fft_forward, including the 1 / n scaling, in place.
+ */
+void fft_inverse(const FFTPlan *p, double re[], double im[]);
+
+#endif
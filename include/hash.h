@@ -0,0 +1,128 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include "types.h"
+#include <stdint.h>
+
+/**
+ * Scrambles the bits of a 64-bit integer so that every input bit affects every
+ * output bit (the finalizer of MurmurHash3). It's a bijection, so distinct
+ * inputs never collide.
+ */
+static inline uint64_t hash_mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/**
+ * Returns a 64-bit hash of a Pitch. Distinct Pitches never collide, so any
+ * bits of the result make a good table index.
+ */
+static inline uint64_t pitch_hash(Pitch p) {
+    return hash_mix64((uint64_t)(uint32_t)p.w << 32 | (uint32_t)p.h);
+}
+
+/**
+ * Returns a 64-bit hash of an Interval, the same as pitch_hash.
+ */
+static inline uint64_t interval_hash(Interval m) { return pitch_hash(m); }
+
+/**
+ * Returns a 64-bit hash of a StandardPitch.
+ */
+static inline uint64_t standard_pitch_hash(StandardPitch s) {
+    uint64_t x = (uint64_t)(uint32_t)s.accidental << 32 | (uint32_t)s.octave;
+    return hash_mix64(x ^ (uint64_t)(uint32_t)s.letter * 0x9e3779b97f4a7c15ULL);
+}
+
+/**
+ * Creates an empty PitchMap.
+ * @param capacity
+ * How many Pitches to make room for before the map has to grow. It grows as
+ * needed either way.
+ * @param out
+ * Pointer to a PitchMap to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if capacity is negative or more than
+ * 2^28 (the most Pitches a PitchMap holds), or memory couldn't be allocated.
+ */
+int pitch_map_create(int capacity, PitchMap *out);
+
+/**
+ * Frees the memory previously allocated by a PitchMap.
+ */
+void pitch_map_destroy(PitchMap *m);
+
+/**
+ * Removes every Pitch from a PitchMap, keeping its memory.
+ */
+void pitch_map_clear(PitchMap *m);
+
+/**
+ * Looks up the value stored for a Pitch.
+ * @return
+ * Pointer to the value, valid until the map is next changed, or NULL if the
+ * Pitch isn't in the map.
+ */
+PitchValue *pitch_map_get(const PitchMap *m, Pitch p);
+
+/**
+ * Looks up the value stored for a Pitch, first inserting the Pitch with a
+ * value of all zeroes (so .i == 0 and .d == 0) if it isn't in the map.
+ * @return
+ * Pointer to the value, valid until the map is next changed, or NULL if memory
+ * couldn't be allocated or the map already holds 2^28 Pitches.
+ */
+PitchValue *pitch_map_slot(PitchMap *m, Pitch p);
+
+/**
+ * Stores a value for a Pitch, replacing any value already stored.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if memory couldn't be allocated.
+ */
+int pitch_map_put(PitchMap *m, Pitch p, PitchValue v);
+
+/**
+ * Removes a Pitch from a PitchMap.
+ * @return
+ * true if the Pitch was in the map.
+ */
+bool pitch_map_remove(PitchMap *m, Pitch p);
+
+/**
+ * Stores values[i] for keys[i] for every i, in order, so later duplicates
+ * win. Makes room for all of them up front.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if memory couldn't be allocated or the
+ * map could end up holding more than 2^28 Pitches.
+ */
+int pitch_map_put_all(PitchMap *m, const Pitch keys[],
+                      const PitchValue values[], int len);
+
+/**
+ * Adds 1 to the .i count of every Pitch in keys, inserting Pitches that
+ * aren't in the map yet with a count of 0 first. Builds a histogram when
+ * used on an empty map.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if memory couldn't be allocated.
+ */
+int pitch_map_increment_all(PitchMap *m, const Pitch keys[], int len);
+
+/**
+ * Steps through the Pitches in a PitchMap, in no particular order. Set *pos to
+ * 0 before the first call, and don't change the map in between.
+ * @param key
+ * Pointer to store the next Pitch.
+ * @param value
+ * Pointer to store its value. May be NULL.
+ * @return
+ * true if a Pitch was stored, false once every Pitch has been visited.
+ */
+bool pitch_map_next(const PitchMap *m, int *pos, Pitch *key,
+                    PitchValue *value);
+
+#endif
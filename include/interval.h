@@ -1,6 +1,7 @@
 #ifndef INTERVAL_H
 #define INTERVAL_H
 
+#include "arith.h"
 #include "types.h"
 #include <stdbool.h>
 #include <stdlib.h>
@@ -71,8 +72,7 @@ static inline bool intervals_equal(Interval m, Interval n) {
  * The EDO tuning system to compare enharmonicity in.
  */
 static inline bool intervals_enharmonic(Interval m, Interval n, int edo) {
-    return (interval_chroma(m) % edo + edo) % edo ==
-           (interval_chroma(n) % edo + edo) % edo;
+    return ((long long)interval_chroma(m) - interval_chroma(n)) % edo == 0;
 }
 
 /**
@@ -83,7 +83,9 @@ static inline int stepspan(Interval m) { return m.w + m.h; }
 /**
  * Get the 12-tone pitch class interval number of an Interval.
  */
-static inline int interval_pc12(Interval m) { return (2 * m.w + m.h) % 12; }
+static inline int interval_pc12(Interval m) {
+    return trunc_mod12(2 * m.w + m.h);
+}
 
 /**
  * 0 is perfect.
@@ -145,15 +147,8 @@ static inline Interval interval_times(Interval m, int x) {
  * Reduces an interval until it is smaller than an octave
  */
 static inline Interval interval_simple(Interval m) {
-    while (m.w + m.h >= 7) {
-        m.w -= 5;
-        m.h -= 2;
-    }
-    while (m.w + m.h <= -7) {
-        m.w += 5;
-        m.h += 2;
-    }
-    return m;
+    int octaves = (m.w + m.h) / 7; // towards 0, so the sign is kept
+    return (Interval){.w = m.w - 5 * octaves, .h = m.h - 2 * octaves};
 }
 
 #endif
@@ -0,0 +1,66 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include "map.h"
+#include "types.h"
+
+/**
+ * Creates a KeyboardLayout from a Map2D taking Pitch vectors to screen
+ * coordinates, and the screen position of one anchor Pitch. For a
+ * Wicki-Hayden layout, compose the geometry you want to draw its lattice with
+ * onto WICKI_TO using map_compose_2d_2d.
+ * @param out
+ * Pointer to a KeyboardLayout to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if the Map2D can't be inverted, so
+ * distinct Pitches would share a key.
+ */
+int keyboard_layout_create(Map2D layout, Pitch anchor, MapVec anchor_pos,
+                           KeyboardLayout *out);
+
+/**
+ * Returns the screen position of the centre of a Pitch's key.
+ */
+static inline MapVec keyboard_key_center(const KeyboardLayout *L, Pitch p) {
+    MapVec v = map_to_2d((MapVec){p.w - L->anchor.w, p.h - L->anchor.h},
+                         L->to_screen);
+    return (MapVec){L->anchor_pos.x + v.x, L->anchor_pos.y + v.y};
+}
+
+/**
+ * Writes the screen position of the centre of each Pitch's key to x and y.
+ */
+void keyboard_key_centers(const KeyboardLayout *L, const Pitch p[], int len,
+                          double x[], double y[]);
+
+/**
+ * Writes the 4 corners of each Pitch's key to x and y, so x and y must each
+ * hold 4 * len values. The corners of p[i] are at 4 * i to 4 * i + 3, going
+ * around the key.
+ */
+void keyboard_key_vertices(const KeyboardLayout *L, const Pitch p[], int len,
+                           double x[], double y[]);
+
+/**
+ * Returns the Pitch whose key contains a screen position, in constant time.
+ * Keys tile the whole plane, so every position hits some key.
+ */
+Pitch keyboard_hit_test(const KeyboardLayout *L, double x, double y);
+
+/**
+ * Runs keyboard_hit_test over arrays of screen positions, e.g. every touch
+ * point in a frame.
+ */
+void keyboard_hit_test_batch(const KeyboardLayout *L, const double x[],
+                             const double y[], int len, Pitch out[]);
+
+/**
+ * Lists the Pitches whose key centres lie within a screen rectangle, row by
+ * row. At most cap Pitches are written to out.
+ * @return
+ * The number of Pitches in the rectangle, which may be more than cap.
+ */
+int keyboard_visible_keys(const KeyboardLayout *L, double x0, double y0,
+                          double x1, double y1, Pitch out[], int cap);
+
+#endif
@@ -86,6 +86,55 @@ double to_ratio(Interval m, TuningMap T);
  */
 double to_cents(Interval m, TuningMap T);
 
+/**
+ * Finds the Pitch whose frequency in the tuning system defined by the
+ * passed-in TuningMap is nearest to a given frequency. This is the inverse of
+ * to_hz.
+ *
+ * Meantone tunings place Pitches arbitrarily close together, so candidates
+ * are limited to the 17 spellings a key can use: its 7 diatonic notes plus the
+ * raised and lowered degrees of degree_alteration. When two candidates sound
+ * the same (C#/Db in 12-EDO), the spelling closer to the key's diatonic notes
+ * wins, and flats win remaining ties.
+ * @param key
+ * The TonalContext to spell in, or NULL to spell relative to C major.
+ * @param out
+ * Pointer to a Pitch to store the result.
+ * @param cents
+ * Pointer to store how far the frequency is from the Pitch in cents, positive
+ * if the frequency is sharp. May be NULL.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if hz isn't a positive, finite
+ * frequency.
+ */
+int pitch_from_hz(double hz, TuningMap T, const TonalContext *key, Pitch *out,
+                  double *cents);
+
+/**
+ * Runs pitch_from_hz over an array of frequencies, doing the per-tuning and
+ * per-key setup only once.
+ * Frequencies that aren't positive and finite (e.g. 0 for unpitched frames)
+ * are skipped, leaving out and cents untouched at that position.
+ * @param cents
+ * Array to store each deviation in cents. May be NULL.
+ * @return
+ * The number of frequencies skipped, so 0 means nothing went wrong.
+ */
+int pitches_from_hz(const double hz[], int len, TuningMap T,
+                    const TonalContext *key, Pitch out[], double cents[]);
+
+/**
+ * Renders n Intervals in k tuning systems in one call, filling the n x k
+ * matrix out in row-major order: out[i * k + j] is the size of m[i] in cents
+ * when rendered by T[j].
+ * @param ref
+ * Sizes in cents to measure each Interval against, e.g. 1200 * log2(5.0 / 4)
+ * for a major third, so out holds each tuning's deviation instead. ref[i] is
+ * subtracted along row i. Pass NULL for plain sizes.
+ */
+void cents_matrix(const Interval m[], const double ref[], int n,
+                  const TuningMap T[], int k, double out[]);
+
 /**
  * Creates a Map1D that can be used to produce a well-ordered integer numbering
  * for pitches in an EDO tuning, and to compare pitches in edosteps.
@@ -97,4 +146,45 @@ double to_cents(Interval m, TuningMap T);
  */
 int create_edo_map(int edo, EDOMap *out);
 
+/**
+ * Looks up an EDO in the catalog generated at build time, which holds the
+ * fifth and EDOMap of every EDO from 1 to EDO_CATALOG_MAX.
+ * create_edo_map and tuning_map_from_edo already use it, so there's no need
+ * to cache their results yourself.
+ * @return
+ * Pointer to the entry, or NULL if edo is outside the catalog.
+ */
+const EDOCatalogEntry *edo_catalog_lookup(int edo);
+
+/**
+ * Creates an EDOSpeller, a lookup table for spelling the pitch numbers of
+ * pitch_to_number in a given EDO as Pitches in a given TonalContext.
+ * Each step gets the spelling closest to the key's diatonic notes, in the
+ * same order of preference pitch_from_hz uses.
+ * @param out
+ * Pointer to an EDOSpeller to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if create_edo_map would reject the
+ * edo, if the edo has steps that no Pitch can name (its fifth shares a factor
+ * with it, e.g. 35), or if memory couldn't be allocated.
+ */
+int edo_speller_create(int edo, TonalContext key, EDOSpeller *out);
+
+/**
+ * Frees the memory previously allocated by an EDOSpeller.
+ */
+void edo_speller_destroy(EDOSpeller *s);
+
+/**
+ * Creates a HeightMap that orders Pitch vectors by how high they sound in the
+ * tuning system defined by the passed-in TuningMap, using integer arithmetic
+ * only. Build it once and reuse it for every comparison.
+ *
+ * If the TuningMap's fifth is (to within 0.0001¢) the fifth of an EDO of up to
+ * 1200 notes, heights are exact step numbers in the smallest such EDO, so
+ * Pitches that are enharmonic in that EDO get equal heights. Otherwise heights
+ * are fixed-point cents with a resolution of 2^-20¢.
+ */
+HeightMap height_map_from_tuning(TuningMap T);
+
 #endif
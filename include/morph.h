@@ -0,0 +1,51 @@
+#ifndef MORPH_H
+#define MORPH_H
+
+#include "types.h"
+
+/**
+ * Creates a TuningMorph of silent voices that moves from one tuning system to
+ * another over the given number of blocks. Frequencies move linearly in cents,
+ * which (cents being linear in the size of the fifth) is the same as sweeping
+ * the fifth, reference frequency and all, at a steady rate.
+ * @param blocks
+ * Length of the morph. 0 means every voice sounds in the target tuning
+ * straight away.
+ * @param out
+ * Pointer to a TuningMorph to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if blocks is negative, voices isn't
+ * positive, or memory couldn't be allocated.
+ */
+int tuning_morph_create(TuningMap from, TuningMap to, int blocks, int voices,
+                        TuningMorph *out);
+
+/**
+ * Frees the memory previously allocated by a TuningMorph.
+ */
+void tuning_morph_destroy(TuningMorph *m);
+
+/**
+ * Starts a voice sounding a Pitch, at its frequency for the morph's current
+ * position. This is the only place frequencies are computed.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if voice is out of range.
+ */
+int tuning_morph_voice_on(TuningMorph *m, int voice, Pitch p);
+
+/**
+ * Silences a voice.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if voice is out of range.
+ */
+int tuning_morph_voice_off(TuningMorph *m, int voice);
+
+/**
+ * Moves the morph on by one block and writes every voice's new frequency to
+ * hz (0 for silent voices). Costs one multiply per voice with no libm calls.
+ * On the final block voices land exactly on their target tuning, and stay
+ * there.
+ */
+void tuning_morph_advance(TuningMorph *m, double hz[]);
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef OPTIMIZE_H
+#define OPTIMIZE_H
+
+#include "types.h"
+
+/**
+ * Finds the fifth size that best fits a collection of Intervals to target
+ * sizes, e.g. their just ratios in cents. Pass the result to
+ * tuning_map_from_fifth. Only fifths that tuning_map_from_fifth accepts are
+ * considered.
+ * @param just
+ * The target size of each Interval in cents, e.g. 1200 * log2(5.0 / 4).
+ * @param weight
+ * How often each Interval is used (non-negative), or NULL to weight them
+ * equally. Under MINIMAX, only whether an Interval is used at all matters.
+ * @param out
+ * Pointer to store the best fifth in cents.
+ * @param error
+ * Pointer to store the error of the best fifth in cents, under the chosen
+ * criterion. May be NULL.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if no used Interval depends on the
+ * size of the fifth (e.g. only octaves are used), so every fifth fits equally
+ * well.
+ */
+int optimal_fifth(const Interval m[], const double just[],
+                  const double weight[], int len, enum FitCriterion criterion,
+                  double *out, double *error);
+
+/**
+ * Finds the EDO between min_edo and max_edo (inclusive) that best fits a
+ * collection of Intervals to target sizes, under the same rules as
+ * optimal_fifth. EDOs that create_edo_map rejects are skipped, and ties go to
+ * the smaller EDO.
+ *
+ * When the library is built with MEANTONAL_THREADS (see parallel.h), long
+ * scans are split over several threads.
+ * @param out
+ * Pointer to store the best EDO.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if no used Interval depends on the
+ * size of the fifth, or there's no usable EDO in the range.
+ */
+int optimal_edo(const Interval m[], const double just[], const double weight[],
+                int len, int min_edo, int max_edo, enum FitCriterion criterion,
+                int *out, double *error);
+
+#endif
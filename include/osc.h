@@ -0,0 +1,49 @@
+#ifndef OSC_H
+#define OSC_H
+
+#include "types.h"
+
+/**
+ * Creates an OscBank of silent voices (phase increment 0) rendering Pitches in
+ * the tuning system defined by the passed-in TuningMap.
+ * @param out
+ * Pointer to an OscBank to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if voices isn't positive, sample_rate
+ * isn't positive and finite, or memory couldn't be allocated.
+ */
+int osc_bank_create(TuningMap T, double sample_rate, int voices, OscBank *out);
+
+/**
+ * Frees the memory previously allocated by an OscBank.
+ */
+void osc_bank_destroy(OscBank *b);
+
+/**
+ * Moves a voice straight to a Pitch, cancelling any glide in progress.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if voice is out of range.
+ */
+int osc_bank_set(OscBank *b, int voice, Pitch p);
+
+/**
+ * Glides a voice exponentially (linearly in cents) from where it is now to a
+ * Pitch, arriving exactly on the Pitch's frequency after the given number of
+ * samples. A silent voice, or a glide of 0 samples, jumps straight there.
+ * Call osc_bank_set first to glide from a particular Pitch.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if voice is out of range.
+ */
+int osc_bank_glide(OscBank *b, int voice, Pitch p, int samples);
+
+/**
+ * Renders the next block of phase increments for every voice.
+ * Gliding costs one multiply per voice per sample: frequencies are only
+ * computed when a voice is set or starts a glide.
+ * @param out
+ * Buffer of frames * b->len increments, interleaved by frame like multichannel
+ * audio: out[i * b->len + v] is voice v's increment at sample i.
+ */
+void osc_bank_render(OscBank *b, int frames, double out[]);
+
+#endif
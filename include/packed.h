@@ -0,0 +1,150 @@
+#ifndef PACKED_H
+#define PACKED_H
+
+#include "pitch.h"
+#include "types.h"
+
+// Pitch16 arithmetic works on both 16-bit lanes of the uint32_t at once (SIMD
+// within a register): the top bit of each lane is masked off so carries can't
+// cross into the next lane, and then patched back in with an XOR. Like int16_t
+// arithmetic, results that don't fit in a lane wrap around.
+
+/**
+ * Packs a Pitch into a Pitch16.
+ * @param out
+ * Pointer to a Pitch16 to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if w or h is outside -32768 to 32767.
+ */
+static inline int pitch16_from_pitch(Pitch p, Pitch16 *out) {
+    if (p.w < -32768 || p.w > 32767 || p.h < -32768 || p.h > 32767)
+        return 1;
+    *out = (uint32_t)(p.w & 0xffff) | (uint32_t)(p.h & 0xffff) << 16;
+    return 0;
+}
+
+/**
+ * Returns the whole steps of a Pitch16.
+ */
+static inline int pitch16_w(Pitch16 p) {
+    return (int)(p & 0xffff) - (int)(p << 1 & 0x10000);
+}
+
+/**
+ * Returns the half steps of a Pitch16.
+ */
+static inline int pitch16_h(Pitch16 p) {
+    return (int)(p >> 16) - (int)(p >> 15 & 0x10000);
+}
+
+/**
+ * Unpacks a Pitch16 back into a Pitch.
+ */
+static inline Pitch pitch16_to_pitch(Pitch16 p) {
+    return (Pitch){.w = pitch16_w(p), .h = pitch16_h(p)};
+}
+
+/**
+ * Returns a Pitch16 shifted by the given packed Interval, like transpose_real.
+ */
+static inline Pitch16 pitch16_transpose(Pitch16 p, Pitch16 m) {
+    const uint32_t sign = 0x80008000u;
+    return ((p & ~sign) + (m & ~sign)) ^ ((p ^ m) & sign);
+}
+
+/**
+ * Returns the packed Interval from p to q, like interval_between.
+ */
+static inline Pitch16 pitch16_interval(Pitch16 p, Pitch16 q) {
+    const uint32_t sign = 0x80008000u;
+    return ((q | sign) - (p & ~sign)) ^ ((q ^ ~p) & sign);
+}
+
+/**
+ * Inverts a Pitch16 about a packed MirrorAxis, like pitch_invert.
+ */
+static inline Pitch16 pitch16_invert(Pitch16 p, Pitch16 axis) {
+    return pitch16_interval(p, axis);
+}
+
+/**
+ * Returns the pitch_chroma of a Pitch16.
+ */
+static inline int pitch16_chroma(Pitch16 p) {
+    return 2 * pitch16_w(p) - 5 * pitch16_h(p);
+}
+
+/**
+ * Returns the pitch_letter of a Pitch16.
+ */
+static inline int pitch16_letter(Pitch16 p) {
+    return floor_mod7(pitch16_w(p) + pitch16_h(p) + 2);
+}
+
+/**
+ * Returns the pitch_accidental of a Pitch16.
+ */
+static inline int pitch16_accidental(Pitch16 p) {
+    return floor_div7(pitch16_chroma(p) + 1);
+}
+
+/**
+ * Returns the pitch_octave of a Pitch16.
+ */
+static inline int pitch16_octave(Pitch16 p) {
+    return floor_div7(pitch16_w(p) + pitch16_h(p)) - 1;
+}
+
+/**
+ * Returns the pitch_midi of a Pitch16.
+ */
+static inline int pitch16_midi(Pitch16 p) {
+    return 2 * pitch16_w(p) + pitch16_h(p);
+}
+
+/**
+ * Packs every Pitch in arr into out with pitch16_from_pitch.
+ * Pitches that don't fit are skipped, leaving out untouched at that position.
+ * @return
+ * The number of Pitches skipped, so 0 means nothing went wrong.
+ */
+int pitches_to_pitch16(const Pitch arr[], int len, Pitch16 out[]);
+
+/**
+ * Unpacks every Pitch16 in arr into out.
+ */
+void pitches_from_pitch16(const Pitch16 arr[], int len, Pitch out[]);
+
+/**
+ * Transposes every Pitch16 in arr in place by the packed Interval m.
+ */
+void pitches16_transpose(Pitch16 arr[], int len, Pitch16 m);
+
+/**
+ * Writes the packed Interval from p[i] to q[i] to out[i] for every i.
+ */
+void pitches16_intervals(const Pitch16 p[], const Pitch16 q[], int len,
+                         Pitch16 out[]);
+
+/**
+ * Writes the pitch_to_standard of every Pitch16 in arr to out.
+ */
+void pitches16_to_standard(const Pitch16 arr[], int len, StandardPitch out[]);
+
+/**
+ * Fills a PitchBuffer with unpacked Pitch16s, replacing its contents.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if len is negative or more than the
+ * buffer's capacity.
+ */
+int pitch_buffer_from_pitch16(PitchBuffer *b, const Pitch16 arr[], int len);
+
+/**
+ * Packs the Pitches in a PitchBuffer into out, skipping any that don't fit as
+ * pitches_to_pitch16 does.
+ * @return
+ * The number of Pitches skipped, so 0 means nothing went wrong.
+ */
+int pitch_buffer_to_pitch16(const PitchBuffer *b, Pitch16 out[]);
+
+#endif
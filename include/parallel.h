@@ -0,0 +1,38 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+// Optional multithreading for the long-running batch functions. Define
+// MEANTONAL_THREADS when compiling the library (and link with -pthread) to
+// spread their work over the machine's cores; without it everything runs on
+// the calling thread. Results are the same either way.
+
+/**
+ * The most threads parallel_for uses, and so the most chunks it splits into.
+ */
+enum { PARALLEL_MAX_THREADS = 64 };
+
+/**
+ * Returns the number of threads parallel_for may use: the number of online
+ * cores (at most PARALLEL_MAX_THREADS) when built with MEANTONAL_THREADS,
+ * otherwise 1.
+ */
+int parallel_threads(void);
+
+/**
+ * Returns how many chunks parallel_for splits len items into: one per thread,
+ * but never so many that a chunk has fewer than grain items, and at least 1.
+ */
+int parallel_chunks(long len, long grain);
+
+/**
+ * Splits the items 0 to len - 1 into n = parallel_chunks(len, grain)
+ * contiguous chunks and calls body(ctx, i, start, end) for each chunk i, on
+ * its own thread where there is one. Chunk i is always items
+ * i * len / n to (i + 1) * len / n - 1, so per-chunk results can be combined
+ * in order afterwards. Returns once every chunk is done.
+ */
+void parallel_for(long len, long grain,
+                  void (*body)(void *ctx, int chunk, long start, long end),
+                  void *ctx);
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef NOTE_H
 #define NOTE_H
 
+#include "arith.h"
 #include "types.h"
 #include <stdbool.h>
 
@@ -20,9 +21,7 @@ static inline int pitch_chroma(Pitch p) { return 2 * p.w - 5 * p.h; }
  * Returns the letter number of a Pitch.
  * To convert to an actual letter, just add 'a' or 'A'.
  */
-static inline int pitch_letter(Pitch p) {
-    return ((p.w + p.h + 2) % 7 + 7) % 7;
-}
+static inline int pitch_letter(Pitch p) { return floor_mod7(p.w + p.h + 2); }
 
 /**
  * 0 is natural.
@@ -30,15 +29,14 @@ static inline int pitch_letter(Pitch p) {
  * Flats are negative.
  */
 static inline int pitch_accidental(Pitch p) {
-    int chroma = pitch_chroma(p) + 1;
-    return chroma < 0 ? chroma / 7 - 1 : chroma / 7;
+    return floor_div7(pitch_chroma(p) + 1);
 }
 
 /**
  * Returns the SPN octave number of a Pitch (C4 is middle C)
  */
 static inline int pitch_octave(Pitch p) {
-    return p.w + p.h < 0 ? (p.w + p.h) / 7 - 2 : (p.w + p.h) / 7 - 1;
+    return floor_div7(p.w + p.h) - 1;
 }
 
 /**
@@ -50,7 +48,7 @@ static inline int pitch_midi(Pitch p) { return 2 * p.w + p.h; }
  * Returns the 12-tone pitch class of a given Pitch.
  * C is 0.
  */
-static inline int pitch_pc12(Pitch p) { return pitch_midi(p) % 12; }
+static inline int pitch_pc12(Pitch p) { return trunc_mod12(pitch_midi(p)); }
 
 /**
  * Returns the (signed) distance in diatonic steps between two Pitch vectors.
@@ -74,8 +72,7 @@ static inline bool pitches_equal(Pitch p, Pitch q) {
  * The EDO tuning system to compare enharmonicity in.
  */
 static inline bool pitches_enharmonic(Pitch m, Pitch n, int edo) {
-    return (pitch_chroma(m) % edo + edo) % edo ==
-           (pitch_chroma(n) % edo + edo) % edo;
+    return ((long long)pitch_chroma(m) - pitch_chroma(n)) % edo == 0;
 }
 
 /**
@@ -88,6 +85,30 @@ static inline int pitch_to_number(Pitch p, EDOMap T) {
     return T.m0 * p.w + T.m1 * p.h;
 }
 
+/**
+ * Writes the pitch_to_number value of every Pitch in arr to out, 8 at a time
+ * when compiled with AVX2.
+ */
+void pitches_to_numbers(const Pitch arr[], int len, EDOMap T, int out[]);
+
+/**
+ * The inverse of pitch_to_number: returns the Pitch an EDOSpeller spells a
+ * pitch number as, in constant time.
+ */
+static inline Pitch pitch_from_number(int n, const EDOSpeller *s) {
+    // in long long, since edo - 1 - n overflows an int for n near INT_MIN
+    long long octaves = n >= 0 ? n / s->edo : -((s->edo - 1LL - n) / s->edo);
+    Pitch p = s->spellings[n - octaves * s->edo];
+    return (Pitch){.w = (int)(p.w + 5 * octaves),
+                   .h = (int)(p.h + 2 * octaves)};
+}
+
+/**
+ * Writes the pitch_from_number spelling of every number in arr to out.
+ */
+void pitches_from_numbers(const int arr[], int len, const EDOSpeller *s,
+                          Pitch out[]);
+
 /**
  * Returns a positive value if p sounds above q.
  * Returns a negative value if p sounds below q.
@@ -97,30 +118,119 @@ static inline int pitches_compare(Pitch p, Pitch q, EDOMap T) {
     return pitch_to_number(p, T) - pitch_to_number(q, T);
 }
 
+/**
+ * Returns the integer height of a Pitch in the tuning system a HeightMap was
+ * created from (see height_map_from_tuning). Higher-sounding Pitches have
+ * larger heights.
+ */
+static inline long long pitch_height(Pitch p, HeightMap H) {
+    return H.m0 * p.w + H.m1 * p.h;
+}
+
+/**
+ * Returns a positive value if p sounds above q.
+ * Returns a negative value if p sounds below q.
+ * Pitches of equal height are ordered by diatonic steps, so C#4 comes before
+ * Db4 when the two are enharmonic. Returns 0 only if neither decides.
+ */
+static inline int pitches_compare_height(Pitch p, Pitch q, HeightMap H) {
+    long long x = pitch_height(p, H), y = pitch_height(q, H);
+    if (x != y)
+        return x > y ? 1 : -1;
+    return (p.w + p.h > q.w + q.h) - (p.w + p.h < q.w + q.h);
+}
+
+/**
+ * Writes the height of every Pitch in arr to out.
+ */
+void pitch_heights(const Pitch arr[], int len, HeightMap H, long long out[]);
+
+/**
+ * Returns the index of the highest Pitch in a passed-in array, or -1 if the
+ * array is empty. Enharmonic ties go to the Pitch with more diatonic steps,
+ * and after that to the earliest one.
+ */
+int pitch_highest_index(const Pitch arr[], int len, HeightMap H);
+
+/**
+ * Returns the index of the lowest Pitch in a passed-in array, or -1 if the
+ * array is empty. Enharmonic ties go to the Pitch with fewer diatonic steps,
+ * and after that to the earliest one.
+ */
+int pitch_lowest_index(const Pitch arr[], int len, HeightMap H);
+
+/**
+ * Sorts an array of Pitches in place from lowest to highest, in the order
+ * given by pitches_compare_height.
+ */
+void pitch_sort(Pitch arr[], int len, HeightMap H);
+
+/**
+ * Ranks an array of Pitches without moving them: out[0] is the index of the
+ * lowest Pitch, out[len - 1] the index of the highest. Pitches that compare
+ * equal keep their original order.
+ */
+void pitch_argsort(const Pitch arr[], int len, HeightMap H, int out[]);
+
 /**
  * Returns true if p is within the approximate average range of human hearing.
  * That is, roughly: between 20Hz - 20kHz
+ * To check many Pitches, create a PitchRange with pitch_range_audible once and
+ * use pitch_in_range instead.
  */
 bool pitch_audible(Pitch p, TuningMap T);
 
 /**
  * Returns the highest Pitch in a passed-in array. Uses a TuningMap to determine
  * which Pitch is higher than the others.
+ * If you're searching many arrays in the same tuning, create a HeightMap once
+ * and use pitch_highest_index instead.
  */
 Pitch pitch_highest(Pitch arr[], int len, TuningMap T);
 
 /**
  * Returns the lowest Pitch in a passed-in array. Uses a TuningMap to determine
  * which Pitch is lower than the others.
+ * If you're searching many arrays in the same tuning, create a HeightMap once
+ * and use pitch_lowest_index instead.
  */
 Pitch pitch_lowest(Pitch arr[], int len, TuningMap T);
 
 /**
  * Finds the nearest Pitch in an array to a given Pitch. Uses a TuningMap to
  * determine which Pitch is closer than the others.
+ * Ties go to the Pitch fewest diatonic steps away, then to the earliest one.
+ * If you're querying the same array many times, build a NearestIndex instead.
  */
 Pitch pitch_nearest(Pitch p, Pitch arr[], int len, TuningMap T);
 
+/**
+ * Builds a NearestIndex over an array of candidate Pitches in the tuning
+ * system defined by the passed-in TuningMap. The array isn't referenced
+ * afterwards.
+ * @param out
+ * Pointer to a NearestIndex to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if the array is empty or memory
+ * couldn't be allocated.
+ */
+int nearest_index_create(const Pitch arr[], int len, TuningMap T,
+                         NearestIndex *out);
+
+/**
+ * Frees the memory previously allocated by a NearestIndex.
+ */
+void nearest_index_destroy(NearestIndex *ix);
+
+/**
+ * Finds the candidate nearest to a given Pitch, following the same rules as
+ * pitch_nearest, in O(log n) time with no allocation.
+ * @return
+ * The position of that candidate in the array the index was built from, or -1
+ * if the index is empty (e.g. after nearest_index_destroy).
+ */
+int nearest_index_query(const NearestIndex *ix, Pitch p);
+
 /**
  * Returns a new Pitch shifted by the given interval.
  * @return
@@ -145,6 +255,34 @@ static inline Pitch pitch_invert(Pitch p, MirrorAxis a) {
     return (Pitch){.w = a.w - p.w, .h = a.h - p.h};
 }
 
+/**
+ * Rebuilds a melody from its starting Pitch and the Intervals between its
+ * notes: out[i] is start transposed by m[0] through m[i] (an inclusive prefix
+ * sum). The inverse of intervals_from_pitches.
+ *
+ * To decode one long melody on several threads, split m into chunks, sum each
+ * chunk with intervals_sum (in parallel), add the sums up in order to find
+ * each chunk's start, then decode the chunks (in parallel).
+ * @return
+ * The last Pitch written (start if len is 0), which is the start of the next
+ * chunk.
+ */
+Pitch pitches_from_intervals(Pitch start, const Interval m[], int len,
+                             Pitch out[]);
+
+/**
+ * Writes the Interval from each Pitch to the next to out: out[0] is the
+ * Interval from start to arr[0], and out[i] the Interval from arr[i - 1] to
+ * arr[i]. The inverse of pitches_from_intervals. out may be arr itself.
+ */
+void intervals_from_pitches(Pitch start, const Pitch arr[], int len,
+                            Interval out[]);
+
+/**
+ * Returns the sum of an array of Intervals.
+ */
+Interval intervals_sum(const Interval m[], int len);
+
 /**
  * Converts from (whole, half) format to (letter, accidental, octave)
  */
@@ -0,0 +1,76 @@
+#ifndef RANGE_H
+#define RANGE_H
+
+#include "pitch.h"
+#include "types.h"
+
+/**
+ * Creates a PitchRange holding every Pitch whose frequency in the tuning
+ * system defined by the passed-in TuningMap is from lo_hz to hi_hz inclusive.
+ * Frequencies are only worked out here, once, so checking Pitches against the
+ * range needs no floating point.
+ * @param out
+ * Pointer to a PitchRange to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if lo_hz and hi_hz aren't positive,
+ * finite frequencies, or hi_hz is below lo_hz.
+ */
+int pitch_range_from_hz(double lo_hz, double hi_hz, TuningMap T,
+                        PitchRange *out);
+
+/**
+ * Creates a PitchRange holding every Pitch from lo to hi inclusive, e.g. the
+ * written range of an instrument, in the tuning system defined by the
+ * passed-in TuningMap. Pitches enharmonic to lo or hi are in range too.
+ */
+PitchRange pitch_range_from_pitches(Pitch lo, Pitch hi, TuningMap T);
+
+/**
+ * Creates the PitchRange of Pitches pitch_audible accepts, from 20Hz to 20kHz.
+ */
+PitchRange pitch_range_audible(TuningMap T);
+
+/**
+ * Returns true if a Pitch is within a PitchRange.
+ */
+static inline bool pitch_in_range(Pitch p, PitchRange r) {
+    long long height = pitch_height(p, r.H);
+    return r.lo <= height && height <= r.hi;
+}
+
+/**
+ * Checks every Pitch in arr with pitch_in_range, writing the results to out.
+ * @return
+ * The number of Pitches in range.
+ */
+int pitches_in_range(const Pitch arr[], int len, PitchRange r, bool out[]);
+
+/**
+ * Copies the Pitches of arr that are within a PitchRange to out, in order.
+ * Nothing else is written, so out only needs room for the Pitches in range.
+ * out may be arr itself.
+ * @return
+ * The number of Pitches copied.
+ */
+int pitches_filter_range(const Pitch arr[], int len, PitchRange r,
+                         Pitch out[]);
+
+/**
+ * Lists every Pitch within a PitchRange that has at most max_accidental sharps
+ * or flats, from lowest to highest in the order of pitch_sort, e.g. the keys
+ * of an on-screen keyboard. Only the spellings that are written are visited,
+ * so the time taken grows with the output, not with the width of the range.
+ * @param out
+ * Array to store up to capacity Pitches. May be NULL if capacity is 0.
+ * @param total
+ * Pointer to store the number of Pitches in the whole list, which is more
+ * than capacity if out was too small to hold them all.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if capacity or max_accidental is
+ * negative, max_accidental is over 100000, the list would hold more than
+ * INT_MAX Pitches, or memory couldn't be allocated.
+ */
+int pitch_range_spellings(PitchRange r, int max_accidental, Pitch out[],
+                          int capacity, int *total);
+
+#endif
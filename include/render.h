@@ -0,0 +1,63 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "types.h"
+
+/**
+ * Fills a wavetable with one cycle of an additive waveform.
+ * @param amps
+ * Amplitude of each harmonic, starting from the fundamental. {1} gives a sine
+ * wave.
+ */
+void wavetable_harmonics(float table[], int len, const double amps[],
+                         int harmonics);
+
+/**
+ * Creates a NoteRenderer for a list of NoteEvents in the tuning system defined
+ * by the passed-in TuningMap. Every note's frequency is computed here, once;
+ * neither the notes nor the table are referenced afterwards.
+ * Notes get a 5ms linear fade in and out so they start and stop cleanly.
+ * @param table
+ * One cycle of the waveform to play, e.g. from wavetable_harmonics.
+ * @param table_len
+ * Length of table, which must be a power of two.
+ * @param out
+ * Pointer to a NoteRenderer to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if sample_rate isn't positive,
+ * table_len isn't a power of two, or memory couldn't be allocated.
+ */
+int note_renderer_create(const NoteEvent notes[], int len, TuningMap T,
+                         int sample_rate, const float table[], int table_len,
+                         NoteRenderer *out);
+
+/**
+ * Frees the memory previously allocated by a NoteRenderer.
+ */
+void note_renderer_destroy(NoteRenderer *r);
+
+/**
+ * Returns the length in samples of the whole render: up to the end of the
+ * last note to finish.
+ */
+long note_renderer_frames(const NoteRenderer *r);
+
+/**
+ * Renders frames samples starting at sample start into out (mono).
+ * Every sample depends only on its position, so any range can be rendered
+ * independently of the rest and comes out the same however the file is split
+ * up; ranges can also be rendered on separate threads, sharing one
+ * NoteRenderer. When the library is built with MEANTONAL_THREADS (see
+ * parallel.h), long ranges are split over several threads here.
+ */
+void note_renderer_render(const NoteRenderer *r, long start, long frames,
+                          float out[]);
+
+/**
+ * Renders everything to a mono 16-bit WAV file, a block at a time.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if the file couldn't be written.
+ */
+int note_renderer_write_wav(const NoteRenderer *r, const char *path);
+
+#endif
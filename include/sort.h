@@ -0,0 +1,36 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include "types.h"
+
+/**
+ * Sorts an array of Pitches in place from lowest to highest in an EDO, by
+ * pitch_to_number and then, between enharmonic Pitches, by diatonic steps (so
+ * C#4 comes before Db4). Pitches equal in both keep their original order.
+ *
+ * Uses an LSD radix sort rather than comparisons, so it takes linear time,
+ * with temporary memory of around 40 bytes per Pitch.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if memory couldn't be allocated, in
+ * which case arr is unchanged.
+ */
+int pitch_radix_sort(Pitch arr[], int len, EDOMap T);
+
+/**
+ * Ranks an array of Pitches in the order of pitch_radix_sort without moving
+ * them: out[0] is the index of the lowest Pitch, out[len - 1] the index of the
+ * highest.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if memory couldn't be allocated.
+ */
+int pitch_radix_argsort(const Pitch arr[], int len, EDOMap T, int out[]);
+
+/**
+ * Sorts the Pitches in a PitchBuffer in the order of pitch_radix_sort.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if memory couldn't be allocated, in
+ * which case the buffer is unchanged.
+ */
+int pitch_buffer_radix_sort(PitchBuffer *b, EDOMap T);
+
+#endif
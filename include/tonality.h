@@ -1,6 +1,7 @@
 #ifndef TONALITY_H
 #define TONALITY_H
 
+#include "arith.h"
 #include "pitch.h"
 #include "types.h"
 
@@ -30,7 +31,7 @@ TonalContext context_from_pitch(Pitch p, enum Mode mode);
  * TonalContext, 0-indexed so the tonic is 0.
  */
 static inline enum Degree degree_number(Pitch p, TonalContext key) {
-    return (enum Degree)(((p.w + p.h - key.tonic.letter + 2) % 7 + 7) % 7);
+    return (enum Degree)floor_mod7(p.w + p.h - key.tonic.letter + 2);
 }
 
 /**
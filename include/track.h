@@ -0,0 +1,55 @@
+#ifndef TRACK_H
+#define TRACK_H
+
+#include "types.h"
+
+/**
+ * Creates a PitchTracker for audio at the given sample rate.
+ * @param window
+ * Frame length in samples, a power of two. The lowest frequency that can be
+ * tracked is 2 * sample_rate / window, e.g. 43Hz for 2048 at 44.1kHz.
+ * @param hop
+ * Samples between the starts of consecutive frames.
+ * @param threshold
+ * How aperiodic a frame may be and still count as voiced, from 0 to 1. 0.1 to
+ * 0.15 suits most monophonic recordings.
+ * @param out
+ * Pointer to a PitchTracker to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if sample_rate or hop isn't positive,
+ * window isn't a power of two of at least 8, or memory couldn't be allocated.
+ */
+int pitch_tracker_create(int sample_rate, int window, int hop,
+                         double threshold, PitchTracker *out);
+
+/**
+ * Frees the memory previously allocated by a PitchTracker.
+ */
+void pitch_tracker_destroy(PitchTracker *t);
+
+/**
+ * Estimates the fundamental frequency of one frame of t->window samples.
+ * @return
+ * The frequency in Hz, or 0 if the frame is silent or unpitched.
+ */
+double pitch_tracker_frame(PitchTracker *t, const float frame[]);
+
+/**
+ * Returns the number of frames pitch_tracker_run finds in len samples.
+ */
+long pitch_tracker_frames(const PitchTracker *t, long len);
+
+/**
+ * Tracks a whole signal, writing the frequency of every frame to hz (0 where
+ * unpitched). Frame i starts at sample i * t->hop.
+ * If T is non-NULL, every pitched frame is also quantized to a spelled Pitch in
+ * out, as by pitches_from_hz, spelled in key (or C major if key is NULL).
+ * Unpitched frames leave out untouched.
+ * @return
+ * The number of frames written.
+ */
+long pitch_tracker_run(PitchTracker *t, const float samples[], long len,
+                       double hz[], const TuningMap *T,
+                       const TonalContext *key, Pitch out[]);
+
+#endif
@@ -1,6 +1,10 @@
 #ifndef TYPES_H
 #define TYPES_H
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
 /**
  * The most fundamental pitch representation in Meantonal.
  */
@@ -14,6 +18,31 @@ typedef struct {
  */
 typedef Pitch Interval;
 
+/**
+ * A Pitch (or Interval) packed into 32 bits, for holding large collections in
+ * half the memory. Whole steps are in the low 16 bits and half steps in the
+ * high 16 bits, both two's complement, so each must be within -32768 to 32767.
+ * Create one with pitch16_from_pitch.
+ */
+typedef uint32_t Pitch16;
+
+/**
+ * Pitch vectors with 16, 32 and 64-bit whole and half steps, for the width
+ * generic functions of width.h (prefixed i16_, i32_ and i64_). Pick the
+ * narrowest one that holds your data, for the densest batch kernels.
+ */
+typedef struct {
+    int16_t w, h;
+} PitchI16;
+
+typedef struct {
+    int32_t w, h;
+} PitchI32;
+
+typedef struct {
+    int64_t w, h;
+} PitchI64;
+
 /**
  * Enum of modes numbered in descending fifths starting from Lydian = 0.
  */
@@ -100,6 +129,52 @@ typedef struct {
     double x, y;
 } MapVec;
 
+/**
+ * Enum for choosing how tuning fits measure the error of a whole collection
+ * of intervals.
+ */
+enum FitCriterion {
+    LEAST_SQUARES, // weighted root-mean-square error
+    MINIMAX        // largest error of any interval that's used at all
+};
+
+/**
+ * Capacity limits of the AdaptiveTuner type.
+ */
+enum {
+    ADAPTIVE_MAX_VOICES = 16, // most Pitches that can sound at once
+    ADAPTIVE_MAX_CHROMA = 48  // widest interval (in 5ths) with a stored target
+};
+
+/**
+ * The AdaptiveTuner type retunes a stream of chords toward just intonation,
+ * as cent offsets from a base TuningMap. Create it with adaptive_tuner_create.
+ * It allocates nothing, so it can live on a real-time thread.
+ */
+typedef struct {
+    // target[ADAPTIVE_MAX_CHROMA + x] is the offset between two Pitches x
+    // fifths apart that makes their interval just
+    double target[2 * ADAPTIVE_MAX_CHROMA + 1];
+    double fifth_error, third_error; // for intervals wider than the table
+    double max_drift;                // largest average offset allowed
+    double drift;                    // average offset of the current chord
+    int len;                         // number of Pitches in the current chord
+    Pitch held[ADAPTIVE_MAX_VOICES];
+    double offset[ADAPTIVE_MAX_VOICES];
+} AdaptiveTuner;
+
+/**
+ * The KeyboardLayout type places the keys of an isomorphic keyboard on
+ * screen. Each key is a parallelogram spanned by the screen images of the
+ * (1, 0) and (0, 1) Pitch vectors, centred on its Pitch's position.
+ */
+typedef struct {
+    Map2D to_screen;   // Pitch vectors to screen offsets
+    Map2D from_screen; // inverse of to_screen
+    Pitch anchor;      // Pitch whose key centre is at anchor_pos
+    MapVec anchor_pos;
+} KeyboardLayout;
+
 /**
  * The TuningMap type is used to render frequencies, cent values and ratios
  * from Pitch and Interval vectors.
@@ -119,6 +194,246 @@ typedef struct {
     int m0, m1;
 } EDOMap;
 
+/**
+ * An entry in the precomputed EDO catalog (see edo_catalog_lookup).
+ */
+typedef struct {
+    int fifth_steps; // size of the fifth in steps of the EDO
+    EDOMap map;      // as create_edo_map would produce, {0, 0} if invalid
+    double fifth;    // size of the fifth in cents
+    bool valid;      // whether the fifth can produce a diatonic scale
+} EDOCatalogEntry;
+
+/**
+ * The EDOSpeller type is used to turn integer pitch numbers in an EDO tuning
+ * system back into Pitch vectors, spelled to suit a given TonalContext. Create
+ * it with edo_speller_create. You are responsible for calling
+ * edo_speller_destroy to free up resources.
+ */
+typedef struct {
+    int edo;
+    EDOMap map;
+    Pitch *spellings; // spellings[n] is numbered n, for 0 <= n < edo
+} EDOSpeller;
+
+/**
+ * The HeightMap type is used to produce a well-ordered integer height for
+ * Pitch vectors in the tuning system of a given TuningMap, so pitches can be
+ * compared and sorted without rendering frequencies.
+ */
+typedef struct {
+    long long m0, m1;
+    double scale; // height units per cent
+} HeightMap;
+
+/**
+ * The PitchRange type is a range of pitch heights (see HeightMap), compiled
+ * from a frequency range or a pair of Pitches so that checking a Pitch against
+ * it takes two integer comparisons. Create it with pitch_range_from_hz or
+ * pitch_range_from_pitches.
+ */
+typedef struct {
+    HeightMap H;
+    long long lo, hi; // smallest and largest heights in range, inclusive
+} PitchRange;
+
+/**
+ * A prebuilt index over a fixed set of candidate Pitches, for answering
+ * nearest-Pitch queries in logarithmic time. Create it with
+ * nearest_index_create. You are responsible for calling nearest_index_destroy
+ * to free up resources.
+ */
+typedef struct {
+    HeightMap H;
+    int len;
+    long long *heights; // ascending
+    Pitch *pitches;     // ascending by diatonic steps within equal heights
+    int *order;         // position of each Pitch in the original array
+} NearestIndex;
+
+/**
+ * The OscBank type turns Pitches into per-sample phase increments (cycles per
+ * sample) for a bank of oscillator voices, gliding between them. Voice state is
+ * kept as one array per field so a block renders all voices at once. Create it
+ * with osc_bank_create. You are responsible for calling osc_bank_destroy to
+ * free up resources.
+ */
+typedef struct {
+    TuningMap T;
+    double sample_rate;
+    int len;          // number of voices
+    double *inc;      // phase increment of each voice's latest sample
+    double *target;   // phase increment each voice is gliding to
+    double *ratio;    // per-sample factor taking inc to target, 1 if steady
+    int *remaining;   // samples left in each voice's glide, 0 if steady
+} OscBank;
+
+/**
+ * The TuningMorph type glides every sounding voice from one TuningMap's
+ * tuning to another's over a fixed number of audio blocks. Create it with
+ * tuning_morph_create. You are responsible for calling tuning_morph_destroy to
+ * free up resources.
+ */
+typedef struct {
+    TuningMap from, to;
+    int blocks;      // length of the morph in blocks
+    int elapsed;     // blocks advanced so far, at most blocks
+    int len;         // number of voices
+    double *hz;      // current frequency of each voice, 0 if silent
+    double *step;    // per-block factor taking hz towards target
+    double *target;  // frequency of each voice at the end of the morph
+} TuningMorph;
+
+/**
+ * The ZoneMap type assigns every Pitch in a window to its nearest sample root,
+ * along with the playback ratio that resamples the root to that Pitch. Create
+ * it with zone_map_create. You are responsible for calling zone_map_destroy to
+ * free up resources.
+ */
+typedef struct {
+    Pitch lo;      // corner of the window with the smallest w and h
+    int width;     // number of w values covered
+    int height;    // number of h values covered
+    int *root;     // root index of each Pitch, indexed by zone_map_lookup
+    double *ratio; // playback ratio of each Pitch
+} ZoneMap;
+
+/**
+ * A note to be rendered to audio by a NoteRenderer.
+ */
+typedef struct {
+    Pitch pitch;
+    double onset;    // in seconds
+    double duration; // in seconds
+    double velocity; // peak amplitude, 1 is full scale
+} NoteEvent;
+
+/**
+ * The NoteRenderer type renders a list of NoteEvents offline by playing a
+ * wavetable at each note's frequency. Create it with note_renderer_create. You
+ * are responsible for calling note_renderer_destroy to free up resources.
+ */
+typedef struct {
+    int sample_rate;
+    int table_len;  // a power of two
+    float *table;   // one cycle of the waveform
+    int len;        // number of notes
+    long *start;    // first sample of each note, ascending
+    long *length;   // length of each note in samples
+    double *inc;    // table positions advanced per sample by each note
+    float *gain;    // velocity of each note
+    long longest;   // largest length
+} NoteRenderer;
+
+/**
+ * The WavWriter type streams 16-bit PCM audio to a WAV file, so long renders
+ * never need to be held in memory. Create it with wav_writer_open, and call
+ * wav_writer_close to finish the file.
+ */
+typedef struct {
+    FILE *file;
+    int channels;
+    int sample_rate;
+    long frames; // frames written so far
+} WavWriter;
+
+/**
+ * The FFTPlan type holds the precomputed tables for fast Fourier transforms of
+ * one power-of-two size. Create it with fft_plan_create. You are responsible
+ * for calling fft_plan_destroy to free up resources.
+ */
+typedef struct {
+    int n;
+    double *cos_table; // cos(2 pi k / n) for 0 <= k < n / 2
+    double *sin_table; // sin(2 pi k / n) for 0 <= k < n / 2
+    int *bitrev;       // bit-reversal permutation of 0 .. n - 1
+} FFTPlan;
+
+/**
+ * A mono audio signal, e.g. read with wav_read. You are responsible for
+ * calling audio_buffer_destroy to free up resources.
+ */
+typedef struct {
+    float *samples;
+    long frames;
+    int sample_rate;
+} AudioBuffer;
+
+/**
+ * The PitchTracker type estimates the fundamental frequency of monophonic
+ * audio, a frame at a time, with the YIN algorithm. Create it with
+ * pitch_tracker_create. You are responsible for calling pitch_tracker_destroy
+ * to free up resources.
+ */
+typedef struct {
+    int sample_rate;
+    int window;       // frame length in samples, a power of two
+    int hop;          // samples between the starts of consecutive frames
+    double threshold; // largest normalised difference accepted as voiced
+    FFTPlan fft;
+    double *re, *im;  // FFT workspace, window long
+    double *energy;   // running sums of squares, window + 1 long
+    double *diff;     // normalised difference function, window / 2 long
+} PitchTracker;
+
+/**
+ * The Chromagram type measures how much energy each chroma class (a pitch
+ * class counted in fifths from C, so C# and Db are different classes) has in
+ * successive frames of audio. Create it with chromagram_create. You are
+ * responsible for calling chromagram_destroy to free up resources.
+ */
+typedef struct {
+    int sample_rate;
+    int window;      // frame length in samples, a power of two
+    int hop;         // samples between the starts of consecutive frames
+    int chroma_min;  // chroma of class 0
+    int classes;     // number of chroma classes
+    FFTPlan fft;
+    double *hann;    // analysis window, window long
+    double *re, *im; // FFT workspace, window long
+    int runs;        // number of runs of consecutive bins in one class
+    int *run_start;  // first bin of each run, grouped by class
+    int *run_end;    // one past the last bin of each run
+    int *class_runs; // runs of class c are class_runs[c] .. class_runs[c + 1]
+} Chromagram;
+
+/**
+ * The PitchBuffer type stores many Pitches as separate arrays of whole and
+ * half steps (structure of arrays), aligned to 32 bytes, so that batch
+ * operations on them vectorize. Create it with pitch_buffer_create. You are
+ * responsible for calling pitch_buffer_destroy to free up resources.
+ */
+typedef struct {
+    int *w;       // whole steps of each Pitch
+    int *h;       // half steps of each Pitch
+    int len;      // number of Pitches stored
+    int capacity; // number of Pitches there's room for
+} PitchBuffer;
+
+/**
+ * A value stored in a PitchMap: a count, a weight or a pointer, whichever the
+ * map is being used for.
+ */
+typedef union {
+    long long i;
+    double d;
+    void *ptr;
+} PitchValue;
+
+/**
+ * The PitchMap type is a hash table from Pitches (or Intervals) to
+ * PitchValues, using open addressing with linear probing. Create it with
+ * pitch_map_create. You are responsible for calling pitch_map_destroy to free
+ * up resources.
+ */
+typedef struct {
+    int len;            // number of Pitches stored
+    int capacity;       // number of slots, a power of two
+    uint8_t *tags;      // 0 for an empty slot, else 7 bits of its key's hash
+    Pitch *keys;        // key of each slot
+    PitchValue *values; // value of each slot
+} PitchMap;
+
 /**
  * This type is used with functions that invert Pitches about a fixed point.
  */
@@ -0,0 +1,48 @@
+#ifndef WAV_H
+#define WAV_H
+
+#include "types.h"
+
+/**
+ * Creates a WAV file and writes its header, ready for wav_writer_write.
+ * @param out
+ * Pointer to a WavWriter to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if channels or sample_rate isn't
+ * positive, or the file couldn't be written.
+ */
+int wav_writer_open(const char *path, int channels, int sample_rate,
+                    WavWriter *out);
+
+/**
+ * Appends frames of audio to a WAV file. Samples are interleaved by frame,
+ * run from -1 to 1, and are clipped outside that range. NaN is written as 0.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if the file couldn't be written.
+ */
+int wav_writer_write(WavWriter *w, const float samples[], long frames);
+
+/**
+ * Fills in the WAV header's lengths and closes the file.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if the file couldn't be written.
+ */
+int wav_writer_close(WavWriter *w);
+
+/**
+ * Reads a WAV file into an AudioBuffer, mixing all channels down to mono.
+ * Reads 8, 16, 24 and 32-bit PCM, and 32 and 64-bit floating point.
+ * @param out
+ * Pointer to an AudioBuffer to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if the file couldn't be read, isn't a
+ * WAV file in one of those formats, or memory couldn't be allocated.
+ */
+int wav_read(const char *path, AudioBuffer *out);
+
+/**
+ * Frees the memory previously allocated by an AudioBuffer.
+ */
+void audio_buffer_destroy(AudioBuffer *a);
+
+#endif
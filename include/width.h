@@ -0,0 +1,138 @@
+#ifndef WIDTH_H
+#define WIDTH_H
+
+#include "arith.h"
+#include "types.h"
+#include <stdint.h>
+
+// The core Pitch and Interval functions of pitch.h and interval.h, generated
+// for PitchI16, PitchI32 and PitchI64 from one definition. Each width gets the
+// same functions as the int versions, prefixed i16_, i32_ or i64_ and taking
+// and returning its own type (which also serves as its Interval type):
+//
+//   pitch_chroma, pitch_letter, pitch_accidental, pitch_octave, pitch_midi,
+//   pitch_pc12, steps_between, pitches_equal, pitches_enharmonic,
+//   pitch_height, transpose_real, axis_create, pitch_invert,
+//   interval_between, interval_chroma, intervals_equal,
+//   intervals_enharmonic, stepspan, interval_negate, intervals_add,
+//   intervals_subtract, interval_times, interval_simple
+//
+// e.g. i64_pitch_octave(PitchI64 p). Classifiers compute in int for i16 and
+// in long long for i32 and i64, so they are exact for every i16 and i32 Pitch,
+// and for i64 Pitches whose w and h are within 2^60 of 0. Vector arithmetic
+// is done in the width's unsigned type, so results that don't fit the width
+// wrap (converting back to the signed type is implementation-defined, and
+// wraps on every two's complement compiler) rather than overflow.
+//
+// Every width also gets the same batch API, declared below.
+
+#define MEANTONAL_WIDTH_INLINE(P, T, U, W, pre, DIV7, MOD7, MOD12)             \
+    static inline W pre##_pitch_chroma(P p) {                                  \
+        return 2 * (W)p.w - 5 * (W)p.h;                                        \
+    }                                                                          \
+    static inline int pre##_pitch_letter(P p) {                                \
+        return (int)MOD7((W)p.w + p.h + 2);                                    \
+    }                                                                          \
+    static inline W pre##_pitch_accidental(P p) {                              \
+        return DIV7(pre##_pitch_chroma(p) + 1);                                \
+    }                                                                          \
+    static inline W pre##_pitch_octave(P p) { return DIV7((W)p.w + p.h) - 1; } \
+    static inline W pre##_pitch_midi(P p) { return 2 * (W)p.w + p.h; }         \
+    static inline int pre##_pitch_pc12(P p) {                                  \
+        return (int)MOD12(pre##_pitch_midi(p));                                \
+    }                                                                          \
+    static inline W pre##_steps_between(P p, P q) {                            \
+        return ((W)q.w + q.h) - ((W)p.w + p.h);                                \
+    }                                                                          \
+    static inline bool pre##_pitches_equal(P p, P q) {                         \
+        return p.w == q.w && p.h == q.h;                                       \
+    }                                                                          \
+    static inline bool pre##_pitches_enharmonic(P m, P n, int edo) {           \
+        return (pre##_pitch_chroma(m) - pre##_pitch_chroma(n)) % edo == 0;     \
+    }                                                                          \
+    static inline long long pre##_pitch_height(P p, HeightMap H) {             \
+        return H.m0 * p.w + H.m1 * p.h;                                        \
+    }                                                                          \
+    static inline P pre##_transpose_real(P p, P m) {                           \
+        return (P){.w = (T)((U)p.w + (U)m.w), .h = (T)((U)p.h + (U)m.h)};      \
+    }                                                                          \
+    static inline P pre##_axis_create(P p, P q) {                              \
+        return (P){.w = (T)((U)p.w + (U)q.w), .h = (T)((U)p.h + (U)q.h)};      \
+    }                                                                          \
+    static inline P pre##_pitch_invert(P p, P a) {                             \
+        return (P){.w = (T)((U)a.w - (U)p.w), .h = (T)((U)a.h - (U)p.h)};      \
+    }                                                                          \
+    static inline P pre##_interval_between(P p, P q) {                         \
+        return (P){.w = (T)((U)q.w - (U)p.w), .h = (T)((U)q.h - (U)p.h)};      \
+    }                                                                          \
+    static inline W pre##_interval_chroma(P m) {                               \
+        return pre##_pitch_chroma(m);                                          \
+    }                                                                          \
+    static inline bool pre##_intervals_equal(P m, P n) {                       \
+        return pre##_pitches_equal(m, n);                                      \
+    }                                                                          \
+    static inline bool pre##_intervals_enharmonic(P m, P n, int edo) {         \
+        return pre##_pitches_enharmonic(m, n, edo);                            \
+    }                                                                          \
+    static inline W pre##_stepspan(P m) { return (W)m.w + m.h; }               \
+    static inline P pre##_interval_negate(P m) {                               \
+        return (P){.w = (T)(0 - (U)m.w), .h = (T)(0 - (U)m.h)};                \
+    }                                                                          \
+    static inline P pre##_intervals_add(P m, P n) {                            \
+        return pre##_transpose_real(m, n);                                     \
+    }                                                                          \
+    static inline P pre##_intervals_subtract(P m, P n) {                       \
+        return pre##_interval_between(n, m);                                   \
+    }                                                                          \
+    static inline P pre##_interval_times(P m, T x) {                           \
+        return (P){.w = (T)((U)m.w * (U)x), .h = (T)((U)m.h * (U)x)};          \
+    }                                                                          \
+    static inline P pre##_interval_simple(P m) {                               \
+        U octaves = (U)(pre##_stepspan(m) / 7);                                \
+        return (P){.w = (T)((U)m.w - 5 * octaves),                             \
+                   .h = (T)((U)m.h - 2 * octaves)};                            \
+    }
+
+MEANTONAL_WIDTH_INLINE(PitchI16, int16_t, unsigned, int, i16, floor_div7,
+                       floor_mod7, trunc_mod12)
+MEANTONAL_WIDTH_INLINE(PitchI32, int32_t, uint32_t, long long, i32,
+                       floor_div7_ll, floor_mod7_ll, trunc_mod12_ll)
+MEANTONAL_WIDTH_INLINE(PitchI64, int64_t, uint64_t, long long, i64,
+                       floor_div7_ll, floor_mod7_ll, trunc_mod12_ll)
+
+// The batch API of each width:
+//
+// int <pre>_pitches_from_pitches(const Pitch arr[], int len, P out[])
+//   Converts Pitches to the width. Pitches that don't fit are skipped, leaving
+//   out untouched at that position. Returns the number skipped.
+// int <pre>_pitches_to_pitches(const P arr[], int len, Pitch out[])
+//   The reverse, skipping any that don't fit in an int.
+// void <pre>_pitches_transpose(P arr[], int len, P m)
+//   Transposes every Pitch in place.
+// void <pre>_pitches_intervals(const P p[], const P q[], int len, P out[])
+//   Writes the Interval from p[i] to q[i] to out[i] for every i.
+// void <pre>_pitches_chromas(const P arr[], int len, W out[])
+// void <pre>_pitches_letters(const P arr[], int len, int out[])
+// void <pre>_pitches_accidentals(const P arr[], int len, W out[])
+// void <pre>_pitches_octaves(const P arr[], int len, W out[])
+// void <pre>_pitches_heights(const P arr[], int len, HeightMap H,
+//                            long long out[])
+//   Write the classifier of every Pitch in arr to out.
+
+#define MEANTONAL_WIDTH_DECLARE(P, W, pre)                                     \
+    int pre##_pitches_from_pitches(const Pitch arr[], int len, P out[]);       \
+    int pre##_pitches_to_pitches(const P arr[], int len, Pitch out[]);         \
+    void pre##_pitches_transpose(P arr[], int len, P m);                       \
+    void pre##_pitches_intervals(const P p[], const P q[], int len, P out[]);  \
+    void pre##_pitches_chromas(const P arr[], int len, W out[]);               \
+    void pre##_pitches_letters(const P arr[], int len, int out[]);             \
+    void pre##_pitches_accidentals(const P arr[], int len, W out[]);           \
+    void pre##_pitches_octaves(const P arr[], int len, W out[]);               \
+    void pre##_pitches_heights(const P arr[], int len, HeightMap H,            \
+                               long long out[]);
+
+MEANTONAL_WIDTH_DECLARE(PitchI16, int, i16)
+MEANTONAL_WIDTH_DECLARE(PitchI32, long long, i32)
+MEANTONAL_WIDTH_DECLARE(PitchI64, long long, i64)
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef ZONE_H
+#define ZONE_H
+
+#include "types.h"
+
+/**
+ * Creates a ZoneMap from an array of sample roots in the tuning system defined
+ * by the passed-in TuningMap. Every Pitch p with lo.w <= p.w <= hi.w and
+ * lo.h <= p.h <= hi.h is assigned the root pitch_nearest would choose, so e.g.
+ * lo = {0, 0} (C-1) and hi = {60, 25} covers every note a piano plays with
+ * anything up to double sharps and flats.
+ * @param out
+ * Pointer to a ZoneMap to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if there are no roots, the window is
+ * empty, or memory couldn't be allocated.
+ */
+int zone_map_create(const Pitch roots[], int len, TuningMap T, Pitch lo,
+                    Pitch hi, ZoneMap *out);
+
+/**
+ * Frees the memory previously allocated by a ZoneMap.
+ */
+void zone_map_destroy(ZoneMap *z);
+
+/**
+ * Looks up the sample root to play a Pitch from, with a single table lookup.
+ * @param ratio
+ * Pointer to store the playback ratio (the Pitch's frequency over the root's).
+ * May be NULL.
+ * @return
+ * The index of the root in the array the ZoneMap was built from, or -1 if p is
+ * outside the window.
+ */
+static inline int zone_map_lookup(const ZoneMap *z, Pitch p, double *ratio) {
+    unsigned w = p.w - z->lo.w, h = p.h - z->lo.h;
+    if (w >= (unsigned)z->width || h >= (unsigned)z->height)
+        return -1;
+    long i = (long)w * z->height + h;
+    if (ratio)
+        *ratio = z->ratio[i];
+    return z->root[i];
+}
+
+#endif
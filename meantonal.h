@@ -1,5 +1,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdio.h>
+#include <stdint.h>
 
 // -----------------------------------------
 // HEADER DECLARATIONS ---------------------
@@ -8,6 +10,7 @@
 #ifndef MEANTONAL_HEADER
 #define MEANTONAL_HEADER
 
+
 /**
  * The most fundamental pitch representation in Meantonal.
  */
@@ -21,6 +24,31 @@ typedef struct {
  */
 typedef Pitch Interval;
 
+/**
+ * A Pitch (or Interval) packed into 32 bits, for holding large collections in
+ * half the memory. Whole steps are in the low 16 bits and half steps in the
+ * high 16 bits, both two's complement, so each must be within -32768 to 32767.
+ * Create one with pitch16_from_pitch.
+ */
+typedef uint32_t Pitch16;
+
+/**
+ * Pitch vectors with 16, 32 and 64-bit whole and half steps, for the width
+ * generic functions of width.h (prefixed i16_, i32_ and i64_). Pick the
+ * narrowest one that holds your data, for the densest batch kernels.
+ */
+typedef struct {
+    int16_t w, h;
+} PitchI16;
+
+typedef struct {
+    int32_t w, h;
+} PitchI32;
+
+typedef struct {
+    int64_t w, h;
+} PitchI64;
+
 /**
  * Enum of modes numbered in descending fifths starting from Lydian = 0.
  */
@@ -107,6 +135,52 @@ typedef struct {
     double x, y;
 } MapVec;
 
+/**
+ * Enum for choosing how tuning fits measure the error of a whole collection
+ * of intervals.
+ */
+enum FitCriterion {
+    LEAST_SQUARES, // weighted root-mean-square error
+    MINIMAX        // largest error of any interval that's used at all
+};
+
+/**
+ * Capacity limits of the AdaptiveTuner type.
+ */
+enum {
+    ADAPTIVE_MAX_VOICES = 16, // most Pitches that can sound at once
+    ADAPTIVE_MAX_CHROMA = 48  // widest interval (in 5ths) with a stored target
+};
+
+/**
+ * The AdaptiveTuner type retunes a stream of chords toward just intonation,
+ * as cent offsets from a base TuningMap. Create it with adaptive_tuner_create.
+ * It allocates nothing, so it can live on a real-time thread.
+ */
+typedef struct {
+    // target[ADAPTIVE_MAX_CHROMA + x] is the offset between two Pitches x
+    // fifths apart that makes their interval just
+    double target[2 * ADAPTIVE_MAX_CHROMA + 1];
+    double fifth_error, third_error; // for intervals wider than the table
+    double max_drift;                // largest average offset allowed
+    double drift;                    // average offset of the current chord
+    int len;                         // number of Pitches in the current chord
+    Pitch held[ADAPTIVE_MAX_VOICES];
+    double offset[ADAPTIVE_MAX_VOICES];
+} AdaptiveTuner;
+
+/**
+ * The KeyboardLayout type places the keys of an isomorphic keyboard on
+ * screen. Each key is a parallelogram spanned by the screen images of the
+ * (1, 0) and (0, 1) Pitch vectors, centred on its Pitch's position.
+ */
+typedef struct {
+    Map2D to_screen;   // Pitch vectors to screen offsets
+    Map2D from_screen; // inverse of to_screen
+    Pitch anchor;      // Pitch whose key centre is at anchor_pos
+    MapVec anchor_pos;
+} KeyboardLayout;
+
 /**
  * The TuningMap type is used to render frequencies, cent values and ratios
  * from Pitch and Interval vectors.
@@ -126,6 +200,246 @@ typedef struct {
     int m0, m1;
 } EDOMap;
 
+/**
+ * An entry in the precomputed EDO catalog (see edo_catalog_lookup).
+ */
+typedef struct {
+    int fifth_steps; // size of the fifth in steps of the EDO
+    EDOMap map;      // as create_edo_map would produce, {0, 0} if invalid
+    double fifth;    // size of the fifth in cents
+    bool valid;      // whether the fifth can produce a diatonic scale
+} EDOCatalogEntry;
+
+/**
+ * The EDOSpeller type is used to turn integer pitch numbers in an EDO tuning
+ * system back into Pitch vectors, spelled to suit a given TonalContext. Create
+ * it with edo_speller_create. You are responsible for calling
+ * edo_speller_destroy to free up resources.
+ */
+typedef struct {
+    int edo;
+    EDOMap map;
+    Pitch *spellings; // spellings[n] is numbered n, for 0 <= n < edo
+} EDOSpeller;
+
+/**
+ * The HeightMap type is used to produce a well-ordered integer height for
+ * Pitch vectors in the tuning system of a given TuningMap, so pitches can be
+ * compared and sorted without rendering frequencies.
+ */
+typedef struct {
+    long long m0, m1;
+    double scale; // height units per cent
+} HeightMap;
+
+/**
+ * The PitchRange type is a range of pitch heights (see HeightMap), compiled
+ * from a frequency range or a pair of Pitches so that checking a Pitch against
+ * it takes two integer comparisons. Create it with pitch_range_from_hz or
+ * pitch_range_from_pitches.
+ */
+typedef struct {
+    HeightMap H;
+    long long lo, hi; // smallest and largest heights in range, inclusive
+} PitchRange;
+
+/**
+ * A prebuilt index over a fixed set of candidate Pitches, for answering
+ * nearest-Pitch queries in logarithmic time. Create it with
+ * nearest_index_create. You are responsible for calling nearest_index_destroy
+ * to free up resources.
+ */
+typedef struct {
+    HeightMap H;
+    int len;
+    long long *heights; // ascending
+    Pitch *pitches;     // ascending by diatonic steps within equal heights
+    int *order;         // position of each Pitch in the original array
+} NearestIndex;
+
+/**
+ * The OscBank type turns Pitches into per-sample phase increments (cycles per
+ * sample) for a bank of oscillator voices, gliding between them. Voice state is
+ * kept as one array per field so a block renders all voices at once. Create it
+ * with osc_bank_create. You are responsible for calling osc_bank_destroy to
+ * free up resources.
+ */
+typedef struct {
+    TuningMap T;
+    double sample_rate;
+    int len;          // number of voices
+    double *inc;      // phase increment of each voice's latest sample
+    double *target;   // phase increment each voice is gliding to
+    double *ratio;    // per-sample factor taking inc to target, 1 if steady
+    int *remaining;   // samples left in each voice's glide, 0 if steady
+} OscBank;
+
+/**
+ * The TuningMorph type glides every sounding voice from one TuningMap's
+ * tuning to another's over a fixed number of audio blocks. Create it with
+ * tuning_morph_create. You are responsible for calling tuning_morph_destroy to
+ * free up resources.
+ */
+typedef struct {
+    TuningMap from, to;
+    int blocks;      // length of the morph in blocks
+    int elapsed;     // blocks advanced so far, at most blocks
+    int len;         // number of voices
+    double *hz;      // current frequency of each voice, 0 if silent
+    double *step;    // per-block factor taking hz towards target
+    double *target;  // frequency of each voice at the end of the morph
+} TuningMorph;
+
+/**
+ * The ZoneMap type assigns every Pitch in a window to its nearest sample root,
+ * along with the playback ratio that resamples the root to that Pitch. Create
+ * it with zone_map_create. You are responsible for calling zone_map_destroy to
+ * free up resources.
+ */
+typedef struct {
+    Pitch lo;      // corner of the window with the smallest w and h
+    int width;     // number of w values covered
+    int height;    // number of h values covered
+    int *root;     // root index of each Pitch, indexed by zone_map_lookup
+    double *ratio; // playback ratio of each Pitch
+} ZoneMap;
+
+/**
+ * A note to be rendered to audio by a NoteRenderer.
+ */
+typedef struct {
+    Pitch pitch;
+    double onset;    // in seconds
+    double duration; // in seconds
+    double velocity; // peak amplitude, 1 is full scale
+} NoteEvent;
+
+/**
+ * The NoteRenderer type renders a list of NoteEvents offline by playing a
+ * wavetable at each note's frequency. Create it with note_renderer_create. You
+ * are responsible for calling note_renderer_destroy to free up resources.
+ */
+typedef struct {
+    int sample_rate;
+    int table_len;  // a power of two
+    float *table;   // one cycle of the waveform
+    int len;        // number of notes
+    long *start;    // first sample of each note, ascending
+    long *length;   // length of each note in samples
+    double *inc;    // table positions advanced per sample by each note
+    float *gain;    // velocity of each note
+    long longest;   // largest length
+} NoteRenderer;
+
+/**
+ * The WavWriter type streams 16-bit PCM audio to a WAV file, so long renders
+ * never need to be held in memory. Create it with wav_writer_open, and call
+ * wav_writer_close to finish the file.
+ */
+typedef struct {
+    FILE *file;
+    int channels;
+    int sample_rate;
+    long frames; // frames written so far
+} WavWriter;
+
+/**
+ * The FFTPlan type holds the precomputed tables for fast Fourier transforms of
+ * one power-of-two size. Create it with fft_plan_create. You are responsible
+ * for calling fft_plan_destroy to free up resources.
+ */
+typedef struct {
+    int n;
+    double *cos_table; // cos(2 pi k / n) for 0 <= k < n / 2
+    double *sin_table; // sin(2 pi k / n) for 0 <= k < n / 2
+    int *bitrev;       // bit-reversal permutation of 0 .. n - 1
+} FFTPlan;
+
+/**
+ * A mono audio signal, e.g. read with wav_read. You are responsible for
+ * calling audio_buffer_destroy to free up resources.
+ */
+typedef struct {
+    float *samples;
+    long frames;
+    int sample_rate;
+} AudioBuffer;
+
+/**
+ * The PitchTracker type estimates the fundamental frequency of monophonic
+ * audio, a frame at a time, with the YIN algorithm. Create it with
+ * pitch_tracker_create. You are responsible for calling pitch_tracker_destroy
+ * to free up resources.
+ */
+typedef struct {
+    int sample_rate;
+    int window;       // frame length in samples, a power of two
+    int hop;          // samples between the starts of consecutive frames
+    double threshold; // largest normalised difference accepted as voiced
+    FFTPlan fft;
+    double *re, *im;  // FFT workspace, window long
+    double *energy;   // running sums of squares, window + 1 long
+    double *diff;     // normalised difference function, window / 2 long
+} PitchTracker;
+
+/**
+ * The Chromagram type measures how much energy each chroma class (a pitch
+ * class counted in fifths from C, so C# and Db are different classes) has in
+ * successive frames of audio. Create it with chromagram_create. You are
+ * responsible for calling chromagram_destroy to free up resources.
+ */
+typedef struct {
+    int sample_rate;
+    int window;      // frame length in samples, a power of two
+    int hop;         // samples between the starts of consecutive frames
+    int chroma_min;  // chroma of class 0
+    int classes;     // number of chroma classes
+    FFTPlan fft;
+    double *hann;    // analysis window, window long
+    double *re, *im; // FFT workspace, window long
+    int runs;        // number of runs of consecutive bins in one class
+    int *run_start;  // first bin of each run, grouped by class
+    int *run_end;    // one past the last bin of each run
+    int *class_runs; // runs of class c are class_runs[c] .. class_runs[c + 1]
+} Chromagram;
+
+/**
+ * The PitchBuffer type stores many Pitches as separate arrays of whole and
+ * half steps (structure of arrays), aligned to 32 bytes, so that batch
+ * operations on them vectorize. Create it with pitch_buffer_create. You are
+ * responsible for calling pitch_buffer_destroy to free up resources.
+ */
+typedef struct {
+    int *w;       // whole steps of each Pitch
+    int *h;       // half steps of each Pitch
+    int len;      // number of Pitches stored
+    int capacity; // number of Pitches there's room for
+} PitchBuffer;
+
+/**
+ * A value stored in a PitchMap: a count, a weight or a pointer, whichever the
+ * map is being used for.
+ */
+typedef union {
+    long long i;
+    double d;
+    void *ptr;
+} PitchValue;
+
+/**
+ * The PitchMap type is a hash table from Pitches (or Intervals) to
+ * PitchValues, using open addressing with linear probing. Create it with
+ * pitch_map_create. You are responsible for calling pitch_map_destroy to free
+ * up resources.
+ */
+typedef struct {
+    int len;            // number of Pitches stored
+    int capacity;       // number of slots, a power of two
+    uint8_t *tags;      // 0 for an empty slot, else 7 bits of its key's hash
+    Pitch *keys;        // key of each slot
+    PitchValue *values; // value of each slot
+} PitchMap;
+
 /**
  * This type is used with functions that invert Pitches about a fixed point.
  */
@@ -145,10 +459,132 @@ typedef struct {
 
 
 
+// Floored division by the two moduli music keeps reaching for, exact for every
+// int. Each divides the magnitude of x as a uint32_t by multiplying with a
+// fixed-point reciprocal and shifting (Granlund & Montgomery, "Division by
+// Invariant Integers using Multiplication", 1994), then restores the sign, so
+// there is no division instruction, signed overflow or shift of a negative
+// value. The AVX2 kernels in buffer.c use the same reciprocals.
+
+/**
+ * n / 7 for any uint32_t. 7's reciprocal needs 33 bits, so the multiply-high
+ * by its low 32 bits is followed by an add-and-halve step.
+ */
+static inline uint32_t udiv7(uint32_t n) {
+    uint32_t q = (uint32_t)((uint64_t)n * 0x24924925u >> 32);
+    return (q + ((n - q) >> 1)) >> 2;
+}
+
+/**
+ * n / 12 for any uint32_t.
+ */
+static inline uint32_t udiv12(uint32_t n) {
+    return (uint32_t)((uint64_t)n * 0xaaaaaaabu >> 35);
+}
+
+/**
+ * floor(x / 7), without a division.
+ */
+static inline int floor_div7(int x) {
+    return x < 0 ? -(int)udiv7(6u - (uint32_t)x) : (int)udiv7((uint32_t)x);
+}
+
+/**
+ * x mod 7 in the range 0 to 6, without a division.
+ */
+static inline int floor_mod7(int x) {
+    return (int)((uint32_t)x - 7u * (uint32_t)floor_div7(x));
+}
+
+/**
+ * floor(x / 12), without a division.
+ */
+static inline int floor_div12(int x) {
+    return x < 0 ? -(int)udiv12(11u - (uint32_t)x) : (int)udiv12((uint32_t)x);
+}
+
+/**
+ * x mod 12 in the range 0 to 11, without a division.
+ */
+static inline int floor_mod12(int x) {
+    return (int)((uint32_t)x - 12u * (uint32_t)floor_div12(x));
+}
+
+/**
+ * x % 12 as C defines it (negative when x is), without a division.
+ */
+static inline int trunc_mod12(int x) {
+    uint32_t n = x < 0 ? 0u - (uint32_t)x : (uint32_t)x;
+    int r = (int)(n - 12 * udiv12(n));
+    return x < 0 ? -r : r;
+}
+
+// The same for long long, used where an int intermediate could overflow.
+// These divide by a constant and leave the multiply-high to the compiler.
+
+/**
+ * floor(x / 7) for a long long.
+ */
+static inline long long floor_div7_ll(long long x) {
+    return x / 7 - (x % 7 < 0);
+}
+
+/**
+ * x mod 7 in the range 0 to 6, for a long long.
+ */
+static inline long long floor_mod7_ll(long long x) {
+    return x - 7 * floor_div7_ll(x);
+}
+
+/**
+ * x % 12 as C defines it, for a long long.
+ */
+static inline long long trunc_mod12_ll(long long x) { return x % 12; }
+
+
+// Optional multithreading for the long-running batch functions. Define
+// MEANTONAL_THREADS when compiling the library (and link with -pthread) to
+// spread their work over the machine's cores; without it everything runs on
+// the calling thread. Results are the same either way.
+
+/**
+ * The most threads parallel_for uses, and so the most chunks it splits into.
+ */
+enum { PARALLEL_MAX_THREADS = 64 };
+
+/**
+ * Returns the number of threads parallel_for may use: the number of online
+ * cores (at most PARALLEL_MAX_THREADS) when built with MEANTONAL_THREADS,
+ * otherwise 1.
+ */
+int parallel_threads(void);
+
+/**
+ * Returns how many chunks parallel_for splits len items into: one per thread,
+ * but never so many that a chunk has fewer than grain items, and at least 1.
+ */
+int parallel_chunks(long len, long grain);
+
+/**
+ * Splits the items 0 to len - 1 into n = parallel_chunks(len, grain)
+ * contiguous chunks and calls body(ctx, i, start, end) for each chunk i, on
+ * its own thread where there is one. Chunk i is always items
+ * i * len / n to (i + 1) * len / n - 1, so per-chunk results can be combined
+ * in order afterwards. Returns once every chunk is done.
+ */
+void parallel_for(long len, long grain,
+                  void (*body)(void *ctx, int chunk, long start, long end),
+                  void *ctx);
+
+
+
 extern const Map2D WICKI_TO, WICKI_FROM, GENERATORS_TO, GENERATORS_FROM;
 
 extern const double CONCERT_C4;
 
+extern const int EDO_CATALOG_MAX;
+extern const EDOCatalogEntry EDO_CATALOG[];
+
 
 
 /**
@@ -167,9 +603,7 @@ static inline int pitch_chroma(Pitch p) { return 2 * p.w - 5 * p.h; }
  * Returns the letter number of a Pitch.
  * To convert to an actual letter, just add 'a' or 'A'.
  */
-static inline int pitch_letter(Pitch p) {
-    return ((p.w + p.h + 2) % 7 + 7) % 7;
-}
+static inline int pitch_letter(Pitch p) { return floor_mod7(p.w + p.h + 2); }
 
 /**
  * 0 is natural.
@@ -177,15 +611,14 @@ static inline int pitch_letter(Pitch p) {
  * Flats are negative.
  */
 static inline int pitch_accidental(Pitch p) {
-    int chroma = pitch_chroma(p) + 1;
-    return chroma < 0 ? chroma / 7 - 1 : chroma / 7;
+    return floor_div7(pitch_chroma(p) + 1);
 }
 
 /**
  * Returns the SPN octave number of a Pitch (C4 is middle C)
  */
 static inline int pitch_octave(Pitch p) {
-    return p.w + p.h < 0 ? (p.w + p.h) / 7 - 2 : (p.w + p.h) / 7 - 1;
+    return floor_div7(p.w + p.h) - 1;
 }
 
 /**
@@ -197,7 +630,7 @@ static inline int pitch_midi(Pitch p) { return 2 * p.w + p.h; }
  * Returns the 12-tone pitch class of a given Pitch.
  * C is 0.
  */
-static inline int pitch_pc12(Pitch p) { return pitch_midi(p) % 12; }
+static inline int pitch_pc12(Pitch p) { return trunc_mod12(pitch_midi(p)); }
 
 /**
  * Returns the (signed) distance in diatonic steps between two Pitch vectors.
@@ -221,8 +654,7 @@ static inline bool pitches_equal(Pitch p, Pitch q) {
  * The EDO tuning system to compare enharmonicity in.
  */
 static inline bool pitches_enharmonic(Pitch m, Pitch n, int edo) {
-    return (pitch_chroma(m) % edo + edo) % edo ==
-           (pitch_chroma(n) % edo + edo) % edo;
+    return ((long long)pitch_chroma(m) - pitch_chroma(n)) % edo == 0;
 }
 
 /**
@@ -235,6 +667,30 @@ static inline int pitch_to_number(Pitch p, EDOMap T) {
     return T.m0 * p.w + T.m1 * p.h;
 }
 
+/**
+ * Writes the pitch_to_number value of every Pitch in arr to out, 8 at a time
+ * when compiled with AVX2.
+ */
+void pitches_to_numbers(const Pitch arr[], int len, EDOMap T, int out[]);
+
+/**
+ * The inverse of pitch_to_number: returns the Pitch an EDOSpeller spells a
+ * pitch number as, in constant time.
+ */
+static inline Pitch pitch_from_number(int n, const EDOSpeller *s) {
+    // in long long, since edo - 1 - n overflows an int for n near INT_MIN
+    long long octaves = n >= 0 ? n / s->edo : -((s->edo - 1LL - n) / s->edo);
+    Pitch p = s->spellings[n - octaves * s->edo];
+    return (Pitch){.w = (int)(p.w + 5 * octaves),
+                   .h = (int)(p.h + 2 * octaves)};
+}
+
+/**
+ * Writes the pitch_from_number spelling of every number in arr to out.
+ */
+void pitches_from_numbers(const int arr[], int len, const EDOSpeller *s,
+                          Pitch out[]);
+
 /**
  * Returns a positive value if p sounds above q.
  * Returns a negative value if p sounds below q.
@@ -244,30 +700,119 @@ static inline int pitches_compare(Pitch p, Pitch q, EDOMap T) {
     return pitch_to_number(p, T) - pitch_to_number(q, T);
 }
 
+/**
+ * Returns the integer height of a Pitch in the tuning system a HeightMap was
+ * created from (see height_map_from_tuning). Higher-sounding Pitches have
+ * larger heights.
+ */
+static inline long long pitch_height(Pitch p, HeightMap H) {
+    return H.m0 * p.w + H.m1 * p.h;
+}
+
+/**
+ * Returns a positive value if p sounds above q.
+ * Returns a negative value if p sounds below q.
+ * Pitches of equal height are ordered by diatonic steps, so C#4 comes before
+ * Db4 when the two are enharmonic. Returns 0 only if neither decides.
+ */
+static inline int pitches_compare_height(Pitch p, Pitch q, HeightMap H) {
+    long long x = pitch_height(p, H), y = pitch_height(q, H);
+    if (x != y)
+        return x > y ? 1 : -1;
+    return (p.w + p.h > q.w + q.h) - (p.w + p.h < q.w + q.h);
+}
+
+/**
+ * Writes the height of every Pitch in arr to out.
+ */
+void pitch_heights(const Pitch arr[], int len, HeightMap H, long long out[]);
+
+/**
+ * Returns the index of the highest Pitch in a passed-in array, or -1 if the
+ * array is empty. Enharmonic ties go to the Pitch with more diatonic steps,
+ * and after that to the earliest one.
+ */
+int pitch_highest_index(const Pitch arr[], int len, HeightMap H);
+
+/**
+ * Returns the index of the lowest Pitch in a passed-in array, or -1 if the
+ * array is empty. Enharmonic ties go to the Pitch with fewer diatonic steps,
+ * and after that to the earliest one.
+ */
+int pitch_lowest_index(const Pitch arr[], int len, HeightMap H);
+
+/**
+ * Sorts an array of Pitches in place from lowest to highest, in the order
+ * given by pitches_compare_height.
+ */
+void pitch_sort(Pitch arr[], int len, HeightMap H);
+
+/**
+ * Ranks an array of Pitches without moving them: out[0] is the index of the
+ * lowest Pitch, out[len - 1] the index of the highest. Pitches that compare
+ * equal keep their original order.
+ */
+void pitch_argsort(const Pitch arr[], int len, HeightMap H, int out[]);
+
 /**
  * Returns true if p is within the approximate average range of human hearing.
  * That is, roughly: between 20Hz - 20kHz
+ * To check many Pitches, create a PitchRange with pitch_range_audible once and
+ * use pitch_in_range instead.
  */
 bool pitch_audible(Pitch p, TuningMap T);
 
 /**
  * Returns the highest Pitch in a passed-in array. Uses a TuningMap to determine
  * which Pitch is higher than the others.
+ * If you're searching many arrays in the same tuning, create a HeightMap once
+ * and use pitch_highest_index instead.
  */
 Pitch pitch_highest(Pitch arr[], int len, TuningMap T);
 
 /**
  * Returns the lowest Pitch in a passed-in array. Uses a TuningMap to determine
  * which Pitch is lower than the others.
+ * If you're searching many arrays in the same tuning, create a HeightMap once
+ * and use pitch_lowest_index instead.
  */
 Pitch pitch_lowest(Pitch arr[], int len, TuningMap T);
 
 /**
  * Finds the nearest Pitch in an array to a given Pitch. Uses a TuningMap to
  * determine which Pitch is closer than the others.
+ * Ties go to the Pitch fewest diatonic steps away, then to the earliest one.
+ * If you're querying the same array many times, build a NearestIndex instead.
  */
 Pitch pitch_nearest(Pitch p, Pitch arr[], int len, TuningMap T);
 
+/**
+ * Builds a NearestIndex over an array of candidate Pitches in the tuning
+ * system defined by the passed-in TuningMap. The array isn't referenced
+ * afterwards.
+ * @param out
+ * Pointer to a NearestIndex to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if the array is empty or memory
+ * couldn't be allocated.
+ */
+int nearest_index_create(const Pitch arr[], int len, TuningMap T,
+                         NearestIndex *out);
+
+/**
+ * Frees the memory previously allocated by a NearestIndex.
+ */
+void nearest_index_destroy(NearestIndex *ix);
+
+/**
+ * Finds the candidate nearest to a given Pitch, following the same rules as
+ * pitch_nearest, in O(log n) time with no allocation.
+ * @return
+ * The position of that candidate in the array the index was built from, or -1
+ * if the index is empty (e.g. after nearest_index_destroy).
+ */
+int nearest_index_query(const NearestIndex *ix, Pitch p);
+
 /**
  * Returns a new Pitch shifted by the given interval.
  * @return
@@ -292,6 +837,34 @@ static inline Pitch pitch_invert(Pitch p, MirrorAxis a) {
     return (Pitch){.w = a.w - p.w, .h = a.h - p.h};
 }
 
+/**
+ * Rebuilds a melody from its starting Pitch and the Intervals between its
+ * notes: out[i] is start transposed by m[0] through m[i] (an inclusive prefix
+ * sum). The inverse of intervals_from_pitches.
+ *
+ * To decode one long melody on several threads, split m into chunks, sum each
+ * chunk with intervals_sum (in parallel), add the sums up in order to find
+ * each chunk's start, then decode the chunks (in parallel).
+ * @return
+ * The last Pitch written (start if len is 0), which is the start of the next
+ * chunk.
+ */
+Pitch pitches_from_intervals(Pitch start, const Interval m[], int len,
+                             Pitch out[]);
+
+/**
+ * Writes the Interval from each Pitch to the next to out: out[0] is the
+ * Interval from start to arr[0], and out[i] the Interval from arr[i - 1] to
+ * arr[i]. The inverse of pitches_from_intervals. out may be arr itself.
+ */
+void intervals_from_pitches(Pitch start, const Pitch arr[], int len,
+                            Interval out[]);
+
+/**
+ * Returns the sum of an array of Intervals.
+ */
+Interval intervals_sum(const Interval m[], int len);
+
 /**
  * Converts from (whole, half) format to (letter, accidental, octave)
  */
@@ -369,8 +942,7 @@ static inline bool intervals_equal(Interval m, Interval n) {
  * The EDO tuning system to compare enharmonicity in.
  */
 static inline bool intervals_enharmonic(Interval m, Interval n, int edo) {
-    return (interval_chroma(m) % edo + edo) % edo ==
-           (interval_chroma(n) % edo + edo) % edo;
+    return ((long long)interval_chroma(m) - interval_chroma(n)) % edo == 0;
 }
 
 /**
@@ -381,7 +953,9 @@ static inline int stepspan(Interval m) { return m.w + m.h; }
 /**
  * Get the 12-tone pitch class interval number of an Interval.
  */
-static inline int interval_pc12(Interval m) { return (2 * m.w + m.h) % 12; }
+static inline int interval_pc12(Interval m) {
+    return trunc_mod12(2 * m.w + m.h);
+}
 
 /**
  * 0 is perfect.
@@ -443,15 +1017,8 @@ static inline Interval interval_times(Interval m, int x) {
  * Reduces an interval until it is smaller than an octave
  */
 static inline Interval interval_simple(Interval m) {
-    while (m.w + m.h >= 7) {
-        m.w -= 5;
-        m.h -= 2;
-    }
-    while (m.w + m.h <= -7) {
-        m.w += 5;
-        m.h += 2;
-    }
-    return m;
+    int octaves = (m.w + m.h) / 7; // towards 0, so the sign is kept
+    return (Interval){.w = m.w - 5 * octaves, .h = m.h - 2 * octaves};
 }
 
 
@@ -482,7 +1049,7 @@ TonalContext context_from_pitch(Pitch p, enum Mode mode);
  * TonalContext, 0-indexed so the tonic is 0.
  */
 static inline enum Degree degree_number(Pitch p, TonalContext key) {
-    return (enum Degree)(((p.w + p.h - key.tonic.letter + 2) % 7 + 7) % 7);
+    return (enum Degree)floor_mod7(p.w + p.h - key.tonic.letter + 2);
 }
 
 /**
@@ -663,6 +1230,55 @@ double to_ratio(Interval m, TuningMap T);
  */
 double to_cents(Interval m, TuningMap T);
 
+/**
+ * Finds the Pitch whose frequency in the tuning system defined by the
+ * passed-in TuningMap is nearest to a given frequency. This is the inverse of
+ * to_hz.
+ *
+ * Meantone tunings place Pitches arbitrarily close together, so candidates
+ * are limited to the 17 spellings a key can use: its 7 diatonic notes plus the
+ * raised and lowered degrees of degree_alteration. When two candidates sound
+ * the same (C#/Db in 12-EDO), the spelling closer to the key's diatonic notes
+ * wins, and flats win remaining ties.
+ * @param key
+ * The TonalContext to spell in, or NULL to spell relative to C major.
+ * @param out
+ * Pointer to a Pitch to store the result.
+ * @param cents
+ * Pointer to store how far the frequency is from the Pitch in cents, positive
+ * if the frequency is sharp. May be NULL.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if hz isn't a positive, finite
+ * frequency.
+ */
+int pitch_from_hz(double hz, TuningMap T, const TonalContext *key, Pitch *out,
+                  double *cents);
+
+/**
+ * Runs pitch_from_hz over an array of frequencies, doing the per-tuning and
+ * per-key setup only once.
+ * Frequencies that aren't positive and finite (e.g. 0 for unpitched frames)
+ * are skipped, leaving out and cents untouched at that position.
+ * @param cents
+ * Array to store each deviation in cents. May be NULL.
+ * @return
+ * The number of frequencies skipped, so 0 means nothing went wrong.
+ */
+int pitches_from_hz(const double hz[], int len, TuningMap T,
+                    const TonalContext *key, Pitch out[], double cents[]);
+
+/**
+ * Renders n Intervals in k tuning systems in one call, filling the n x k
+ * matrix out in row-major order: out[i * k + j] is the size of m[i] in cents
+ * when rendered by T[j].
+ * @param ref
+ * Sizes in cents to measure each Interval against, e.g. 1200 * log2(5.0 / 4)
+ * for a major third, so out holds each tuning's deviation instead. ref[i] is
+ * subtracted along row i. Pass NULL for plain sizes.
+ */
+void cents_matrix(const Interval m[], const double ref[], int n,
+                  const TuningMap T[], int k, double out[]);
+
 /**
  * Creates a Map1D that can be used to produce a well-ordered integer numbering
  * for pitches in an EDO tuning, and to compare pitches in edosteps.
@@ -674,580 +1290,5279 @@ double to_cents(Interval m, TuningMap T);
  */
 int create_edo_map(int edo, EDOMap *out);
 
-
 /**
- * Converts from (letter, accidental, octave) format to (whole, half)
+ * Looks up an EDO in the catalog generated at build time, which holds the
+ * fifth and EDOMap of every EDO from 1 to EDO_CATALOG_MAX.
+ * create_edo_map and tuning_map_from_edo already use it, so there's no need
+ * to cache their results yourself.
+ * @return
+ * Pointer to the entry, or NULL if edo is outside the catalog.
  */
-Pitch pitch_from_standard(StandardPitch p);
+const EDOCatalogEntry *edo_catalog_lookup(int edo);
 
 /**
- * Parses Scientific Pitch Notation to generate a pitch.
+ * Creates an EDOSpeller, a lookup table for spelling the pitch numbers of
+ * pitch_to_number in a given EDO as Pitches in a given TonalContext.
+ * Each step gets the spelling closest to the key's diatonic notes, in the
+ * same order of preference pitch_from_hz uses.
  * @param out
- * Pointer to a Pitch to store the parsed vector.
+ * Pointer to an EDOSpeller to store the result.
  * @return
- * 0 means nothing went wrong.
+ * 0 means nothing went wrong. Returns 1 if create_edo_map would reject the
+ * edo, if the edo has steps that no Pitch can name (its fifth shares a factor
+ * with it, e.g. 35), or if memory couldn't be allocated.
  */
-int pitch_from_spn(const char *s, Pitch *out);
+int edo_speller_create(int edo, TonalContext key, EDOSpeller *out);
 
 /**
- * Parses a LilyPond pitch name to generate a pitch.
- * @param out
- * Pointer to a Pitch to store the parsed vector.
- * @return
- * 0 means nothing went wrong.
+ * Frees the memory previously allocated by an EDOSpeller.
  */
-int pitch_from_lily(const char *s, Pitch *out);
+void edo_speller_destroy(EDOSpeller *s);
 
-typedef struct LilyParseContext {
-    Pitch previous;
-} LilyParseContext;
+/**
+ * Creates a HeightMap that orders Pitch vectors by how high they sound in the
+ * tuning system defined by the passed-in TuningMap, using integer arithmetic
+ * only. Build it once and reuse it for every comparison.
+ *
+ * If the TuningMap's fifth is (to within 0.0001¢) the fifth of an EDO of up to
+ * 1200 notes, heights are exact step numbers in the smallest such EDO, so
+ * Pitches that are enharmonic in that EDO get equal heights. Otherwise heights
+ * are fixed-point cents with a resolution of 2^-20¢.
+ */
+HeightMap height_map_from_tuning(TuningMap T);
 
-LilyParseContext lily_parse_context_init(Pitch p);
 
-int pitch_from_relative_lily(
-    LilyParseContext *ctx,
-    const char *s,
-    Pitch *out
-);
 
 /**
- * Parses a Helmholtz pitch name to generate a pitch.
+ * Creates a KeyboardLayout from a Map2D taking Pitch vectors to screen
+ * coordinates, and the screen position of one anchor Pitch. For a
+ * Wicki-Hayden layout, compose the geometry you want to draw its lattice with
+ * onto WICKI_TO using map_compose_2d_2d.
  * @param out
- * Pointer to a Pitch to store the parsed vector.
+ * Pointer to a KeyboardLayout to store the result.
  * @return
- * 0 means nothing went wrong.
+ * 0 means nothing went wrong. Returns 1 if the Map2D can't be inverted, so
+ * distinct Pitches would share a key.
  */
-int pitch_from_helmholtz(const char *s, Pitch *out);
+int keyboard_layout_create(Map2D layout, Pitch anchor, MapVec anchor_pos,
+                           KeyboardLayout *out);
 
 /**
- * Parses an ABC note name to generate a pitch.
+ * Returns the screen position of the centre of a Pitch's key.
+ */
+static inline MapVec keyboard_key_center(const KeyboardLayout *L, Pitch p) {
+    MapVec v = map_to_2d((MapVec){p.w - L->anchor.w, p.h - L->anchor.h},
+                         L->to_screen);
+    return (MapVec){L->anchor_pos.x + v.x, L->anchor_pos.y + v.y};
+}
+
+/**
+ * Writes the screen position of the centre of each Pitch's key to x and y.
+ */
+void keyboard_key_centers(const KeyboardLayout *L, const Pitch p[], int len,
+                          double x[], double y[]);
+
+/**
+ * Writes the 4 corners of each Pitch's key to x and y, so x and y must each
+ * hold 4 * len values. The corners of p[i] are at 4 * i to 4 * i + 3, going
+ * around the key.
+ */
+void keyboard_key_vertices(const KeyboardLayout *L, const Pitch p[], int len,
+                           double x[], double y[]);
+
+/**
+ * Returns the Pitch whose key contains a screen position, in constant time.
+ * Keys tile the whole plane, so every position hits some key.
+ */
+Pitch keyboard_hit_test(const KeyboardLayout *L, double x, double y);
+
+/**
+ * Runs keyboard_hit_test over arrays of screen positions, e.g. every touch
+ * point in a frame.
+ */
+void keyboard_hit_test_batch(const KeyboardLayout *L, const double x[],
+                             const double y[], int len, Pitch out[]);
+
+/**
+ * Lists the Pitches whose key centres lie within a screen rectangle, row by
+ * row. At most cap Pitches are written to out.
+ * @return
+ * The number of Pitches in the rectangle, which may be more than cap.
+ */
+int keyboard_visible_keys(const KeyboardLayout *L, double x0, double y0,
+                          double x1, double y1, Pitch out[], int cap);
+
+
+
+/**
+ * Finds the fifth size that best fits a collection of Intervals to target
+ * sizes, e.g. their just ratios in cents. Pass the result to
+ * tuning_map_from_fifth. Only fifths that tuning_map_from_fifth accepts are
+ * considered.
+ * @param just
+ * The target size of each Interval in cents, e.g. 1200 * log2(5.0 / 4).
+ * @param weight
+ * How often each Interval is used (non-negative), or NULL to weight them
+ * equally. Under MINIMAX, only whether an Interval is used at all matters.
  * @param out
- * Pointer to a Pitch to store the parsed vector.
+ * Pointer to store the best fifth in cents.
+ * @param error
+ * Pointer to store the error of the best fifth in cents, under the chosen
+ * criterion. May be NULL.
  * @return
- * 0 means nothing went wrong.
+ * 0 means nothing went wrong. Returns 1 if no used Interval depends on the
+ * size of the fifth (e.g. only octaves are used), so every fifth fits equally
+ * well.
  */
-int pitch_from_abc(const char *s, Pitch *out);
+int optimal_fifth(const Interval m[], const double just[],
+                  const double weight[], int len, enum FitCriterion criterion,
+                  double *out, double *error);
+
+/**
+ * Finds the EDO between min_edo and max_edo (inclusive) that best fits a
+ * collection of Intervals to target sizes, under the same rules as
+ * optimal_fifth. EDOs that create_edo_map rejects are skipped, and ties go to
+ * the smaller EDO.
+ *
+ * When the library is built with MEANTONAL_THREADS (see parallel.h), long
+ * scans are split over several threads.
+ * @param out
+ * Pointer to store the best EDO.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if no used Interval depends on the
+ * size of the fifth, or there's no usable EDO in the range.
+ */
+int optimal_edo(const Interval m[], const double just[], const double weight[],
+                int len, int min_edo, int max_edo, enum FitCriterion criterion,
+                int *out, double *error);
+
+
+
+/**
+ * Creates an AdaptiveTuner that retunes chords played in the tuning system
+ * defined by the passed-in TuningMap.
+ *
+ * Intervals are made just in 5-limit terms: every interval is read as a number
+ * of pure fifths and pure major thirds (so a minor third is 6/5 and an
+ * augmented fourth 45/32), with octaves left as they are.
+ * @param max_drift
+ * How far in cents the average offset of a chord may wander from the base
+ * tuning as common tones are held over comma pumps. 0 keeps every chord
+ * centred on the base tuning.
+ * @param out
+ * Pointer to an AdaptiveTuner to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if max_drift is negative or not
+ * finite.
+ */
+int adaptive_tuner_create(TuningMap T, double max_drift, AdaptiveTuner *out);
+
+/**
+ * Forgets the current chord and any drift, as if the tuner were newly
+ * created.
+ */
+void adaptive_tuner_reset(AdaptiveTuner *t);
+
+/**
+ * Moves the tuner on to the next chord, writing the cent offset from the base
+ * tuning of each of its Pitches to out.
+ *
+ * Offsets make every interval in the chord as close to just as possible (in
+ * the least-squares sense). The chord as a whole is then shifted so held-over
+ * common tones stay where they were, as far as max_drift allows. Each call
+ * costs at most a few hundred operations and allocates nothing.
+ * @param len
+ * The number of Pitches in chord, at most ADAPTIVE_MAX_VOICES. 0 means
+ * silence: the drift is kept, but there are no common tones to hold.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if len is out of range, leaving the
+ * tuner untouched.
+ */
+int adaptive_tuner_update(AdaptiveTuner *t, const Pitch chord[], int len,
+                          double out[]);
+
+
+
+/**
+ * Creates an OscBank of silent voices (phase increment 0) rendering Pitches in
+ * the tuning system defined by the passed-in TuningMap.
+ * @param out
+ * Pointer to an OscBank to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if voices isn't positive, sample_rate
+ * isn't positive and finite, or memory couldn't be allocated.
+ */
+int osc_bank_create(TuningMap T, double sample_rate, int voices, OscBank *out);
+
+/**
+ * Frees the memory previously allocated by an OscBank.
+ */
+void osc_bank_destroy(OscBank *b);
+
+/**
+ * Moves a voice straight to a Pitch, cancelling any glide in progress.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if voice is out of range.
+ */
+int osc_bank_set(OscBank *b, int voice, Pitch p);
+
+/**
+ * Glides a voice exponentially (linearly in cents) from where it is now to a
+ * Pitch, arriving exactly on the Pitch's frequency after the given number of
+ * samples. A silent voice, or a glide of 0 samples, jumps straight there.
+ * Call osc_bank_set first to glide from a particular Pitch.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if voice is out of range.
+ */
+int osc_bank_glide(OscBank *b, int voice, Pitch p, int samples);
+
+/**
+ * Renders the next block of phase increments for every voice.
+ * Gliding costs one multiply per voice per sample: frequencies are only
+ * computed when a voice is set or starts a glide.
+ * @param out
+ * Buffer of frames * b->len increments, interleaved by frame like multichannel
+ * audio: out[i * b->len + v] is voice v's increment at sample i.
+ */
+void osc_bank_render(OscBank *b, int frames, double out[]);
+
+
+
+/**
+ * Creates a TuningMorph of silent voices that moves from one tuning system to
+ * another over the given number of blocks. Frequencies move linearly in cents,
+ * which (cents being linear in the size of the fifth) is the same as sweeping
+ * the fifth, reference frequency and all, at a steady rate.
+ * @param blocks
+ * Length of the morph. 0 means every voice sounds in the target tuning
+ * straight away.
+ * @param out
+ * Pointer to a TuningMorph to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if blocks is negative, voices isn't
+ * positive, or memory couldn't be allocated.
+ */
+int tuning_morph_create(TuningMap from, TuningMap to, int blocks, int voices,
+                        TuningMorph *out);
+
+/**
+ * Frees the memory previously allocated by a TuningMorph.
+ */
+void tuning_morph_destroy(TuningMorph *m);
+
+/**
+ * Starts a voice sounding a Pitch, at its frequency for the morph's current
+ * position. This is the only place frequencies are computed.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if voice is out of range.
+ */
+int tuning_morph_voice_on(TuningMorph *m, int voice, Pitch p);
+
+/**
+ * Silences a voice.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if voice is out of range.
+ */
+int tuning_morph_voice_off(TuningMorph *m, int voice);
+
+/**
+ * Moves the morph on by one block and writes every voice's new frequency to
+ * hz (0 for silent voices). Costs one multiply per voice with no libm calls.
+ * On the final block voices land exactly on their target tuning, and stay
+ * there.
+ */
+void tuning_morph_advance(TuningMorph *m, double hz[]);
+
+
+
+/**
+ * Creates a WAV file and writes its header, ready for wav_writer_write.
+ * @param out
+ * Pointer to a WavWriter to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if channels or sample_rate isn't
+ * positive, or the file couldn't be written.
+ */
+int wav_writer_open(const char *path, int channels, int sample_rate,
+                    WavWriter *out);
+
+/**
+ * Appends frames of audio to a WAV file. Samples are interleaved by frame,
+ * run from -1 to 1, and are clipped outside that range. NaN is written as 0.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if the file couldn't be written.
+ */
+int wav_writer_write(WavWriter *w, const float samples[], long frames);
+
+/**
+ * Fills in the WAV header's lengths and closes the file.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if the file couldn't be written.
+ */
+int wav_writer_close(WavWriter *w);
+
+/**
+ * Reads a WAV file into an AudioBuffer, mixing all channels down to mono.
+ * Reads 8, 16, 24 and 32-bit PCM, and 32 and 64-bit floating point.
+ * @param out
+ * Pointer to an AudioBuffer to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if the file couldn't be read, isn't a
+ * WAV file in one of those formats, or memory couldn't be allocated.
+ */
+int wav_read(const char *path, AudioBuffer *out);
+
+/**
+ * Frees the memory previously allocated by an AudioBuffer.
+ */
+void audio_buffer_destroy(AudioBuffer *a);
+
+
+
+/**
+ * Fills a wavetable with one cycle of an additive waveform.
+ * @param amps
+ * Amplitude of each harmonic, starting from the fundamental. {1} gives a sine
+ * wave.
+ */
+void wavetable_harmonics(float table[], int len, const double amps[],
+                         int harmonics);
+
+/**
+ * Creates a NoteRenderer for a list of NoteEvents in the tuning system defined
+ * by the passed-in TuningMap. Every note's frequency is computed here, once;
+ * neither the notes nor the table are referenced afterwards.
+ * Notes get a 5ms linear fade in and out so they start and stop cleanly.
+ * @param table
+ * One cycle of the waveform to play, e.g. from wavetable_harmonics.
+ * @param table_len
+ * Length of table, which must be a power of two.
+ * @param out
+ * Pointer to a NoteRenderer to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if sample_rate isn't positive,
+ * table_len isn't a power of two, or memory couldn't be allocated.
+ */
+int note_renderer_create(const NoteEvent notes[], int len, TuningMap T,
+                         int sample_rate, const float table[], int table_len,
+                         NoteRenderer *out);
+
+/**
+ * Frees the memory previously allocated by a NoteRenderer.
+ */
+void note_renderer_destroy(NoteRenderer *r);
+
+/**
+ * Returns the length in samples of the whole render: up to the end of the
+ * last note to finish.
+ */
+long note_renderer_frames(const NoteRenderer *r);
+
+/**
+ * Renders frames samples starting at sample start into out (mono).
+ * Every sample depends only on its position, so any range can be rendered
+ * independently of the rest and comes out the same however the file is split
+ * up; ranges can also be rendered on separate threads, sharing one
+ * NoteRenderer. When the library is built with MEANTONAL_THREADS (see
+ * parallel.h), long ranges are split over several threads here.
+ */
+void note_renderer_render(const NoteRenderer *r, long start, long frames,
+                          float out[]);
+
+/**
+ * Renders everything to a mono 16-bit WAV file, a block at a time.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if the file couldn't be written.
+ */
+int note_renderer_write_wav(const NoteRenderer *r, const char *path);
+
+
+
+/**
+ * Creates a ZoneMap from an array of sample roots in the tuning system defined
+ * by the passed-in TuningMap. Every Pitch p with lo.w <= p.w <= hi.w and
+ * lo.h <= p.h <= hi.h is assigned the root pitch_nearest would choose, so e.g.
+ * lo = {0, 0} (C-1) and hi = {60, 25} covers every note a piano plays with
+ * anything up to double sharps and flats.
+ * @param out
+ * Pointer to a ZoneMap to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if there are no roots, the window is
+ * empty, or memory couldn't be allocated.
+ */
+int zone_map_create(const Pitch roots[], int len, TuningMap T, Pitch lo,
+                    Pitch hi, ZoneMap *out);
+
+/**
+ * Frees the memory previously allocated by a ZoneMap.
+ */
+void zone_map_destroy(ZoneMap *z);
+
+/**
+ * Looks up the sample root to play a Pitch from, with a single table lookup.
+ * @param ratio
+ * Pointer to store the playback ratio (the Pitch's frequency over the root's).
+ * May be NULL.
+ * @return
+ * The index of the root in the array the ZoneMap was built from, or -1 if p is
+ * outside the window.
+ */
+static inline int zone_map_lookup(const ZoneMap *z, Pitch p, double *ratio) {
+    unsigned w = p.w - z->lo.w, h = p.h - z->lo.h;
+    if (w >= (unsigned)z->width || h >= (unsigned)z->height)
+        return -1;
+    long i = (long)w * z->height + h;
+    if (ratio)
+        *ratio = z->ratio[i];
+    return z->root[i];
+}
+
+
+
+/**
+ * Creates an FFTPlan for transforms of length n.
+ * @param out
+ * Pointer to an FFTPlan to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if n isn't a power of two, or memory
+ * couldn't be allocated.
+ */
+int fft_plan_create(int n, FFTPlan *out);
+
+/**
+ * Frees the memory previously allocated by an FFTPlan.
+ */
+void fft_plan_destroy(FFTPlan *p);
+
+/**
+ * Transforms a complex signal of p->n samples, stored as separate real and
+ * imaginary arrays, into its spectrum in place:
+ * X[k] = sum of x[j] * e^(-2 pi i j k / n).
+ */
+void fft_forward(const FFTPlan *p, double re[], double im[]);
+
+/**
+ * The inverse of fft_forward, including the 1 / n scaling, in place.
+ */
+void fft_inverse(const FFTPlan *p, double re[], double im[]);
+
+
+
+/**
+ * Creates a PitchTracker for audio at the given sample rate.
+ * @param window
+ * Frame length in samples, a power of two. The lowest frequency that can be
+ * tracked is 2 * sample_rate / window, e.g. 43Hz for 2048 at 44.1kHz.
+ * @param hop
+ * Samples between the starts of consecutive frames.
+ * @param threshold
+ * How aperiodic a frame may be and still count as voiced, from 0 to 1. 0.1 to
+ * 0.15 suits most monophonic recordings.
+ * @param out
+ * Pointer to a PitchTracker to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if sample_rate or hop isn't positive,
+ * window isn't a power of two of at least 8, or memory couldn't be allocated.
+ */
+int pitch_tracker_create(int sample_rate, int window, int hop,
+                         double threshold, PitchTracker *out);
+
+/**
+ * Frees the memory previously allocated by a PitchTracker.
+ */
+void pitch_tracker_destroy(PitchTracker *t);
+
+/**
+ * Estimates the fundamental frequency of one frame of t->window samples.
+ * @return
+ * The frequency in Hz, or 0 if the frame is silent or unpitched.
+ */
+double pitch_tracker_frame(PitchTracker *t, const float frame[]);
+
+/**
+ * Returns the number of frames pitch_tracker_run finds in len samples.
+ */
+long pitch_tracker_frames(const PitchTracker *t, long len);
+
+/**
+ * Tracks a whole signal, writing the frequency of every frame to hz (0 where
+ * unpitched). Frame i starts at sample i * t->hop.
+ * If T is non-NULL, every pitched frame is also quantized to a spelled Pitch in
+ * out, as by pitches_from_hz, spelled in key (or C major if key is NULL).
+ * Unpitched frames leave out untouched.
+ * @return
+ * The number of frames written.
+ */
+long pitch_tracker_run(PitchTracker *t, const float samples[], long len,
+                       double hz[], const TuningMap *T,
+                       const TonalContext *key, Pitch out[]);
+
+
+
+/**
+ * Creates a Chromagram for audio at the given sample rate, with one class for
+ * every chroma from chroma_min to chroma_max. Each FFT bin between min_hz and
+ * max_hz is assigned once, here, to the class whose pitch class in the tuning
+ * system defined by the passed-in TuningMap is nearest to it. Bins equally near
+ * two classes (e.g. C# and Db in 12-EDO) go to the class with the smaller
+ * |chroma|, and then to the flatter one.
+ * @param window
+ * Frame length in samples, a power of two.
+ * @param hop
+ * Samples between the starts of consecutive frames.
+ * @param out
+ * Pointer to a Chromagram to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if sample_rate or hop isn't positive,
+ * window isn't a power of two, chroma_max < chroma_min, the frequency range is
+ * empty, or memory couldn't be allocated.
+ */
+int chromagram_create(TuningMap T, int sample_rate, int window, int hop,
+                      int chroma_min, int chroma_max, double min_hz,
+                      double max_hz, Chromagram *out);
+
+/**
+ * Frees the memory previously allocated by a Chromagram.
+ */
+void chromagram_destroy(Chromagram *c);
+
+/**
+ * Measures one frame of c->window samples, writing the spectral energy of each
+ * chroma class to out, so out[i] is the energy of chroma c->chroma_min + i.
+ */
+void chromagram_frame(Chromagram *c, const float frame[], double out[]);
+
+/**
+ * Returns the number of frames chromagram_run finds in len samples.
+ */
+long chromagram_frames(const Chromagram *c, long len);
+
+/**
+ * Measures every frame of a signal, writing c->classes values per frame to out
+ * in row-major order. Frame i starts at sample i * c->hop.
+ *
+ * A Chromagram's workspace belongs to one thread at a time. When the library
+ * is built with MEANTONAL_THREADS (see parallel.h), long recordings are split
+ * over several threads here, each with its own workspace; otherwise, give
+ * each thread its own Chromagram and pass it samples + first * c->hop to
+ * start at frame first.
+ * @return
+ * The number of frames written.
+ */
+long chromagram_run(Chromagram *c, const float samples[], long len,
+                    double out[]);
+
+
+
+/**
+ * Creates an empty PitchBuffer with room for capacity Pitches.
+ * @param out
+ * Pointer to a PitchBuffer to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if capacity is negative or memory
+ * couldn't be allocated.
+ */
+int pitch_buffer_create(int capacity, PitchBuffer *out);
+
+/**
+ * Frees the memory previously allocated by a PitchBuffer.
+ */
+void pitch_buffer_destroy(PitchBuffer *b);
+
+/**
+ * Replaces the contents of a PitchBuffer with an array of Pitches.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if len is negative or more than the
+ * buffer's capacity.
+ */
+int pitch_buffer_from_pitches(PitchBuffer *b, const Pitch arr[], int len);
+
+/**
+ * Copies the contents of a PitchBuffer out to an array of b->len Pitches.
+ */
+void pitch_buffer_to_pitches(const PitchBuffer *b, Pitch out[]);
+
+/**
+ * Shifts every Pitch in the buffer by an Interval, as transpose_real does.
+ */
+void pitch_buffer_transpose(PitchBuffer *b, Interval m);
+
+/**
+ * Inverts every Pitch in the buffer about a MirrorAxis, as pitch_invert does.
+ */
+void pitch_buffer_invert(PitchBuffer *b, MirrorAxis a);
+
+/**
+ * Finds the Interval from each Pitch in p to the Pitch at the same position in
+ * q, as interval_between does, storing them in out.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if p and q have different lengths or
+ * out doesn't have room for them.
+ */
+int pitch_buffer_intervals(const PitchBuffer *p, const PitchBuffer *q,
+                           PitchBuffer *out);
+
+/**
+ * Writes the pitch_chroma of every Pitch in the buffer to out.
+ */
+void pitch_buffer_chromas(const PitchBuffer *b, int out[]);
+
+/**
+ * Writes the pitch_midi of every Pitch in the buffer to out.
+ */
+void pitch_buffer_midis(const PitchBuffer *b, int out[]);
+
+/**
+ * Writes the pitch_letter of every Pitch in the buffer to out.
+ */
+void pitch_buffer_letters(const PitchBuffer *b, int out[]);
+
+/**
+ * Writes the pitch_accidental of every Pitch in the buffer to out.
+ */
+void pitch_buffer_accidentals(const PitchBuffer *b, int out[]);
+
+/**
+ * Writes the pitch_octave of every Pitch in the buffer to out.
+ */
+void pitch_buffer_octaves(const PitchBuffer *b, int out[]);
+
+/**
+ * Writes the pitch_to_standard of every Pitch in the buffer to out.
+ */
+void pitch_buffer_to_standard(const PitchBuffer *b, StandardPitch out[]);
+
+/**
+ * Writes the pitch_pc12 of every Pitch in the buffer to out.
+ */
+void pitch_buffer_pc12s(const PitchBuffer *b, int out[]);
+
+/**
+ * Writes the degree_number of every Pitch in the buffer in a given
+ * TonalContext to out.
+ */
+void pitch_buffer_degrees(const PitchBuffer *b, TonalContext key, int out[]);
+
+/**
+ * Checks each pair of Pitches at the same position in p and q with
+ * pitches_enharmonic, writing the results to out. The edo is only divided by
+ * once, however long the buffers are.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if the buffers differ in length or edo
+ * isn't positive.
+ */
+int pitch_buffer_enharmonic(const PitchBuffer *p, const PitchBuffer *q,
+                            int edo, bool out[]);
+
+/**
+ * Turns a buffer of Intervals into the melody they step through from start,
+ * in place, as pitches_from_intervals does. When the library is built with
+ * MEANTONAL_THREADS (see parallel.h), long buffers are split over several
+ * threads, with the same result.
+ * @return
+ * The last Pitch of the melody (start if the buffer is empty), which is the
+ * start of the next chunk.
+ */
+Pitch pitch_buffer_scan(PitchBuffer *b, Pitch start);
+
+/**
+ * Turns a buffer of Pitches into the Intervals between them, in place, as
+ * intervals_from_pitches does. The inverse of pitch_buffer_scan. Long buffers
+ * are split over threads as pitch_buffer_scan does.
+ */
+void pitch_buffer_differences(PitchBuffer *b, Pitch start);
+
+/**
+ * Returns the sum of a buffer of Intervals.
+ */
+Interval pitch_buffer_sum(const PitchBuffer *b);
+
+/**
+ * Checks every Pitch in the buffer with pitch_in_range, writing the results to
+ * out.
+ * @return
+ * The number of Pitches in range.
+ */
+int pitch_buffer_in_range(const PitchBuffer *b, PitchRange r, bool out[]);
+
+/**
+ * Removes the Pitches outside a PitchRange from the buffer, keeping the rest
+ * in order.
+ * @return
+ * The number of Pitches kept, which is also the buffer's new len.
+ */
+int pitch_buffer_filter_range(PitchBuffer *b, PitchRange r);
+
+
+
+// Pitch16 arithmetic works on both 16-bit lanes of the uint32_t at once (SIMD
+// within a register): the top bit of each lane is masked off so carries can't
+// cross into the next lane, and then patched back in with an XOR. Like int16_t
+// arithmetic, results that don't fit in a lane wrap around.
+
+/**
+ * Packs a Pitch into a Pitch16.
+ * @param out
+ * Pointer to a Pitch16 to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if w or h is outside -32768 to 32767.
+ */
+static inline int pitch16_from_pitch(Pitch p, Pitch16 *out) {
+    if (p.w < -32768 || p.w > 32767 || p.h < -32768 || p.h > 32767)
+        return 1;
+    *out = (uint32_t)(p.w & 0xffff) | (uint32_t)(p.h & 0xffff) << 16;
+    return 0;
+}
+
+/**
+ * Returns the whole steps of a Pitch16.
+ */
+static inline int pitch16_w(Pitch16 p) {
+    return (int)(p & 0xffff) - (int)(p << 1 & 0x10000);
+}
+
+/**
+ * Returns the half steps of a Pitch16.
+ */
+static inline int pitch16_h(Pitch16 p) {
+    return (int)(p >> 16) - (int)(p >> 15 & 0x10000);
+}
+
+/**
+ * Unpacks a Pitch16 back into a Pitch.
+ */
+static inline Pitch pitch16_to_pitch(Pitch16 p) {
+    return (Pitch){.w = pitch16_w(p), .h = pitch16_h(p)};
+}
+
+/**
+ * Returns a Pitch16 shifted by the given packed Interval, like transpose_real.
+ */
+static inline Pitch16 pitch16_transpose(Pitch16 p, Pitch16 m) {
+    const uint32_t sign = 0x80008000u;
+    return ((p & ~sign) + (m & ~sign)) ^ ((p ^ m) & sign);
+}
+
+/**
+ * Returns the packed Interval from p to q, like interval_between.
+ */
+static inline Pitch16 pitch16_interval(Pitch16 p, Pitch16 q) {
+    const uint32_t sign = 0x80008000u;
+    return ((q | sign) - (p & ~sign)) ^ ((q ^ ~p) & sign);
+}
+
+/**
+ * Inverts a Pitch16 about a packed MirrorAxis, like pitch_invert.
+ */
+static inline Pitch16 pitch16_invert(Pitch16 p, Pitch16 axis) {
+    return pitch16_interval(p, axis);
+}
+
+/**
+ * Returns the pitch_chroma of a Pitch16.
+ */
+static inline int pitch16_chroma(Pitch16 p) {
+    return 2 * pitch16_w(p) - 5 * pitch16_h(p);
+}
+
+/**
+ * Returns the pitch_letter of a Pitch16.
+ */
+static inline int pitch16_letter(Pitch16 p) {
+    return floor_mod7(pitch16_w(p) + pitch16_h(p) + 2);
+}
+
+/**
+ * Returns the pitch_accidental of a Pitch16.
+ */
+static inline int pitch16_accidental(Pitch16 p) {
+    return floor_div7(pitch16_chroma(p) + 1);
+}
+
+/**
+ * Returns the pitch_octave of a Pitch16.
+ */
+static inline int pitch16_octave(Pitch16 p) {
+    return floor_div7(pitch16_w(p) + pitch16_h(p)) - 1;
+}
+
+/**
+ * Returns the pitch_midi of a Pitch16.
+ */
+static inline int pitch16_midi(Pitch16 p) {
+    return 2 * pitch16_w(p) + pitch16_h(p);
+}
+
+/**
+ * Packs every Pitch in arr into out with pitch16_from_pitch.
+ * Pitches that don't fit are skipped, leaving out untouched at that position.
+ * @return
+ * The number of Pitches skipped, so 0 means nothing went wrong.
+ */
+int pitches_to_pitch16(const Pitch arr[], int len, Pitch16 out[]);
+
+/**
+ * Unpacks every Pitch16 in arr into out.
+ */
+void pitches_from_pitch16(const Pitch16 arr[], int len, Pitch out[]);
+
+/**
+ * Transposes every Pitch16 in arr in place by the packed Interval m.
+ */
+void pitches16_transpose(Pitch16 arr[], int len, Pitch16 m);
+
+/**
+ * Writes the packed Interval from p[i] to q[i] to out[i] for every i.
+ */
+void pitches16_intervals(const Pitch16 p[], const Pitch16 q[], int len,
+                         Pitch16 out[]);
+
+/**
+ * Writes the pitch_to_standard of every Pitch16 in arr to out.
+ */
+void pitches16_to_standard(const Pitch16 arr[], int len, StandardPitch out[]);
+
+/**
+ * Fills a PitchBuffer with unpacked Pitch16s, replacing its contents.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if len is negative or more than the
+ * buffer's capacity.
+ */
+int pitch_buffer_from_pitch16(PitchBuffer *b, const Pitch16 arr[], int len);
+
+/**
+ * Packs the Pitches in a PitchBuffer into out, skipping any that don't fit as
+ * pitches_to_pitch16 does.
+ * @return
+ * The number of Pitches skipped, so 0 means nothing went wrong.
+ */
+int pitch_buffer_to_pitch16(const PitchBuffer *b, Pitch16 out[]);
+
+
+
+// The core Pitch and Interval functions of pitch.h and interval.h, generated
+// for PitchI16, PitchI32 and PitchI64 from one definition. Each width gets the
+// same functions as the int versions, prefixed i16_, i32_ or i64_ and taking
+// and returning its own type (which also serves as its Interval type):
+//
+//   pitch_chroma, pitch_letter, pitch_accidental, pitch_octave, pitch_midi,
+//   pitch_pc12, steps_between, pitches_equal, pitches_enharmonic,
+//   pitch_height, transpose_real, axis_create, pitch_invert,
+//   interval_between, interval_chroma, intervals_equal,
+//   intervals_enharmonic, stepspan, interval_negate, intervals_add,
+//   intervals_subtract, interval_times, interval_simple
+//
+// e.g. i64_pitch_octave(PitchI64 p). Classifiers compute in int for i16 and
+// in long long for i32 and i64, so they are exact for every i16 and i32 Pitch,
+// and for i64 Pitches whose w and h are within 2^60 of 0. Vector arithmetic
+// is done in the width's unsigned type, so results that don't fit the width
+// wrap (converting back to the signed type is implementation-defined, and
+// wraps on every two's complement compiler) rather than overflow.
+//
+// Every width also gets the same batch API, declared below.
+
+#define MEANTONAL_WIDTH_INLINE(P, T, U, W, pre, DIV7, MOD7, MOD12)             \
+    static inline W pre##_pitch_chroma(P p) {                                  \
+        return 2 * (W)p.w - 5 * (W)p.h;                                        \
+    }                                                                          \
+    static inline int pre##_pitch_letter(P p) {                                \
+        return (int)MOD7((W)p.w + p.h + 2);                                    \
+    }                                                                          \
+    static inline W pre##_pitch_accidental(P p) {                              \
+        return DIV7(pre##_pitch_chroma(p) + 1);                                \
+    }                                                                          \
+    static inline W pre##_pitch_octave(P p) { return DIV7((W)p.w + p.h) - 1; } \
+    static inline W pre##_pitch_midi(P p) { return 2 * (W)p.w + p.h; }         \
+    static inline int pre##_pitch_pc12(P p) {                                  \
+        return (int)MOD12(pre##_pitch_midi(p));                                \
+    }                                                                          \
+    static inline W pre##_steps_between(P p, P q) {                            \
+        return ((W)q.w + q.h) - ((W)p.w + p.h);                                \
+    }                                                                          \
+    static inline bool pre##_pitches_equal(P p, P q) {                         \
+        return p.w == q.w && p.h == q.h;                                       \
+    }                                                                          \
+    static inline bool pre##_pitches_enharmonic(P m, P n, int edo) {           \
+        return (pre##_pitch_chroma(m) - pre##_pitch_chroma(n)) % edo == 0;     \
+    }                                                                          \
+    static inline long long pre##_pitch_height(P p, HeightMap H) {             \
+        return H.m0 * p.w + H.m1 * p.h;                                        \
+    }                                                                          \
+    static inline P pre##_transpose_real(P p, P m) {                           \
+        return (P){.w = (T)((U)p.w + (U)m.w), .h = (T)((U)p.h + (U)m.h)};      \
+    }                                                                          \
+    static inline P pre##_axis_create(P p, P q) {                              \
+        return (P){.w = (T)((U)p.w + (U)q.w), .h = (T)((U)p.h + (U)q.h)};      \
+    }                                                                          \
+    static inline P pre##_pitch_invert(P p, P a) {                             \
+        return (P){.w = (T)((U)a.w - (U)p.w), .h = (T)((U)a.h - (U)p.h)};      \
+    }                                                                          \
+    static inline P pre##_interval_between(P p, P q) {                         \
+        return (P){.w = (T)((U)q.w - (U)p.w), .h = (T)((U)q.h - (U)p.h)};      \
+    }                                                                          \
+    static inline W pre##_interval_chroma(P m) {                               \
+        return pre##_pitch_chroma(m);                                          \
+    }                                                                          \
+    static inline bool pre##_intervals_equal(P m, P n) {                       \
+        return pre##_pitches_equal(m, n);                                      \
+    }                                                                          \
+    static inline bool pre##_intervals_enharmonic(P m, P n, int edo) {         \
+        return pre##_pitches_enharmonic(m, n, edo);                            \
+    }                                                                          \
+    static inline W pre##_stepspan(P m) { return (W)m.w + m.h; }               \
+    static inline P pre##_interval_negate(P m) {                               \
+        return (P){.w = (T)(0 - (U)m.w), .h = (T)(0 - (U)m.h)};                \
+    }                                                                          \
+    static inline P pre##_intervals_add(P m, P n) {                            \
+        return pre##_transpose_real(m, n);                                     \
+    }                                                                          \
+    static inline P pre##_intervals_subtract(P m, P n) {                       \
+        return pre##_interval_between(n, m);                                   \
+    }                                                                          \
+    static inline P pre##_interval_times(P m, T x) {                           \
+        return (P){.w = (T)((U)m.w * (U)x), .h = (T)((U)m.h * (U)x)};          \
+    }                                                                          \
+    static inline P pre##_interval_simple(P m) {                               \
+        U octaves = (U)(pre##_stepspan(m) / 7);                                \
+        return (P){.w = (T)((U)m.w - 5 * octaves),                             \
+                   .h = (T)((U)m.h - 2 * octaves)};                            \
+    }
+
+MEANTONAL_WIDTH_INLINE(PitchI16, int16_t, unsigned, int, i16, floor_div7,
+                       floor_mod7, trunc_mod12)
+MEANTONAL_WIDTH_INLINE(PitchI32, int32_t, uint32_t, long long, i32,
+                       floor_div7_ll, floor_mod7_ll, trunc_mod12_ll)
+MEANTONAL_WIDTH_INLINE(PitchI64, int64_t, uint64_t, long long, i64,
+                       floor_div7_ll, floor_mod7_ll, trunc_mod12_ll)
+
+// The batch API of each width:
+//
+// int <pre>_pitches_from_pitches(const Pitch arr[], int len, P out[])
+//   Converts Pitches to the width. Pitches that don't fit are skipped, leaving
+//   out untouched at that position. Returns the number skipped.
+// int <pre>_pitches_to_pitches(const P arr[], int len, Pitch out[])
+//   The reverse, skipping any that don't fit in an int.
+// void <pre>_pitches_transpose(P arr[], int len, P m)
+//   Transposes every Pitch in place.
+// void <pre>_pitches_intervals(const P p[], const P q[], int len, P out[])
+//   Writes the Interval from p[i] to q[i] to out[i] for every i.
+// void <pre>_pitches_chromas(const P arr[], int len, W out[])
+// void <pre>_pitches_letters(const P arr[], int len, int out[])
+// void <pre>_pitches_accidentals(const P arr[], int len, W out[])
+// void <pre>_pitches_octaves(const P arr[], int len, W out[])
+// void <pre>_pitches_heights(const P arr[], int len, HeightMap H,
+//                            long long out[])
+//   Write the classifier of every Pitch in arr to out.
+
+#define MEANTONAL_WIDTH_DECLARE(P, W, pre)                                     \
+    int pre##_pitches_from_pitches(const Pitch arr[], int len, P out[]);       \
+    int pre##_pitches_to_pitches(const P arr[], int len, Pitch out[]);         \
+    void pre##_pitches_transpose(P arr[], int len, P m);                       \
+    void pre##_pitches_intervals(const P p[], const P q[], int len, P out[]);  \
+    void pre##_pitches_chromas(const P arr[], int len, W out[]);               \
+    void pre##_pitches_letters(const P arr[], int len, int out[]);             \
+    void pre##_pitches_accidentals(const P arr[], int len, W out[]);           \
+    void pre##_pitches_octaves(const P arr[], int len, W out[]);               \
+    void pre##_pitches_heights(const P arr[], int len, HeightMap H,            \
+                               long long out[]);
+
+MEANTONAL_WIDTH_DECLARE(PitchI16, int, i16)
+MEANTONAL_WIDTH_DECLARE(PitchI32, long long, i32)
+MEANTONAL_WIDTH_DECLARE(PitchI64, long long, i64)
+
+
+
+/**
+ * Scrambles the bits of a 64-bit integer so that every input bit affects every
+ * output bit (the finalizer of MurmurHash3). It's a bijection, so distinct
+ * inputs never collide.
+ */
+static inline uint64_t hash_mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/**
+ * Returns a 64-bit hash of a Pitch. Distinct Pitches never collide, so any
+ * bits of the result make a good table index.
+ */
+static inline uint64_t pitch_hash(Pitch p) {
+    return hash_mix64((uint64_t)(uint32_t)p.w << 32 | (uint32_t)p.h);
+}
+
+/**
+ * Returns a 64-bit hash of an Interval, the same as pitch_hash.
+ */
+static inline uint64_t interval_hash(Interval m) { return pitch_hash(m); }
+
+/**
+ * Returns a 64-bit hash of a StandardPitch.
+ */
+static inline uint64_t standard_pitch_hash(StandardPitch s) {
+    uint64_t x = (uint64_t)(uint32_t)s.accidental << 32 | (uint32_t)s.octave;
+    return hash_mix64(x ^ (uint64_t)(uint32_t)s.letter * 0x9e3779b97f4a7c15ULL);
+}
+
+/**
+ * Creates an empty PitchMap.
+ * @param capacity
+ * How many Pitches to make room for before the map has to grow. It grows as
+ * needed either way.
+ * @param out
+ * Pointer to a PitchMap to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if capacity is negative or more than
+ * 2^28 (the most Pitches a PitchMap holds), or memory couldn't be allocated.
+ */
+int pitch_map_create(int capacity, PitchMap *out);
+
+/**
+ * Frees the memory previously allocated by a PitchMap.
+ */
+void pitch_map_destroy(PitchMap *m);
+
+/**
+ * Removes every Pitch from a PitchMap, keeping its memory.
+ */
+void pitch_map_clear(PitchMap *m);
+
+/**
+ * Looks up the value stored for a Pitch.
+ * @return
+ * Pointer to the value, valid until the map is next changed, or NULL if the
+ * Pitch isn't in the map.
+ */
+PitchValue *pitch_map_get(const PitchMap *m, Pitch p);
+
+/**
+ * Looks up the value stored for a Pitch, first inserting the Pitch with a
+ * value of all zeroes (so .i == 0 and .d == 0) if it isn't in the map.
+ * @return
+ * Pointer to the value, valid until the map is next changed, or NULL if memory
+ * couldn't be allocated or the map already holds 2^28 Pitches.
+ */
+PitchValue *pitch_map_slot(PitchMap *m, Pitch p);
+
+/**
+ * Stores a value for a Pitch, replacing any value already stored.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if memory couldn't be allocated.
+ */
+int pitch_map_put(PitchMap *m, Pitch p, PitchValue v);
+
+/**
+ * Removes a Pitch from a PitchMap.
+ * @return
+ * true if the Pitch was in the map.
+ */
+bool pitch_map_remove(PitchMap *m, Pitch p);
+
+/**
+ * Stores values[i] for keys[i] for every i, in order, so later duplicates
+ * win. Makes room for all of them up front.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if memory couldn't be allocated or the
+ * map could end up holding more than 2^28 Pitches.
+ */
+int pitch_map_put_all(PitchMap *m, const Pitch keys[],
+                      const PitchValue values[], int len);
+
+/**
+ * Adds 1 to the .i count of every Pitch in keys, inserting Pitches that
+ * aren't in the map yet with a count of 0 first. Builds a histogram when
+ * used on an empty map.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if memory couldn't be allocated.
+ */
+int pitch_map_increment_all(PitchMap *m, const Pitch keys[], int len);
+
+/**
+ * Steps through the Pitches in a PitchMap, in no particular order. Set *pos to
+ * 0 before the first call, and don't change the map in between.
+ * @param key
+ * Pointer to store the next Pitch.
+ * @param value
+ * Pointer to store its value. May be NULL.
+ * @return
+ * true if a Pitch was stored, false once every Pitch has been visited.
+ */
+bool pitch_map_next(const PitchMap *m, int *pos, Pitch *key,
+                    PitchValue *value);
+
+
+
+/**
+ * Sorts an array of Pitches in place from lowest to highest in an EDO, by
+ * pitch_to_number and then, between enharmonic Pitches, by diatonic steps (so
+ * C#4 comes before Db4). Pitches equal in both keep their original order.
+ *
+ * Uses an LSD radix sort rather than comparisons, so it takes linear time,
+ * with temporary memory of around 40 bytes per Pitch.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if memory couldn't be allocated, in
+ * which case arr is unchanged.
+ */
+int pitch_radix_sort(Pitch arr[], int len, EDOMap T);
+
+/**
+ * Ranks an array of Pitches in the order of pitch_radix_sort without moving
+ * them: out[0] is the index of the lowest Pitch, out[len - 1] the index of the
+ * highest.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if memory couldn't be allocated.
+ */
+int pitch_radix_argsort(const Pitch arr[], int len, EDOMap T, int out[]);
+
+/**
+ * Sorts the Pitches in a PitchBuffer in the order of pitch_radix_sort.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if memory couldn't be allocated, in
+ * which case the buffer is unchanged.
+ */
+int pitch_buffer_radix_sort(PitchBuffer *b, EDOMap T);
+
+
+
+/**
+ * Creates a PitchRange holding every Pitch whose frequency in the tuning
+ * system defined by the passed-in TuningMap is from lo_hz to hi_hz inclusive.
+ * Frequencies are only worked out here, once, so checking Pitches against the
+ * range needs no floating point.
+ * @param out
+ * Pointer to a PitchRange to store the result.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if lo_hz and hi_hz aren't positive,
+ * finite frequencies, or hi_hz is below lo_hz.
+ */
+int pitch_range_from_hz(double lo_hz, double hi_hz, TuningMap T,
+                        PitchRange *out);
+
+/**
+ * Creates a PitchRange holding every Pitch from lo to hi inclusive, e.g. the
+ * written range of an instrument, in the tuning system defined by the
+ * passed-in TuningMap. Pitches enharmonic to lo or hi are in range too.
+ */
+PitchRange pitch_range_from_pitches(Pitch lo, Pitch hi, TuningMap T);
+
+/**
+ * Creates the PitchRange of Pitches pitch_audible accepts, from 20Hz to 20kHz.
+ */
+PitchRange pitch_range_audible(TuningMap T);
+
+/**
+ * Returns true if a Pitch is within a PitchRange.
+ */
+static inline bool pitch_in_range(Pitch p, PitchRange r) {
+    long long height = pitch_height(p, r.H);
+    return r.lo <= height && height <= r.hi;
+}
+
+/**
+ * Checks every Pitch in arr with pitch_in_range, writing the results to out.
+ * @return
+ * The number of Pitches in range.
+ */
+int pitches_in_range(const Pitch arr[], int len, PitchRange r, bool out[]);
+
+/**
+ * Copies the Pitches of arr that are within a PitchRange to out, in order.
+ * Nothing else is written, so out only needs room for the Pitches in range.
+ * out may be arr itself.
+ * @return
+ * The number of Pitches copied.
+ */
+int pitches_filter_range(const Pitch arr[], int len, PitchRange r,
+                         Pitch out[]);
+
+/**
+ * Lists every Pitch within a PitchRange that has at most max_accidental sharps
+ * or flats, from lowest to highest in the order of pitch_sort, e.g. the keys
+ * of an on-screen keyboard. Only the spellings that are written are visited,
+ * so the time taken grows with the output, not with the width of the range.
+ * @param out
+ * Array to store up to capacity Pitches. May be NULL if capacity is 0.
+ * @param total
+ * Pointer to store the number of Pitches in the whole list, which is more
+ * than capacity if out was too small to hold them all.
+ * @return
+ * 0 means nothing went wrong. Returns 1 if capacity or max_accidental is
+ * negative, max_accidental is over 100000, the list would hold more than
+ * INT_MAX Pitches, or memory couldn't be allocated.
+ */
+int pitch_range_spellings(PitchRange r, int max_accidental, Pitch out[],
+                          int capacity, int *total);
+
+
+/**
+ * Converts from (letter, accidental, octave) format to (whole, half)
+ */
+Pitch pitch_from_standard(StandardPitch p);
+
+/**
+ * Parses Scientific Pitch Notation to generate a pitch.
+ * @param out
+ * Pointer to a Pitch to store the parsed vector.
+ * @return
+ * 0 means nothing went wrong.
+ */
+int pitch_from_spn(const char *s, Pitch *out);
+
+/**
+ * Parses a LilyPond pitch name to generate a pitch.
+ * @param out
+ * Pointer to a Pitch to store the parsed vector.
+ * @return
+ * 0 means nothing went wrong.
+ */
+int pitch_from_lily(const char *s, Pitch *out);
+
+typedef struct LilyParseContext {
+    Pitch previous;
+} LilyParseContext;
+
+LilyParseContext lily_parse_context_init(Pitch p);
+
+int pitch_from_relative_lily(
+    LilyParseContext *ctx,
+    const char *s,
+    Pitch *out
+);
+
+/**
+ * Parses a Helmholtz pitch name to generate a pitch.
+ * @param out
+ * Pointer to a Pitch to store the parsed vector.
+ * @return
+ * 0 means nothing went wrong.
+ */
+int pitch_from_helmholtz(const char *s, Pitch *out);
+
+/**
+ * Parses an ABC note name to generate a pitch.
+ * @param out
+ * Pointer to a Pitch to store the parsed vector.
+ * @return
+ * 0 means nothing went wrong.
+ */
+int pitch_from_abc(const char *s, Pitch *out);
+
+/**
+ * Returns the SPN name of a Pitch as a string.
+ * You must pass a char buf[8] to store the result, which is returned via an
+ * out-param.
+ * @return
+ * true if the Pitch is more than a quadruple sharp/flat away from a natural,
+ * which usually indicates a logic error upstream, or if the name would not
+ * fit in 8 characters at all, in which case "ERR" is written to out instead.
+ * false otherwise.
+ */
+bool pitch_spn(Pitch p, char *out);
+
+/**
+ * Returns the LilyPond note name of a Pitch as a string.
+ * You must pass a char buf[16] to store the result, which is returned via an
+ * out-param.
+ * @return
+ * true if the Pitch's accidental goes beyond a double sharp/flat (LilyPond
+ * has no symbol for anything more remote), or if the name would not fit in
+ * 16 characters at all. In either case "ERR" is written to out instead.
+ * False otherwise.
+ */
+bool pitch_lily(Pitch p, char *out);
+
+/**
+ * Returns the Helmholtz note name of a Pitch as a string.
+ * You must pass a char buf[16] to store the result, which is returned via an
+ * out-param.
+ * @return
+ * true if the Pitch is more than a quadruple sharp/flat away from a natural,
+ * which usually indicates a logic error upstream, or if the name would not
+ * fit in 16 characters at all, in which case "ERR" is written to out instead.
+ * false otherwise.
+ */
+bool pitch_helmholtz(Pitch p, char *out);
+
+/**
+ * Returns the ABC note name of a Pitch as a string.
+ * You must pass a char buf[16] to store the result, which is returned via an
+ * out-param.
+ * @return
+ * true if the Pitch's accidental goes beyond a double sharp/flat (ABC
+ * notation has no symbol for anything more remote), or if the name would not
+ * fit in 16 characters at all. In either case "ERR" is written to out instead.
+ * False otherwise.
+ */
+bool pitch_abc(Pitch p, char *out);
+
+/**
+ * Creates a MirrorAxis about which to invert Pitch vectors from two input SPN
+ * strings representing Pitches that will map to each other.
+ * @param out
+ * Pointer to a MirrorAxis to store the resulting axis.
+ * @return
+ * 0 means nothing went wrong.
+ */
+static inline int axis_from_spn(char *p_str, char *q_str, MirrorAxis *out) {
+    Pitch p, q;
+
+    if (pitch_from_spn(p_str, &p))
+        return 1;
+    if (pitch_from_spn(q_str, &q))
+        return 1;
+
+    out->w = p.w + q.w;
+    out->h = p.h + q.h;
+    return 0;
+}
+#endif // MEANTONAL_HEADER
+
+// -----------------------------------------
+// IMPLEMENTATION --------------------------
+// -----------------------------------------
+
+#ifdef MEANTONAL
+#undef MEANTONAL
+#include <stdio.h>
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#ifdef MEANTONAL_THREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+const Map2D WICKI_TO = {1, -3, 0, 1};
+const Map2D WICKI_FROM = {1, 3, 0, 1};
+
+const Map2D GENERATORS_TO = {2, -5, -1, 3};
+const Map2D GENERATORS_FROM = {3, 5, 1, 2};
+
+const double CONCERT_C4 = 261.6255653005986;
+#ifdef MEANTONAL_THREADS
+#endif
+
+#ifdef MEANTONAL_THREADS
+static int parallel_cores = 1;
+static pthread_once_t parallel_once = PTHREAD_ONCE_INIT;
+
+static void parallel_count_cores(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    parallel_cores = n < 1                      ? 1
+                     : n > PARALLEL_MAX_THREADS ? PARALLEL_MAX_THREADS
+                                                : (int)n;
+}
+#endif
+
+int parallel_threads(void) {
+#ifdef MEANTONAL_THREADS
+    pthread_once(&parallel_once, parallel_count_cores);
+    return parallel_cores;
+#else
+    return 1;
+#endif
+}
+
+int parallel_chunks(long len, long grain) {
+    long n = grain > 0 ? len / grain : len;
+    int threads = parallel_threads();
+    return n < 1 ? 1 : n > threads ? threads : (int)n;
+}
+
+typedef struct {
+    void (*body)(void *ctx, int chunk, long start, long end);
+    void *ctx;
+    int chunk;
+    long start, end;
+} ParallelTask;
+
+#ifdef MEANTONAL_THREADS
+static void *parallel_run(void *arg) {
+    ParallelTask *t = arg;
+    t->body(t->ctx, t->chunk, t->start, t->end);
+    return NULL;
+}
+#endif
+
+void parallel_for(long len, long grain,
+                  void (*body)(void *ctx, int chunk, long start, long end),
+                  void *ctx) {
+    int n = parallel_chunks(len, grain);
+    ParallelTask tasks[PARALLEL_MAX_THREADS];
+    for (int i = 0; i < n; i++)
+        tasks[i] = (ParallelTask){body, ctx, i, (long)((long long)i * len / n),
+                                  (long)((long long)(i + 1) * len / n)};
+#ifdef MEANTONAL_THREADS
+    // Chunk 0 runs here while the others get a thread each. A chunk whose
+    // thread can't be started runs here too, once chunk 0 is done.
+    pthread_t threads[PARALLEL_MAX_THREADS];
+    bool started[PARALLEL_MAX_THREADS] = {false};
+    for (int i = 1; i < n; i++)
+        started[i] =
+            pthread_create(&threads[i], NULL, parallel_run, &tasks[i]) == 0;
+    parallel_run(&tasks[0]);
+    for (int i = 1; i < n; i++) {
+        if (started[i])
+            pthread_join(threads[i], NULL);
+        else
+            parallel_run(&tasks[i]);
+    }
+#else
+    for (int i = 0; i < n; i++)
+        body(ctx, i, tasks[i].start, tasks[i].end);
+#endif
+}
+// Generated by tools/gen_edo_catalog.c. Do not edit by hand, run
+// `make catalog` instead.
+
+const int EDO_CATALOG_MAX = 512;
+
+const EDOCatalogEntry EDO_CATALOG[] = {
+    {0, {0, 0}, 0, false},
+    {1, {0, 0}, 1200, false},
+    {1, {0, 0}, 600, false},
+    {2, {0, 0}, 800, false},
+    {2, {0, 0}, 600, false},
+    {3, {1, 0}, 720, true},
+    {4, {0, 0}, 800, false},
+    {4, {1, 1}, 685.71428571428567, true},
+    {5, {0, 0}, 750, false},
+    {5, {0, 0}, 666.66666666666663, false},
+    {6, {2, 0}, 720, true},
+    {6, {0, 0}, 654.5454545454545, false},
+    {7, {2, 1}, 700, true},
+    {8, {0, 0}, 738.46153846153845, false},
+    {8, {2, 2}, 685.71428571428567, true},
+    {9, {3, 0}, 720, true},
+    {9, {0, 0}, 675, false},
+    {10, {3, 1}, 705.88235294117646, true},
+    {11, {0, 0}, 733.33333333333337, false},
+    {11, {3, 2}, 694.73684210526312, true},
+    {12, {4, 0}, 720, true},
+    {12, {3, 3}, 685.71428571428567, true},
+    {13, {4, 1}, 709.09090909090912, true},
+    {13, {0, 0}, 678.26086956521738, false},
+    {14, {4, 2}, 700, true},
+    {15, {5, 0}, 720, true},
+    {15, {4, 3}, 692.30769230769226, true},
+    {16, {5, 1}, 711.11111111111109, true},
+    {16, {4, 4}, 685.71428571428567, true},
+    {17, {5, 2}, 703.44827586206895, true},
+    {18, {6, 0}, 720, true},
+    {18, {5, 3}, 696.77419354838707, true},
+    {19, {6, 1}, 712.5, true},
+    {19, {5, 4}, 690.90909090909088, true},
+    {20, {6, 2}, 705.88235294117646, true},
+    {20, {5, 5}, 685.71428571428567, true},
+    {21, {6, 3}, 700, true},
+    {22, {7, 1}, 713.51351351351354, true},
+    {22, {6, 4}, 694.73684210526312, true},
+    {23, {7, 2}, 707.69230769230774, true},
+    {23, {6, 5}, 690, true},
+    {24, {7, 3}, 702.43902439024396, true},
+    {25, {8, 1}, 714.28571428571433, true},
+    {25, {7, 4}, 697.67441860465112, true},
+    {26, {8, 2}, 709.09090909090912, true},
+    {26, {7, 5}, 693.33333333333337, true},
+    {27, {8, 3}, 704.3478260869565, true},
+    {27, {7, 6}, 689.36170212765956, true},
+    {28, {8, 4}, 700, true},
+    {29, {9, 2}, 710.20408163265301, true},
+    {29, {8, 5}, 696, true},
+    {30, {9, 3}, 705.88235294117646, true},
+    {30, {8, 6}, 692.30769230769226, true},
+    {31, {9, 4}, 701.88679245283015, true},
+    {32, {10, 2}, 711.11111111111109, true},
+    {32, {9, 5}, 698.18181818181813, true},
+    {33, {10, 3}, 707.14285714285711, true},
+    {33, {9, 6}, 694.73684210526312, true},
+    {34, {10, 4}, 703.44827586206895, true},
+    {35, {11, 2}, 711.86440677966107, true},
+    {35, {10, 5}, 700, true},
+    {36, {11, 3}, 708.19672131147536, true},
+    {36, {10, 6}, 696.77419354838707, true},
+    {37, {11, 4}, 704.76190476190482, true},
+    {37, {10, 7}, 693.75, true},
+    {38, {11, 5}, 701.53846153846155, true},
+    {39, {12, 3}, 709.09090909090912, true},
+    {39, {11, 6}, 698.50746268656712, true},
+    {40, {12, 4}, 705.88235294117646, true},
+    {40, {11, 7}, 695.6521739130435, true},
+    {41, {12, 5}, 702.85714285714289, true},
+    {42, {13, 3}, 709.85915492957747, true},
+    {42, {12, 6}, 700, true},
+    {43, {13, 4}, 706.84931506849318, true},
+    {43, {12, 7}, 697.29729729729729, true},
+    {44, {13, 5}, 704, true},
+    {44, {12, 8}, 694.73684210526312, true},
+    {45, {13, 6}, 701.2987012987013, true},
+    {46, {14, 4}, 707.69230769230774, true},
+    {46, {13, 7}, 698.7341772151899, true},
+    {47, {14, 5}, 705, true},
+    {47, {13, 8}, 696.2962962962963, true},
+    {48, {14, 6}, 702.43902439024396, true},
+    {49, {15, 4}, 708.43373493975901, true},
+    {49, {14, 7}, 700, true},
+    {50, {15, 5}, 705.88235294117646, true},
+    {50, {14, 8}, 697.67441860465112, true},
+    {51, {15, 6}, 703.44827586206895, true},
+    {51, {14, 9}, 695.4545454545455, true},
+    {52, {15, 7}, 701.12359550561803, true},
+    {53, {16, 5}, 706.66666666666663, true},
+    {53, {15, 8}, 698.90109890109886, true},
+    {54, {16, 6}, 704.3478260869565, true},
+    {54, {15, 9}, 696.77419354838707, true},
+    {55, {16, 7}, 702.12765957446811, true},
+    {56, {17, 5}, 707.36842105263156, true},
+    {56, {16, 8}, 700, true},
+    {57, {17, 6}, 705.15463917525778, true},
+    {57, {16, 9}, 697.9591836734694, true},
+    {58, {17, 7}, 703.030303030303, true},
+    {58, {16, 10}, 696, true},
+    {59, {17, 8}, 700.99009900990097, true},
+    {60, {18, 6}, 705.88235294117646, true},
+    {60, {17, 9}, 699.02912621359224, true},
+    {61, {18, 7}, 703.84615384615381, true},
+    {61, {17, 10}, 697.14285714285711, true},
+    {62, {18, 8}, 701.88679245283015, true},
+    {63, {19, 6}, 706.54205607476638, true},
+    {63, {18, 9}, 700, true},
+    {64, {19, 7}, 704.58715596330273, true},
+    {64, {18, 10}, 698.18181818181813, true},
+    {65, {19, 8}, 702.70270270270271, true},
+    {66, {20, 6}, 707.14285714285711, true},
+    {66, {19, 9}, 700.88495575221236, true},
+    {67, {20, 7}, 705.26315789473688, true},
+    {67, {19, 10}, 699.13043478260875, true},
+    {68, {20, 8}, 703.44827586206895, true},
+    {68, {19, 11}, 697.43589743589746, true},
+    {69, {20, 9}, 701.69491525423734, true},
+    {70, {21, 7}, 705.88235294117646, true},
+    {70, {20, 10}, 700, true},
+    {71, {21, 8}, 704.1322314049587, true},
+    {71, {20, 11}, 698.36065573770497, true},
+    {72, {21, 9}, 702.43902439024396, true},
+    {73, {22, 7}, 706.45161290322585, true},
+    {73, {21, 10}, 700.79999999999995, true},
+    {74, {22, 8}, 704.76190476190482, true},
+    {74, {21, 11}, 699.2125984251968, true},
+    {75, {22, 9}, 703.125, true},
+    {75, {21, 12}, 697.67441860465112, true},
+    {76, {22, 10}, 701.53846153846155, true},
+    {77, {23, 8}, 705.3435114503817, true},
+    {77, {22, 11}, 700, true},
+    {78, {23, 9}, 703.75939849624058, true},
+    {78, {22, 12}, 698.50746268656712, true},
+    {79, {23, 10}, 702.22222222222217, true},
+    {80, {24, 8}, 705.88235294117646, true},
+    {80, {23, 11}, 700.72992700729924, true},
+    {81, {24, 9}, 704.3478260869565, true},
+    {81, {23, 12}, 699.2805755395683, true},
+    {82, {24, 10}, 702.85714285714289, true},
+    {82, {23, 13}, 697.87234042553189, true},
+    {83, {24, 11}, 701.4084507042254, true},
+    {84, {25, 9}, 704.89510489510485, true},
+    {84, {24, 12}, 700, true},
+    {85, {25, 10}, 703.44827586206895, true},
+    {85, {24, 13}, 698.63013698630141, true},
+    {86, {25, 11}, 702.0408163265306, true},
+    {87, {26, 9}, 705.40540540540542, true},
+    {87, {25, 12}, 700.67114093959731, true},
+    {88, {26, 10}, 704, true},
+    {88, {25, 13}, 699.33774834437088, true},
+    {89, {26, 11}, 702.63157894736844, true},
+    {89, {25, 14}, 698.03921568627447, true},
+    {90, {26, 12}, 701.2987012987013, true},
+    {91, {27, 10}, 704.51612903225805, true},
+    {91, {26, 13}, 700, true},
+    {92, {27, 11}, 703.18471337579615, true},
+    {92, {26, 14}, 698.7341772151899, true},
+    {93, {27, 12}, 701.88679245283015, true},
+    {94, {28, 10}, 705, true},
+    {94, {27, 13}, 700.62111801242236, true},
+    {95, {28, 11}, 703.7037037037037, true},
+    {95, {27, 14}, 699.38650306748468, true},
+    {96, {28, 12}, 702.43902439024396, true},
+    {97, {29, 10}, 705.4545454545455, true},
+    {97, {28, 13}, 701.20481927710841, true},
+    {98, {29, 11}, 704.19161676646706, true},
+    {98, {28, 14}, 700, true},
+    {99, {29, 12}, 702.95857988165676, true},
+    {99, {28, 15}, 698.82352941176475, true},
+    {100, {29, 13}, 701.75438596491233, true},
+    {101, {30, 11}, 704.65116279069764, true},
+    {101, {29, 14}, 700.5780346820809, true},
+    {102, {30, 12}, 703.44827586206895, true},
+    {102, {29, 15}, 699.42857142857144, true},
+    {103, {30, 13}, 702.27272727272725, true},
+    {104, {31, 11}, 705.08474576271192, true},
+    {104, {30, 14}, 701.12359550561803, true},
+    {105, {31, 12}, 703.91061452513964, true},
+    {105, {30, 15}, 700, true},
+    {106, {31, 13}, 702.76243093922653, true},
+    {106, {30, 16}, 698.90109890109886, true},
+    {107, {31, 14}, 701.63934426229503, true},
+    {108, {32, 12}, 704.3478260869565, true},
+    {108, {31, 15}, 700.54054054054052, true},
+    {109, {32, 13}, 703.22580645161293, true},
+    {109, {31, 16}, 699.46524064171126, true},
+    {110, {32, 14}, 702.12765957446811, true},
+    {111, {33, 12}, 704.76190476190482, true},
+    {111, {32, 15}, 701.0526315789474, true},
+    {112, {33, 13}, 703.66492146596863, true},
+    {112, {32, 16}, 700, true},
+    {113, {33, 14}, 702.59067357512959, true},
+    {113, {32, 17}, 698.96907216494844, true},
+    {114, {33, 15}, 701.53846153846155, true},
+    {115, {34, 13}, 704.08163265306121, true},
+    {115, {33, 16}, 700.50761421319794, true},
+    {116, {34, 14}, 703.030303030303, true},
+    {116, {33, 17}, 699.4974874371859, true},
+    {117, {34, 15}, 702, true},
+    {118, {35, 13}, 704.47761194029852, true},
+    {118, {34, 16}, 700.99009900990097, true},
+    {119, {35, 14}, 703.44827586206895, true},
+    {119, {34, 17}, 700, true},
+    {120, {35, 15}, 702.43902439024396, true},
+    {121, {36, 13}, 704.85436893203882, true},
+    {121, {35, 16}, 701.44927536231887, true},
+    {122, {36, 14}, 703.84615384615381, true},
+    {122, {35, 17}, 700.47846889952154, true},
+    {123, {36, 15}, 702.85714285714289, true},
+    {123, {35, 18}, 699.52606635071095, true},
+    {124, {36, 16}, 701.88679245283015, true},
+    {125, {37, 14}, 704.22535211267609, true},
+    {125, {36, 17}, 700.93457943925239, true},
+    {126, {37, 15}, 703.25581395348843, true},
+    {126, {36, 18}, 700, true},
+    {127, {37, 16}, 702.30414746543784, true},
+    {128, {38, 14}, 704.58715596330273, true},
+    {128, {37, 17}, 701.36986301369859, true},
+    {129, {38, 15}, 703.63636363636363, true},
+    {129, {37, 18}, 700.45248868778276, true},
+    {130, {38, 16}, 702.70270270270271, true},
+    {130, {37, 19}, 699.55156950672642, true},
+    {131, {38, 17}, 701.78571428571433, true},
+    {132, {39, 15}, 704, true},
+    {132, {38, 18}, 700.88495575221236, true},
+    {133, {39, 16}, 703.08370044052867, true},
+    {133, {38, 19}, 700, true},
+    {134, {39, 17}, 702.1834061135371, true},
+    {135, {40, 15}, 704.3478260869565, true},
+    {135, {39, 18}, 701.2987012987013, true},
+    {136, {40, 16}, 703.44827586206895, true},
+    {136, {39, 19}, 700.42918454935625, true},
+    {137, {40, 17}, 702.56410256410254, true},
+    {137, {39, 20}, 699.57446808510633, true},
+    {138, {40, 18}, 701.69491525423734, true},
+    {139, {41, 16}, 703.79746835443041, true},
+    {139, {40, 19}, 700.84033613445376, true},
+    {140, {41, 17}, 702.92887029288704, true},
+    {140, {40, 20}, 700, true},
+    {141, {41, 18}, 702.07468879668045, true},
+    {142, {42, 16}, 704.1322314049587, true},
+    {142, {41, 19}, 701.23456790123453, true},
+    {143, {42, 17}, 703.27868852459017, true},
+    {143, {41, 20}, 700.40816326530614, true},
+    {144, {42, 18}, 702.43902439024396, true},
+    {144, {41, 21}, 699.59514170040484, true},
+    {145, {42, 19}, 701.61290322580646, true},
+    {146, {43, 17}, 703.61445783132535, true},
+    {146, {42, 20}, 700.79999999999995, true},
+    {147, {43, 18}, 702.78884462151393, true},
+    {147, {42, 21}, 700, true},
+    {148, {43, 19}, 701.97628458498025, true},
+    {149, {44, 17}, 703.93700787401576, true},
+    {149, {43, 20}, 701.17647058823525, true},
+    {150, {44, 18}, 703.125, true},
+    {150, {43, 21}, 700.38910505836577, true},
+    {151, {44, 19}, 702.32558139534888, true},
+    {152, {45, 17}, 704.24710424710429, true},
+    {152, {44, 20}, 701.53846153846155, true},
+    {153, {45, 18}, 703.44827586206895, true},
+    {153, {44, 21}, 700.76335877862596, true},
+    {154, {45, 19}, 702.66159695817487, true},
+    {154, {44, 22}, 700, true},
+    {155, {45, 20}, 701.88679245283015, true},
+    {156, {46, 18}, 703.75939849624058, true},
+    {156, {45, 21}, 701.12359550561803, true},
+    {157, {46, 19}, 702.98507462686564, true},
+    {157, {45, 22}, 700.37174721189592, true},
+    {158, {46, 20}, 702.22222222222217, true},
+    {159, {47, 18}, 704.05904059040586, true},
+    {159, {46, 21}, 701.47058823529414, true},
+    {160, {47, 19}, 703.2967032967033, true},
+    {160, {46, 22}, 700.72992700729924, true},
+    {161, {47, 20}, 702.5454545454545, true},
+    {161, {46, 23}, 700, true},
+    {162, {47, 21}, 701.80505415162452, true},
+    {163, {48, 19}, 703.59712230215825, true},
+    {163, {47, 22}, 701.07526881720435, true},
+    {164, {48, 20}, 702.85714285714289, true},
+    {164, {47, 23}, 700.35587188612101, true},
+    {165, {48, 21}, 702.12765957446811, true},
+    {166, {49, 19}, 703.886925795053, true},
+    {166, {48, 22}, 701.4084507042254, true},
+    {167, {49, 20}, 703.15789473684208, true},
+    {167, {48, 23}, 700.69930069930069, true},
+    {168, {49, 21}, 702.43902439024396, true},
+    {168, {48, 24}, 700, true},
+    {169, {49, 22}, 701.73010380622839, true},
+    {170, {50, 20}, 703.44827586206895, true},
+    {170, {49, 23}, 701.03092783505156, true},
+    {171, {50, 21}, 702.7397260273973, true},
+    {171, {49, 24}, 700.34129692832767, true},
+    {172, {50, 22}, 702.0408163265306, true},
+    {173, {51, 20}, 703.72881355932202, true},
+    {173, {50, 23}, 701.35135135135135, true},
+    {174, {51, 21}, 703.030303030303, true},
+    {174, {50, 24}, 700.67114093959731, true},
+    {175, {51, 22}, 702.34113712374585, true},
+    {175, {50, 25}, 700, true},
+    {176, {51, 23}, 701.66112956810628, true},
+    {177, {52, 21}, 703.31125827814571, true},
+    {177, {51, 24}, 700.99009900990097, true},
+    {178, {52, 22}, 702.63157894736844, true},
+    {178, {51, 25}, 700.32786885245901, true},
+    {179, {52, 23}, 701.96078431372553, true},
+    {180, {53, 21}, 703.58306188925087, true},
+    {180, {52, 24}, 701.2987012987013, true},
+    {181, {53, 22}, 702.91262135922329, true},
+    {181, {52, 25}, 700.64516129032256, true},
+    {182, {53, 23}, 702.25080385852095, true},
+    {183, {54, 21}, 703.84615384615381, true},
+    {183, {53, 24}, 701.59744408945687, true},
+    {184, {54, 22}, 703.18471337579615, true},
+    {184, {53, 25}, 700.95238095238096, true},
+    {185, {54, 23}, 702.53164556962031, true},
+    {185, {53, 26}, 700.31545741324919, true},
+    {186, {54, 24}, 701.88679245283015, true},
+    {187, {55, 22}, 703.44827586206895, true},
+    {187, {54, 25}, 701.25, true},
+    {188, {55, 23}, 702.80373831775705, true},
+    {188, {54, 26}, 700.62111801242236, true},
+    {189, {55, 24}, 702.16718266253872, true},
+    {190, {56, 22}, 703.7037037037037, true},
+    {190, {55, 25}, 701.53846153846155, true},
+    {191, {56, 23}, 703.0674846625767, true},
+    {191, {55, 26}, 700.9174311926605, true},
+    {192, {56, 24}, 702.43902439024396, true},
+    {192, {55, 27}, 700.30395136778111, true},
+    {193, {56, 25}, 701.81818181818187, true},
+    {194, {57, 23}, 703.32326283987913, true},
+    {194, {56, 26}, 701.20481927710841, true},
+    {195, {57, 24}, 702.70270270270271, true},
+    {195, {56, 27}, 700.59880239520953, true},
+    {196, {57, 25}, 702.08955223880594, true},
+    {197, {58, 23}, 703.57142857142856, true},
+    {197, {57, 26}, 701.48367952522256, true},
+    {198, {58, 24}, 702.95857988165676, true},
+    {198, {57, 27}, 700.88495575221236, true},
+    {199, {58, 25}, 702.35294117647061, true},
+    {199, {57, 28}, 700.29325513196477, true},
+    {200, {58, 26}, 701.75438596491233, true},
+    {201, {59, 24}, 703.20699708454811, true},
+    {201, {58, 27}, 701.16279069767438, true},
+    {202, {59, 25}, 702.60869565217388, true},
+    {202, {58, 28}, 700.5780346820809, true},
+    {203, {59, 26}, 702.01729106628238, true},
+    {204, {60, 24}, 703.44827586206895, true},
+    {204, {59, 27}, 701.43266475644702, true},
+    {205, {60, 25}, 702.85714285714289, true},
+    {205, {59, 28}, 700.85470085470081, true},
+    {206, {60, 26}, 702.27272727272725, true},
+    {206, {59, 29}, 700.28328611898019, true},
+    {207, {60, 27}, 701.69491525423734, true},
+    {208, {61, 25}, 703.09859154929575, true},
+    {208, {60, 28}, 701.12359550561803, true},
+    {209, {61, 26}, 702.52100840336129, true},
+    {209, {60, 29}, 700.55865921787711, true},
+    {210, {61, 27}, 701.94986072423399, true},
+    {211, {62, 25}, 703.33333333333337, true},
+    {211, {61, 28}, 701.38504155124656, true},
+    {212, {62, 26}, 702.76243093922653, true},
+    {212, {61, 29}, 700.82644628099172, true},
+    {213, {62, 27}, 702.19780219780216, true},
+    {214, {63, 25}, 703.56164383561645, true},
+    {214, {62, 28}, 701.63934426229503, true},
+    {215, {63, 26}, 702.99727520435965, true},
+    {215, {62, 29}, 701.08695652173913, true},
+    {216, {63, 27}, 702.43902439024396, true},
+    {216, {62, 30}, 700.54054054054052, true},
+    {217, {63, 28}, 701.88679245283015, true},
+    {218, {64, 26}, 703.22580645161293, true},
+    {218, {63, 29}, 701.34048257372649, true},
+    {219, {64, 27}, 702.67379679144381, true},
+    {219, {63, 30}, 700.79999999999995, true},
+    {220, {64, 28}, 702.12765957446811, true},
+    {221, {65, 26}, 703.44827586206895, true},
+    {221, {64, 29}, 701.58730158730157, true},
+    {222, {65, 27}, 702.90237467018471, true},
+    {222, {64, 30}, 701.0526315789474, true},
+    {223, {65, 28}, 702.36220472440948, true},
+    {223, {64, 31}, 700.52356020942409, true},
+    {224, {65, 29}, 701.82767624020892, true},
+    {225, {66, 27}, 703.125, true},
+    {225, {65, 30}, 701.2987012987013, true},
+    {226, {66, 28}, 702.59067357512959, true},
+    {226, {65, 31}, 700.77519379844966, true},
+    {227, {66, 29}, 702.06185567010311, true},
+    {228, {67, 27}, 703.3419023136247, true},
+    {228, {66, 30}, 701.53846153846155, true},
+    {229, {67, 28}, 702.81329923273654, true},
+    {229, {66, 31}, 701.0204081632653, true},
+    {230, {67, 29}, 702.29007633587787, true},
+    {230, {66, 32}, 700.50761421319794, true},
+    {231, {67, 30}, 701.77215189873414, true},
+    {232, {68, 28}, 703.030303030303, true},
+    {232, {67, 31}, 701.25944584382876, true},
+    {233, {68, 29}, 702.51256281407041, true},
+    {233, {67, 32}, 700.75187969924809, true},
+    {234, {68, 30}, 702, true},
+    {235, {69, 28}, 703.24189526184534, true},
+    {235, {68, 31}, 701.49253731343288, true},
+    {236, {69, 29}, 702.72952853598019, true},
+    {236, {68, 32}, 700.99009900990097, true},
+    {237, {69, 30}, 702.22222222222217, true},
+    {237, {68, 33}, 700.49261083743841, true},
+    {238, {69, 31}, 701.71990171990171, true},
+    {239, {70, 29}, 702.94117647058829, true},
+    {239, {69, 32}, 701.22249388753062, true},
+    {240, {70, 30}, 702.43902439024396, true},
+    {240, {69, 33}, 700.72992700729924, true},
+    {241, {70, 31}, 701.94174757281553, true},
+    {242, {71, 29}, 703.1476997578693, true},
+    {242, {70, 32}, 701.44927536231887, true},
+    {243, {71, 30}, 702.65060240963851, true},
+    {243, {70, 33}, 700.96153846153845, true},
+    {244, {71, 31}, 702.15827338129498, true},
+    {245, {72, 29}, 703.3492822966507, true},
+    {245, {71, 32}, 701.67064439140813, true},
+    {246, {72, 30}, 702.85714285714289, true},
+    {246, {71, 33}, 701.18764845605699, true},
+    {247, {72, 31}, 702.36966824644549, true},
+    {247, {71, 34}, 700.70921985815608, true},
+    {248, {72, 32}, 701.88679245283015, true},
+    {249, {73, 30}, 703.05882352941171, true},
+    {249, {72, 33}, 701.4084507042254, true},
+    {250, {73, 31}, 702.57611241217796, true},
+    {250, {72, 34}, 700.93457943925239, true},
+    {251, {73, 32}, 702.09790209790208, true},
+    {252, {74, 30}, 703.25581395348843, true},
+    {252, {73, 33}, 701.62412993039447, true},
+    {253, {74, 31}, 702.77777777777783, true},
+    {253, {73, 34}, 701.15473441108543, true},
+    {254, {74, 32}, 702.30414746543784, true},
+    {254, {73, 35}, 700.68965517241384, true},
+    {255, {74, 33}, 701.83486238532112, true},
+    {256, {75, 31}, 702.97482837528605, true},
+    {256, {74, 34}, 701.36986301369859, true},
+    {257, {75, 32}, 702.50569476082001, true},
+    {257, {74, 35}, 700.90909090909088, true},
+    {258, {75, 33}, 702.0408163265306, true},
+    {259, {76, 31}, 703.16742081447967, true},
+    {259, {75, 34}, 701.58013544018058, true},
+    {260, {76, 32}, 702.70270270270271, true},
+    {260, {75, 35}, 701.12359550561803, true},
+    {261, {76, 33}, 702.24215246636766, true},
+    {261, {75, 36}, 700.67114093959731, true},
+    {262, {76, 34}, 701.78571428571433, true},
+    {263, {77, 32}, 702.89532293986633, true},
+    {263, {76, 35}, 701.33333333333337, true},
+    {264, {77, 33}, 702.43902439024396, true},
+    {264, {76, 36}, 700.88495575221236, true},
+    {265, {77, 34}, 701.98675496688736, true},
+    {266, {78, 32}, 703.08370044052867, true},
+    {266, {77, 35}, 701.53846153846155, true},
+    {267, {78, 33}, 702.63157894736844, true},
+    {267, {77, 36}, 701.09409190371991, true},
+    {268, {78, 34}, 702.1834061135371, true},
+    {268, {77, 37}, 700.65359477124184, true},
+    {269, {78, 35}, 701.73913043478262, true},
+    {270, {79, 33}, 702.81995661605208, true},
+    {270, {78, 36}, 701.2987012987013, true},
+    {271, {79, 34}, 702.37580993520521, true},
+    {271, {78, 37}, 700.86206896551721, true},
+    {272, {79, 35}, 701.93548387096769, true},
+    {273, {80, 33}, 703.00429184549353, true},
+    {273, {79, 36}, 701.49892933618844, true},
+    {274, {80, 34}, 702.56410256410254, true},
+    {274, {79, 37}, 701.06609808102348, true},
+    {275, {80, 35}, 702.12765957446811, true},
+    {276, {81, 33}, 703.18471337579615, true},
+    {276, {80, 36}, 701.69491525423734, true},
+    {277, {81, 34}, 702.74841437632131, true},
+    {277, {80, 37}, 701.2658227848101, true},
+    {278, {81, 35}, 702.31578947368416, true},
+    {278, {80, 38}, 700.84033613445376, true},
+    {279, {81, 36}, 701.88679245283015, true},
+    {280, {82, 34}, 702.92887029288704, true},
+    {280, {81, 37}, 701.46137787056364, true},
+    {281, {82, 35}, 702.5, true},
+    {281, {81, 38}, 701.03950103950103, true},
+    {282, {82, 36}, 702.07468879668045, true},
+    {283, {83, 34}, 703.10559006211179, true},
+    {283, {82, 37}, 701.65289256198344, true},
+    {284, {83, 35}, 702.68041237113403, true},
+    {284, {82, 38}, 701.23456790123453, true},
+    {285, {83, 36}, 702.25872689938399, true},
+    {285, {82, 39}, 700.81967213114751, true},
+    {286, {83, 37}, 701.84049079754607, true},
+    {287, {84, 35}, 702.85714285714289, true},
+    {287, {83, 38}, 701.42566191446031, true},
+    {288, {84, 36}, 702.43902439024396, true},
+    {288, {83, 39}, 701.01419878296144, true},
+    {289, {84, 37}, 702.0242914979757, true},
+    {290, {85, 35}, 703.030303030303, true},
+    {290, {84, 38}, 701.61290322580646, true},
+    {291, {85, 36}, 702.61569416498992, true},
+    {291, {84, 39}, 701.20481927710841, true},
+    {292, {85, 37}, 702.20440881763523, true},
+    {292, {84, 40}, 700.79999999999995, true},
+    {293, {85, 38}, 701.79640718562871, true},
+    {294, {86, 36}, 702.78884462151393, true},
+    {294, {85, 39}, 701.39165009940359, true},
+    {295, {86, 37}, 702.38095238095241, true},
+    {295, {85, 40}, 700.99009900990097, true},
+    {296, {86, 38}, 701.97628458498025, true},
+    {297, {87, 36}, 702.95857988165676, true},
+    {297, {86, 39}, 701.57480314960628, true},
+    {298, {87, 37}, 702.55402750491157, true},
+    {298, {86, 40}, 701.17647058823525, true},
+    {299, {87, 38}, 702.15264187866933, true},
+    {300, {88, 36}, 703.125, true},
+};
+#ifdef __AVX2__
+#endif
+
+Pitch pitch_from_chroma(int chroma, int octave) {
+    Pitch p = {chroma * 3, chroma};
+    int octaves = octave - pitch_octave(p);
+    return (Pitch){.w = p.w + 5 * octaves, .h = p.h + 2 * octaves};
+}
+
+// With AVX2, 8 Pitches at a time are loaded as two vectors of interleaved w
+// and h, multiplied by {m0, m1, m0, m1, ...}, and added pairwise. The pairwise
+// add works within 128-bit halves, so a 64-bit permute puts the 8 numbers back
+// in order.
+void pitches_to_numbers(const Pitch arr[], int len, EDOMap T, int out[]) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i m = _mm256_setr_epi32(T.m0, T.m1, T.m0, T.m1, T.m0, T.m1, T.m0,
+                                  T.m1);
+    for (; i + 8 <= len; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(arr + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(arr + i + 4));
+        __m256i n = _mm256_hadd_epi32(_mm256_mullo_epi32(a, m),
+                                      _mm256_mullo_epi32(b, m));
+        _mm256_storeu_si256((__m256i *)(out + i),
+                            _mm256_permute4x64_epi64(n, 0xd8));
+    }
+#endif
+    for (; i < len; i++)
+        out[i] = T.m0 * arr[i].w + T.m1 * arr[i].h;
+}
+
+void pitches_from_numbers(const int arr[], int len, const EDOSpeller *s,
+                          Pitch out[]) {
+    for (int i = 0; i < len; i++)
+        out[i] = pitch_from_number(arr[i], s);
+}
+
+Pitch pitches_from_intervals(Pitch start, const Interval m[], int len,
+                             Pitch out[]) {
+    for (int i = 0; i < len; i++)
+        out[i] = start = transpose_real(start, m[i]);
+    return start;
+}
+
+void intervals_from_pitches(Pitch start, const Pitch arr[], int len,
+                            Interval out[]) {
+    for (int i = 0; i < len; i++) {
+        Pitch p = arr[i];
+        out[i] = interval_between(start, p);
+        start = p;
+    }
+}
+
+Interval intervals_sum(const Interval m[], int len) {
+    Interval sum = {0, 0};
+    for (int i = 0; i < len; i++)
+        sum = transpose_real(sum, m[i]);
+    return sum;
+}
+
+bool pitch_audible(Pitch p, TuningMap T) {
+    double f = to_hz(p, T);
+    if (f < 20.0) return false;
+    if (f > 20000.0) return false;
+    return true;
+}
+
+Pitch pitch_highest(Pitch arr[], int len, TuningMap T) {
+    return arr[pitch_highest_index(arr, len, height_map_from_tuning(T))];
+}
+
+Pitch pitch_lowest(Pitch arr[], int len, TuningMap T) {
+    return arr[pitch_lowest_index(arr, len, height_map_from_tuning(T))];
+}
+
+void pitch_heights(const Pitch arr[], int len, HeightMap H, long long out[]) {
+    for (int i = 0; i < len; i++)
+        out[i] = pitch_height(arr[i], H);
+}
+
+// Both searches reduce to the extreme height first, in a loop with no
+// data-dependent branches so it vectorizes, then settle enharmonic ties
+// among the (usually very few) Pitches at that height.
+int pitch_highest_index(const Pitch arr[], int len, HeightMap H) {
+    if (len <= 0)
+        return -1;
+    long long top = pitch_height(arr[0], H);
+    for (int i = 1; i < len; i++) {
+        long long x = pitch_height(arr[i], H);
+        top = x > top ? x : top;
+    }
+
+    int best = -1;
+    for (int i = 0; i < len; i++) {
+        if (pitch_height(arr[i], H) != top)
+            continue;
+        if (best < 0 || steps_between(arr[i], arr[best]) < 0)
+            best = i;
+    }
+    return best;
+}
+
+int pitch_lowest_index(const Pitch arr[], int len, HeightMap H) {
+    if (len <= 0)
+        return -1;
+    long long bottom = pitch_height(arr[0], H);
+    for (int i = 1; i < len; i++) {
+        long long x = pitch_height(arr[i], H);
+        bottom = x < bottom ? x : bottom;
+    }
+
+    int best = -1;
+    for (int i = 0; i < len; i++) {
+        if (pitch_height(arr[i], H) != bottom)
+            continue;
+        if (best < 0 || steps_between(arr[i], arr[best]) > 0)
+            best = i;
+    }
+    return best;
+}
+
+// Heapsort: O(n log n) with no allocation, and no comparator callback to
+// thread the HeightMap through.
+static void sift_down(Pitch arr[], int root, int len, HeightMap H) {
+    while (2 * root + 1 < len) {
+        int child = 2 * root + 1;
+        if (child + 1 < len &&
+            pitches_compare_height(arr[child + 1], arr[child], H) > 0)
+            child++;
+        if (pitches_compare_height(arr[child], arr[root], H) <= 0)
+            return;
+        Pitch tmp = arr[root];
+        arr[root] = arr[child];
+        arr[child] = tmp;
+        root = child;
+    }
+}
+
+void pitch_sort(Pitch arr[], int len, HeightMap H) {
+    for (int i = len / 2 - 1; i >= 0; i--)
+        sift_down(arr, i, len, H);
+    for (int end = len - 1; end > 0; end--) {
+        Pitch tmp = arr[0];
+        arr[0] = arr[end];
+        arr[end] = tmp;
+        sift_down(arr, 0, end, H);
+    }
+}
+
+// Anything pitches_compare_height leaves tied is broken by index, making the
+// order total so the unstable heapsort still produces a stable ranking.
+static int index_compare(const Pitch arr[], int i, int j, HeightMap H) {
+    int c = pitches_compare_height(arr[i], arr[j], H);
+    return c ? c : (i > j) - (i < j);
+}
+
+static void sift_down_index(const Pitch arr[], int idx[], int root, int len,
+                            HeightMap H) {
+    while (2 * root + 1 < len) {
+        int child = 2 * root + 1;
+        if (child + 1 < len &&
+            index_compare(arr, idx[child + 1], idx[child], H) > 0)
+            child++;
+        if (index_compare(arr, idx[child], idx[root], H) <= 0)
+            return;
+        int tmp = idx[root];
+        idx[root] = idx[child];
+        idx[child] = tmp;
+        root = child;
+    }
+}
+
+void pitch_argsort(const Pitch arr[], int len, HeightMap H, int out[]) {
+    for (int i = 0; i < len; i++)
+        out[i] = i;
+    for (int i = len / 2 - 1; i >= 0; i--)
+        sift_down_index(arr, out, i, len, H);
+    for (int end = len - 1; end > 0; end--) {
+        int tmp = out[0];
+        out[0] = out[end];
+        out[end] = tmp;
+        sift_down_index(arr, out, 0, end, H);
+    }
+}
+
+Pitch pitch_nearest(Pitch p, Pitch arr[], int len, TuningMap T) {
+    HeightMap H = height_map_from_tuning(T);
+    long long height = pitch_height(p, H);
+
+    int closest = 0;
+    long long best_dist = llabs(pitch_height(arr[0], H) - height);
+    int best_steps = abs(steps_between(p, arr[0]));
+    for (int i = 1; i < len; i++) {
+        long long dist = llabs(pitch_height(arr[i], H) - height);
+        int steps = abs(steps_between(p, arr[i]));
+        if (dist < best_dist || (dist == best_dist && steps < best_steps)) {
+            closest = i;
+            best_dist = dist;
+            best_steps = steps;
+        }
+    }
+    return arr[closest];
+}
+
+typedef struct {
+    long long height;
+    Pitch p;
+    int order;
+} IndexEntry;
+
+static int index_entry_compare(const void *a, const void *b) {
+    const IndexEntry *x = a, *y = b;
+    if (x->height != y->height)
+        return x->height > y->height ? 1 : -1;
+    int sx = x->p.w + x->p.h, sy = y->p.w + y->p.h;
+    if (sx != sy)
+        return sx > sy ? 1 : -1;
+    return (x->order > y->order) - (x->order < y->order);
+}
+
+int nearest_index_create(const Pitch arr[], int len, TuningMap T,
+                         NearestIndex *out) {
+    if (len <= 0)
+        return 1;
+
+    IndexEntry *entries = malloc(len * sizeof(IndexEntry));
+    long long *heights = malloc(len * sizeof(long long));
+    Pitch *pitches = malloc(len * sizeof(Pitch));
+    int *order = malloc(len * sizeof(int));
+    if (!entries || !heights || !pitches || !order) {
+        free(entries);
+        free(heights);
+        free(pitches);
+        free(order);
+        return 1;
+    }
+
+    HeightMap H = height_map_from_tuning(T);
+    for (int i = 0; i < len; i++)
+        entries[i] = (IndexEntry){pitch_height(arr[i], H), arr[i], i};
+    qsort(entries, len, sizeof(IndexEntry), index_entry_compare);
+
+    // A candidate with the same height and steps as an earlier one can never
+    // win a query, so only the first of each is kept.
+    int n = 0;
+    for (int i = 0; i < len; i++) {
+        if (n > 0 && heights[n - 1] == entries[i].height &&
+            steps_between(pitches[n - 1], entries[i].p) == 0)
+            continue;
+        heights[n] = entries[i].height;
+        pitches[n] = entries[i].p;
+        order[n] = entries[i].order;
+        n++;
+    }
+    free(entries);
+
+    *out = (NearestIndex){.H = H,
+                          .len = n,
+                          .heights = heights,
+                          .pitches = pitches,
+                          .order = order};
+    return 0;
+}
+
+void nearest_index_destroy(NearestIndex *ix) {
+    free(ix->heights);
+    free(ix->pitches);
+    free(ix->order);
+    ix->heights = NULL;
+    ix->pitches = NULL;
+    ix->order = NULL;
+    ix->len = 0;
+}
+
+// First position in [lo, hi) whose height is >= height.
+static int lower_height(const NearestIndex *ix, int lo, int hi,
+                        long long height) {
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (ix->heights[mid] < height)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// Within the run [lo, hi) of equal heights, the position whose steps are
+// closest to p's, with ties going to the earlier candidate.
+static int closest_in_run(const NearestIndex *ix, int lo, int hi, Pitch p) {
+    int steps = p.w + p.h;
+    int a = lo, b = hi;
+    while (a < b) {
+        int mid = a + (b - a) / 2;
+        if (ix->pitches[mid].w + ix->pitches[mid].h < steps)
+            a = mid + 1;
+        else
+            b = mid;
+    }
+    if (a == hi)
+        return a - 1;
+    if (a == lo)
+        return a;
+    int above = abs(steps_between(p, ix->pitches[a]));
+    int below = abs(steps_between(p, ix->pitches[a - 1]));
+    if (above != below)
+        return above < below ? a : a - 1;
+    return ix->order[a] < ix->order[a - 1] ? a : a - 1;
+}
+
+int nearest_index_query(const NearestIndex *ix, Pitch p) {
+    if (ix->len <= 0)
+        return -1;
+    long long height = pitch_height(p, ix->H);
+    int pos = lower_height(ix, 0, ix->len, height);
+
+    int above = -1, below = -1;
+    if (pos < ix->len) {
+        long long h = ix->heights[pos];
+        above = closest_in_run(ix, pos, lower_height(ix, pos, ix->len, h + 1),
+                               p);
+    }
+    if (pos > 0) {
+        long long h = ix->heights[pos - 1];
+        below = closest_in_run(ix, lower_height(ix, 0, pos, h), pos, p);
+    }
+
+    if (below < 0)
+        return ix->order[above];
+    if (above < 0)
+        return ix->order[below];
+
+    long long da = ix->heights[above] - height;
+    long long db = height - ix->heights[below];
+    if (da != db)
+        return ix->order[da < db ? above : below];
+    int sa = abs(steps_between(p, ix->pitches[above]));
+    int sb = abs(steps_between(p, ix->pitches[below]));
+    if (sa != sb)
+        return ix->order[sa < sb ? above : below];
+    return ix->order[above] < ix->order[below] ? ix->order[above]
+                                               : ix->order[below];
+}
+
+static const Interval major_ints[7] = {
+    {0, 0}, {1, 0}, {2, 0}, {2, 1}, {3, 1}, {4, 1}, {5, 1},
+};
+
+int interval_from_name(const char *s, Interval *out) {
+    // 1. sign
+    bool negative = false;
+    if (*s == '-') {
+        negative = true;
+        s++;
+    }
+
+    // 2. quality (unadjusted)
+    int quality = 0;
+    while (*s == 'P' || *s == 'p' || *s == 'M' || *s == 'm' || *s == 'b' ||
+           *s == '#' || *s == 'A' || *s == 'a' || *s == 'D' || *s == 'd') {
+        switch (*s) {
+        case 'A':
+        case 'a':
+        case '#':
+            quality++;
+            break;
+        case 'm':
+        case 'b':
+            quality--;
+            break;
+        case 'D':
+        case 'd':
+            if (quality == 0)
+                quality -= 2;
+            else
+                quality--;
+            break;
+        }
+        s++;
+    }
+
+    // 3. generic size / octave
+    char *end;
+    long generic = strtol(s, &end, 10) - 1;
+    if (end == s) {
+        return 1; // no digits found
+    }
+    int simple = generic % 7;
+    int octave = generic / 7;
+
+    // 4. construct output pitch
+    out->w = major_ints[simple].w;
+    out->h = major_ints[simple].h;
+
+    // 5. adjust octave
+    out->w += 5 * octave;
+    out->h += 2 * octave;
+
+    // 6. adjust quality
+    if (quality < 0 && (simple == 0 || simple == 3 || simple == 4))
+        quality++;
+    out->w += quality;
+    out->h -= quality;
+
+    // 7. account for sign
+    if (negative) {
+        out->w = -out->w;
+        out->h = -out->h;
+    }
+
+    return 0;
+}
+
+int interval_from_spn(const char *p_str, const char *q_str, Interval *out) {
+    Pitch p, q;
+    if (pitch_from_spn(p_str, &p))
+        return 1;
+    if (pitch_from_spn(q_str, &q))
+        return 1;
+    out->w = q.w - p.w;
+    out->h = q.h - p.h;
+    return 0;
+}
+
+void interval_name(Interval m, char *out) {
+    size_t cap = 8;
+
+    static const char qualities[5] = {'d', 'm', 'P', 'M', 'A'};
+    int8_t quality = interval_quality(m);
+    int ss = stepspan(m);
+    int8_t generic_size = abs(ss) + 1;
+    char *sign = ss < 0 ? "-" : "";
+    if (quality <= 2 && quality >= -2) {
+        snprintf(out, cap, "%s%c%hhd", sign, qualities[quality + 2],
+                 generic_size);
+    } else if (quality > 0) {
+        snprintf(out, cap, "%s%dA%hhd", sign, quality - 1, generic_size);
+    } else {
+        snprintf(out, cap, "%s%hhdd%hhd", sign, -quality - 1, generic_size);
+    }
+}
+
+int context_from_str(char *s, enum Mode mode, TonalContext *out) {
+    // 1. letter name
+    int letter, chroma;
+    if (*s >= 'A' && *s <= 'G') {
+        letter = *s++ - 'A';
+    } else if (*s >= 'a' && *s <= 'g') {
+        letter = *s++ - 'a';
+    } else {
+        return 1; // invalid
+    }
+    chroma = (letter * 2 + 4) % 7 - 1; // trust me it works.
+
+    // 2. accidental
+    int acc = 0;
+    while (*s == '#' || *s == 'b' || *s == 'x' || *s == 'w') {
+        switch (*s) {
+        case '#':
+            acc++;
+            break;
+        case 'b':
+            acc--;
+            break;
+        case 'x':
+            acc += 2;
+            break;
+        case 'w':
+            acc -= 2;
+            break;
+        }
+        s++;
+    }
+    chroma += 7 * acc;
+
+    out->tonic.letter = letter;
+    out->tonic.accidental = acc;
+    out->mode = mode;
+    out->chroma_offset = mode - chroma;
+
+    return 0;
+}
+
+TonalContext context_from_chroma(int chroma, enum Mode mode) {
+    TonalContext out;
+
+    out.mode = mode;
+    out.chroma_offset = mode - chroma;
+    out.tonic.letter = floor_mod7(chroma * 4 + 2);
+    out.tonic.accidental = floor_div7(chroma + 1);
+
+    return out;
+}
+
+TonalContext context_from_pitch(Pitch p, enum Mode mode) {
+    TonalContext out;
+
+    out.tonic.letter = pitch_letter(p);
+    out.tonic.accidental = pitch_accidental(p);
+    out.mode = mode;
+    out.chroma_offset = mode - pitch_chroma(p);
+
+    return out;
+}
+
+enum Alteration degree_alteration(Pitch p, TonalContext key) {
+    int x = pitch_chroma(p) + key.chroma_offset;
+    if (0 <= x && x < 7)
+        return DIATONIC_DEG;
+    if (7 <= x && x < 12)
+        return RAISED_DEG;
+    if (-5 <= x && x < 0)
+        return LOWERED_DEG;
+    if (x < -5)
+        return FOREIGN_DEG_FLAT;
+    return FOREIGN_DEG_SHARP;
+}
+
+// Each chromatic step (-1, 1) moves the chroma down 7 fifths, so the number of
+// steps to take is how many 7s the chroma is above the diatonic window.
+Pitch snap_diatonic(Pitch p, TonalContext key) {
+    int steps = floor_div7(pitch_chroma(p) + key.chroma_offset);
+    return (Pitch){.w = p.w - steps, .h = p.h + steps};
+}
+
+Pitch transpose_diatonic(Pitch p, int interval, TonalContext key) {
+    return snap_diatonic(transpose_real(p, (Interval){interval, 0}), key);
+}
+
+
+typedef struct tnode {
+    int value;
+    struct tnode *left;
+    struct tnode *right;
+} *PitchClassSet;
+
+static struct tnode *create_tnode(int chroma) {
+    struct tnode *node = malloc(sizeof(struct tnode));
+    node->value = chroma;
+    node->left = node->right = NULL;
+    return node;
+}
+
+void pc_set_destroy(PitchClassSet set) {
+    if (set->left)
+        pc_set_destroy(set->left);
+    if (set->right)
+        pc_set_destroy(set->right);
+    free(set);
+}
+
+void pc_set_insert(PitchClassSet *set, int chroma) {
+    if (*set == NULL)
+        *set = create_tnode(chroma);
+    else if ((*set)->value > chroma)
+        pc_set_insert(&(*set)->left, chroma);
+    else if ((*set)->value < chroma)
+        pc_set_insert(&(*set)->right, chroma);
+}
+
+bool pc_set_contains(PitchClassSet set, int chroma) {
+    if (set == NULL)
+        return false;
+    return set->value == chroma || pc_set_contains(set->left, chroma) ||
+           pc_set_contains(set->right, chroma);
+}
+
+PitchClassSet pc_set_transpose(PitchClassSet set, int offset) {
+    if (set == NULL)
+        return NULL;
+    PitchClassSet new_node = create_tnode(set->value + offset);
+    new_node->left = pc_set_transpose(set->left, offset);
+    new_node->right = pc_set_transpose(set->right, offset);
+
+    return new_node;
+}
+
+PitchClassSet pc_set_invert(PitchClassSet set, int axis) {
+    if (set == NULL)
+        return NULL;
+    PitchClassSet new_node = create_tnode(axis - set->value);
+    new_node->left = pc_set_invert(set->left, axis);
+    new_node->right = pc_set_invert(set->right, axis);
+
+    return new_node;
+}
+
+PitchClassSet pc_set_clone(PitchClassSet set) {
+    if (set == NULL)
+        return NULL;
+    PitchClassSet copy = create_tnode(set->value);
+    copy->left = pc_set_clone(set->left);
+    copy->right = pc_set_clone(set->right);
+    return copy;
+}
+
+void pc_set_insert_all(PitchClassSet *dest, PitchClassSet src) {
+    if (src == NULL)
+        return;
+    pc_set_insert(dest, src->value);
+    pc_set_insert_all(dest, src->left);
+    pc_set_insert_all(dest, src->right);
+}
+
+PitchClassSet pc_set_union(PitchClassSet a, PitchClassSet b) {
+    PitchClassSet result = pc_set_clone(a);
+    pc_set_insert_all(&result, b);
+    return result;
+}
+
+PitchClassSet pc_set_intersection(PitchClassSet a, PitchClassSet b) {
+    if (a == NULL || b == NULL)
+        return NULL;
+
+    PitchClassSet result = NULL;
+    if (pc_set_contains(b, a->value))
+        pc_set_insert(&result, a->value);
+
+    PitchClassSet left = pc_set_intersection(a->left, b);
+    PitchClassSet right = pc_set_intersection(a->right, b);
+
+    result = pc_set_union(result, left);
+    result = pc_set_union(result, right);
+
+    return result;
+}
+
+PitchClassSet pc_set_difference(PitchClassSet a, PitchClassSet b) {
+    if (a == NULL)
+        return NULL;
+
+    PitchClassSet result = NULL;
+
+    if (!pc_set_contains(b, a->value)) {
+        pc_set_insert(&result, a->value);
+    }
+
+    // Recurse left and right
+    PitchClassSet left = pc_set_difference(a->left, b);
+    PitchClassSet right = pc_set_difference(a->right, b);
+
+    // Merge results
+    result = pc_set_union(result, left);
+    result = pc_set_union(result, right);
+
+    return result;
+}
+
+// A fifth outside this range can't produce a well-defined diatonic scale.
+static int fifth_supports_diatonic(double fifth) {
+    return fifth >= (1200.0 * 4 / 7) && fifth <= (1200.0 * 3 / 5);
+}
+
+int tuning_map_from_fifth(double fifth, Pitch ref_pitch, double ref_freq,
+                          TuningMap *out) {
+    if (!fifth_supports_diatonic(fifth))
+        return 1;
+    *out = (TuningMap){.ref_pitch = ref_pitch,
+                       .ref_freq = ref_freq,
+                       .centmap = (Map1D){fifth, 1200}};
+    return 0;
+}
+
+const EDOCatalogEntry *edo_catalog_lookup(int edo) {
+    if (edo < 1 || edo > EDO_CATALOG_MAX)
+        return NULL;
+    return &EDO_CATALOG[edo];
+}
+
+int tuning_map_from_edo(int edo, Pitch ref_pitch, double ref_freq,
+                       TuningMap *out) {
+    const EDOCatalogEntry *entry = edo_catalog_lookup(edo);
+    if (entry)
+        return tuning_map_from_fifth(entry->fifth, ref_pitch, ref_freq, out);
+
+    int fifth_steps = round(log2(1.5) * edo);
+    double fifth = (double)fifth_steps * 1200 / edo;
+    return tuning_map_from_fifth(fifth, ref_pitch, ref_freq, out);
+}
+
+double to_cents(Interval m, TuningMap T) {
+    return map_to_1d(map_to_2d((MapVec){m.w, m.h}, GENERATORS_TO), T.centmap);
+}
+
+// Cents are linear in (w, h), so the matrix is the n x 2 matrix of Intervals
+// times the 2 x k matrix of step sizes. Tunings are taken a tile at a time so
+// their step sizes stay in L1 while every row streams past, and the inner
+// loop runs along a row of out, so it vectorizes.
+void cents_matrix(const Interval m[], const double ref[], int n,
+                  const TuningMap T[], int k, double out[]) {
+    enum { TILE = 64 };
+    double whole[TILE], half[TILE];
+
+    for (int j0 = 0; j0 < k; j0 += TILE) {
+        int jn = k - j0 < TILE ? k - j0 : TILE;
+        for (int j = 0; j < jn; j++) {
+            Map1D steps = map_compose_1d_2d(T[j0 + j].centmap, GENERATORS_TO);
+            whole[j] = steps.m0;
+            half[j] = steps.m1;
+        }
+        for (int i = 0; i < n; i++) {
+            double w = m[i].w, h = m[i].h, r = ref ? ref[i] : 0;
+            double *row = out + (long)i * k + j0;
+            for (int j = 0; j < jn; j++)
+                row[j] = w * whole[j] + h * half[j] - r;
+        }
+    }
+}
+
+double to_ratio(Interval m, TuningMap T) {
+    return pow(2, to_cents(m, T) / 1200);
+}
+
+double to_hz(Pitch p, TuningMap T) {
+    return T.ref_freq * to_ratio(interval_between(T.ref_pitch, p), T);
+}
+
+// Spellings in order of preference, as chromas relative to a key's diatonic
+// window (see degree_alteration): the 7 diatonic notes, then alternately
+// lowered and raised further and further from the window.
+static int spelling_rank(int i) {
+    if (i < 7)
+        return i;
+    return (i - 7) % 2 == 0 ? -((i - 7) / 2 + 1) : 7 + (i - 7) / 2;
+}
+
+// pitch_from_hz chooses between the first 17 spellings, which are exactly the
+// ones degree_alteration doesn't consider foreign. Each repeats every octave,
+// so the candidates within an octave are sorted once by their position in it,
+// and a frequency is rounded to the lattice by reducing it to the octave and
+// finding its two neighbours there: no per-candidate loop at query time.
+// Spellings that sound the same (to within rounding) keep only the preferred
+// one, and preferred spellings win ties between neighbours too.
+typedef struct {
+    int len;
+    Pitch base[17];   // sorted by pos, in the octave above the reference Pitch
+    double pos[17];   // cents of each base Pitch above the reference Pitch
+    int rank[17];     // index in spelling_rank order, lower is preferred
+    double ref_freq;
+    double octave;
+} Quantizer;
+
+static Quantizer quantizer_create(TuningMap T, const TonalContext *key) {
+    // C major's offset is MAJOR - pitch_chroma(C) == MAJOR.
+    int offset = key ? key->chroma_offset : MAJOR;
+    Map1D steps = map_compose_1d_2d(T.centmap, GENERATORS_TO);
+    Quantizer q = {.ref_freq = T.ref_freq, .octave = T.centmap.m1};
+    for (int i = 0; i < 17; i++) {
+        int chroma = spelling_rank(i) - offset;
+        Pitch p = {3 * chroma, chroma};
+        Interval m = interval_between(T.ref_pitch, p);
+        double cents = steps.m0 * m.w + steps.m1 * m.h;
+        int oct = (int)floor(cents / q.octave);
+        p = transpose_real(p, (Interval){-5 * oct, -2 * oct});
+        cents -= oct * q.octave;
+
+        // insert in order of position, dropping enharmonic duplicates
+        int j = q.len;
+        while (j > 0 && q.pos[j - 1] > cents + 1e-6)
+            j--;
+        if (j > 0 && q.pos[j - 1] >= cents - 1e-6)
+            continue; // a preferred spelling already sounds here
+        for (int k = q.len; k > j; k--) {
+            q.base[k] = q.base[k - 1];
+            q.pos[k] = q.pos[k - 1];
+            q.rank[k] = q.rank[k - 1];
+        }
+        q.base[j] = p;
+        q.pos[j] = cents;
+        q.rank[j] = i;
+        q.len++;
+    }
+    return q;
+}
+
+static Pitch quantize(const Quantizer *q, double hz, double *cents) {
+    double c = q->octave * log2(hz / q->ref_freq);
+    double oct = floor(c / q->octave);
+    double x = c - oct * q->octave;
+
+    // the first candidate above x, and the one below it, wrapping around the
+    // octave at either end
+    int lo = 0, hi = q->len;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (q->pos[mid] <= x)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    int above = lo % q->len, below = (lo + q->len - 1) % q->len;
+    double above_oct = oct + (lo == q->len);
+    double below_oct = oct - (lo == 0);
+    double up = q->pos[above] + above_oct * q->octave - c;
+    double down = c - q->pos[below] - below_oct * q->octave;
+
+    // a little slack so that rounding error can't break an enharmonic tie
+    bool take_above = fabs(up - down) <= 1e-6 ? q->rank[above] < q->rank[below]
+                                               : up < down;
+    int best = take_above ? above : below;
+    int n = (int)(take_above ? above_oct : below_oct);
+    if (cents)
+        *cents = take_above ? -up : down;
+    return transpose_real(q->base[best], (Interval){5 * n, 2 * n});
+}
+
+int pitch_from_hz(double hz, TuningMap T, const TonalContext *key, Pitch *out,
+                  double *cents) {
+    if (!(hz > 0) || !isfinite(hz))
+        return 1;
+    Quantizer q = quantizer_create(T, key);
+    *out = quantize(&q, hz, cents);
+    return 0;
+}
+
+int pitches_from_hz(const double hz[], int len, TuningMap T,
+                    const TonalContext *key, Pitch out[], double cents[]) {
+    Quantizer q = quantizer_create(T, key);
+    int skipped = 0;
+    for (int i = 0; i < len; i++) {
+        if (!(hz[i] > 0) || !isfinite(hz[i])) {
+            skipped++;
+            continue;
+        }
+        out[i] = quantize(&q, hz[i], cents ? cents + i : NULL);
+    }
+    return skipped;
+}
+
+int create_edo_map(int edo, EDOMap *out) {
+    const EDOCatalogEntry *entry = edo_catalog_lookup(edo);
+    if (entry) {
+        if (!entry->valid)
+            return 1;
+        *out = entry->map;
+        return 0;
+    }
+
+    // Keep in step with tools/gen_edo_catalog.c.
+    int fifth_steps = (int)round(log2(1.5) * edo);
+    double fifth = (double)fifth_steps * 1200 / edo;
+    if (!fifth_supports_diatonic(fifth))
+        return 1;
+
+    int whole = ((fifth_steps * 2) % edo + edo) % edo;
+    int half = ((fifth_steps * -5) % edo + edo) % edo;
+    *out = (EDOMap){whole, half};
+    return 0;
+}
+
+HeightMap height_map_from_tuning(TuningMap T) {
+    double octave = T.centmap.m1;
+    double x = T.centmap.m0 / octave;
+
+    // Walk the convergents of fifth/octave looking for the smallest EDO whose
+    // fifth matches. Any EDO fifth this close to ours must be a convergent
+    // (Legendre's theorem), so nothing below 1200 notes is missed.
+    long long h2 = 0, h1 = 1, k2 = 1, k1 = 0;
+    double r = x;
+    while (1) {
+        double a = floor(r);
+        long long h = (long long)a * h1 + h2;
+        long long k = (long long)a * k1 + k2;
+        if (k > 1200)
+            break;
+        if (fabs(x * k - h) * octave <= 1e-4 * k)
+            return (HeightMap){.m0 = 2 * h - k,
+                               .m1 = 3 * k - 5 * h,
+                               .scale = k / octave};
+        if (r - a < 1e-12)
+            break;
+        r = 1 / (r - a);
+        h2 = h1, h1 = h;
+        k2 = k1, k1 = k;
+    }
+
+    double scale = 1048576.0; // 2^20 units per cent
+    Map1D steps = map_compose_1d_2d(T.centmap, GENERATORS_TO);
+    return (HeightMap){.m0 = llround(steps.m0 * scale),
+                       .m1 = llround(steps.m1 * scale),
+                       .scale = scale};
+}
+
+int edo_speller_create(int edo, TonalContext key, EDOSpeller *out) {
+    EDOMap map;
+    if (create_edo_map(edo, &map))
+        return 1;
+
+    // Spellings are walked in an unbroken chain of fifths, which reaches
+    // every step exactly once in its first edo links unless the fifth shares a
+    // factor with the EDO, in which case some steps have no spelling at all.
+    int a = 3 * map.m0 + map.m1, b = edo;
+    while (b) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    if (a != 1)
+        return 1;
+
+    Pitch *spellings = malloc(edo * sizeof(Pitch));
+    if (!spellings)
+        return 1;
+    for (int i = 0; i < edo; i++) {
+        int chroma = spelling_rank(i) - key.chroma_offset;
+        Pitch p = {3 * chroma, chroma};
+        int n = pitch_to_number(p, map);
+        int step = (n % edo + edo) % edo;
+        int octaves = (step - n) / edo;
+        spellings[step] = transpose_real(p, (Interval){5 * octaves,
+                                                       2 * octaves});
+    }
+
+    *out = (EDOSpeller){.edo = edo, .map = map, .spellings = spellings};
+    return 0;
+}
+
+void edo_speller_destroy(EDOSpeller *s) {
+    free(s->spellings);
+    s->spellings = NULL;
+}
+
+int keyboard_layout_create(Map2D layout, Pitch anchor, MapVec anchor_pos,
+                           KeyboardLayout *out) {
+    double det = layout.m00 * layout.m11 - layout.m01 * layout.m10;
+    if (det == 0 || !isfinite(det))
+        return 1;
+    *out = (KeyboardLayout){
+        .to_screen = layout,
+        .from_screen = (Map2D){layout.m11 / det, -layout.m01 / det,
+                               -layout.m10 / det, layout.m00 / det},
+        .anchor = anchor,
+        .anchor_pos = anchor_pos,
+    };
+    return 0;
+}
+
+void keyboard_key_centers(const KeyboardLayout *L, const Pitch p[], int len,
+                          double x[], double y[]) {
+    Map2D T = L->to_screen;
+    double x0 = L->anchor_pos.x - T.m00 * L->anchor.w - T.m01 * L->anchor.h;
+    double y0 = L->anchor_pos.y - T.m10 * L->anchor.w - T.m11 * L->anchor.h;
+    for (int i = 0; i < len; i++) {
+        x[i] = x0 + T.m00 * p[i].w + T.m01 * p[i].h;
+        y[i] = y0 + T.m10 * p[i].w + T.m11 * p[i].h;
+    }
+}
+
+void keyboard_key_vertices(const KeyboardLayout *L, const Pitch p[], int len,
+                           double x[], double y[]) {
+    Map2D T = L->to_screen;
+    // Corners sit half a lattice step away along each basis vector.
+    double ax = T.m00 / 2, ay = T.m10 / 2;
+    double bx = T.m01 / 2, by = T.m11 / 2;
+    const double dx[4] = {-ax - bx, ax - bx, ax + bx, -ax + bx};
+    const double dy[4] = {-ay - by, ay - by, ay + by, -ay + by};
+    for (int i = 0; i < len; i++) {
+        MapVec c = keyboard_key_center(L, p[i]);
+        for (int k = 0; k < 4; k++) {
+            x[4 * i + k] = c.x + dx[k];
+            y[4 * i + k] = c.y + dy[k];
+        }
+    }
+}
+
+// Screen positions map back to fractional Pitch vectors, and rounding both
+// coordinates picks the parallelogram the position falls in.
+Pitch keyboard_hit_test(const KeyboardLayout *L, double x, double y) {
+    MapVec v = map_to_2d(
+        (MapVec){x - L->anchor_pos.x, y - L->anchor_pos.y}, L->from_screen);
+    return (Pitch){L->anchor.w + (int)floor(v.x + 0.5),
+                   L->anchor.h + (int)floor(v.y + 0.5)};
+}
+
+void keyboard_hit_test_batch(const KeyboardLayout *L, const double x[],
+                             const double y[], int len, Pitch out[]) {
+    for (int i = 0; i < len; i++)
+        out[i] = keyboard_hit_test(L, x[i], y[i]);
+}
+
+int keyboard_visible_keys(const KeyboardLayout *L, double x0, double y0,
+                          double x1, double y1, Pitch out[], int cap) {
+    double xlo = fmin(x0, x1), xhi = fmax(x0, x1);
+    double ylo = fmin(y0, y1), yhi = fmax(y0, y1);
+
+    // The rectangle's corners bound the Pitch vectors worth checking.
+    double wlo = INFINITY, whi = -INFINITY, hlo = INFINITY, hhi = -INFINITY;
+    const double cx[4] = {xlo, xhi, xhi, xlo}, cy[4] = {ylo, ylo, yhi, yhi};
+    for (int k = 0; k < 4; k++) {
+        MapVec v = map_to_2d(
+            (MapVec){cx[k] - L->anchor_pos.x, cy[k] - L->anchor_pos.y},
+            L->from_screen);
+        wlo = fmin(wlo, v.x), whi = fmax(whi, v.x);
+        hlo = fmin(hlo, v.y), hhi = fmax(hhi, v.y);
+    }
+
+    int count = 0;
+    for (int h = (int)ceil(hlo); h <= (int)floor(hhi); h++) {
+        for (int w = (int)ceil(wlo); w <= (int)floor(whi); w++) {
+            Pitch p = {L->anchor.w + w, L->anchor.h + h};
+            MapVec c = keyboard_key_center(L, p);
+            if (c.x < xlo || c.x > xhi || c.y < ylo || c.y > yhi)
+                continue;
+            if (count < cap)
+                out[count] = p;
+            count++;
+        }
+    }
+    return count;
+}
+
+// Every Interval is x fifths plus y octaves (see GENERATORS_TO), so its error
+// in a tuning with a fifth of F cents is linear in F:
+//     e = x * F + (1200 * y - just)
+// Least squares error is then a quadratic in F, fully described by a handful
+// of sums that only need computing once.
+typedef struct {
+    double xx, xc, cc, total;
+} FitSums;
+
+static double fit_offset(Interval m, double just) {
+    return 1200 * map_to_2d((MapVec){m.w, m.h}, GENERATORS_TO).y - just;
+}
+
+static double fit_chroma(Interval m) {
+    return map_to_2d((MapVec){m.w, m.h}, GENERATORS_TO).x;
+}
+
+static FitSums fit_sums(const Interval m[], const double just[],
+                        const double weight[], int len) {
+    FitSums s = {0, 0, 0, 0};
+    for (int i = 0; i < len; i++) {
+        double w = weight ? weight[i] : 1;
+        double x = fit_chroma(m[i]), c = fit_offset(m[i], just[i]);
+        s.xx += w * x * x;
+        s.xc += w * x * c;
+        s.cc += w * c * c;
+        s.total += w;
+    }
+    return s;
+}
+
+static double least_squares_error(FitSums s, double fifth) {
+    double e = (fifth * fifth * s.xx + 2 * fifth * s.xc + s.cc) / s.total;
+    return sqrt(e > 0 ? e : 0);
+}
+
+static double minimax_error(const Interval m[], const double just[],
+                            const double weight[], int len, double fifth) {
+    double worst = 0;
+    for (int i = 0; i < len; i++) {
+        if (weight && !(weight[i] > 0))
+            continue;
+        double e = fabs(fit_chroma(m[i]) * fifth + fit_offset(m[i], just[i]));
+        worst = e > worst ? e : worst;
+    }
+    return worst;
+}
+
+int optimal_fifth(const Interval m[], const double just[],
+                  const double weight[], int len, enum FitCriterion criterion,
+                  double *out, double *error) {
+    FitSums s = fit_sums(m, just, weight, len);
+    if (!(s.xx > 0))
+        return 1;
+
+    double lo = 1200.0 * 4 / 7, hi = 1200.0 * 3 / 5;
+    double fifth;
+    if (criterion == LEAST_SQUARES) {
+        // Minimum of the quadratic, clamped to the diatonic range.
+        fifth = -s.xc / s.xx;
+        fifth = fifth < lo ? lo : fifth > hi ? hi : fifth;
+    } else {
+        // The worst error is convex in the fifth, so ternary search finds
+        // its minimum; 200 rounds shrink the range below a double's
+        // precision.
+        for (int i = 0; i < 200; i++) {
+            double a = lo + (hi - lo) / 3, b = hi - (hi - lo) / 3;
+            if (minimax_error(m, just, weight, len, a) <
+                minimax_error(m, just, weight, len, b))
+                hi = b;
+            else
+                lo = a;
+        }
+        fifth = (lo + hi) / 2;
+    }
+
+    *out = fifth;
+    if (error)
+        *error = criterion == LEAST_SQUARES
+                     ? least_squares_error(s, fifth)
+                     : minimax_error(m, just, weight, len, fifth);
+    return 0;
+}
+
+// optimal_edo's scan, split into chunks of the EDO range that may run on
+// separate threads. Each chunk keeps its own best, and the bests are compared
+// in order afterwards so ties still go to the smaller EDO.
+typedef struct {
+    const Interval *m;
+    const double *just, *weight;
+    int len, min_edo;
+    enum FitCriterion criterion;
+    FitSums s;
+    int best[PARALLEL_MAX_THREADS]; // per chunk
+    double best_error[PARALLEL_MAX_THREADS];
+} EDOScan;
+
+static void edo_scan(void *ctx, int chunk, long start, long end) {
+    EDOScan *scan = ctx;
+    int best = 0;
+    double best_error = INFINITY;
+    for (int edo = scan->min_edo + start; edo < scan->min_edo + end; edo++) {
+        double fifth;
+        const EDOCatalogEntry *entry = edo_catalog_lookup(edo);
+        if (entry) {
+            if (!entry->valid)
+                continue;
+            fifth = entry->fifth;
+        } else {
+            EDOMap T;
+            if (create_edo_map(edo, &T))
+                continue;
+            fifth = (double)(3 * T.m0 + T.m1) * 1200 / edo;
+        }
+
+        double e = scan->criterion == LEAST_SQUARES
+                       ? least_squares_error(scan->s, fifth)
+                       : minimax_error(scan->m, scan->just, scan->weight,
+                                       scan->len, fifth);
+        if (e < best_error) {
+            best = edo;
+            best_error = e;
+        }
+    }
+    scan->best[chunk] = best;
+    scan->best_error[chunk] = best_error;
+}
+
+int optimal_edo(const Interval m[], const double just[], const double weight[],
+                int len, int min_edo, int max_edo, enum FitCriterion criterion,
+                int *out, double *error) {
+    FitSums s = fit_sums(m, just, weight, len);
+    if (!(s.xx > 0))
+        return 1;
+
+    EDOScan scan = {.m = m,
+                    .just = just,
+                    .weight = weight,
+                    .len = len,
+                    .min_edo = min_edo < 1 ? 1 : min_edo,
+                    .criterion = criterion,
+                    .s = s};
+    long edos = max_edo >= scan.min_edo ? max_edo - scan.min_edo + 1 : 0;
+    // enough EDOs per thread to be worth starting it: about 2^16 Intervals
+    long grain =
+        criterion == LEAST_SQUARES ? 1 << 16 : (1 << 16) / (len + 1) + 1;
+    parallel_for(edos, grain, edo_scan, &scan);
+
+    int best = 0;
+    double best_error = INFINITY;
+    for (int i = 0; i < parallel_chunks(edos, grain); i++) {
+        if (scan.best[i] && scan.best_error[i] < best_error) {
+            best = scan.best[i];
+            best_error = scan.best_error[i];
+        }
+    }
+    if (!best)
+        return 1;
+
+    *out = best;
+    if (error)
+        *error = best_error;
+    return 0;
+}
+
+// An interval of x fifths is read as a fifths and b major thirds, x = a + 4b,
+// choosing b so that |a| <= 2 (ties toward the sharper spelling with fewer
+// thirds, so 6 fifths is 45/32 rather than 64/45). Octaves are pure in both
+// tunings, so only the fifths and thirds contribute to the offset.
+static double adaptive_target(int x, double fifth_error, double third_error) {
+    int b = (x < 0 ? -1 : 1) * ((abs(x) + 1) / 4);
+    return (x - 4 * b) * fifth_error + b * third_error;
+}
+
+int adaptive_tuner_create(TuningMap T, double max_drift, AdaptiveTuner *out) {
+    if (!(max_drift >= 0) || isinf(max_drift))
+        return 1;
+    out->fifth_error = 1200 * log2(3.0 / 2) - to_cents((Interval){3, 1}, T);
+    out->third_error = 1200 * log2(5.0 / 4) - to_cents((Interval){2, 0}, T);
+    for (int x = -ADAPTIVE_MAX_CHROMA; x <= ADAPTIVE_MAX_CHROMA; x++)
+        out->target[ADAPTIVE_MAX_CHROMA + x] =
+            adaptive_target(x, out->fifth_error, out->third_error);
+    out->max_drift = max_drift;
+    adaptive_tuner_reset(out);
+    return 0;
+}
+
+void adaptive_tuner_reset(AdaptiveTuner *t) {
+    t->drift = 0;
+    t->len = 0;
+}
+
+// Minimising the squared error over every pair of notes has a closed form: each
+// note's offset is the mean of the targets to every note in the chord (itself
+// included, with target 0), plus a shift common to the whole chord. Targets
+// are odd in x, so before shifting the offsets average to 0 and the shift is
+// exactly the chord's drift.
+int adaptive_tuner_update(AdaptiveTuner *t, const Pitch chord[], int len,
+                          double out[]) {
+    if (len < 0 || len > ADAPTIVE_MAX_VOICES)
+        return 1;
+
+    int chroma[ADAPTIVE_MAX_VOICES];
+    for (int i = 0; i < len; i++)
+        chroma[i] = pitch_chroma(chord[i]);
+
+    for (int i = 0; i < len; i++) {
+        double sum = 0;
+        for (int j = 0; j < len; j++) {
+            int x = chroma[i] - chroma[j];
+            sum += abs(x) <= ADAPTIVE_MAX_CHROMA
+                       ? t->target[ADAPTIVE_MAX_CHROMA + x]
+                       : adaptive_target(x, t->fifth_error, t->third_error);
+        }
+        out[i] = sum / len;
+    }
+
+    // Hold common tones where they were, on average, or failing that keep the
+    // drift of the previous chord.
+    double shift = 0;
+    int common = 0;
+    for (int i = 0; i < len; i++) {
+        for (int j = 0; j < t->len; j++) {
+            if (pitches_equal(chord[i], t->held[j])) {
+                shift += t->offset[j] - out[i];
+                common++;
+                break;
+            }
+        }
+    }
+    shift = common ? shift / common : t->drift;
+    if (shift > t->max_drift)
+        shift = t->max_drift;
+    if (shift < -t->max_drift)
+        shift = -t->max_drift;
+
+    for (int i = 0; i < len; i++) {
+        out[i] += shift;
+        t->held[i] = chord[i];
+        t->offset[i] = out[i];
+    }
+    t->drift = shift;
+    t->len = len;
+    return 0;
+}
+
+int osc_bank_create(TuningMap T, double sample_rate, int voices, OscBank *out) {
+    if (voices <= 0 || !(sample_rate > 0) || isinf(sample_rate))
+        return 1;
+
+    double *inc = calloc(voices, sizeof(double));
+    double *target = calloc(voices, sizeof(double));
+    double *ratio = malloc(voices * sizeof(double));
+    int *remaining = calloc(voices, sizeof(int));
+    if (!inc || !target || !ratio || !remaining) {
+        free(inc);
+        free(target);
+        free(ratio);
+        free(remaining);
+        return 1;
+    }
+    for (int v = 0; v < voices; v++)
+        ratio[v] = 1;
+
+    *out = (OscBank){.T = T,
+                     .sample_rate = sample_rate,
+                     .len = voices,
+                     .inc = inc,
+                     .target = target,
+                     .ratio = ratio,
+                     .remaining = remaining};
+    return 0;
+}
+
+void osc_bank_destroy(OscBank *b) {
+    free(b->inc);
+    free(b->target);
+    free(b->ratio);
+    free(b->remaining);
+}
+
+int osc_bank_set(OscBank *b, int voice, Pitch p) {
+    return osc_bank_glide(b, voice, p, 0);
+}
+
+int osc_bank_glide(OscBank *b, int voice, Pitch p, int samples) {
+    if (voice < 0 || voice >= b->len)
+        return 1;
+
+    double target = to_hz(p, b->T) / b->sample_rate;
+    b->target[voice] = target;
+    if (samples <= 0 || b->inc[voice] == 0) {
+        b->inc[voice] = target;
+        b->ratio[voice] = 1;
+        b->remaining[voice] = 0;
+    } else {
+        b->ratio[voice] = pow(target / b->inc[voice], 1.0 / samples);
+        b->remaining[voice] = samples;
+    }
+    return 0;
+}
+
+// The block is cut wherever a glide ends. Within each piece every voice takes
+// the same path, inc *= ratio (steady voices have a ratio of exactly 1), so the
+// inner loop runs across contiguous voice arrays and vectorizes. Glides that
+// end on a cut are snapped onto their target, so rounding never accumulates.
+void osc_bank_render(OscBank *b, int frames, double out[]) {
+    int n = b->len;
+    double *inc = b->inc;
+    const double *ratio = b->ratio;
+
+    for (int i = 0; i < frames;) {
+        int piece = frames - i;
+        for (int v = 0; v < n; v++)
+            if (b->remaining[v] && b->remaining[v] < piece)
+                piece = b->remaining[v];
+
+        for (int end = i + piece; i < end; i++) {
+            double *row = out + (long)i * n;
+            for (int v = 0; v < n; v++) {
+                inc[v] *= ratio[v];
+                row[v] = inc[v];
+            }
+        }
+
+        for (int v = 0; v < n; v++) {
+            if (!b->remaining[v])
+                continue;
+            b->remaining[v] -= piece;
+            if (!b->remaining[v]) {
+                inc[v] = b->target[v];
+                b->ratio[v] = 1;
+                out[(long)(i - 1) * n + v] = inc[v];
+            }
+        }
+    }
+}
+
+int tuning_morph_create(TuningMap from, TuningMap to, int blocks, int voices,
+                        TuningMorph *out) {
+    if (blocks < 0 || voices <= 0)
+        return 1;
+
+    double *hz = calloc(voices, sizeof(double));
+    double *step = malloc(voices * sizeof(double));
+    double *target = calloc(voices, sizeof(double));
+    if (!hz || !step || !target) {
+        free(hz);
+        free(step);
+        free(target);
+        return 1;
+    }
+    for (int v = 0; v < voices; v++)
+        step[v] = 1;
+
+    *out = (TuningMorph){.from = from,
+                         .to = to,
+                         .blocks = blocks,
+                         .elapsed = 0,
+                         .len = voices,
+                         .hz = hz,
+                         .step = step,
+                         .target = target};
+    return 0;
+}
+
+void tuning_morph_destroy(TuningMorph *m) {
+    free(m->hz);
+    free(m->step);
+    free(m->target);
+}
+
+// A voice's log-frequency moves the same distance every block, so its
+// frequency is multiplied by the same factor every block: the per-block
+// interval between its two tunings.
+int tuning_morph_voice_on(TuningMorph *m, int voice, Pitch p) {
+    if (voice < 0 || voice >= m->len)
+        return 1;
+
+    double target = to_hz(p, m->to);
+    m->target[voice] = target;
+    if (m->elapsed == m->blocks) {
+        m->hz[voice] = target;
+        m->step[voice] = 1;
+        return 0;
+    }
+    double octaves = log2(target / to_hz(p, m->from));
+    m->hz[voice] =
+        target * exp2(octaves * (m->elapsed - m->blocks) / m->blocks);
+    m->step[voice] = exp2(octaves / m->blocks);
+    return 0;
+}
+
+int tuning_morph_voice_off(TuningMorph *m, int voice) {
+    if (voice < 0 || voice >= m->len)
+        return 1;
+    m->hz[voice] = 0;
+    m->step[voice] = 1;
+    m->target[voice] = 0;
+    return 0;
+}
+
+void tuning_morph_advance(TuningMorph *m, double hz[]) {
+    int n = m->len;
+    if (m->elapsed < m->blocks && ++m->elapsed == m->blocks) {
+        for (int v = 0; v < n; v++) {
+            m->hz[v] = m->target[v];
+            m->step[v] = 1;
+        }
+    } else {
+        for (int v = 0; v < n; v++)
+            m->hz[v] *= m->step[v];
+    }
+    for (int v = 0; v < n; v++)
+        hz[v] = m->hz[v];
+}
+
+// WAV fields are little-endian whatever the host is, so they're written a
+// byte at a time.
+static void wav_put16(unsigned char *buf, uint16_t x) {
+    buf[0] = x & 0xff;
+    buf[1] = x >> 8;
+}
+
+static void wav_put32(unsigned char *buf, uint32_t x) {
+    wav_put16(buf, x & 0xffff);
+    wav_put16(buf + 2, x >> 16);
+}
+
+static int wav_write_header(WavWriter *w) {
+    uint32_t data_bytes = (uint32_t)(w->frames * w->channels * 2);
+    unsigned char h[44] = "RIFF\0\0\0\0WAVEfmt ";
+    wav_put32(h + 4, 36 + data_bytes);
+    wav_put32(h + 16, 16);
+    wav_put16(h + 20, 1); // PCM
+    wav_put16(h + 22, w->channels);
+    wav_put32(h + 24, w->sample_rate);
+    wav_put32(h + 28, w->sample_rate * w->channels * 2);
+    wav_put16(h + 32, w->channels * 2);
+    wav_put16(h + 34, 16);
+    h[36] = 'd', h[37] = 'a', h[38] = 't', h[39] = 'a';
+    wav_put32(h + 40, data_bytes);
+    return fseek(w->file, 0, SEEK_SET) != 0 ||
+           fwrite(h, 1, sizeof(h), w->file) != sizeof(h);
+}
+
+int wav_writer_open(const char *path, int channels, int sample_rate,
+                    WavWriter *out) {
+    if (channels <= 0 || sample_rate <= 0)
+        return 1;
+    FILE *file = fopen(path, "wb");
+    if (!file)
+        return 1;
+    *out = (WavWriter){.file = file,
+                       .channels = channels,
+                       .sample_rate = sample_rate,
+                       .frames = 0};
+    if (wav_write_header(out)) {
+        fclose(file);
+        return 1;
+    }
+    return 0;
+}
+
+int wav_writer_write(WavWriter *w, const float samples[], long frames) {
+    unsigned char buf[4096];
+    long len = frames * w->channels;
+    for (long i = 0; i < len;) {
+        int n = 0;
+        for (; n < (int)sizeof(buf) && i < len; n += 2, i++) {
+            float x = samples[i];
+            // NaN fails every comparison, so it's silenced before clipping
+            x = x != x ? 0 : x > 1 ? 1 : x < -1 ? -1 : x;
+            wav_put16(buf + n, (uint16_t)(int16_t)(x * 32767));
+        }
+        if (fwrite(buf, 1, n, w->file) != (size_t)n)
+            return 1;
+    }
+    w->frames += frames;
+    return 0;
+}
+
+int wav_writer_close(WavWriter *w) {
+    int err = wav_write_header(w);
+    return fclose(w->file) != 0 || err;
+}
+
+static uint32_t wav_get16(const unsigned char *buf) {
+    return buf[0] | buf[1] << 8;
+}
+
+static uint32_t wav_get32(const unsigned char *buf) {
+    return wav_get16(buf) | wav_get16(buf + 2) << 16;
+}
+
+// Decodes one little-endian sample to the range -1 to 1.
+static double wav_sample(const unsigned char *b, int format, int bits) {
+    if (format == 3) {
+        union {
+            uint32_t i;
+            float f;
+        } x32 = {wav_get32(b)};
+        if (bits == 32)
+            return x32.f;
+        union {
+            uint64_t i;
+            double f;
+        } x64 = {x32.i | (uint64_t)wav_get32(b + 4) << 32};
+        return x64.f;
+    }
+    switch (bits) {
+    case 8:
+        return (b[0] - 128) / 128.0;
+    case 16:
+        return (int16_t)wav_get16(b) / 32768.0;
+    case 24:
+        return (int32_t)(wav_get32((unsigned char[4]){0, b[0], b[1], b[2]})) /
+               2147483648.0;
+    default:
+        return (int32_t)wav_get32(b) / 2147483648.0;
+    }
+}
+
+int wav_read(const char *path, AudioBuffer *out) {
+    FILE *file = fopen(path, "rb");
+    if (!file)
+        return 1;
+
+    unsigned char h[12], chunk[8], fmt[40];
+    int format = 0, channels = 0, sample_rate = 0, bits = 0;
+    unsigned char *data = NULL;
+    uint32_t data_bytes = 0;
+    if (fread(h, 1, 12, file) != 12 || memcmp(h, "RIFF", 4) ||
+        memcmp(h + 8, "WAVE", 4)) {
+        fclose(file);
+        return 1;
+    }
+
+    // Chunks can come in any order, and unknown ones are skipped. Chunk sizes
+    // are padded to an even number of bytes. The data chunk is only located
+    // here, and read once the fmt chunk has been seen, wherever that is.
+    long data_at = -1;
+    bool have_fmt = false;
+    while (!(have_fmt && data_at >= 0) && fread(chunk, 1, 8, file) == 8) {
+        uint32_t size = wav_get32(chunk + 4);
+        long next = ftell(file) + size + (size & 1);
+        if (!memcmp(chunk, "fmt ", 4) && size >= 16 && !have_fmt) {
+            uint32_t n = size < sizeof(fmt) ? size : sizeof(fmt);
+            if (fread(fmt, 1, n, file) != n)
+                break;
+            format = wav_get16(fmt);
+            channels = wav_get16(fmt + 2);
+            sample_rate = wav_get32(fmt + 4);
+            bits = wav_get16(fmt + 14);
+            if (format == 0xfffe && n >= 26) // WAVE_FORMAT_EXTENSIBLE
+                format = wav_get16(fmt + 24);
+            have_fmt = true;
+        } else if (!memcmp(chunk, "data", 4) && data_at < 0) {
+            data_at = ftell(file);
+            data_bytes = size;
+        }
+        if (fseek(file, next, SEEK_SET))
+            break;
+    }
+    if (have_fmt && channels && data_at >= 0 &&
+        !fseek(file, data_at, SEEK_SET)) {
+        data = malloc(data_bytes ? data_bytes : 1);
+        if (data && fread(data, 1, data_bytes, file) != data_bytes) {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+
+    bool supported = (format == 1 && (bits == 8 || bits == 16 || bits == 24 ||
+                                      bits == 32)) ||
+                     (format == 3 && (bits == 32 || bits == 64));
+    if (!data || !supported || sample_rate <= 0) {
+        free(data);
+        return 1;
+    }
+
+    int frame_bytes = channels * bits / 8;
+    long frames = data_bytes / frame_bytes;
+    float *samples = malloc((frames ? frames : 1) * sizeof(float));
+    if (!samples) {
+        free(data);
+        return 1;
+    }
+    for (long i = 0; i < frames; i++) {
+        double x = 0;
+        for (int c = 0; c < channels; c++)
+            x += wav_sample(data + i * frame_bytes + c * bits / 8, format,
+                            bits);
+        samples[i] = x / channels;
+    }
+    free(data);
+
+    *out = (AudioBuffer){
+        .samples = samples, .frames = frames, .sample_rate = sample_rate};
+    return 0;
+}
+
+void audio_buffer_destroy(AudioBuffer *a) { free(a->samples); }
+
+// Samples are rendered in blocks, each starting from a phase computed from
+// scratch, so the loop inside a block carries no dependency between samples.
+// Blocks are counted from the note's start, so a sample comes out the same
+// however the range around it is split.
+enum { RENDER_BLOCK = 256 };
+
+// Ranges longer than this are split between threads (see parallel.h).
+enum { RENDER_SLICE = 16384 };
+
+// note_renderer_write_wav renders this many samples at a time, enough to give
+// every thread a slice.
+enum { RENDER_WAV_BLOCK = 1 << 18 };
+
+static const double RENDER_TAU = 6.283185307179586;
+
+void wavetable_harmonics(float table[], int len, const double amps[],
+                         int harmonics) {
+    for (int i = 0; i < len; i++) {
+        double x = 0;
+        for (int k = 0; k < harmonics; k++)
+            x += amps[k] * sin(RENDER_TAU * (k + 1) * i / len);
+        table[i] = x;
+    }
+}
+
+typedef struct {
+    long start;
+    int order;
+} RenderOnset;
+
+static int render_onset_compare(const void *a, const void *b) {
+    const RenderOnset *x = a, *y = b;
+    if (x->start != y->start)
+        return x->start > y->start ? 1 : -1;
+    return x->order - y->order;
+}
+
+int note_renderer_create(const NoteEvent notes[], int len, TuningMap T,
+                         int sample_rate, const float table[], int table_len,
+                         NoteRenderer *out) {
+    if (sample_rate <= 0 || table_len <= 0 || (table_len & (table_len - 1)))
+        return 1;
+
+    int n = len > 0 ? len : 0;
+    RenderOnset *onsets = malloc((n ? n : 1) * sizeof(RenderOnset));
+    float *copy = malloc(table_len * sizeof(float));
+    long *start = malloc((n ? n : 1) * sizeof(long));
+    long *length = malloc((n ? n : 1) * sizeof(long));
+    double *inc = malloc((n ? n : 1) * sizeof(double));
+    float *gain = malloc((n ? n : 1) * sizeof(float));
+    if (!onsets || !copy || !start || !length || !inc || !gain) {
+        free(onsets);
+        free(copy);
+        free(start);
+        free(length);
+        free(inc);
+        free(gain);
+        return 1;
+    }
+    memcpy(copy, table, table_len * sizeof(float));
+
+    for (int i = 0; i < n; i++)
+        onsets[i] = (RenderOnset){lround(notes[i].onset * sample_rate), i};
+    qsort(onsets, n, sizeof(RenderOnset), render_onset_compare);
+
+    long longest = 0;
+    for (int i = 0; i < n; i++) {
+        const NoteEvent *e = notes + onsets[i].order;
+        long samples = lround(e->duration * sample_rate);
+        start[i] = onsets[i].start;
+        length[i] = samples > 0 ? samples : 0;
+        inc[i] = to_hz(e->pitch, T) * table_len / sample_rate;
+        gain[i] = e->velocity;
+        longest = length[i] > longest ? length[i] : longest;
+    }
+    free(onsets);
+
+    *out = (NoteRenderer){.sample_rate = sample_rate,
+                          .table_len = table_len,
+                          .table = copy,
+                          .len = n,
+                          .start = start,
+                          .length = length,
+                          .inc = inc,
+                          .gain = gain,
+                          .longest = longest};
+    return 0;
+}
+
+void note_renderer_destroy(NoteRenderer *r) {
+    free(r->table);
+    free(r->start);
+    free(r->length);
+    free(r->inc);
+    free(r->gain);
+}
+
+long note_renderer_frames(const NoteRenderer *r) {
+    long end = 0;
+    for (int i = 0; i < r->len; i++)
+        if (r->start[i] + r->length[i] > end)
+            end = r->start[i] + r->length[i];
+    return end;
+}
+
+// Adds samples [from, to) of note i, all within the note, to out, where out[0]
+// is sample origin.
+static void render_note(const NoteRenderer *r, int i, long from, long to,
+                        long origin, float out[]) {
+    int mask = r->table_len - 1;
+    const float *table = r->table;
+    double inc = r->inc[i];
+    float fade = 0.005f * r->sample_rate;
+    float length = r->length[i];
+
+    for (long b = from; b < to;) {
+        long t0 = b - r->start[i];
+        int skip = t0 % RENDER_BLOCK;
+        int n = to - b < RENDER_BLOCK - skip ? to - b : RENDER_BLOCK - skip;
+        double phase = fmod(inc * (t0 - skip), r->table_len);
+        float *o = out + (b - origin);
+        for (int k = 0; k < n; k++) {
+            double ph = phase + (skip + k) * inc;
+            long idx = (long)ph;
+            float frac = ph - idx;
+            float x0 = table[idx & mask], x1 = table[(idx + 1) & mask];
+            float t = t0 + k;
+            float env = fminf(1, fminf(t, length - t) / fade);
+            o[k] += r->gain[i] * env * (x0 + frac * (x1 - x0));
+        }
+        b += n;
+    }
+}
+
+// Notes are sorted by onset, so the notes sounding in a range are found by
+// binary search, starting from the latest onset that could still reach it.
+static void render_range(const NoteRenderer *r, long start, long frames,
+                         float out[]) {
+    long end = start + frames;
+    for (long i = 0; i < frames; i++)
+        out[i] = 0;
+
+    int lo = 0, hi = r->len;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (r->start[mid] + r->longest <= start)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    for (int i = lo; i < r->len && r->start[i] < end; i++) {
+        long from = r->start[i] > start ? r->start[i] : start;
+        long to = r->start[i] + r->length[i];
+        to = to < end ? to : end;
+        if (from < to)
+            render_note(r, i, from, to, start, out);
+    }
+}
+
+typedef struct {
+    const NoteRenderer *r;
+    long start;
+    float *out;
+} RenderSlices;
+
+static void render_slice(void *ctx, int chunk, long start, long end) {
+    (void)chunk;
+    RenderSlices *s = ctx;
+    render_range(s->r, s->start + start, end - start, s->out + start);
+}
+
+void note_renderer_render(const NoteRenderer *r, long start, long frames,
+                          float out[]) {
+    RenderSlices s = {r, start, out};
+    parallel_for(frames > 0 ? frames : 0, RENDER_SLICE, render_slice, &s);
+}
+
+int note_renderer_write_wav(const NoteRenderer *r, const char *path) {
+    WavWriter w;
+    if (wav_writer_open(path, 1, r->sample_rate, &w))
+        return 1;
+
+    float *block = malloc(RENDER_WAV_BLOCK * sizeof(float));
+    if (!block) {
+        wav_writer_close(&w);
+        return 1;
+    }
+    long frames = note_renderer_frames(r);
+    int err = 0;
+    for (long i = 0; i < frames && !err; i += RENDER_WAV_BLOCK) {
+        long n = frames - i < RENDER_WAV_BLOCK ? frames - i : RENDER_WAV_BLOCK;
+        note_renderer_render(r, i, n, block);
+        err = wav_writer_write(&w, block, n);
+    }
+    free(block);
+    return wav_writer_close(&w) || err;
+}
+
+int zone_map_create(const Pitch roots[], int len, TuningMap T, Pitch lo,
+                    Pitch hi, ZoneMap *out) {
+    long long width = (long long)hi.w - lo.w + 1;
+    long long height = (long long)hi.h - lo.h + 1;
+    // zone_map_lookup indexes the table with a long
+    if (len <= 0 || width <= 0 || height <= 0 || width > INT_MAX ||
+        height > INT_MAX || width * height > LONG_MAX / (long)sizeof(double))
+        return 1;
+
+    NearestIndex ix;
+    if (nearest_index_create(roots, len, T, &ix))
+        return 1;
+    int *root = malloc(width * height * sizeof(int));
+    double *ratio = malloc(width * height * sizeof(double));
+    if (!root || !ratio) {
+        free(root);
+        free(ratio);
+        nearest_index_destroy(&ix);
+        return 1;
+    }
+
+    for (int w = 0; w < width; w++) {
+        for (int h = 0; h < height; h++) {
+            Pitch p = {lo.w + w, lo.h + h};
+            long i = (long)w * height + h;
+            root[i] = nearest_index_query(&ix, p);
+            ratio[i] = to_ratio(interval_between(roots[root[i]], p), T);
+        }
+    }
+    nearest_index_destroy(&ix);
+
+    *out = (ZoneMap){.lo = lo,
+                     .width = width,
+                     .height = height,
+                     .root = root,
+                     .ratio = ratio};
+    return 0;
+}
+
+void zone_map_destroy(ZoneMap *z) {
+    free(z->root);
+    free(z->ratio);
+}
+
+static const double FFT_TAU = 6.283185307179586;
+
+int fft_plan_create(int n, FFTPlan *out) {
+    if (n <= 0 || (n & (n - 1)))
+        return 1;
+
+    int half = n > 1 ? n / 2 : 1;
+    double *cos_table = malloc(half * sizeof(double));
+    double *sin_table = malloc(half * sizeof(double));
+    int *bitrev = malloc(n * sizeof(int));
+    if (!cos_table || !sin_table || !bitrev) {
+        free(cos_table);
+        free(sin_table);
+        free(bitrev);
+        return 1;
+    }
+
+    for (int k = 0; k < n / 2; k++) {
+        cos_table[k] = cos(FFT_TAU * k / n);
+        sin_table[k] = sin(FFT_TAU * k / n);
+    }
+    int bits = 0;
+    while (1 << bits < n)
+        bits++;
+    for (int i = 0; i < n; i++) {
+        int r = 0;
+        for (int b = 0; b < bits; b++)
+            r |= (i >> b & 1) << (bits - 1 - b);
+        bitrev[i] = r;
+    }
+
+    *out = (FFTPlan){.n = n,
+                     .cos_table = cos_table,
+                     .sin_table = sin_table,
+                     .bitrev = bitrev};
+    return 0;
+}
+
+void fft_plan_destroy(FFTPlan *p) {
+    free(p->cos_table);
+    free(p->sin_table);
+    free(p->bitrev);
+}
 
-/**
- * Returns the SPN name of a Pitch as a string.
- * You must pass a char buf[8] to store the result, which is returned via an
- * out-param.
- * @return
- * true if the Pitch is more than a quadruple sharp/flat away from a natural,
- * which usually indicates a logic error upstream, or if the name would not
- * fit in 8 characters at all, in which case "ERR" is written to out instead.
- * false otherwise.
- */
-bool pitch_spn(Pitch p, char *out);
+// Iterative radix-2 decimation in time. sign is -1 for the forward transform
+// and 1 for the inverse.
+static void fft_transform(const FFTPlan *p, double re[], double im[],
+                          int sign) {
+    int n = p->n;
+    for (int i = 0; i < n; i++) {
+        int j = p->bitrev[i];
+        if (i < j) {
+            double t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
 
-/**
- * Returns the LilyPond note name of a Pitch as a string.
- * You must pass a char buf[16] to store the result, which is returned via an
- * out-param.
- * @return
- * true if the Pitch's accidental goes beyond a double sharp/flat (LilyPond
- * has no symbol for anything more remote), or if the name would not fit in
- * 16 characters at all. In either case "ERR" is written to out instead.
- * False otherwise.
- */
-bool pitch_lily(Pitch p, char *out);
+    for (int len = 2; len <= n; len *= 2) {
+        int half = len / 2, stride = n / len;
+        for (int start = 0; start < n; start += len) {
+            for (int k = 0; k < half; k++) {
+                double wr = p->cos_table[k * stride];
+                double wi = sign * p->sin_table[k * stride];
+                int a = start + k, b = a + half;
+                double xr = re[b] * wr - im[b] * wi;
+                double xi = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - xr;
+                im[b] = im[a] - xi;
+                re[a] += xr;
+                im[a] += xi;
+            }
+        }
+    }
+}
 
-/**
- * Returns the Helmholtz note name of a Pitch as a string.
- * You must pass a char buf[16] to store the result, which is returned via an
- * out-param.
- * @return
- * true if the Pitch is more than a quadruple sharp/flat away from a natural,
- * which usually indicates a logic error upstream, or if the name would not
- * fit in 16 characters at all, in which case "ERR" is written to out instead.
- * false otherwise.
- */
-bool pitch_helmholtz(Pitch p, char *out);
+void fft_forward(const FFTPlan *p, double re[], double im[]) {
+    fft_transform(p, re, im, -1);
+}
 
-/**
- * Returns the ABC note name of a Pitch as a string.
- * You must pass a char buf[16] to store the result, which is returned via an
- * out-param.
- * @return
- * true if the Pitch's accidental goes beyond a double sharp/flat (ABC
- * notation has no symbol for anything more remote), or if the name would not
- * fit in 16 characters at all. In either case "ERR" is written to out instead.
- * False otherwise.
- */
-bool pitch_abc(Pitch p, char *out);
+void fft_inverse(const FFTPlan *p, double re[], double im[]) {
+    fft_transform(p, re, im, 1);
+    for (int i = 0; i < p->n; i++) {
+        re[i] /= p->n;
+        im[i] /= p->n;
+    }
+}
 
-/**
- * Creates a MirrorAxis about which to invert Pitch vectors from two input SPN
- * strings representing Pitches that will map to each other.
- * @param out
- * Pointer to a MirrorAxis to store the resulting axis.
- * @return
- * 0 means nothing went wrong.
- */
-static inline int axis_from_spn(char *p_str, char *q_str, MirrorAxis *out) {
-    Pitch p, q;
+int pitch_tracker_create(int sample_rate, int window, int hop,
+                         double threshold, PitchTracker *out) {
+    if (sample_rate <= 0 || hop <= 0 || window < 8 || (window & (window - 1)))
+        return 1;
 
-    if (pitch_from_spn(p_str, &p))
+    FFTPlan fft;
+    if (fft_plan_create(window, &fft))
         return 1;
-    if (pitch_from_spn(q_str, &q))
+    double *re = malloc(window * sizeof(double));
+    double *im = malloc(window * sizeof(double));
+    double *energy = malloc((window + 1) * sizeof(double));
+    double *diff = malloc(window / 2 * sizeof(double));
+    if (!re || !im || !energy || !diff) {
+        free(re);
+        free(im);
+        free(energy);
+        free(diff);
+        fft_plan_destroy(&fft);
         return 1;
+    }
 
-    out->w = p.w + q.w;
-    out->h = p.h + q.h;
+    *out = (PitchTracker){.sample_rate = sample_rate,
+                          .window = window,
+                          .hop = hop,
+                          .threshold = threshold,
+                          .fft = fft,
+                          .re = re,
+                          .im = im,
+                          .energy = energy,
+                          .diff = diff};
     return 0;
 }
-#endif // MEANTONAL_HEADER
 
-// -----------------------------------------
-// IMPLEMENTATION --------------------------
-// -----------------------------------------
+void pitch_tracker_destroy(PitchTracker *t) {
+    fft_plan_destroy(&t->fft);
+    free(t->re);
+    free(t->im);
+    free(t->energy);
+    free(t->diff);
+}
 
-#ifdef MEANTONAL
-#undef MEANTONAL
-#include <stdio.h>
-#include <stdint.h>
-#include <math.h>
-#include <string.h>
+// d(tau) before normalisation, from the energies and correlation that
+// pitch_tracker_difference leaves behind.
+static double pitch_tracker_raw(const PitchTracker *t, int tau) {
+    int L = t->window / 2;
+    const double *E = t->energy;
+    double d = E[L] + (E[tau + L] - E[tau]) - 2 * t->re[tau];
+    return d > 0 ? d : 0;
+}
 
-const Map2D WICKI_TO = {1, -3, 0, 1};
-const Map2D WICKI_FROM = {1, 3, 0, 1};
+// The YIN difference function compares the first half of the frame, x[0..L),
+// with the frame delayed by each lag tau < L:
+//     d(tau) = sum (x[j] - x[j + tau])^2
+//            = E(0) + E(tau) - 2 * sum x[j] x[j + tau]
+// where E(tau) is the energy of x[tau..tau + L), read off running sums. The
+// cross term is a correlation, done with one complex FFT of length window by
+// packing the frame and its first half as the real and imaginary parts.
+// j + tau never reaches window, so the circular correlation doesn't wrap.
+static void pitch_tracker_difference(PitchTracker *t, const float x[]) {
+    int n = t->window, L = n / 2;
+    double *re = t->re, *im = t->im, *E = t->energy;
+
+    E[0] = 0;
+    for (int j = 0; j < n; j++) {
+        re[j] = x[j];
+        im[j] = j < L ? x[j] : 0;
+        E[j + 1] = E[j] + (double)x[j] * x[j];
+    }
+    fft_forward(&t->fft, re, im);
+
+    // Unpack both spectra: X = (Z[k] + conj Z[n-k]) / 2 is the frame's and
+    // Y = (Z[k] - conj Z[n-k]) / 2i its first half's. conj(Y) * X is the
+    // spectrum of the correlation, and it's Hermitian, so only k <= n / 2 is
+    // worked out.
+    for (int k = 0; k <= n / 2; k++) {
+        int m = (n - k) & (n - 1);
+        double xr = (re[k] + re[m]) / 2, xi = (im[k] - im[m]) / 2;
+        double yr = (im[k] + im[m]) / 2, yi = (re[m] - re[k]) / 2;
+        double cr = xr * yr + xi * yi, ci = xi * yr - xr * yi;
+        re[k] = cr;
+        im[k] = ci;
+        re[m] = cr;
+        im[m] = -ci;
+    }
+    fft_inverse(&t->fft, re, im);
+
+    // Cumulative mean normalisation, so the threshold doesn't depend on level
+    // and lag 0 can't win.
+    double sum = 0;
+    t->diff[0] = 1;
+    for (int tau = 1; tau < L; tau++) {
+        double d = pitch_tracker_raw(t, tau);
+        sum += d;
+        t->diff[tau] = sum > 0 ? d * tau / sum : 1;
+    }
+}
 
-const Map2D GENERATORS_TO = {2, -5, -1, 3};
-const Map2D GENERATORS_FROM = {3, 5, 1, 2};
+double pitch_tracker_frame(PitchTracker *t, const float frame[]) {
+    pitch_tracker_difference(t, frame);
+    int L = t->window / 2;
+    const double *d = t->diff;
+
+    // The first dip below the threshold, followed down to its minimum.
+    int tau = 2;
+    while (tau < L - 1 && d[tau] >= t->threshold)
+        tau++;
+    if (tau >= L - 1)
+        return 0;
+    while (tau + 1 < L - 1 && d[tau + 1] < d[tau])
+        tau++;
+
+    // Parabolic interpolation between neighbouring lags, on the raw
+    // difference function, which normalisation would skew.
+    double a = pitch_tracker_raw(t, tau - 1), b = pitch_tracker_raw(t, tau),
+           c = pitch_tracker_raw(t, tau + 1);
+    double curve = a - 2 * b + c;
+    double shift = curve > 0 ? (a - c) / (2 * curve) : 0;
+    return t->sample_rate / (tau + shift);
+}
 
-const double CONCERT_C4 = 261.6255653005986;
+long pitch_tracker_frames(const PitchTracker *t, long len) {
+    return len < t->window ? 0 : (len - t->window) / t->hop + 1;
+}
 
-Pitch pitch_from_chroma(int chroma, int octave) {
-    Pitch p = {0, 0};
-    p.w += chroma * 3;
-    p.h += chroma;
-    while (pitch_octave(p) > octave) {
-        p.w -= 5;
-        p.h -= 2;
+long pitch_tracker_run(PitchTracker *t, const float samples[], long len,
+                       double hz[], const TuningMap *T,
+                       const TonalContext *key, Pitch out[]) {
+    long frames = pitch_tracker_frames(t, len);
+    for (long i = 0; i < frames; i++)
+        hz[i] = pitch_tracker_frame(t, samples + i * t->hop);
+    if (T)
+        pitches_from_hz(hz, frames, *T, key, out, NULL);
+    return frames;
+}
+
+static const double CHROMA_TAU = 6.283185307179586;
+
+// Which class a bin goes to: the nearest pitch class, measured around the
+// octave, with ties as documented in chromagram_create.
+static int chroma_class_of(double cents, const double pc[], int chroma_min,
+                           int classes) {
+    int best = 0;
+    double best_d = INFINITY;
+    for (int i = 0; i < classes; i++) {
+        double d = fabs(remainder(cents - pc[i], 1200));
+        int chroma = chroma_min + i, prev = chroma_min + best;
+        if (d < best_d - 1e-9 ||
+            (d < best_d + 1e-9 &&
+             (abs(chroma) < abs(prev) || (abs(chroma) == abs(prev) &&
+                                          chroma < prev)))) {
+            best = i;
+            best_d = d;
+        }
+    }
+    return best;
+}
+
+int chromagram_create(TuningMap T, int sample_rate, int window, int hop,
+                      int chroma_min, int chroma_max, double min_hz,
+                      double max_hz, Chromagram *out) {
+    int classes = chroma_max - chroma_min + 1;
+    if (sample_rate <= 0 || hop <= 0 || classes <= 0 || window <= 0 ||
+        !(min_hz < max_hz) || isinf(max_hz))
+        return 1;
+    double lo = ceil(min_hz * window / sample_rate);
+    double hi = floor(max_hz * window / sample_rate);
+    int first = lo < 1 ? 1 : lo > window ? window : lo;
+    int last = hi > window / 2 ? window / 2 : hi < 0 ? 0 : hi;
+    if (first > last)
+        return 1;
+
+    FFTPlan fft;
+    if (fft_plan_create(window, &fft))
+        return 1;
+    int bins = last - first + 1;
+    double *pc = malloc(classes * sizeof(double));
+    int *bin_class = malloc(bins * sizeof(int));
+    double *hann = malloc(window * sizeof(double));
+    double *re = malloc(window * sizeof(double));
+    double *im = malloc(window * sizeof(double));
+    int *run_start = malloc(bins * sizeof(int));
+    int *run_end = malloc(bins * sizeof(int));
+    int *class_runs = calloc(classes + 1, sizeof(int));
+    if (!pc || !bin_class || !hann || !re || !im || !run_start || !run_end ||
+        !class_runs) {
+        free(pc);
+        free(bin_class);
+        free(hann);
+        free(re);
+        free(im);
+        free(run_start);
+        free(run_end);
+        free(class_runs);
+        fft_plan_destroy(&fft);
+        return 1;
+    }
+
+    // Pitch classes in cents above the TuningMap's reference pitch.
+    for (int i = 0; i < classes; i++) {
+        int chroma = chroma_min + i;
+        Interval m = {3 * chroma - T.ref_pitch.w, chroma - T.ref_pitch.h};
+        pc[i] = to_cents(m, T);
+    }
+    for (int k = first; k <= last; k++) {
+        double hz = (double)k * sample_rate / window;
+        double cents = 1200 * log2(hz / T.ref_freq);
+        bin_class[k - first] = chroma_class_of(cents, pc, chroma_min, classes);
     }
-    while (pitch_octave(p) < octave) {
-        p.w += 5;
-        p.h += 2;
+
+    // Consecutive bins of the same class form a run, and runs are grouped by
+    // class (a counting sort), so each class sums a few contiguous stretches
+    // of the spectrum rather than scattering every bin.
+    int runs = 0;
+    for (int k = 0; k < bins; k++)
+        if (k == 0 || bin_class[k] != bin_class[k - 1])
+            class_runs[bin_class[k] + 1]++, runs++;
+    for (int i = 0; i < classes; i++)
+        class_runs[i + 1] += class_runs[i];
+    for (int k = 0; k < bins;) {
+        int end = k + 1;
+        while (end < bins && bin_class[end] == bin_class[k])
+            end++;
+        int r = class_runs[bin_class[k]]++;
+        run_start[r] = first + k;
+        run_end[r] = first + end;
+        k = end;
     }
-    return p;
+    // Filling moved each class's start up to the next one's, so shift back.
+    for (int i = classes; i > 0; i--)
+        class_runs[i] = class_runs[i - 1];
+    class_runs[0] = 0;
+    free(pc);
+    free(bin_class);
+
+    for (int i = 0; i < window; i++)
+        hann[i] = 0.5 - 0.5 * cos(CHROMA_TAU * i / window);
+
+    *out = (Chromagram){.sample_rate = sample_rate,
+                        .window = window,
+                        .hop = hop,
+                        .chroma_min = chroma_min,
+                        .classes = classes,
+                        .fft = fft,
+                        .hann = hann,
+                        .re = re,
+                        .im = im,
+                        .runs = runs,
+                        .run_start = run_start,
+                        .run_end = run_end,
+                        .class_runs = class_runs};
+    return 0;
 }
 
-bool pitch_audible(Pitch p, TuningMap T) {
-    double f = to_hz(p, T);
-    if (f < 20.0) return false;
-    if (f > 20000.0) return false;
-    return true;
+void chromagram_destroy(Chromagram *c) {
+    fft_plan_destroy(&c->fft);
+    free(c->hann);
+    free(c->re);
+    free(c->im);
+    free(c->run_start);
+    free(c->run_end);
+    free(c->class_runs);
 }
 
-Pitch pitch_highest(Pitch arr[], int len, TuningMap T) {
-    Pitch highest = arr[0];
-    for (int i = 1; i < len; i++) {
-        if (to_hz(arr[i], T) > to_hz(highest, T))
-            highest = arr[i];
-        else if (to_hz(arr[i], T) == to_hz(highest, T) &&
-                 steps_between(arr[i], highest) < 0)
-            highest = arr[i];
+// chromagram_frame, using re and im (c->window doubles each) as workspace.
+static void chroma_frame(const Chromagram *c, const float frame[], double out[],
+                         double re[], double im[]) {
+    int n = c->window;
+    for (int i = 0; i < n; i++) {
+        re[i] = frame[i] * c->hann[i];
+        im[i] = 0;
+    }
+    fft_forward(&c->fft, re, im);
+    for (int k = 0; k <= n / 2; k++)
+        re[k] = re[k] * re[k] + im[k] * im[k];
+
+    for (int i = 0; i < c->classes; i++) {
+        double sum = 0;
+        for (int r = c->class_runs[i]; r < c->class_runs[i + 1]; r++)
+            for (int k = c->run_start[r]; k < c->run_end[r]; k++)
+                sum += re[k];
+        out[i] = sum;
     }
-    return highest;
 }
 
-Pitch pitch_lowest(Pitch arr[], int len, TuningMap T) {
-    Pitch lowest = arr[0];
-    for (int i = 1; i < len; i++) {
-        if (to_hz(arr[i], T) < to_hz(lowest, T))
-            lowest = arr[i];
-        else if (to_hz(arr[i], T) == to_hz(lowest, T) &&
-                 steps_between(arr[i], lowest) > 0)
-            lowest = arr[i];
+void chromagram_frame(Chromagram *c, const float frame[], double out[]) {
+    chroma_frame(c, frame, out, c->re, c->im);
+}
+
+long chromagram_frames(const Chromagram *c, long len) {
+    return len < c->window ? 0 : (len - c->window) / c->hop + 1;
+}
+
+// Frames per thread worth starting it for.
+enum { CHROMA_SLICE = 8 };
+
+typedef struct {
+    const Chromagram *c;
+    const float *samples;
+    double *out;
+    double *work; // 2 * c->window doubles for each chunk after the first
+} ChromaSlices;
+
+static void chroma_slice(void *ctx, int chunk, long start, long end) {
+    ChromaSlices *s = ctx;
+    const Chromagram *c = s->c;
+    double *re = c->re, *im = c->im;
+    if (chunk) {
+        re = s->work + (long)(chunk - 1) * 2 * c->window;
+        im = re + c->window;
     }
-    return lowest;
+    for (long i = start; i < end; i++)
+        chroma_frame(c, s->samples + i * c->hop, s->out + i * c->classes, re,
+                     im);
 }
 
-double oriented_ratio_between(Pitch p, Pitch q, TuningMap T) {
-    double x = to_ratio(interval_between(p, q), T);
-    double y = to_ratio(interval_between(q, p), T);
-    return x >= y ? x : y;
+// Chunk 0 uses the Chromagram's own workspace and every other chunk gets its
+// own. If that can't be allocated, the frames are measured on this thread.
+long chromagram_run(Chromagram *c, const float samples[], long len,
+                    double out[]) {
+    long frames = chromagram_frames(c, len);
+    int chunks = parallel_chunks(frames, CHROMA_SLICE);
+    ChromaSlices s = {c, samples, out, NULL};
+    if (chunks > 1)
+        s.work = malloc((long)(chunks - 1) * 2 * c->window * sizeof(double));
+    if (s.work)
+        parallel_for(frames, CHROMA_SLICE, chroma_slice, &s);
+    else
+        chroma_slice(&s, 0, 0, frames);
+    free(s.work);
+    return frames;
+}
+#ifdef __AVX2__
+#endif
+
+// Every kernel below has an AVX2 loop over 8 Pitches at a time when compiled
+// with AVX2 enabled (e.g. -mavx2 or -march=native), and a scalar loop that
+// finishes off the remainder, or does everything otherwise. The buffer's
+// arrays are 32-byte aligned and the AVX2 loop always starts at 0, so its
+// loads never split a cache line. They're still done as unaligned loads, so
+// that a PitchBuffer viewing part of another's arrays (to split work into
+// chunks) works too; caller-owned out arrays may not be aligned either.
+
+// aligned_alloc is C11, so arrays are aligned by hand: malloc enough to round
+// up to the next multiple of 32, and keep the pointer malloc returned just
+// below the array for pitch_buffer_free.
+static int *pitch_buffer_alloc(int capacity) {
+    size_t bytes = (size_t)capacity * sizeof(int);
+    unsigned char *raw = malloc(bytes + 31 + sizeof(void *));
+    if (!raw)
+        return NULL;
+    uintptr_t at = ((uintptr_t)(raw + sizeof(void *)) + 31) & ~(uintptr_t)31;
+    ((void **)at)[-1] = raw;
+    return (int *)at;
 }
 
-Pitch pitch_nearest(Pitch p, Pitch arr[], int len, TuningMap T) {
-    double smallest_ratio = oriented_ratio_between(p, arr[0], T);
+static void pitch_buffer_free(int *arr) {
+    if (arr)
+        free(((void **)arr)[-1]);
+}
 
-    for (int i = 1; i < len; i++) {
-        double x = oriented_ratio_between(p, arr[i], T);
-        if (x < smallest_ratio)
-            smallest_ratio = x;
+int pitch_buffer_create(int capacity, PitchBuffer *out) {
+    if (capacity < 0)
+        return 1;
+    int *w = pitch_buffer_alloc(capacity);
+    int *h = pitch_buffer_alloc(capacity);
+    if (!w || !h) {
+        pitch_buffer_free(w);
+        pitch_buffer_free(h);
+        return 1;
     }
+    *out = (PitchBuffer){.w = w, .h = h, .len = 0, .capacity = capacity};
+    return 0;
+}
+
+void pitch_buffer_destroy(PitchBuffer *b) {
+    pitch_buffer_free(b->w);
+    pitch_buffer_free(b->h);
+}
 
-    Pitch candidates[len];
-    int candidates_len = 0;
+int pitch_buffer_from_pitches(PitchBuffer *b, const Pitch arr[], int len) {
+    if (len < 0 || len > b->capacity)
+        return 1;
     for (int i = 0; i < len; i++) {
-        if (oriented_ratio_between(p, arr[i], T) == smallest_ratio)
-            candidates[candidates_len++] = arr[i];
+        b->w[i] = arr[i].w;
+        b->h[i] = arr[i].h;
     }
+    b->len = len;
+    return 0;
+}
+
+void pitch_buffer_to_pitches(const PitchBuffer *b, Pitch out[]) {
+    for (int i = 0; i < b->len; i++)
+        out[i] = (Pitch){b->w[i], b->h[i]};
+}
+
+#ifdef __AVX2__
+// floor(x / 7) in every lane. AVX2 has no integer division, so this is the
+// multiply-high by a magic number that compilers use for signed division by 7
+// (Hacker's Delight, 10-3), done for even and odd lanes separately, followed by
+// a step from truncated to floored division.
+static inline __m256i floordiv7_avx2(__m256i x) {
+    __m256i magic = _mm256_set1_epi32((int)0x92492493);
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(x, magic), 32);
+    __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(x, 32), magic);
+    __m256i q = _mm256_add_epi32(_mm256_blend_epi32(even, odd, 0xaa), x);
+    q = _mm256_sub_epi32(_mm256_srai_epi32(q, 2), _mm256_srai_epi32(x, 31));
+    __m256i q7 = _mm256_sub_epi32(_mm256_slli_epi32(q, 3), q);
+    __m256i r = _mm256_sub_epi32(x, q7);
+    return _mm256_add_epi32(q, _mm256_cmpgt_epi32(_mm256_setzero_si256(), r));
+}
+
+// x / 12 as C defines it (truncated) in every lane, exact for every int: the
+// same signed multiply-high as floordiv7_avx2 with 12's magic number.
+static inline __m256i truncdiv12_avx2(__m256i x) {
+    __m256i magic = _mm256_set1_epi32(0x2aaaaaab);
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(x, magic), 32);
+    __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(x, 32), magic);
+    __m256i q = _mm256_blend_epi32(even, odd, 0xaa);
+    return _mm256_sub_epi32(_mm256_srai_epi32(q, 1), _mm256_srai_epi32(x, 31));
+}
 
-    Pitch closest = candidates[0];
-    for (int i = 1; i < candidates_len; i++) {
-        if (abs(steps_between(p, candidates[i])) <
-            abs(steps_between(p, closest)))
-            closest = candidates[i];
+// Inclusive prefix sum of the 8 lanes: each 128-bit half is summed with two
+// shifts, and then the low half's total is added to the high half.
+static inline __m256i scan_avx2(__m256i x) {
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+    __m256i low = _mm256_permutevar8x32_epi32(
+        x, _mm256_setr_epi32(0, 0, 0, 0, 3, 3, 3, 3));
+    return _mm256_add_epi32(
+        x, _mm256_blend_epi32(_mm256_setzero_si256(), low, 0xf0));
+}
+
+static inline __m256i load_avx2(const int *p) {
+    return _mm256_loadu_si256((const __m256i *)p);
+}
+
+static inline void store_avx2(int *p, __m256i x) {
+    _mm256_storeu_si256((__m256i *)p, x);
+}
+#endif
+
+void pitch_buffer_transpose(PitchBuffer *b, Interval m) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i dw = _mm256_set1_epi32(m.w), dh = _mm256_set1_epi32(m.h);
+    for (; i + 8 <= b->len; i += 8) {
+        store_avx2(b->w + i, _mm256_add_epi32(load_avx2(b->w + i), dw));
+        store_avx2(b->h + i, _mm256_add_epi32(load_avx2(b->h + i), dh));
+    }
+#endif
+    for (; i < b->len; i++) {
+        b->w[i] += m.w;
+        b->h[i] += m.h;
     }
+}
 
-    return closest;
+void pitch_buffer_invert(PitchBuffer *b, MirrorAxis a) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i aw = _mm256_set1_epi32(a.w), ah = _mm256_set1_epi32(a.h);
+    for (; i + 8 <= b->len; i += 8) {
+        store_avx2(b->w + i, _mm256_sub_epi32(aw, load_avx2(b->w + i)));
+        store_avx2(b->h + i, _mm256_sub_epi32(ah, load_avx2(b->h + i)));
+    }
+#endif
+    for (; i < b->len; i++) {
+        b->w[i] = a.w - b->w[i];
+        b->h[i] = a.h - b->h[i];
+    }
 }
 
-static const Interval major_ints[7] = {
-    {0, 0}, {1, 0}, {2, 0}, {2, 1}, {3, 1}, {4, 1}, {5, 1},
-};
+int pitch_buffer_intervals(const PitchBuffer *p, const PitchBuffer *q,
+                           PitchBuffer *out) {
+    if (p->len != q->len || out->capacity < p->len)
+        return 1;
+    int i = 0;
+#ifdef __AVX2__
+    for (; i + 8 <= p->len; i += 8) {
+        store_avx2(out->w + i,
+                   _mm256_sub_epi32(load_avx2(q->w + i), load_avx2(p->w + i)));
+        store_avx2(out->h + i,
+                   _mm256_sub_epi32(load_avx2(q->h + i), load_avx2(p->h + i)));
+    }
+#endif
+    for (; i < p->len; i++) {
+        out->w[i] = q->w[i] - p->w[i];
+        out->h[i] = q->h[i] - p->h[i];
+    }
+    out->len = p->len;
+    return 0;
+}
 
-int interval_from_name(const char *s, Interval *out) {
-    // 1. sign
-    bool negative = false;
-    if (*s == '-') {
-        negative = true;
-        s++;
+void pitch_buffer_chromas(const PitchBuffer *b, int out[]) {
+    int i = 0;
+#ifdef __AVX2__
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i w = load_avx2(b->w + i), h = load_avx2(b->h + i);
+        __m256i h5 = _mm256_add_epi32(_mm256_slli_epi32(h, 2), h);
+        store_avx2(out + i, _mm256_sub_epi32(_mm256_add_epi32(w, w), h5));
     }
+#endif
+    for (; i < b->len; i++)
+        out[i] = 2 * b->w[i] - 5 * b->h[i];
+}
 
-    // 2. quality (unadjusted)
-    int quality = 0;
-    while (*s == 'P' || *s == 'p' || *s == 'M' || *s == 'm' || *s == 'b' ||
-           *s == '#' || *s == 'A' || *s == 'a' || *s == 'D' || *s == 'd') {
-        switch (*s) {
-        case 'A':
-        case 'a':
-        case '#':
-            quality++;
-            break;
-        case 'm':
-        case 'b':
-            quality--;
-            break;
-        case 'D':
-        case 'd':
-            if (quality == 0)
-                quality -= 2;
-            else
-                quality--;
-            break;
-        }
-        s++;
+void pitch_buffer_midis(const PitchBuffer *b, int out[]) {
+    int i = 0;
+#ifdef __AVX2__
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i w = load_avx2(b->w + i), h = load_avx2(b->h + i);
+        store_avx2(out + i, _mm256_add_epi32(_mm256_add_epi32(w, w), h));
     }
+#endif
+    for (; i < b->len; i++)
+        out[i] = 2 * b->w[i] + b->h[i];
+}
 
-    // 3. generic size / octave
-    char *end;
-    long generic = strtol(s, &end, 10) - 1;
-    if (end == s) {
-        return 1; // no digits found
+void pitch_buffer_letters(const PitchBuffer *b, int out[]) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i two = _mm256_set1_epi32(2), seven = _mm256_set1_epi32(7);
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i x = _mm256_add_epi32(
+            _mm256_add_epi32(load_avx2(b->w + i), load_avx2(b->h + i)), two);
+        __m256i q = _mm256_mullo_epi32(floordiv7_avx2(x), seven);
+        store_avx2(out + i, _mm256_sub_epi32(x, q));
     }
-    int simple = generic % 7;
-    int octave = generic / 7;
+#endif
+    for (; i < b->len; i++)
+        out[i] = pitch_letter((Pitch){b->w[i], b->h[i]});
+}
 
-    // 4. construct output pitch
-    out->w = major_ints[simple].w;
-    out->h = major_ints[simple].h;
+void pitch_buffer_accidentals(const PitchBuffer *b, int out[]) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i one = _mm256_set1_epi32(1);
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i w = load_avx2(b->w + i), h = load_avx2(b->h + i);
+        __m256i h5 = _mm256_add_epi32(_mm256_slli_epi32(h, 2), h);
+        __m256i x = _mm256_add_epi32(
+            _mm256_sub_epi32(_mm256_add_epi32(w, w), h5), one);
+        store_avx2(out + i, floordiv7_avx2(x));
+    }
+#endif
+    for (; i < b->len; i++)
+        out[i] = pitch_accidental((Pitch){b->w[i], b->h[i]});
+}
 
-    // 5. adjust octave
-    out->w += 5 * octave;
-    out->h += 2 * octave;
+void pitch_buffer_octaves(const PitchBuffer *b, int out[]) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i one = _mm256_set1_epi32(1);
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i x = _mm256_add_epi32(load_avx2(b->w + i), load_avx2(b->h + i));
+        store_avx2(out + i, _mm256_sub_epi32(floordiv7_avx2(x), one));
+    }
+#endif
+    for (; i < b->len; i++)
+        out[i] = pitch_octave((Pitch){b->w[i], b->h[i]});
+}
 
-    // 6. adjust quality
-    if (quality < 0 && (simple == 0 || simple == 3 || simple == 4))
-        quality++;
-    out->w += quality;
-    out->h -= quality;
+// Runs the three classifiers over a chunk at a time (keeping their output in
+// L1) and then interleaves them into StandardPitches.
+void pitch_buffer_to_standard(const PitchBuffer *b, StandardPitch out[]) {
+    enum { CHUNK = 256 };
+    int letter[CHUNK], accidental[CHUNK], octave[CHUNK];
+    for (int start = 0; start < b->len; start += CHUNK) {
+        int n = b->len - start < CHUNK ? b->len - start : CHUNK;
+        PitchBuffer chunk = {b->w + start, b->h + start, n, n};
+        pitch_buffer_letters(&chunk, letter);
+        pitch_buffer_accidentals(&chunk, accidental);
+        pitch_buffer_octaves(&chunk, octave);
+        for (int i = 0; i < n; i++)
+            out[start + i] =
+                (StandardPitch){letter[i], accidental[i], octave[i]};
+    }
+}
 
-    // 7. account for sign
-    if (negative) {
-        out->w = -out->w;
-        out->h = -out->h;
+void pitch_buffer_pc12s(const PitchBuffer *b, int out[]) {
+    int i = 0;
+#ifdef __AVX2__
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i w = load_avx2(b->w + i), h = load_avx2(b->h + i);
+        __m256i x = _mm256_add_epi32(_mm256_add_epi32(w, w), h);
+        __m256i q = truncdiv12_avx2(x);
+        __m256i q3 = _mm256_add_epi32(_mm256_add_epi32(q, q), q);
+        store_avx2(out + i, _mm256_sub_epi32(x, _mm256_slli_epi32(q3, 2)));
     }
+#endif
+    for (; i < b->len; i++)
+        out[i] = pitch_pc12((Pitch){b->w[i], b->h[i]});
+}
 
-    return 0;
+void pitch_buffer_degrees(const PitchBuffer *b, TonalContext key, int out[]) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i shift = _mm256_set1_epi32(2 - key.tonic.letter);
+    __m256i seven = _mm256_set1_epi32(7);
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i x = _mm256_add_epi32(
+            _mm256_add_epi32(load_avx2(b->w + i), load_avx2(b->h + i)), shift);
+        __m256i q = _mm256_mullo_epi32(floordiv7_avx2(x), seven);
+        store_avx2(out + i, _mm256_sub_epi32(x, q));
+    }
+#endif
+    for (; i < b->len; i++)
+        out[i] = degree_number((Pitch){b->w[i], b->h[i]}, key);
 }
 
-int interval_from_spn(const char *p_str, const char *q_str, Interval *out) {
-    Pitch p, q;
-    if (pitch_from_spn(p_str, &p))
-        return 1;
-    if (pitch_from_spn(q_str, &q))
+// Chromas are enharmonic when their difference d is a multiple of edo, and
+// |d| is a multiple of edo exactly when |d| * c, with c = 2^64 / edo rounded
+// up, wraps to less than c (Lemire, Kaser & Kurz, "Faster Remainder by Direct
+// Computation", 2019). That leaves one division per call instead of four per
+// Pitch.
+int pitch_buffer_enharmonic(const PitchBuffer *p, const PitchBuffer *q,
+                            int edo, bool out[]) {
+    if (p->len != q->len || edo <= 0)
         return 1;
-    out->w = q.w - p.w;
-    out->h = q.h - p.h;
+    uint64_t c = UINT64_MAX / (uint64_t)edo + 1;
+    for (int i = 0; i < p->len; i++) {
+        // two ints are less than 2^32 apart, so n fits 32 bits
+        long long d = (long long)(2 * p->w[i] - 5 * p->h[i]) -
+                      (2 * q->w[i] - 5 * q->h[i]);
+        uint32_t n = (uint32_t)(d < 0 ? -d : d);
+        out[i] = n * c <= c - 1;
+    }
     return 0;
 }
 
-void interval_name(Interval m, char *out) {
-    size_t cap = 8;
+// Each vector is scanned on its own and then offset by the running total of
+// everything before it, carried along broadcast to every lane.
+static Pitch buffer_scan(PitchBuffer *b, Pitch start) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i last = _mm256_set1_epi32(7);
+    __m256i cw = _mm256_set1_epi32(start.w), ch = _mm256_set1_epi32(start.h);
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i w = _mm256_add_epi32(scan_avx2(load_avx2(b->w + i)), cw);
+        __m256i h = _mm256_add_epi32(scan_avx2(load_avx2(b->h + i)), ch);
+        store_avx2(b->w + i, w);
+        store_avx2(b->h + i, h);
+        cw = _mm256_permutevar8x32_epi32(w, last);
+        ch = _mm256_permutevar8x32_epi32(h, last);
+    }
+    if (i > 0)
+        start = (Pitch){b->w[i - 1], b->h[i - 1]};
+#endif
+    for (; i < b->len; i++) {
+        start.w = b->w[i] += start.w;
+        start.h = b->h[i] += start.h;
+    }
+    return start;
+}
 
-    static const char qualities[5] = {'d', 'm', 'P', 'M', 'A'};
-    int8_t quality = interval_quality(m);
-    int ss = stepspan(m);
-    int8_t generic_size = abs(ss) + 1;
-    char *sign = ss < 0 ? "-" : "";
-    if (quality <= 2 && quality >= -2) {
-        snprintf(out, cap, "%s%c%hhd", sign, qualities[quality + 2],
-                 generic_size);
-    } else if (quality > 0) {
-        snprintf(out, cap, "%s%dA%hhd", sign, quality - 1, generic_size);
-    } else {
-        snprintf(out, cap, "%s%hhdd%hhd", sign, -quality - 1, generic_size);
+// Each vector is shifted up a lane, with the previous vector's last lane
+// moved into the bottom, and subtracted from itself.
+static void buffer_differences(PitchBuffer *b, Pitch start) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i rotate = _mm256_setr_epi32(7, 0, 1, 2, 3, 4, 5, 6);
+    __m256i pw = _mm256_set1_epi32(start.w), ph = _mm256_set1_epi32(start.h);
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i w = load_avx2(b->w + i), h = load_avx2(b->h + i);
+        __m256i rw = _mm256_permutevar8x32_epi32(w, rotate);
+        __m256i rh = _mm256_permutevar8x32_epi32(h, rotate);
+        __m256i prev_w = _mm256_blend_epi32(rw, pw, 1);
+        __m256i prev_h = _mm256_blend_epi32(rh, ph, 1);
+        store_avx2(b->w + i, _mm256_sub_epi32(w, prev_w));
+        store_avx2(b->h + i, _mm256_sub_epi32(h, prev_h));
+        pw = rw;
+        ph = rh;
+    }
+    if (i > 0)
+        start = (Pitch){_mm256_cvtsi256_si32(pw), _mm256_cvtsi256_si32(ph)};
+#endif
+    for (; i < b->len; i++) {
+        Pitch p = {b->w[i], b->h[i]};
+        b->w[i] -= start.w;
+        b->h[i] -= start.h;
+        start = p;
+    }
+}
+
+Interval pitch_buffer_sum(const PitchBuffer *b) {
+    int i = 0;
+    Interval sum = {0, 0};
+#ifdef __AVX2__
+    __m256i sw = _mm256_setzero_si256(), sh = _mm256_setzero_si256();
+    for (; i + 8 <= b->len; i += 8) {
+        sw = _mm256_add_epi32(sw, load_avx2(b->w + i));
+        sh = _mm256_add_epi32(sh, load_avx2(b->h + i));
+    }
+    int lanes[8];
+    store_avx2(lanes, scan_avx2(sw));
+    sum.w = lanes[7];
+    store_avx2(lanes, scan_avx2(sh));
+    sum.h = lanes[7];
+#endif
+    for (; i < b->len; i++) {
+        sum.w += b->w[i];
+        sum.h += b->h[i];
     }
+    return sum;
+}
+
+// Buffers longer than this are split between threads (see parallel.h). Each
+// chunk is scanned from the total of the chunks before it, found by summing
+// every chunk first; differences only need the Pitch before each chunk.
+enum { BUFFER_SLICE = 1 << 18 };
+
+typedef struct {
+    PitchBuffer *b;
+    Pitch start[PARALLEL_MAX_THREADS];
+    Interval sum[PARALLEL_MAX_THREADS];
+} BufferSlices;
+
+static PitchBuffer buffer_slice(PitchBuffer *b, long start, long end) {
+    int n = end - start;
+    return (PitchBuffer){b->w + start, b->h + start, n, n};
 }
 
-int context_from_str(char *s, enum Mode mode, TonalContext *out) {
-    // 1. letter name
-    int letter, chroma;
-    if (*s >= 'A' && *s <= 'G') {
-        letter = *s++ - 'A';
-    } else if (*s >= 'a' && *s <= 'g') {
-        letter = *s++ - 'a';
-    } else {
-        return 1; // invalid
+static void buffer_slice_sum(void *ctx, int chunk, long start, long end) {
+    BufferSlices *s = ctx;
+    PitchBuffer slice = buffer_slice(s->b, start, end);
+    s->sum[chunk] = pitch_buffer_sum(&slice);
+}
+
+static void buffer_slice_scan(void *ctx, int chunk, long start, long end) {
+    BufferSlices *s = ctx;
+    PitchBuffer slice = buffer_slice(s->b, start, end);
+    buffer_scan(&slice, s->start[chunk]);
+}
+
+static void buffer_slice_differences(void *ctx, int chunk, long start,
+                                     long end) {
+    BufferSlices *s = ctx;
+    PitchBuffer slice = buffer_slice(s->b, start, end);
+    buffer_differences(&slice, s->start[chunk]);
+}
+
+Pitch pitch_buffer_scan(PitchBuffer *b, Pitch start) {
+    int n = parallel_chunks(b->len, BUFFER_SLICE);
+    if (n == 1)
+        return buffer_scan(b, start);
+
+    BufferSlices s = {.b = b};
+    parallel_for(b->len, BUFFER_SLICE, buffer_slice_sum, &s);
+    s.start[0] = start;
+    for (int i = 1; i < n; i++)
+        s.start[i] = transpose_real(s.start[i - 1], s.sum[i - 1]);
+    parallel_for(b->len, BUFFER_SLICE, buffer_slice_scan, &s);
+    return transpose_real(s.start[n - 1], s.sum[n - 1]);
+}
+
+void pitch_buffer_differences(PitchBuffer *b, Pitch start) {
+    int n = parallel_chunks(b->len, BUFFER_SLICE);
+    if (n == 1) {
+        buffer_differences(b, start);
+        return;
     }
-    chroma = (letter * 2 + 4) % 7 - 1; // trust me it works.
 
-    // 2. accidental
-    int acc = 0;
-    while (*s == '#' || *s == 'b' || *s == 'x' || *s == 'w') {
-        switch (*s) {
-        case '#':
-            acc++;
-            break;
-        case 'b':
-            acc--;
-            break;
-        case 'x':
-            acc += 2;
-            break;
-        case 'w':
-            acc -= 2;
-            break;
-        }
-        s++;
+    BufferSlices s = {.b = b};
+    s.start[0] = start;
+    for (int i = 1; i < n; i++) {
+        long first = (long long)i * b->len / n;
+        s.start[i] = (Pitch){b->w[first - 1], b->h[first - 1]};
     }
-    chroma += 7 * acc;
+    parallel_for(b->len, BUFFER_SLICE, buffer_slice_differences, &s);
+}
 
-    out->tonic.letter = letter;
-    out->tonic.accidental = acc;
-    out->mode = mode;
-    out->chroma_offset = mode - chroma;
+// Heights need 64 bits, so the AVX2 loop widens each half of 8 Pitches to 4
+// 64-bit lanes and multiplies with _mm256_mul_epi32, which takes the low 32
+// bits of each lane as signed. That's exact when the HeightMap's coefficients
+// fit in 32 bits, as they do for every EDO and for fixed-point heights of any
+// sensible tuning; otherwise the scalar loop does everything.
+int pitch_buffer_in_range(const PitchBuffer *b, PitchRange r, bool out[]) {
+    int i = 0, count = 0;
+#ifdef __AVX2__
+    if (r.H.m0 == (int)r.H.m0 && r.H.m1 == (int)r.H.m1) {
+        __m256i m0 = _mm256_set1_epi64x(r.H.m0);
+        __m256i m1 = _mm256_set1_epi64x(r.H.m1);
+        __m256i lo = _mm256_set1_epi64x(r.lo), hi = _mm256_set1_epi64x(r.hi);
+        for (; i + 8 <= b->len; i += 8) {
+            __m256i w = load_avx2(b->w + i), h = load_avx2(b->h + i);
+            for (int half = 0; half < 2; half++) {
+                __m128i w4 = half ? _mm256_extracti128_si256(w, 1)
+                                  : _mm256_castsi256_si128(w);
+                __m128i h4 = half ? _mm256_extracti128_si256(h, 1)
+                                  : _mm256_castsi256_si128(h);
+                __m256i height = _mm256_add_epi64(
+                    _mm256_mul_epi32(_mm256_cvtepi32_epi64(w4), m0),
+                    _mm256_mul_epi32(_mm256_cvtepi32_epi64(h4), m1));
+                __m256i outside = _mm256_or_si256(
+                    _mm256_cmpgt_epi64(lo, height),
+                    _mm256_cmpgt_epi64(height, hi));
+                // spread the 4 inside bits to 4 bools with one multiply
+                uint32_t in = ~_mm256_movemask_pd(_mm256_castsi256_pd(outside));
+                in = ((in & 15) * 0x00204081u) & 0x01010101u;
+                memcpy(out + i + 4 * half, &in, 4);
+                count += (in * 0x01010101u) >> 24;
+            }
+        }
+    }
+#endif
+    for (; i < b->len; i++)
+        count += out[i] = pitch_in_range((Pitch){b->w[i], b->h[i]}, r);
+    return count;
+}
 
-    return 0;
+int pitch_buffer_filter_range(PitchBuffer *b, PitchRange r) {
+    int count = 0;
+    for (int i = 0; i < b->len; i++) {
+        int w = b->w[i], h = b->h[i];
+        b->w[count] = w;
+        b->h[count] = h;
+        count += pitch_in_range((Pitch){w, h}, r);
+    }
+    b->len = count;
+    return count;
 }
 
-TonalContext context_from_chroma(int chroma, enum Mode mode) {
-    TonalContext out;
+int pitches_to_pitch16(const Pitch arr[], int len, Pitch16 out[]) {
+    int skipped = 0;
+    for (int i = 0; i < len; i++)
+        skipped += pitch16_from_pitch(arr[i], &out[i]);
+    return skipped;
+}
 
-    out.mode = mode;
-    out.chroma_offset = mode - chroma;
-    out.tonic.letter = (chroma * 4 % 7 + 9) % 7;
-    out.tonic.accidental = ++chroma < 0 ? chroma / 7 - 1 : chroma / 7;
+void pitches_from_pitch16(const Pitch16 arr[], int len, Pitch out[]) {
+    for (int i = 0; i < len; i++)
+        out[i] = pitch16_to_pitch(arr[i]);
+}
 
-    return out;
+void pitches16_transpose(Pitch16 arr[], int len, Pitch16 m) {
+    for (int i = 0; i < len; i++)
+        arr[i] = pitch16_transpose(arr[i], m);
 }
 
-TonalContext context_from_pitch(Pitch p, enum Mode mode) {
-    TonalContext out;
+void pitches16_intervals(const Pitch16 p[], const Pitch16 q[], int len,
+                         Pitch16 out[]) {
+    for (int i = 0; i < len; i++)
+        out[i] = pitch16_interval(p[i], q[i]);
+}
 
-    out.tonic.letter = pitch_letter(p);
-    out.tonic.accidental = pitch_accidental(p);
-    out.mode = mode;
-    out.chroma_offset = mode - pitch_chroma(p);
+void pitches16_to_standard(const Pitch16 arr[], int len, StandardPitch out[]) {
+    for (int i = 0; i < len; i++)
+        out[i] = (StandardPitch){.letter = pitch16_letter(arr[i]),
+                                 .accidental = pitch16_accidental(arr[i]),
+                                 .octave = pitch16_octave(arr[i])};
+}
 
-    return out;
+int pitch_buffer_from_pitch16(PitchBuffer *b, const Pitch16 arr[], int len) {
+    if (len < 0 || len > b->capacity)
+        return 1;
+    for (int i = 0; i < len; i++) {
+        b->w[i] = pitch16_w(arr[i]);
+        b->h[i] = pitch16_h(arr[i]);
+    }
+    b->len = len;
+    return 0;
 }
 
-enum Alteration degree_alteration(Pitch p, TonalContext key) {
-    int x = pitch_chroma(p) + key.chroma_offset;
-    if (0 <= x && x < 7)
-        return DIATONIC_DEG;
-    if (7 <= x && x < 12)
-        return RAISED_DEG;
-    if (-5 <= x && x < 0)
-        return LOWERED_DEG;
-    if (x < -5)
-        return FOREIGN_DEG_FLAT;
-    return FOREIGN_DEG_SHARP;
+int pitch_buffer_to_pitch16(const PitchBuffer *b, Pitch16 out[]) {
+    int skipped = 0;
+    for (int i = 0; i < b->len; i++)
+        skipped += pitch16_from_pitch((Pitch){b->w[i], b->h[i]}, &out[i]);
+    return skipped;
 }
 
-Pitch snap_diatonic(Pitch p, TonalContext key) {
-    while (degree_alteration(p, key) > DIATONIC_DEG) {
-        p.w--;
-        p.h++;
-    }
-    while (degree_alteration(p, key) < DIATONIC_DEG) {
-        p.w++;
-        p.h--;
+// Converting between widths checks each step against the narrower type's
+// range, compared as long long so no comparison is out of range for its type.
+#define MEANTONAL_WIDTH_DEFINE(P, T, W, pre, MIN, MAX)                         \
+    int pre##_pitches_from_pitches(const Pitch arr[], int len, P out[]) {      \
+        int skipped = 0;                                                       \
+        for (int i = 0; i < len; i++) {                                        \
+            long long w = arr[i].w, h = arr[i].h;                              \
+            if (w < MIN || w > MAX || h < MIN || h > MAX)                      \
+                skipped++;                                                     \
+            else                                                               \
+                out[i] = (P){.w = (T)w, .h = (T)h};                            \
+        }                                                                      \
+        return skipped;                                                        \
+    }                                                                          \
+    int pre##_pitches_to_pitches(const P arr[], int len, Pitch out[]) {        \
+        int skipped = 0;                                                       \
+        for (int i = 0; i < len; i++) {                                        \
+            long long w = arr[i].w, h = arr[i].h;                              \
+            if (w < INT_MIN || w > INT_MAX || h < INT_MIN || h > INT_MAX)      \
+                skipped++;                                                     \
+            else                                                               \
+                out[i] = (Pitch){.w = (int)w, .h = (int)h};                    \
+        }                                                                      \
+        return skipped;                                                        \
+    }                                                                          \
+    void pre##_pitches_transpose(P arr[], int len, P m) {                      \
+        for (int i = 0; i < len; i++)                                          \
+            arr[i] = pre##_transpose_real(arr[i], m);                          \
+    }                                                                          \
+    void pre##_pitches_intervals(const P p[], const P q[], int len, P out[]) { \
+        for (int i = 0; i < len; i++)                                          \
+            out[i] = pre##_interval_between(p[i], q[i]);                       \
+    }                                                                          \
+    void pre##_pitches_chromas(const P arr[], int len, W out[]) {              \
+        for (int i = 0; i < len; i++)                                          \
+            out[i] = pre##_pitch_chroma(arr[i]);                               \
+    }                                                                          \
+    void pre##_pitches_letters(const P arr[], int len, int out[]) {            \
+        for (int i = 0; i < len; i++)                                          \
+            out[i] = pre##_pitch_letter(arr[i]);                               \
+    }                                                                          \
+    void pre##_pitches_accidentals(const P arr[], int len, W out[]) {          \
+        for (int i = 0; i < len; i++)                                          \
+            out[i] = pre##_pitch_accidental(arr[i]);                           \
+    }                                                                          \
+    void pre##_pitches_octaves(const P arr[], int len, W out[]) {              \
+        for (int i = 0; i < len; i++)                                          \
+            out[i] = pre##_pitch_octave(arr[i]);                               \
+    }                                                                          \
+    void pre##_pitches_heights(const P arr[], int len, HeightMap H,            \
+                               long long out[]) {                              \
+        for (int i = 0; i < len; i++)                                          \
+            out[i] = pre##_pitch_height(arr[i], H);                            \
     }
 
-    return p;
+MEANTONAL_WIDTH_DEFINE(PitchI16, int16_t, int, i16, INT16_MIN, INT16_MAX)
+MEANTONAL_WIDTH_DEFINE(PitchI32, int32_t, long long, i32, INT32_MIN, INT32_MAX)
+MEANTONAL_WIDTH_DEFINE(PitchI64, int64_t, long long, i64, LLONG_MIN, LLONG_MAX)
+
+// Slots are found by the low bits of a Pitch's hash, and hold a tag made from
+// the top 7 bits. Probing scans the tag array first, 64 slots to a cache line,
+// and only compares keys when a tag matches.
+
+static uint8_t hash_tag(uint64_t h) { return 0x80 | (uint8_t)(h >> 57); }
+
+// The slot holding p if it's in the map, otherwise -1 - the empty slot where it
+// would go.
+static int pitch_map_find(const PitchMap *m, Pitch p, uint64_t h) {
+    int mask = m->capacity - 1;
+    uint8_t tag = hash_tag(h);
+    for (int i = (int)(h & mask);; i = (i + 1) & mask) {
+        if (m->tags[i] == 0)
+            return -1 - i;
+        if (m->tags[i] == tag && m->keys[i].w == p.w && m->keys[i].h == p.h)
+            return i;
+    }
 }
 
-Pitch transpose_diatonic(Pitch p, int interval, TonalContext key) {
-    return snap_diatonic(transpose_real(p, (Interval){interval, 0}), key);
+static int pitch_map_alloc(int capacity, PitchMap *out) {
+    uint8_t *tags = calloc(capacity, sizeof(uint8_t));
+    Pitch *keys = malloc(capacity * sizeof(Pitch));
+    PitchValue *values = malloc(capacity * sizeof(PitchValue));
+    if (!tags || !keys || !values) {
+        free(tags);
+        free(keys);
+        free(values);
+        return 1;
+    }
+    *out = (PitchMap){.len = 0,
+                      .capacity = capacity,
+                      .tags = tags,
+                      .keys = keys,
+                      .values = values};
+    return 0;
 }
 
+// The most Pitches a map holds, which keeps every slot count (at most 2^29)
+// within an int.
+enum { PITCH_MAP_MAX_LEN = 1 << 28 };
+
+// Keeps the map at most 3/4 full, so probe runs stay short. len must be at
+// most PITCH_MAP_MAX_LEN.
+static int slots_for(int len) {
+    int capacity = 8;
+    while (capacity / 4 * 3 < len)
+        capacity *= 2;
+    return capacity;
+}
 
-typedef struct tnode {
-    int value;
-    struct tnode *left;
-    struct tnode *right;
-} *PitchClassSet;
+// Makes room for len Pitches in total, rehashing into a bigger table if
+// needed. len is a long long so that callers can add to m->len freely.
+static int pitch_map_reserve(PitchMap *m, long long len) {
+    if (len > PITCH_MAP_MAX_LEN)
+        return 1;
+    int capacity = slots_for((int)len);
+    if (capacity <= m->capacity)
+        return 0;
+    PitchMap bigger;
+    if (pitch_map_alloc(capacity, &bigger))
+        return 1;
+    for (int i = 0; i < m->capacity; i++) {
+        if (!m->tags[i])
+            continue;
+        Pitch key = m->keys[i];
+        int j = -1 - pitch_map_find(&bigger, key, pitch_hash(key));
+        bigger.tags[j] = m->tags[i];
+        bigger.keys[j] = m->keys[i];
+        bigger.values[j] = m->values[i];
+    }
+    bigger.len = m->len;
+    pitch_map_destroy(m);
+    *m = bigger;
+    return 0;
+}
 
-static struct tnode *create_tnode(int chroma) {
-    struct tnode *node = malloc(sizeof(struct tnode));
-    node->value = chroma;
-    node->left = node->right = NULL;
-    return node;
+int pitch_map_create(int capacity, PitchMap *out) {
+    if (capacity < 0 || capacity > PITCH_MAP_MAX_LEN)
+        return 1;
+    return pitch_map_alloc(slots_for(capacity), out);
 }
 
-void pc_set_destroy(PitchClassSet set) {
-    if (set->left)
-        pc_set_destroy(set->left);
-    if (set->right)
-        pc_set_destroy(set->right);
-    free(set);
+void pitch_map_destroy(PitchMap *m) {
+    free(m->tags);
+    free(m->keys);
+    free(m->values);
 }
 
-void pc_set_insert(PitchClassSet *set, int chroma) {
-    if (*set == NULL)
-        *set = create_tnode(chroma);
-    else if ((*set)->value > chroma)
-        pc_set_insert(&(*set)->left, chroma);
-    else if ((*set)->value < chroma)
-        pc_set_insert(&(*set)->right, chroma);
+void pitch_map_clear(PitchMap *m) {
+    memset(m->tags, 0, m->capacity);
+    m->len = 0;
 }
 
-bool pc_set_contains(PitchClassSet set, int chroma) {
-    if (set == NULL)
-        return false;
-    return set->value == chroma || pc_set_contains(set->left, chroma) ||
-           pc_set_contains(set->right, chroma);
+PitchValue *pitch_map_get(const PitchMap *m, Pitch p) {
+    int i = pitch_map_find(m, p, pitch_hash(p));
+    return i < 0 ? NULL : &m->values[i];
 }
 
-PitchClassSet pc_set_transpose(PitchClassSet set, int offset) {
-    if (set == NULL)
-        return NULL;
-    PitchClassSet new_node = create_tnode(set->value + offset);
-    new_node->left = pc_set_transpose(set->left, offset);
-    new_node->right = pc_set_transpose(set->right, offset);
+PitchValue *pitch_map_slot(PitchMap *m, Pitch p) {
+    uint64_t h = pitch_hash(p);
+    int i = pitch_map_find(m, p, h);
+    if (i >= 0)
+        return &m->values[i];
+    if (m->capacity / 4 * 3 < m->len + 1) {
+        if (pitch_map_reserve(m, m->len + 1LL))
+            return NULL;
+        i = pitch_map_find(m, p, h);
+    }
+    i = -1 - i;
+    m->tags[i] = hash_tag(h);
+    m->keys[i] = p;
+    m->values[i] = (PitchValue){0};
+    m->len++;
+    return &m->values[i];
+}
 
-    return new_node;
+int pitch_map_put(PitchMap *m, Pitch p, PitchValue v) {
+    PitchValue *slot = pitch_map_slot(m, p);
+    if (!slot)
+        return 1;
+    *slot = v;
+    return 0;
 }
 
-PitchClassSet pc_set_invert(PitchClassSet set, int axis) {
-    if (set == NULL)
-        return NULL;
-    PitchClassSet new_node = create_tnode(axis - set->value);
-    new_node->left = pc_set_invert(set->left, axis);
-    new_node->right = pc_set_invert(set->right, axis);
+// Linear probing can't just empty a slot, or it would cut the probe runs of
+// keys stored after it. Instead each later key in the run moves back into the
+// hole if that doesn't take it before its home slot.
+bool pitch_map_remove(PitchMap *m, Pitch p) {
+    int i = pitch_map_find(m, p, pitch_hash(p));
+    if (i < 0)
+        return false;
+    int mask = m->capacity - 1;
+    for (int j = (i + 1) & mask; m->tags[j]; j = (j + 1) & mask) {
+        int home = (int)(pitch_hash(m->keys[j]) & mask);
+        // whether home lies cyclically in (i, j], so the key must stay put
+        bool stays =
+            i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (stays)
+            continue;
+        m->tags[i] = m->tags[j];
+        m->keys[i] = m->keys[j];
+        m->values[i] = m->values[j];
+        i = j;
+    }
+    m->tags[i] = 0;
+    m->len--;
+    return true;
+}
 
-    return new_node;
+int pitch_map_put_all(PitchMap *m, const Pitch keys[],
+                      const PitchValue values[], int len) {
+    if (len > 0 && pitch_map_reserve(m, (long long)m->len + len))
+        return 1;
+    for (int i = 0; i < len; i++)
+        if (pitch_map_put(m, keys[i], values[i]))
+            return 1;
+    return 0;
 }
 
-PitchClassSet pc_set_clone(PitchClassSet set) {
-    if (set == NULL)
-        return NULL;
-    PitchClassSet copy = create_tnode(set->value);
-    copy->left = pc_set_clone(set->left);
-    copy->right = pc_set_clone(set->right);
-    return copy;
+int pitch_map_increment_all(PitchMap *m, const Pitch keys[], int len) {
+    for (int i = 0; i < len; i++) {
+        PitchValue *slot = pitch_map_slot(m, keys[i]);
+        if (!slot)
+            return 1;
+        slot->i++;
+    }
+    return 0;
 }
 
-void pc_set_insert_all(PitchClassSet *dest, PitchClassSet src) {
-    if (src == NULL)
-        return;
-    pc_set_insert(dest, src->value);
-    pc_set_insert_all(dest, src->left);
-    pc_set_insert_all(dest, src->right);
+bool pitch_map_next(const PitchMap *m, int *pos, Pitch *key,
+                    PitchValue *value) {
+    for (; *pos < m->capacity; (*pos)++) {
+        if (!m->tags[*pos])
+            continue;
+        *key = m->keys[*pos];
+        if (value)
+            *value = m->values[*pos];
+        (*pos)++;
+        return true;
+    }
+    return false;
 }
 
-PitchClassSet pc_set_union(PitchClassSet a, PitchClassSet b) {
-    PitchClassSet result = pc_set_clone(a);
-    pc_set_insert_all(&result, b);
-    return result;
+// Each Pitch gets a 64-bit key: its EDO number in the high half and its
+// diatonic steps in the low half, both with the sign bit flipped so that
+// unsigned order matches signed order. Sorting the keys a byte at a time from
+// the lowest byte up, stably, sorts by both at once.
+
+static uint64_t radix_key(int w, int h, EDOMap T) {
+    uint32_t number = (uint32_t)(T.m0 * w + T.m1 * h) ^ 0x80000000u;
+    uint32_t steps = (uint32_t)(w + h) ^ 0x80000000u;
+    return (uint64_t)number << 32 | steps;
 }
 
-PitchClassSet pc_set_intersection(PitchClassSet a, PitchClassSet b) {
-    if (a == NULL || b == NULL)
-        return NULL;
+// Bits needed to write x in binary.
+static int bit_width(uint32_t x) {
+    int bits = 0;
+    for (; x; x >>= 1)
+        bits++;
+    return bits;
+}
 
-    PitchClassSet result = NULL;
-    if (pc_set_contains(b, a->value))
-        pc_set_insert(&result, a->value);
+// Ranks the len keys at the start of keys, which must have room for 2 * len,
+// writing the index of each key in sorted order to out.
+static int radix_rank(uint64_t keys[], int len, int out[]) {
+    int *order = malloc(2 * (size_t)len * sizeof(int));
+    if (!order)
+        return 1;
 
-    PitchClassSet left = pc_set_intersection(a->left, b);
-    PitchClassSet right = pc_set_intersection(a->right, b);
+    // Measured from their smallest values, the numbers and steps of real
+    // music only take a few bits each, so packing them together leaves a much
+    // shorter key.
+    uint32_t number_lo = UINT32_MAX, steps_lo = UINT32_MAX;
+    uint32_t number_hi = 0, steps_hi = 0;
+    for (int i = 0; i < len; i++) {
+        uint32_t number = (uint32_t)(keys[i] >> 32), steps = (uint32_t)keys[i];
+        number_lo = number < number_lo ? number : number_lo;
+        number_hi = number > number_hi ? number : number_hi;
+        steps_lo = steps < steps_lo ? steps : steps_lo;
+        steps_hi = steps > steps_hi ? steps : steps_hi;
+    }
+    int steps_bits = bit_width(steps_hi - steps_lo);
+    int bytes = (bit_width(number_hi - number_lo) + steps_bits + 7) / 8;
 
-    result = pc_set_union(result, left);
-    result = pc_set_union(result, right);
+    // one pass over the keys counts every byte at once
+    int counts[8][256];
+    memset(counts, 0, sizeof(counts));
+    for (int i = 0; i < len; i++) {
+        uint64_t number = (uint32_t)(keys[i] >> 32) - number_lo;
+        keys[i] = number << steps_bits | ((uint32_t)keys[i] - steps_lo);
+        order[i] = i;
+        for (int b = 0; b < bytes; b++)
+            counts[b][keys[i] >> (8 * b) & 0xff]++;
+    }
 
-    return result;
+    uint64_t *src_keys = keys, *dst_keys = keys + len;
+    int *src_order = order, *dst_order = order + len;
+    for (int b = 0; b < bytes; b++) {
+        // a byte every key shares can't change the order
+        if (counts[b][src_keys[0] >> (8 * b) & 0xff] == len)
+            continue;
+        int start[256], total = 0;
+        for (int d = 0; d < 256; d++) {
+            start[d] = total;
+            total += counts[b][d];
+        }
+        for (int i = 0; i < len; i++) {
+            int j = start[src_keys[i] >> (8 * b) & 0xff]++;
+            dst_keys[j] = src_keys[i];
+            dst_order[j] = src_order[i];
+        }
+        uint64_t *k = src_keys;
+        src_keys = dst_keys;
+        dst_keys = k;
+        int *o = src_order;
+        src_order = dst_order;
+        dst_order = o;
+    }
+    memcpy(out, src_order, len * sizeof(int));
+    free(order);
+    return 0;
 }
 
-PitchClassSet pc_set_difference(PitchClassSet a, PitchClassSet b) {
-    if (a == NULL)
-        return NULL;
-
-    PitchClassSet result = NULL;
+int pitch_radix_argsort(const Pitch arr[], int len, EDOMap T, int out[]) {
+    if (len <= 0)
+        return 0;
+    uint64_t *keys = malloc(2 * (size_t)len * sizeof(uint64_t));
+    if (!keys)
+        return 1;
+    for (int i = 0; i < len; i++)
+        keys[i] = radix_key(arr[i].w, arr[i].h, T);
+    int failed = radix_rank(keys, len, out);
+    free(keys);
+    return failed;
+}
 
-    if (!pc_set_contains(b, a->value)) {
-        pc_set_insert(&result, a->value);
+int pitch_radix_sort(Pitch arr[], int len, EDOMap T) {
+    if (len <= 1)
+        return 0;
+    int *order = malloc(len * sizeof(int));
+    Pitch *copy = malloc(len * sizeof(Pitch));
+    if (!order || !copy || pitch_radix_argsort(arr, len, T, order)) {
+        free(order);
+        free(copy);
+        return 1;
     }
+    memcpy(copy, arr, len * sizeof(Pitch));
+    for (int i = 0; i < len; i++)
+        arr[i] = copy[order[i]];
+    free(order);
+    free(copy);
+    return 0;
+}
 
-    // Recurse left and right
-    PitchClassSet left = pc_set_difference(a->left, b);
-    PitchClassSet right = pc_set_difference(a->right, b);
+int pitch_buffer_radix_sort(PitchBuffer *b, EDOMap T) {
+    int len = b->len;
+    if (len <= 1)
+        return 0;
+    uint64_t *keys = malloc(2 * (size_t)len * sizeof(uint64_t));
+    int *order = malloc(len * sizeof(int));
+    int *copy = malloc(2 * (size_t)len * sizeof(int));
+    int failed = !keys || !order || !copy;
+    if (!failed) {
+        for (int i = 0; i < len; i++)
+            keys[i] = radix_key(b->w[i], b->h[i], T);
+        failed = radix_rank(keys, len, order);
+    }
+    if (!failed) {
+        memcpy(copy, b->w, len * sizeof(int));
+        memcpy(copy + len, b->h, len * sizeof(int));
+        for (int i = 0; i < len; i++) {
+            b->w[i] = copy[order[i]];
+            b->h[i] = copy[len + order[i]];
+        }
+    }
+    free(keys);
+    free(order);
+    free(copy);
+    return failed;
+}
 
-    // Merge results
-    result = pc_set_union(result, left);
-    result = pc_set_union(result, right);
+// Heights are (to within rounding) cents above the Pitch (0, 0) times the
+// HeightMap's scale, so a frequency's height comes from its cents above the
+// reference Pitch. That estimate is then nudged until the bound agrees with
+// to_hz at the Pitches of neighbouring heights, which matters for EDO heights,
+// where a Pitch exactly on a bound is common.
 
-    return result;
+static double height_of_hz(double hz, TuningMap T, HeightMap H) {
+    Map1D cents = map_compose_1d_2d(T.centmap, GENERATORS_TO);
+    double ref = cents.m0 * T.ref_pitch.w + cents.m1 * T.ref_pitch.h;
+    return (ref + 1200 * log2(hz / T.ref_freq)) * H.scale;
 }
 
-// A fifth outside this range can't produce a well-defined diatonic scale.
-static int fifth_supports_diatonic(double fifth) {
-    return fifth >= (1200.0 * 4 / 7) && fifth <= (1200.0 * 3 / 5);
+// A Pitch of the given height, if the HeightMap is an EDO's; fixed-point
+// heights have no such Pitch in general, and are left as estimated.
+static bool pitch_of_height(long long height, HeightMap H, Pitch *out) {
+    // m0 and m1 of an EDO HeightMap are the sizes of whole and half steps
+    long long a = H.m0, b = H.m1;
+    if (H.scale >= 1048576.0 || a <= 0 || b <= 0)
+        return false;
+    // solve a * w + b * h = height with extended Euclid
+    long long x0 = 1, y0 = 0, x1 = 0, y1 = 1;
+    while (b) {
+        long long q = a / b, t = a - q * b;
+        a = b, b = t;
+        t = x0 - q * x1, x0 = x1, x1 = t;
+        t = y0 - q * y1, y0 = y1, y1 = t;
+    }
+    if (a != 1)
+        return false;
+    // Adding (m1, -m0) keeps the height and moves the chroma by a whole EDO,
+    // so pick the solution spelled nearest C, whose frequency in a tuning only
+    // approximated by the EDO is closest to the EDO's.
+    long long w = x0 * height, h = y0 * height, edo = 5 * H.m0 + 2 * H.m1;
+    long long k = (2 * w - 5 * h + edo / 2) / edo;
+    k -= (2 * w - 5 * h + edo / 2) % edo < 0;
+    *out = (Pitch){(int)(w - k * H.m1), (int)(h + k * H.m0)};
+    return true;
 }
 
-int tuning_map_from_fifth(double fifth, Pitch ref_pitch, double ref_freq,
-                          TuningMap *out) {
-    if (!fifth_supports_diatonic(fifth))
+int pitch_range_from_hz(double lo_hz, double hi_hz, TuningMap T,
+                        PitchRange *out) {
+    if (!(lo_hz > 0) || !isfinite(hi_hz) || !(hi_hz >= lo_hz))
         return 1;
-    *out = (TuningMap){.ref_pitch = ref_pitch,
-                       .ref_freq = ref_freq,
-                       .centmap = (Map1D){fifth, 1200}};
+    HeightMap H = height_map_from_tuning(T);
+    long long lo = (long long)ceil(height_of_hz(lo_hz, T, H));
+    long long hi = (long long)floor(height_of_hz(hi_hz, T, H));
+    Pitch p;
+    while (pitch_of_height(lo - 1, H, &p) && to_hz(p, T) >= lo_hz)
+        lo--;
+    while (pitch_of_height(lo, H, &p) && to_hz(p, T) < lo_hz)
+        lo++;
+    while (pitch_of_height(hi + 1, H, &p) && to_hz(p, T) <= hi_hz)
+        hi++;
+    while (pitch_of_height(hi, H, &p) && to_hz(p, T) > hi_hz)
+        hi--;
+    *out = (PitchRange){.H = H, .lo = lo, .hi = hi};
     return 0;
 }
 
-int tuning_map_from_edo(int edo, Pitch ref_pitch, double ref_freq,
-                       TuningMap *out) {
-    int fifth_steps = round(log2(1.5) * edo);
-    double fifth = (float)fifth_steps * 1200 / edo;
-    return tuning_map_from_fifth(fifth, ref_pitch, ref_freq, out);
+PitchRange pitch_range_from_pitches(Pitch lo, Pitch hi, TuningMap T) {
+    HeightMap H = height_map_from_tuning(T);
+    return (PitchRange){
+        .H = H, .lo = pitch_height(lo, H), .hi = pitch_height(hi, H)};
 }
 
-double to_cents(Interval m, TuningMap T) {
-    return map_to_1d(map_to_2d((MapVec){m.w, m.h}, GENERATORS_TO), T.centmap);
+PitchRange pitch_range_audible(TuningMap T) {
+    PitchRange r;
+    pitch_range_from_hz(20.0, 20000.0, T, &r);
+    return r;
 }
 
-double to_ratio(Interval m, TuningMap T) {
-    return pow(2, to_cents(m, T) / 1200);
+int pitches_in_range(const Pitch arr[], int len, PitchRange r, bool out[]) {
+    int count = 0;
+    for (int i = 0; i < len; i++)
+        count += out[i] = pitch_in_range(arr[i], r);
+    return count;
 }
 
-double to_hz(Pitch p, TuningMap T) {
-    return T.ref_freq * to_ratio(interval_between(T.ref_pitch, p), T);
+int pitches_filter_range(const Pitch arr[], int len, PitchRange r,
+                         Pitch out[]) {
+    int count = 0;
+    for (int i = 0; i < len; i++) {
+        Pitch p = arr[i];
+        if (pitch_in_range(p, r))
+            out[count++] = p;
+    }
+    return count;
 }
 
-int create_edo_map(int edo, EDOMap *out) {
-    int fifth_steps = (int)round(log2(1.5) * edo);
-    double fifth = (double)fifth_steps * 1200 / edo;
-    if (!fifth_supports_diatonic(fifth))
+// A Pitch with at most k sharps or flats has a chroma from -7k - 1 to 7k + 5,
+// and every Pitch of one chroma is an octave apart from the next. Moving one
+// Pitch of each chroma into the octave starting at r.lo and sorting them gives
+// the order for every octave of the range, so listing is then a matter of
+// stepping through that octave over and over, an octave higher each time.
+int pitch_range_spellings(PitchRange r, int max_accidental, Pitch out[],
+                          int capacity, int *total) {
+    if (capacity < 0 || max_accidental < 0 || max_accidental > 100000)
         return 1;
-
-    int whole = ((fifth_steps * 2) % edo + edo) % edo;
-    int half = ((fifth_steps * -5) % edo + edo) % edo;
-    *out = (EDOMap){whole, half};
+    int len = 14 * max_accidental + 7;
+    Pitch *octave = malloc(len * sizeof(Pitch));
+    if (!octave)
+        return 1;
+    long long span = pitch_height((Pitch){5, 2}, r.H);
+    long long count = 0;
+    for (int i = 0; i < len; i++) {
+        int chroma = i - 7 * max_accidental - 1;
+        Pitch p = {3 * chroma, chroma};
+        // the fewest octaves that bring p up to r.lo, which may be negative
+        long long below = r.lo - pitch_height(p, r.H);
+        long long n = below / span + (below % span > 0);
+        octave[i] = (Pitch){(int)(p.w + 5 * n), (int)(p.h + 2 * n)};
+        long long height = pitch_height(octave[i], r.H);
+        if (height <= r.hi)
+            count += (r.hi - height) / span + 1;
+    }
+    if (count > INT_MAX) {
+        free(octave);
+        return 1;
+    }
+    pitch_sort(octave, len, r.H);
+    for (int i = 0, n = 0; i < count && i < capacity; n++)
+        for (int j = 0; j < len && i < count && i < capacity; j++, i++)
+            out[i] = (Pitch){octave[j].w + 5 * n, octave[j].h + 2 * n};
+    free(octave);
+    *total = (int)count;
     return 0;
 }
 
@@ -1390,14 +6705,11 @@ int pitch_from_relative_lily(
     out->w += acc;
     out->h -= acc;
 
-    while (steps_between((Pitch){out->w, out->h}, ctx->previous) > 3) {
-        out->w += 5;
-        out->h += 2;
-    }
-    while (steps_between((Pitch){out->w, out->h}, ctx->previous) < -3) {
-        out->w -= 5;
-        out->h -= 2;
-    }
+    // the octave that lands within a 4th of the previous note
+    int octaves =
+        floor_div7(steps_between((Pitch){out->w, out->h}, ctx->previous) + 3);
+    out->w += 5 * octaves;
+    out->h += 2 * octaves;
 
     int oct = 0;
     while (*p == '\'' || *p == ',') {
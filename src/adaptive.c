@@ -0,0 +1,87 @@
+#include "../include/adaptive.h"
+#include "../include/map.h"
+#include "../include/pitch.h"
+#include "../include/types.h"
+#include <math.h>
+#include <stdlib.h>
+
+// An interval of x fifths is read as a fifths and b major thirds, x = a + 4b,
+// choosing b so that |a| <= 2 (ties toward the sharper spelling with fewer
+// thirds, so 6 fifths is 45/32 rather than 64/45). Octaves are pure in both
+// tunings, so only the fifths and thirds contribute to the offset.
+static double adaptive_target(int x, double fifth_error, double third_error) {
+    int b = (x < 0 ? -1 : 1) * ((abs(x) + 1) / 4);
+    return (x - 4 * b) * fifth_error + b * third_error;
+}
+
+int adaptive_tuner_create(TuningMap T, double max_drift, AdaptiveTuner *out) {
+    if (!(max_drift >= 0) || isinf(max_drift))
+        return 1;
+    out->fifth_error = 1200 * log2(3.0 / 2) - to_cents((Interval){3, 1}, T);
+    out->third_error = 1200 * log2(5.0 / 4) - to_cents((Interval){2, 0}, T);
+    for (int x = -ADAPTIVE_MAX_CHROMA; x <= ADAPTIVE_MAX_CHROMA; x++)
+        out->target[ADAPTIVE_MAX_CHROMA + x] =
+            adaptive_target(x, out->fifth_error, out->third_error);
+    out->max_drift = max_drift;
+    adaptive_tuner_reset(out);
+    return 0;
+}
+
+void adaptive_tuner_reset(AdaptiveTuner *t) {
+    t->drift = 0;
+    t->len = 0;
+}
+
+// Minimising the squared error over every pair of notes has a closed form: each
+// note's offset is the mean of the targets to every note in the chord (itself
+// included, with target 0), plus a shift common to the whole chord. Targets
+// are odd in x, so before shifting the offsets average to 0 and the shift is
+// exactly the chord's drift.
+int adaptive_tuner_update(AdaptiveTuner *t, const Pitch chord[], int len,
+                          double out[]) {
+    if (len < 0 || len > ADAPTIVE_MAX_VOICES)
+        return 1;
+
+    int chroma[ADAPTIVE_MAX_VOICES];
+    for (int i = 0; i < len; i++)
+        chroma[i] = pitch_chroma(chord[i]);
+
+    for (int i = 0; i < len; i++) {
+        double sum = 0;
+        for (int j = 0; j < len; j++) {
+            int x = chroma[i] - chroma[j];
+            sum += abs(x) <= ADAPTIVE_MAX_CHROMA
+                       ? t->target[ADAPTIVE_MAX_CHROMA + x]
+                       : adaptive_target(x, t->fifth_error, t->third_error);
+        }
+        out[i] = sum / len;
+    }
+
+    // Hold common tones where they were, on average, or failing that keep the
+    // drift of the previous chord.
+    double shift = 0;
+    int common = 0;
+    for (int i = 0; i < len; i++) {
+        for (int j = 0; j < t->len; j++) {
+            if (pitches_equal(chord[i], t->held[j])) {
+                shift += t->offset[j] - out[i];
+                common++;
+                break;
+            }
+        }
+    }
+    shift = common ? shift / common : t->drift;
+    if (shift > t->max_drift)
+        shift = t->max_drift;
+    if (shift < -t->max_drift)
+        shift = -t->max_drift;
+
+    for (int i = 0; i < len; i++) {
+        out[i] += shift;
+        t->held[i] = chord[i];
+        t->offset[i] = out[i];
+    }
+    t->drift = shift;
+    t->len = len;
+    return 0;
+}
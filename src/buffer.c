@@ -0,0 +1,500 @@
+#include "../include/arith.h"
+#include "../include/buffer.h"
+#include "../include/parallel.h"
+#include "../include/pitch.h"
+#include "../include/range.h"
+#include "../include/tonality.h"
+#include "../include/types.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Every kernel below has an AVX2 loop over 8 Pitches at a time when compiled
+// with AVX2 enabled (e.g. -mavx2 or -march=native), and a scalar loop that
+// finishes off the remainder, or does everything otherwise. The buffer's
+// arrays are 32-byte aligned and the AVX2 loop always starts at 0, so its
+// loads never split a cache line. They're still done as unaligned loads, so
+// that a PitchBuffer viewing part of another's arrays (to split work into
+// chunks) works too; caller-owned out arrays may not be aligned either.
+
+// aligned_alloc is C11, so arrays are aligned by hand: malloc enough to round
+// up to the next multiple of 32, and keep the pointer malloc returned just
+// below the array for pitch_buffer_free.
+static int *pitch_buffer_alloc(int capacity) {
+    size_t bytes = (size_t)capacity * sizeof(int);
+    unsigned char *raw = malloc(bytes + 31 + sizeof(void *));
+    if (!raw)
+        return NULL;
+    uintptr_t at = ((uintptr_t)(raw + sizeof(void *)) + 31) & ~(uintptr_t)31;
+    ((void **)at)[-1] = raw;
+    return (int *)at;
+}
+
+static void pitch_buffer_free(int *arr) {
+    if (arr)
+        free(((void **)arr)[-1]);
+}
+
+int pitch_buffer_create(int capacity, PitchBuffer *out) {
+    if (capacity < 0)
+        return 1;
+    int *w = pitch_buffer_alloc(capacity);
+    int *h = pitch_buffer_alloc(capacity);
+    if (!w || !h) {
+        pitch_buffer_free(w);
+        pitch_buffer_free(h);
+        return 1;
+    }
+    *out = (PitchBuffer){.w = w, .h = h, .len = 0, .capacity = capacity};
+    return 0;
+}
+
+void pitch_buffer_destroy(PitchBuffer *b) {
+    pitch_buffer_free(b->w);
+    pitch_buffer_free(b->h);
+}
+
+int pitch_buffer_from_pitches(PitchBuffer *b, const Pitch arr[], int len) {
+    if (len < 0 || len > b->capacity)
+        return 1;
+    for (int i = 0; i < len; i++) {
+        b->w[i] = arr[i].w;
+        b->h[i] = arr[i].h;
+    }
+    b->len = len;
+    return 0;
+}
+
+void pitch_buffer_to_pitches(const PitchBuffer *b, Pitch out[]) {
+    for (int i = 0; i < b->len; i++)
+        out[i] = (Pitch){b->w[i], b->h[i]};
+}
+
+#ifdef __AVX2__
+// floor(x / 7) in every lane. AVX2 has no integer division, so this is the
+// multiply-high by a magic number that compilers use for signed division by 7
+// (Hacker's Delight, 10-3), done for even and odd lanes separately, followed by
+// a step from truncated to floored division.
+static inline __m256i floordiv7_avx2(__m256i x) {
+    __m256i magic = _mm256_set1_epi32((int)0x92492493);
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(x, magic), 32);
+    __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(x, 32), magic);
+    __m256i q = _mm256_add_epi32(_mm256_blend_epi32(even, odd, 0xaa), x);
+    q = _mm256_sub_epi32(_mm256_srai_epi32(q, 2), _mm256_srai_epi32(x, 31));
+    __m256i q7 = _mm256_sub_epi32(_mm256_slli_epi32(q, 3), q);
+    __m256i r = _mm256_sub_epi32(x, q7);
+    return _mm256_add_epi32(q, _mm256_cmpgt_epi32(_mm256_setzero_si256(), r));
+}
+
+// x / 12 as C defines it (truncated) in every lane, exact for every int: the
+// same signed multiply-high as floordiv7_avx2 with 12's magic number.
+static inline __m256i truncdiv12_avx2(__m256i x) {
+    __m256i magic = _mm256_set1_epi32(0x2aaaaaab);
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(x, magic), 32);
+    __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(x, 32), magic);
+    __m256i q = _mm256_blend_epi32(even, odd, 0xaa);
+    return _mm256_sub_epi32(_mm256_srai_epi32(q, 1), _mm256_srai_epi32(x, 31));
+}
+
+// Inclusive prefix sum of the 8 lanes: each 128-bit half is summed with two
+// shifts, and then the low half's total is added to the high half.
+static inline __m256i scan_avx2(__m256i x) {
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+    __m256i low = _mm256_permutevar8x32_epi32(
+        x, _mm256_setr_epi32(0, 0, 0, 0, 3, 3, 3, 3));
+    return _mm256_add_epi32(
+        x, _mm256_blend_epi32(_mm256_setzero_si256(), low, 0xf0));
+}
+
+static inline __m256i load_avx2(const int *p) {
+    return _mm256_loadu_si256((const __m256i *)p);
+}
+
+static inline void store_avx2(int *p, __m256i x) {
+    _mm256_storeu_si256((__m256i *)p, x);
+}
+#endif
+
+void pitch_buffer_transpose(PitchBuffer *b, Interval m) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i dw = _mm256_set1_epi32(m.w), dh = _mm256_set1_epi32(m.h);
+    for (; i + 8 <= b->len; i += 8) {
+        store_avx2(b->w + i, _mm256_add_epi32(load_avx2(b->w + i), dw));
+        store_avx2(b->h + i, _mm256_add_epi32(load_avx2(b->h + i), dh));
+    }
+#endif
+    for (; i < b->len; i++) {
+        b->w[i] += m.w;
+        b->h[i] += m.h;
+    }
+}
+
+void pitch_buffer_invert(PitchBuffer *b, MirrorAxis a) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i aw = _mm256_set1_epi32(a.w), ah = _mm256_set1_epi32(a.h);
+    for (; i + 8 <= b->len; i += 8) {
+        store_avx2(b->w + i, _mm256_sub_epi32(aw, load_avx2(b->w + i)));
+        store_avx2(b->h + i, _mm256_sub_epi32(ah, load_avx2(b->h + i)));
+    }
+#endif
+    for (; i < b->len; i++) {
+        b->w[i] = a.w - b->w[i];
+        b->h[i] = a.h - b->h[i];
+    }
+}
+
+int pitch_buffer_intervals(const PitchBuffer *p, const PitchBuffer *q,
+                           PitchBuffer *out) {
+    if (p->len != q->len || out->capacity < p->len)
+        return 1;
+    int i = 0;
+#ifdef __AVX2__
+    for (; i + 8 <= p->len; i += 8) {
+        store_avx2(out->w + i,
+                   _mm256_sub_epi32(load_avx2(q->w + i), load_avx2(p->w + i)));
+        store_avx2(out->h + i,
+                   _mm256_sub_epi32(load_avx2(q->h + i), load_avx2(p->h + i)));
+    }
+#endif
+    for (; i < p->len; i++) {
+        out->w[i] = q->w[i] - p->w[i];
+        out->h[i] = q->h[i] - p->h[i];
+    }
+    out->len = p->len;
+    return 0;
+}
+
+void pitch_buffer_chromas(const PitchBuffer *b, int out[]) {
+    int i = 0;
+#ifdef __AVX2__
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i w = load_avx2(b->w + i), h = load_avx2(b->h + i);
+        __m256i h5 = _mm256_add_epi32(_mm256_slli_epi32(h, 2), h);
+        store_avx2(out + i, _mm256_sub_epi32(_mm256_add_epi32(w, w), h5));
+    }
+#endif
+    for (; i < b->len; i++)
+        out[i] = 2 * b->w[i] - 5 * b->h[i];
+}
+
+void pitch_buffer_midis(const PitchBuffer *b, int out[]) {
+    int i = 0;
+#ifdef __AVX2__
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i w = load_avx2(b->w + i), h = load_avx2(b->h + i);
+        store_avx2(out + i, _mm256_add_epi32(_mm256_add_epi32(w, w), h));
+    }
+#endif
+    for (; i < b->len; i++)
+        out[i] = 2 * b->w[i] + b->h[i];
+}
+
+void pitch_buffer_letters(const PitchBuffer *b, int out[]) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i two = _mm256_set1_epi32(2), seven = _mm256_set1_epi32(7);
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i x = _mm256_add_epi32(
+            _mm256_add_epi32(load_avx2(b->w + i), load_avx2(b->h + i)), two);
+        __m256i q = _mm256_mullo_epi32(floordiv7_avx2(x), seven);
+        store_avx2(out + i, _mm256_sub_epi32(x, q));
+    }
+#endif
+    for (; i < b->len; i++)
+        out[i] = pitch_letter((Pitch){b->w[i], b->h[i]});
+}
+
+void pitch_buffer_accidentals(const PitchBuffer *b, int out[]) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i one = _mm256_set1_epi32(1);
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i w = load_avx2(b->w + i), h = load_avx2(b->h + i);
+        __m256i h5 = _mm256_add_epi32(_mm256_slli_epi32(h, 2), h);
+        __m256i x = _mm256_add_epi32(
+            _mm256_sub_epi32(_mm256_add_epi32(w, w), h5), one);
+        store_avx2(out + i, floordiv7_avx2(x));
+    }
+#endif
+    for (; i < b->len; i++)
+        out[i] = pitch_accidental((Pitch){b->w[i], b->h[i]});
+}
+
+void pitch_buffer_octaves(const PitchBuffer *b, int out[]) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i one = _mm256_set1_epi32(1);
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i x = _mm256_add_epi32(load_avx2(b->w + i), load_avx2(b->h + i));
+        store_avx2(out + i, _mm256_sub_epi32(floordiv7_avx2(x), one));
+    }
+#endif
+    for (; i < b->len; i++)
+        out[i] = pitch_octave((Pitch){b->w[i], b->h[i]});
+}
+
+// Runs the three classifiers over a chunk at a time (keeping their output in
+// L1) and then interleaves them into StandardPitches.
+void pitch_buffer_to_standard(const PitchBuffer *b, StandardPitch out[]) {
+    enum { CHUNK = 256 };
+    int letter[CHUNK], accidental[CHUNK], octave[CHUNK];
+    for (int start = 0; start < b->len; start += CHUNK) {
+        int n = b->len - start < CHUNK ? b->len - start : CHUNK;
+        PitchBuffer chunk = {b->w + start, b->h + start, n, n};
+        pitch_buffer_letters(&chunk, letter);
+        pitch_buffer_accidentals(&chunk, accidental);
+        pitch_buffer_octaves(&chunk, octave);
+        for (int i = 0; i < n; i++)
+            out[start + i] =
+                (StandardPitch){letter[i], accidental[i], octave[i]};
+    }
+}
+
+void pitch_buffer_pc12s(const PitchBuffer *b, int out[]) {
+    int i = 0;
+#ifdef __AVX2__
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i w = load_avx2(b->w + i), h = load_avx2(b->h + i);
+        __m256i x = _mm256_add_epi32(_mm256_add_epi32(w, w), h);
+        __m256i q = truncdiv12_avx2(x);
+        __m256i q3 = _mm256_add_epi32(_mm256_add_epi32(q, q), q);
+        store_avx2(out + i, _mm256_sub_epi32(x, _mm256_slli_epi32(q3, 2)));
+    }
+#endif
+    for (; i < b->len; i++)
+        out[i] = pitch_pc12((Pitch){b->w[i], b->h[i]});
+}
+
+void pitch_buffer_degrees(const PitchBuffer *b, TonalContext key, int out[]) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i shift = _mm256_set1_epi32(2 - key.tonic.letter);
+    __m256i seven = _mm256_set1_epi32(7);
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i x = _mm256_add_epi32(
+            _mm256_add_epi32(load_avx2(b->w + i), load_avx2(b->h + i)), shift);
+        __m256i q = _mm256_mullo_epi32(floordiv7_avx2(x), seven);
+        store_avx2(out + i, _mm256_sub_epi32(x, q));
+    }
+#endif
+    for (; i < b->len; i++)
+        out[i] = degree_number((Pitch){b->w[i], b->h[i]}, key);
+}
+
+// Chromas are enharmonic when their difference d is a multiple of edo, and
+// |d| is a multiple of edo exactly when |d| * c, with c = 2^64 / edo rounded
+// up, wraps to less than c (Lemire, Kaser & Kurz, "Faster Remainder by Direct
+// Computation", 2019). That leaves one division per call instead of four per
+// Pitch.
+int pitch_buffer_enharmonic(const PitchBuffer *p, const PitchBuffer *q,
+                            int edo, bool out[]) {
+    if (p->len != q->len || edo <= 0)
+        return 1;
+    uint64_t c = UINT64_MAX / (uint64_t)edo + 1;
+    for (int i = 0; i < p->len; i++) {
+        // two ints are less than 2^32 apart, so n fits 32 bits
+        long long d = (long long)(2 * p->w[i] - 5 * p->h[i]) -
+                      (2 * q->w[i] - 5 * q->h[i]);
+        uint32_t n = (uint32_t)(d < 0 ? -d : d);
+        out[i] = n * c <= c - 1;
+    }
+    return 0;
+}
+
+// Each vector is scanned on its own and then offset by the running total of
+// everything before it, carried along broadcast to every lane.
+static Pitch buffer_scan(PitchBuffer *b, Pitch start) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i last = _mm256_set1_epi32(7);
+    __m256i cw = _mm256_set1_epi32(start.w), ch = _mm256_set1_epi32(start.h);
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i w = _mm256_add_epi32(scan_avx2(load_avx2(b->w + i)), cw);
+        __m256i h = _mm256_add_epi32(scan_avx2(load_avx2(b->h + i)), ch);
+        store_avx2(b->w + i, w);
+        store_avx2(b->h + i, h);
+        cw = _mm256_permutevar8x32_epi32(w, last);
+        ch = _mm256_permutevar8x32_epi32(h, last);
+    }
+    if (i > 0)
+        start = (Pitch){b->w[i - 1], b->h[i - 1]};
+#endif
+    for (; i < b->len; i++) {
+        start.w = b->w[i] += start.w;
+        start.h = b->h[i] += start.h;
+    }
+    return start;
+}
+
+// Each vector is shifted up a lane, with the previous vector's last lane
+// moved into the bottom, and subtracted from itself.
+static void buffer_differences(PitchBuffer *b, Pitch start) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i rotate = _mm256_setr_epi32(7, 0, 1, 2, 3, 4, 5, 6);
+    __m256i pw = _mm256_set1_epi32(start.w), ph = _mm256_set1_epi32(start.h);
+    for (; i + 8 <= b->len; i += 8) {
+        __m256i w = load_avx2(b->w + i), h = load_avx2(b->h + i);
+        __m256i rw = _mm256_permutevar8x32_epi32(w, rotate);
+        __m256i rh = _mm256_permutevar8x32_epi32(h, rotate);
+        __m256i prev_w = _mm256_blend_epi32(rw, pw, 1);
+        __m256i prev_h = _mm256_blend_epi32(rh, ph, 1);
+        store_avx2(b->w + i, _mm256_sub_epi32(w, prev_w));
+        store_avx2(b->h + i, _mm256_sub_epi32(h, prev_h));
+        pw = rw;
+        ph = rh;
+    }
+    if (i > 0)
+        start = (Pitch){_mm256_cvtsi256_si32(pw), _mm256_cvtsi256_si32(ph)};
+#endif
+    for (; i < b->len; i++) {
+        Pitch p = {b->w[i], b->h[i]};
+        b->w[i] -= start.w;
+        b->h[i] -= start.h;
+        start = p;
+    }
+}
+
+Interval pitch_buffer_sum(const PitchBuffer *b) {
+    int i = 0;
+    Interval sum = {0, 0};
+#ifdef __AVX2__
+    __m256i sw = _mm256_setzero_si256(), sh = _mm256_setzero_si256();
+    for (; i + 8 <= b->len; i += 8) {
+        sw = _mm256_add_epi32(sw, load_avx2(b->w + i));
+        sh = _mm256_add_epi32(sh, load_avx2(b->h + i));
+    }
+    int lanes[8];
+    store_avx2(lanes, scan_avx2(sw));
+    sum.w = lanes[7];
+    store_avx2(lanes, scan_avx2(sh));
+    sum.h = lanes[7];
+#endif
+    for (; i < b->len; i++) {
+        sum.w += b->w[i];
+        sum.h += b->h[i];
+    }
+    return sum;
+}
+
+// Buffers longer than this are split between threads (see parallel.h). Each
+// chunk is scanned from the total of the chunks before it, found by summing
+// every chunk first; differences only need the Pitch before each chunk.
+enum { BUFFER_SLICE = 1 << 18 };
+
+typedef struct {
+    PitchBuffer *b;
+    Pitch start[PARALLEL_MAX_THREADS];
+    Interval sum[PARALLEL_MAX_THREADS];
+} BufferSlices;
+
+static PitchBuffer buffer_slice(PitchBuffer *b, long start, long end) {
+    int n = end - start;
+    return (PitchBuffer){b->w + start, b->h + start, n, n};
+}
+
+static void buffer_slice_sum(void *ctx, int chunk, long start, long end) {
+    BufferSlices *s = ctx;
+    PitchBuffer slice = buffer_slice(s->b, start, end);
+    s->sum[chunk] = pitch_buffer_sum(&slice);
+}
+
+static void buffer_slice_scan(void *ctx, int chunk, long start, long end) {
+    BufferSlices *s = ctx;
+    PitchBuffer slice = buffer_slice(s->b, start, end);
+    buffer_scan(&slice, s->start[chunk]);
+}
+
+static void buffer_slice_differences(void *ctx, int chunk, long start,
+                                     long end) {
+    BufferSlices *s = ctx;
+    PitchBuffer slice = buffer_slice(s->b, start, end);
+    buffer_differences(&slice, s->start[chunk]);
+}
+
+Pitch pitch_buffer_scan(PitchBuffer *b, Pitch start) {
+    int n = parallel_chunks(b->len, BUFFER_SLICE);
+    if (n == 1)
+        return buffer_scan(b, start);
+
+    BufferSlices s = {.b = b};
+    parallel_for(b->len, BUFFER_SLICE, buffer_slice_sum, &s);
+    s.start[0] = start;
+    for (int i = 1; i < n; i++)
+        s.start[i] = transpose_real(s.start[i - 1], s.sum[i - 1]);
+    parallel_for(b->len, BUFFER_SLICE, buffer_slice_scan, &s);
+    return transpose_real(s.start[n - 1], s.sum[n - 1]);
+}
+
+void pitch_buffer_differences(PitchBuffer *b, Pitch start) {
+    int n = parallel_chunks(b->len, BUFFER_SLICE);
+    if (n == 1) {
+        buffer_differences(b, start);
+        return;
+    }
+
+    BufferSlices s = {.b = b};
+    s.start[0] = start;
+    for (int i = 1; i < n; i++) {
+        long first = (long long)i * b->len / n;
+        s.start[i] = (Pitch){b->w[first - 1], b->h[first - 1]};
+    }
+    parallel_for(b->len, BUFFER_SLICE, buffer_slice_differences, &s);
+}
+
+// Heights need 64 bits, so the AVX2 loop widens each half of 8 Pitches to 4
+// 64-bit lanes and multiplies with _mm256_mul_epi32, which takes the low 32
+// bits of each lane as signed. That's exact when the HeightMap's coefficients
+// fit in 32 bits, as they do for every EDO and for fixed-point heights of any
+// sensible tuning; otherwise the scalar loop does everything.
+int pitch_buffer_in_range(const PitchBuffer *b, PitchRange r, bool out[]) {
+    int i = 0, count = 0;
+#ifdef __AVX2__
+    if (r.H.m0 == (int)r.H.m0 && r.H.m1 == (int)r.H.m1) {
+        __m256i m0 = _mm256_set1_epi64x(r.H.m0);
+        __m256i m1 = _mm256_set1_epi64x(r.H.m1);
+        __m256i lo = _mm256_set1_epi64x(r.lo), hi = _mm256_set1_epi64x(r.hi);
+        for (; i + 8 <= b->len; i += 8) {
+            __m256i w = load_avx2(b->w + i), h = load_avx2(b->h + i);
+            for (int half = 0; half < 2; half++) {
+                __m128i w4 = half ? _mm256_extracti128_si256(w, 1)
+                                  : _mm256_castsi256_si128(w);
+                __m128i h4 = half ? _mm256_extracti128_si256(h, 1)
+                                  : _mm256_castsi256_si128(h);
+                __m256i height = _mm256_add_epi64(
+                    _mm256_mul_epi32(_mm256_cvtepi32_epi64(w4), m0),
+                    _mm256_mul_epi32(_mm256_cvtepi32_epi64(h4), m1));
+                __m256i outside = _mm256_or_si256(
+                    _mm256_cmpgt_epi64(lo, height),
+                    _mm256_cmpgt_epi64(height, hi));
+                // spread the 4 inside bits to 4 bools with one multiply
+                uint32_t in = ~_mm256_movemask_pd(_mm256_castsi256_pd(outside));
+                in = ((in & 15) * 0x00204081u) & 0x01010101u;
+                memcpy(out + i + 4 * half, &in, 4);
+                count += (in * 0x01010101u) >> 24;
+            }
+        }
+    }
+#endif
+    for (; i < b->len; i++)
+        count += out[i] = pitch_in_range((Pitch){b->w[i], b->h[i]}, r);
+    return count;
+}
+
+int pitch_buffer_filter_range(PitchBuffer *b, PitchRange r) {
+    int count = 0;
+    for (int i = 0; i < b->len; i++) {
+        int w = b->w[i], h = b->h[i];
+        b->w[count] = w;
+        b->h[count] = h;
+        count += pitch_in_range((Pitch){w, h}, r);
+    }
+    b->len = count;
+    return count;
+}
@@ -0,0 +1,204 @@
+#include "../include/chroma.h"
+#include "../include/fft.h"
+#include "../include/map.h"
+#include "../include/parallel.h"
+#include "../include/types.h"
+#include <math.h>
+#include <stdlib.h>
+
+static const double CHROMA_TAU = 6.283185307179586;
+
+// Which class a bin goes to: the nearest pitch class, measured around the
+// octave, with ties as documented in chromagram_create.
+static int chroma_class_of(double cents, const double pc[], int chroma_min,
+                           int classes) {
+    int best = 0;
+    double best_d = INFINITY;
+    for (int i = 0; i < classes; i++) {
+        double d = fabs(remainder(cents - pc[i], 1200));
+        int chroma = chroma_min + i, prev = chroma_min + best;
+        if (d < best_d - 1e-9 ||
+            (d < best_d + 1e-9 &&
+             (abs(chroma) < abs(prev) || (abs(chroma) == abs(prev) &&
+                                          chroma < prev)))) {
+            best = i;
+            best_d = d;
+        }
+    }
+    return best;
+}
+
+int chromagram_create(TuningMap T, int sample_rate, int window, int hop,
+                      int chroma_min, int chroma_max, double min_hz,
+                      double max_hz, Chromagram *out) {
+    int classes = chroma_max - chroma_min + 1;
+    if (sample_rate <= 0 || hop <= 0 || classes <= 0 || window <= 0 ||
+        !(min_hz < max_hz) || isinf(max_hz))
+        return 1;
+    double lo = ceil(min_hz * window / sample_rate);
+    double hi = floor(max_hz * window / sample_rate);
+    int first = lo < 1 ? 1 : lo > window ? window : lo;
+    int last = hi > window / 2 ? window / 2 : hi < 0 ? 0 : hi;
+    if (first > last)
+        return 1;
+
+    FFTPlan fft;
+    if (fft_plan_create(window, &fft))
+        return 1;
+    int bins = last - first + 1;
+    double *pc = malloc(classes * sizeof(double));
+    int *bin_class = malloc(bins * sizeof(int));
+    double *hann = malloc(window * sizeof(double));
+    double *re = malloc(window * sizeof(double));
+    double *im = malloc(window * sizeof(double));
+    int *run_start = malloc(bins * sizeof(int));
+    int *run_end = malloc(bins * sizeof(int));
+    int *class_runs = calloc(classes + 1, sizeof(int));
+    if (!pc || !bin_class || !hann || !re || !im || !run_start || !run_end ||
+        !class_runs) {
+        free(pc);
+        free(bin_class);
+        free(hann);
+        free(re);
+        free(im);
+        free(run_start);
+        free(run_end);
+        free(class_runs);
+        fft_plan_destroy(&fft);
+        return 1;
+    }
+
+    // Pitch classes in cents above the TuningMap's reference pitch.
+    for (int i = 0; i < classes; i++) {
+        int chroma = chroma_min + i;
+        Interval m = {3 * chroma - T.ref_pitch.w, chroma - T.ref_pitch.h};
+        pc[i] = to_cents(m, T);
+    }
+    for (int k = first; k <= last; k++) {
+        double hz = (double)k * sample_rate / window;
+        double cents = 1200 * log2(hz / T.ref_freq);
+        bin_class[k - first] = chroma_class_of(cents, pc, chroma_min, classes);
+    }
+
+    // Consecutive bins of the same class form a run, and runs are grouped by
+    // class (a counting sort), so each class sums a few contiguous stretches
+    // of the spectrum rather than scattering every bin.
+    int runs = 0;
+    for (int k = 0; k < bins; k++)
+        if (k == 0 || bin_class[k] != bin_class[k - 1])
+            class_runs[bin_class[k] + 1]++, runs++;
+    for (int i = 0; i < classes; i++)
+        class_runs[i + 1] += class_runs[i];
+    for (int k = 0; k < bins;) {
+        int end = k + 1;
+        while (end < bins && bin_class[end] == bin_class[k])
+            end++;
+        int r = class_runs[bin_class[k]]++;
+        run_start[r] = first + k;
+        run_end[r] = first + end;
+        k = end;
+    }
+    // Filling moved each class's start up to the next one's, so shift back.
+    for (int i = classes; i > 0; i--)
+        class_runs[i] = class_runs[i - 1];
+    class_runs[0] = 0;
+    free(pc);
+    free(bin_class);
+
+    for (int i = 0; i < window; i++)
+        hann[i] = 0.5 - 0.5 * cos(CHROMA_TAU * i / window);
+
+    *out = (Chromagram){.sample_rate = sample_rate,
+                        .window = window,
+                        .hop = hop,
+                        .chroma_min = chroma_min,
+                        .classes = classes,
+                        .fft = fft,
+                        .hann = hann,
+                        .re = re,
+                        .im = im,
+                        .runs = runs,
+                        .run_start = run_start,
+                        .run_end = run_end,
+                        .class_runs = class_runs};
+    return 0;
+}
+
+void chromagram_destroy(Chromagram *c) {
+    fft_plan_destroy(&c->fft);
+    free(c->hann);
+    free(c->re);
+    free(c->im);
+    free(c->run_start);
+    free(c->run_end);
+    free(c->class_runs);
+}
+
+// chromagram_frame, using re and im (c->window doubles each) as workspace.
+static void chroma_frame(const Chromagram *c, const float frame[], double out[],
+                         double re[], double im[]) {
+    int n = c->window;
+    for (int i = 0; i < n; i++) {
+        re[i] = frame[i] * c->hann[i];
+        im[i] = 0;
+    }
+    fft_forward(&c->fft, re, im);
+    for (int k = 0; k <= n / 2; k++)
+        re[k] = re[k] * re[k] + im[k] * im[k];
+
+    for (int i = 0; i < c->classes; i++) {
+        double sum = 0;
+        for (int r = c->class_runs[i]; r < c->class_runs[i + 1]; r++)
+            for (int k = c->run_start[r]; k < c->run_end[r]; k++)
+                sum += re[k];
+        out[i] = sum;
+    }
+}
+
+void chromagram_frame(Chromagram *c, const float frame[], double out[]) {
+    chroma_frame(c, frame, out, c->re, c->im);
+}
+
+long chromagram_frames(const Chromagram *c, long len) {
+    return len < c->window ? 0 : (len - c->window) / c->hop + 1;
+}
+
+// Frames per thread worth starting it for.
+enum { CHROMA_SLICE = 8 };
+
+typedef struct {
+    const Chromagram *c;
+    const float *samples;
+    double *out;
+    double *work; // 2 * c->window doubles for each chunk after the first
+} ChromaSlices;
+
+static void chroma_slice(void *ctx, int chunk, long start, long end) {
+    ChromaSlices *s = ctx;
+    const Chromagram *c = s->c;
+    double *re = c->re, *im = c->im;
+    if (chunk) {
+        re = s->work + (long)(chunk - 1) * 2 * c->window;
+        im = re + c->window;
+    }
+    for (long i = start; i < end; i++)
+        chroma_frame(c, s->samples + i * c->hop, s->out + i * c->classes, re,
+                     im);
+}
+
+// Chunk 0 uses the Chromagram's own workspace and every other chunk gets its
+// own. If that can't be allocated, the frames are measured on this thread.
+long chromagram_run(Chromagram *c, const float samples[], long len,
+                    double out[]) {
+    long frames = chromagram_frames(c, len);
+    int chunks = parallel_chunks(frames, CHROMA_SLICE);
+    ChromaSlices s = {c, samples, out, NULL};
+    if (chunks > 1)
+        s.work = malloc((long)(chunks - 1) * 2 * c->window * sizeof(double));
+    if (s.work)
+        parallel_for(frames, CHROMA_SLICE, chroma_slice, &s);
+    else
+        chroma_slice(&s, 0, 0, frames);
+    free(s.work);
+    return frames;
+}
@@ -0,0 +1,521 @@
+// Generated by tools/gen_edo_catalog.c. Do not edit by hand, run
+// `make catalog` instead.
+#include "../include/constants.h"
+
+const int EDO_CATALOG_MAX = 512;
+
+const EDOCatalogEntry EDO_CATALOG[] = {
+    {0, {0, 0}, 0, false},
+    {1, {0, 0}, 1200, false},
+    {1, {0, 0}, 600, false},
+    {2, {0, 0}, 800, false},
+    {2, {0, 0}, 600, false},
+    {3, {1, 0}, 720, true},
+    {4, {0, 0}, 800, false},
+    {4, {1, 1}, 685.71428571428567, true},
+    {5, {0, 0}, 750, false},
+    {5, {0, 0}, 666.66666666666663, false},
+    {6, {2, 0}, 720, true},
+    {6, {0, 0}, 654.5454545454545, false},
+    {7, {2, 1}, 700, true},
+    {8, {0, 0}, 738.46153846153845, false},
+    {8, {2, 2}, 685.71428571428567, true},
+    {9, {3, 0}, 720, true},
+    {9, {0, 0}, 675, false},
+    {10, {3, 1}, 705.88235294117646, true},
+    {11, {0, 0}, 733.33333333333337, false},
+    {11, {3, 2}, 694.73684210526312, true},
+    {12, {4, 0}, 720, true},
+    {12, {3, 3}, 685.71428571428567, true},
+    {13, {4, 1}, 709.09090909090912, true},
+    {13, {0, 0}, 678.26086956521738, false},
+    {14, {4, 2}, 700, true},
+    {15, {5, 0}, 720, true},
+    {15, {4, 3}, 692.30769230769226, true},
+    {16, {5, 1}, 711.11111111111109, true},
+    {16, {4, 4}, 685.71428571428567, true},
+    {17, {5, 2}, 703.44827586206895, true},
+    {18, {6, 0}, 720, true},
+    {18, {5, 3}, 696.77419354838707, true},
+    {19, {6, 1}, 712.5, true},
+    {19, {5, 4}, 690.90909090909088, true},
+    {20, {6, 2}, 705.88235294117646, true},
+    {20, {5, 5}, 685.71428571428567, true},
+    {21, {6, 3}, 700, true},
+    {22, {7, 1}, 713.51351351351354, true},
+    {22, {6, 4}, 694.73684210526312, true},
+    {23, {7, 2}, 707.69230769230774, true},
+    {23, {6, 5}, 690, true},
+    {24, {7, 3}, 702.43902439024396, true},
+    {25, {8, 1}, 714.28571428571433, true},
+    {25, {7, 4}, 697.67441860465112, true},
+    {26, {8, 2}, 709.09090909090912, true},
+    {26, {7, 5}, 693.33333333333337, true},
+    {27, {8, 3}, 704.3478260869565, true},
+    {27, {7, 6}, 689.36170212765956, true},
+    {28, {8, 4}, 700, true},
+    {29, {9, 2}, 710.20408163265301, true},
+    {29, {8, 5}, 696, true},
+    {30, {9, 3}, 705.88235294117646, true},
+    {30, {8, 6}, 692.30769230769226, true},
+    {31, {9, 4}, 701.88679245283015, true},
+    {32, {10, 2}, 711.11111111111109, true},
+    {32, {9, 5}, 698.18181818181813, true},
+    {33, {10, 3}, 707.14285714285711, true},
+    {33, {9, 6}, 694.73684210526312, true},
+    {34, {10, 4}, 703.44827586206895, true},
+    {35, {11, 2}, 711.86440677966107, true},
+    {35, {10, 5}, 700, true},
+    {36, {11, 3}, 708.19672131147536, true},
+    {36, {10, 6}, 696.77419354838707, true},
+    {37, {11, 4}, 704.76190476190482, true},
+    {37, {10, 7}, 693.75, true},
+    {38, {11, 5}, 701.53846153846155, true},
+    {39, {12, 3}, 709.09090909090912, true},
+    {39, {11, 6}, 698.50746268656712, true},
+    {40, {12, 4}, 705.88235294117646, true},
+    {40, {11, 7}, 695.6521739130435, true},
+    {41, {12, 5}, 702.85714285714289, true},
+    {42, {13, 3}, 709.85915492957747, true},
+    {42, {12, 6}, 700, true},
+    {43, {13, 4}, 706.84931506849318, true},
+    {43, {12, 7}, 697.29729729729729, true},
+    {44, {13, 5}, 704, true},
+    {44, {12, 8}, 694.73684210526312, true},
+    {45, {13, 6}, 701.2987012987013, true},
+    {46, {14, 4}, 707.69230769230774, true},
+    {46, {13, 7}, 698.7341772151899, true},
+    {47, {14, 5}, 705, true},
+    {47, {13, 8}, 696.2962962962963, true},
+    {48, {14, 6}, 702.43902439024396, true},
+    {49, {15, 4}, 708.43373493975901, true},
+    {49, {14, 7}, 700, true},
+    {50, {15, 5}, 705.88235294117646, true},
+    {50, {14, 8}, 697.67441860465112, true},
+    {51, {15, 6}, 703.44827586206895, true},
+    {51, {14, 9}, 695.4545454545455, true},
+    {52, {15, 7}, 701.12359550561803, true},
+    {53, {16, 5}, 706.66666666666663, true},
+    {53, {15, 8}, 698.90109890109886, true},
+    {54, {16, 6}, 704.3478260869565, true},
+    {54, {15, 9}, 696.77419354838707, true},
+    {55, {16, 7}, 702.12765957446811, true},
+    {56, {17, 5}, 707.36842105263156, true},
+    {56, {16, 8}, 700, true},
+    {57, {17, 6}, 705.15463917525778, true},
+    {57, {16, 9}, 697.9591836734694, true},
+    {58, {17, 7}, 703.030303030303, true},
+    {58, {16, 10}, 696, true},
+    {59, {17, 8}, 700.99009900990097, true},
+    {60, {18, 6}, 705.88235294117646, true},
+    {60, {17, 9}, 699.02912621359224, true},
+    {61, {18, 7}, 703.84615384615381, true},
+    {61, {17, 10}, 697.14285714285711, true},
+    {62, {18, 8}, 701.88679245283015, true},
+    {63, {19, 6}, 706.54205607476638, true},
+    {63, {18, 9}, 700, true},
+    {64, {19, 7}, 704.58715596330273, true},
+    {64, {18, 10}, 698.18181818181813, true},
+    {65, {19, 8}, 702.70270270270271, true},
+    {66, {20, 6}, 707.14285714285711, true},
+    {66, {19, 9}, 700.88495575221236, true},
+    {67, {20, 7}, 705.26315789473688, true},
+    {67, {19, 10}, 699.13043478260875, true},
+    {68, {20, 8}, 703.44827586206895, true},
+    {68, {19, 11}, 697.43589743589746, true},
+    {69, {20, 9}, 701.69491525423734, true},
+    {70, {21, 7}, 705.88235294117646, true},
+    {70, {20, 10}, 700, true},
+    {71, {21, 8}, 704.1322314049587, true},
+    {71, {20, 11}, 698.36065573770497, true},
+    {72, {21, 9}, 702.43902439024396, true},
+    {73, {22, 7}, 706.45161290322585, true},
+    {73, {21, 10}, 700.79999999999995, true},
+    {74, {22, 8}, 704.76190476190482, true},
+    {74, {21, 11}, 699.2125984251968, true},
+    {75, {22, 9}, 703.125, true},
+    {75, {21, 12}, 697.67441860465112, true},
+    {76, {22, 10}, 701.53846153846155, true},
+    {77, {23, 8}, 705.3435114503817, true},
+    {77, {22, 11}, 700, true},
+    {78, {23, 9}, 703.75939849624058, true},
+    {78, {22, 12}, 698.50746268656712, true},
+    {79, {23, 10}, 702.22222222222217, true},
+    {80, {24, 8}, 705.88235294117646, true},
+    {80, {23, 11}, 700.72992700729924, true},
+    {81, {24, 9}, 704.3478260869565, true},
+    {81, {23, 12}, 699.2805755395683, true},
+    {82, {24, 10}, 702.85714285714289, true},
+    {82, {23, 13}, 697.87234042553189, true},
+    {83, {24, 11}, 701.4084507042254, true},
+    {84, {25, 9}, 704.89510489510485, true},
+    {84, {24, 12}, 700, true},
+    {85, {25, 10}, 703.44827586206895, true},
+    {85, {24, 13}, 698.63013698630141, true},
+    {86, {25, 11}, 702.0408163265306, true},
+    {87, {26, 9}, 705.40540540540542, true},
+    {87, {25, 12}, 700.67114093959731, true},
+    {88, {26, 10}, 704, true},
+    {88, {25, 13}, 699.33774834437088, true},
+    {89, {26, 11}, 702.63157894736844, true},
+    {89, {25, 14}, 698.03921568627447, true},
+    {90, {26, 12}, 701.2987012987013, true},
+    {91, {27, 10}, 704.51612903225805, true},
+    {91, {26, 13}, 700, true},
+    {92, {27, 11}, 703.18471337579615, true},
+    {92, {26, 14}, 698.7341772151899, true},
+    {93, {27, 12}, 701.88679245283015, true},
+    {94, {28, 10}, 705, true},
+    {94, {27, 13}, 700.62111801242236, true},
+    {95, {28, 11}, 703.7037037037037, true},
+    {95, {27, 14}, 699.38650306748468, true},
+    {96, {28, 12}, 702.43902439024396, true},
+    {97, {29, 10}, 705.4545454545455, true},
+    {97, {28, 13}, 701.20481927710841, true},
+    {98, {29, 11}, 704.19161676646706, true},
+    {98, {28, 14}, 700, true},
+    {99, {29, 12}, 702.95857988165676, true},
+    {99, {28, 15}, 698.82352941176475, true},
+    {100, {29, 13}, 701.75438596491233, true},
+    {101, {30, 11}, 704.65116279069764, true},
+    {101, {29, 14}, 700.5780346820809, true},
+    {102, {30, 12}, 703.44827586206895, true},
+    {102, {29, 15}, 699.42857142857144, true},
+    {103, {30, 13}, 702.27272727272725, true},
+    {104, {31, 11}, 705.08474576271192, true},
+    {104, {30, 14}, 701.12359550561803, true},
+    {105, {31, 12}, 703.91061452513964, true},
+    {105, {30, 15}, 700, true},
+    {106, {31, 13}, 702.76243093922653, true},
+    {106, {30, 16}, 698.90109890109886, true},
+    {107, {31, 14}, 701.63934426229503, true},
+    {108, {32, 12}, 704.3478260869565, true},
+    {108, {31, 15}, 700.54054054054052, true},
+    {109, {32, 13}, 703.22580645161293, true},
+    {109, {31, 16}, 699.46524064171126, true},
+    {110, {32, 14}, 702.12765957446811, true},
+    {111, {33, 12}, 704.76190476190482, true},
+    {111, {32, 15}, 701.0526315789474, true},
+    {112, {33, 13}, 703.66492146596863, true},
+    {112, {32, 16}, 700, true},
+    {113, {33, 14}, 702.59067357512959, true},
+    {113, {32, 17}, 698.96907216494844, true},
+    {114, {33, 15}, 701.53846153846155, true},
+    {115, {34, 13}, 704.08163265306121, true},
+    {115, {33, 16}, 700.50761421319794, true},
+    {116, {34, 14}, 703.030303030303, true},
+    {116, {33, 17}, 699.4974874371859, true},
+    {117, {34, 15}, 702, true},
+    {118, {35, 13}, 704.47761194029852, true},
+    {118, {34, 16}, 700.99009900990097, true},
+    {119, {35, 14}, 703.44827586206895, true},
+    {119, {34, 17}, 700, true},
+    {120, {35, 15}, 702.43902439024396, true},
+    {121, {36, 13}, 704.85436893203882, true},
+    {121, {35, 16}, 701.44927536231887, true},
+    {122, {36, 14}, 703.84615384615381, true},
+    {122, {35, 17}, 700.47846889952154, true},
+    {123, {36, 15}, 702.85714285714289, true},
+    {123, {35, 18}, 699.52606635071095, true},
+    {124, {36, 16}, 701.88679245283015, true},
+    {125, {37, 14}, 704.22535211267609, true},
+    {125, {36, 17}, 700.93457943925239, true},
+    {126, {37, 15}, 703.25581395348843, true},
+    {126, {36, 18}, 700, true},
+    {127, {37, 16}, 702.30414746543784, true},
+    {128, {38, 14}, 704.58715596330273, true},
+    {128, {37, 17}, 701.36986301369859, true},
+    {129, {38, 15}, 703.63636363636363, true},
+    {129, {37, 18}, 700.45248868778276, true},
+    {130, {38, 16}, 702.70270270270271, true},
+    {130, {37, 19}, 699.55156950672642, true},
+    {131, {38, 17}, 701.78571428571433, true},
+    {132, {39, 15}, 704, true},
+    {132, {38, 18}, 700.88495575221236, true},
+    {133, {39, 16}, 703.08370044052867, true},
+    {133, {38, 19}, 700, true},
+    {134, {39, 17}, 702.1834061135371, true},
+    {135, {40, 15}, 704.3478260869565, true},
+    {135, {39, 18}, 701.2987012987013, true},
+    {136, {40, 16}, 703.44827586206895, true},
+    {136, {39, 19}, 700.42918454935625, true},
+    {137, {40, 17}, 702.56410256410254, true},
+    {137, {39, 20}, 699.57446808510633, true},
+    {138, {40, 18}, 701.69491525423734, true},
+    {139, {41, 16}, 703.79746835443041, true},
+    {139, {40, 19}, 700.84033613445376, true},
+    {140, {41, 17}, 702.92887029288704, true},
+    {140, {40, 20}, 700, true},
+    {141, {41, 18}, 702.07468879668045, true},
+    {142, {42, 16}, 704.1322314049587, true},
+    {142, {41, 19}, 701.23456790123453, true},
+    {143, {42, 17}, 703.27868852459017, true},
+    {143, {41, 20}, 700.40816326530614, true},
+    {144, {42, 18}, 702.43902439024396, true},
+    {144, {41, 21}, 699.59514170040484, true},
+    {145, {42, 19}, 701.61290322580646, true},
+    {146, {43, 17}, 703.61445783132535, true},
+    {146, {42, 20}, 700.79999999999995, true},
+    {147, {43, 18}, 702.78884462151393, true},
+    {147, {42, 21}, 700, true},
+    {148, {43, 19}, 701.97628458498025, true},
+    {149, {44, 17}, 703.93700787401576, true},
+    {149, {43, 20}, 701.17647058823525, true},
+    {150, {44, 18}, 703.125, true},
+    {150, {43, 21}, 700.38910505836577, true},
+    {151, {44, 19}, 702.32558139534888, true},
+    {152, {45, 17}, 704.24710424710429, true},
+    {152, {44, 20}, 701.53846153846155, true},
+    {153, {45, 18}, 703.44827586206895, true},
+    {153, {44, 21}, 700.76335877862596, true},
+    {154, {45, 19}, 702.66159695817487, true},
+    {154, {44, 22}, 700, true},
+    {155, {45, 20}, 701.88679245283015, true},
+    {156, {46, 18}, 703.75939849624058, true},
+    {156, {45, 21}, 701.12359550561803, true},
+    {157, {46, 19}, 702.98507462686564, true},
+    {157, {45, 22}, 700.37174721189592, true},
+    {158, {46, 20}, 702.22222222222217, true},
+    {159, {47, 18}, 704.05904059040586, true},
+    {159, {46, 21}, 701.47058823529414, true},
+    {160, {47, 19}, 703.2967032967033, true},
+    {160, {46, 22}, 700.72992700729924, true},
+    {161, {47, 20}, 702.5454545454545, true},
+    {161, {46, 23}, 700, true},
+    {162, {47, 21}, 701.80505415162452, true},
+    {163, {48, 19}, 703.59712230215825, true},
+    {163, {47, 22}, 701.07526881720435, true},
+    {164, {48, 20}, 702.85714285714289, true},
+    {164, {47, 23}, 700.35587188612101, true},
+    {165, {48, 21}, 702.12765957446811, true},
+    {166, {49, 19}, 703.886925795053, true},
+    {166, {48, 22}, 701.4084507042254, true},
+    {167, {49, 20}, 703.15789473684208, true},
+    {167, {48, 23}, 700.69930069930069, true},
+    {168, {49, 21}, 702.43902439024396, true},
+    {168, {48, 24}, 700, true},
+    {169, {49, 22}, 701.73010380622839, true},
+    {170, {50, 20}, 703.44827586206895, true},
+    {170, {49, 23}, 701.03092783505156, true},
+    {171, {50, 21}, 702.7397260273973, true},
+    {171, {49, 24}, 700.34129692832767, true},
+    {172, {50, 22}, 702.0408163265306, true},
+    {173, {51, 20}, 703.72881355932202, true},
+    {173, {50, 23}, 701.35135135135135, true},
+    {174, {51, 21}, 703.030303030303, true},
+    {174, {50, 24}, 700.67114093959731, true},
+    {175, {51, 22}, 702.34113712374585, true},
+    {175, {50, 25}, 700, true},
+    {176, {51, 23}, 701.66112956810628, true},
+    {177, {52, 21}, 703.31125827814571, true},
+    {177, {51, 24}, 700.99009900990097, true},
+    {178, {52, 22}, 702.63157894736844, true},
+    {178, {51, 25}, 700.32786885245901, true},
+    {179, {52, 23}, 701.96078431372553, true},
+    {180, {53, 21}, 703.58306188925087, true},
+    {180, {52, 24}, 701.2987012987013, true},
+    {181, {53, 22}, 702.91262135922329, true},
+    {181, {52, 25}, 700.64516129032256, true},
+    {182, {53, 23}, 702.25080385852095, true},
+    {183, {54, 21}, 703.84615384615381, true},
+    {183, {53, 24}, 701.59744408945687, true},
+    {184, {54, 22}, 703.18471337579615, true},
+    {184, {53, 25}, 700.95238095238096, true},
+    {185, {54, 23}, 702.53164556962031, true},
+    {185, {53, 26}, 700.31545741324919, true},
+    {186, {54, 24}, 701.88679245283015, true},
+    {187, {55, 22}, 703.44827586206895, true},
+    {187, {54, 25}, 701.25, true},
+    {188, {55, 23}, 702.80373831775705, true},
+    {188, {54, 26}, 700.62111801242236, true},
+    {189, {55, 24}, 702.16718266253872, true},
+    {190, {56, 22}, 703.7037037037037, true},
+    {190, {55, 25}, 701.53846153846155, true},
+    {191, {56, 23}, 703.0674846625767, true},
+    {191, {55, 26}, 700.9174311926605, true},
+    {192, {56, 24}, 702.43902439024396, true},
+    {192, {55, 27}, 700.30395136778111, true},
+    {193, {56, 25}, 701.81818181818187, true},
+    {194, {57, 23}, 703.32326283987913, true},
+    {194, {56, 26}, 701.20481927710841, true},
+    {195, {57, 24}, 702.70270270270271, true},
+    {195, {56, 27}, 700.59880239520953, true},
+    {196, {57, 25}, 702.08955223880594, true},
+    {197, {58, 23}, 703.57142857142856, true},
+    {197, {57, 26}, 701.48367952522256, true},
+    {198, {58, 24}, 702.95857988165676, true},
+    {198, {57, 27}, 700.88495575221236, true},
+    {199, {58, 25}, 702.35294117647061, true},
+    {199, {57, 28}, 700.29325513196477, true},
+    {200, {58, 26}, 701.75438596491233, true},
+    {201, {59, 24}, 703.20699708454811, true},
+    {201, {58, 27}, 701.16279069767438, true},
+    {202, {59, 25}, 702.60869565217388, true},
+    {202, {58, 28}, 700.5780346820809, true},
+    {203, {59, 26}, 702.01729106628238, true},
+    {204, {60, 24}, 703.44827586206895, true},
+    {204, {59, 27}, 701.43266475644702, true},
+    {205, {60, 25}, 702.85714285714289, true},
+    {205, {59, 28}, 700.85470085470081, true},
+    {206, {60, 26}, 702.27272727272725, true},
+    {206, {59, 29}, 700.28328611898019, true},
+    {207, {60, 27}, 701.69491525423734, true},
+    {208, {61, 25}, 703.09859154929575, true},
+    {208, {60, 28}, 701.12359550561803, true},
+    {209, {61, 26}, 702.52100840336129, true},
+    {209, {60, 29}, 700.55865921787711, true},
+    {210, {61, 27}, 701.94986072423399, true},
+    {211, {62, 25}, 703.33333333333337, true},
+    {211, {61, 28}, 701.38504155124656, true},
+    {212, {62, 26}, 702.76243093922653, true},
+    {212, {61, 29}, 700.82644628099172, true},
+    {213, {62, 27}, 702.19780219780216, true},
+    {214, {63, 25}, 703.56164383561645, true},
+    {214, {62, 28}, 701.63934426229503, true},
+    {215, {63, 26}, 702.99727520435965, true},
+    {215, {62, 29}, 701.08695652173913, true},
+    {216, {63, 27}, 702.43902439024396, true},
+    {216, {62, 30}, 700.54054054054052, true},
+    {217, {63, 28}, 701.88679245283015, true},
+    {218, {64, 26}, 703.22580645161293, true},
+    {218, {63, 29}, 701.34048257372649, true},
+    {219, {64, 27}, 702.67379679144381, true},
+    {219, {63, 30}, 700.79999999999995, true},
+    {220, {64, 28}, 702.12765957446811, true},
+    {221, {65, 26}, 703.44827586206895, true},
+    {221, {64, 29}, 701.58730158730157, true},
+    {222, {65, 27}, 702.90237467018471, true},
+    {222, {64, 30}, 701.0526315789474, true},
+    {223, {65, 28}, 702.36220472440948, true},
+    {223, {64, 31}, 700.52356020942409, true},
+    {224, {65, 29}, 701.82767624020892, true},
+    {225, {66, 27}, 703.125, true},
+    {225, {65, 30}, 701.2987012987013, true},
+    {226, {66, 28}, 702.59067357512959, true},
+    {226, {65, 31}, 700.77519379844966, true},
+    {227, {66, 29}, 702.06185567010311, true},
+    {228, {67, 27}, 703.3419023136247, true},
+    {228, {66, 30}, 701.53846153846155, true},
+    {229, {67, 28}, 702.81329923273654, true},
+    {229, {66, 31}, 701.0204081632653, true},
+    {230, {67, 29}, 702.29007633587787, true},
+    {230, {66, 32}, 700.50761421319794, true},
+    {231, {67, 30}, 701.77215189873414, true},
+    {232, {68, 28}, 703.030303030303, true},
+    {232, {67, 31}, 701.25944584382876, true},
+    {233, {68, 29}, 702.51256281407041, true},
+    {233, {67, 32}, 700.75187969924809, true},
+    {234, {68, 30}, 702, true},
+    {235, {69, 28}, 703.24189526184534, true},
+    {235, {68, 31}, 701.49253731343288, true},
+    {236, {69, 29}, 702.72952853598019, true},
+    {236, {68, 32}, 700.99009900990097, true},
+    {237, {69, 30}, 702.22222222222217, true},
+    {237, {68, 33}, 700.49261083743841, true},
+    {238, {69, 31}, 701.71990171990171, true},
+    {239, {70, 29}, 702.94117647058829, true},
+    {239, {69, 32}, 701.22249388753062, true},
+    {240, {70, 30}, 702.43902439024396, true},
+    {240, {69, 33}, 700.72992700729924, true},
+    {241, {70, 31}, 701.94174757281553, true},
+    {242, {71, 29}, 703.1476997578693, true},
+    {242, {70, 32}, 701.44927536231887, true},
+    {243, {71, 30}, 702.65060240963851, true},
+    {243, {70, 33}, 700.96153846153845, true},
+    {244, {71, 31}, 702.15827338129498, true},
+    {245, {72, 29}, 703.3492822966507, true},
+    {245, {71, 32}, 701.67064439140813, true},
+    {246, {72, 30}, 702.85714285714289, true},
+    {246, {71, 33}, 701.18764845605699, true},
+    {247, {72, 31}, 702.36966824644549, true},
+    {247, {71, 34}, 700.70921985815608, true},
+    {248, {72, 32}, 701.88679245283015, true},
+    {249, {73, 30}, 703.05882352941171, true},
+    {249, {72, 33}, 701.4084507042254, true},
+    {250, {73, 31}, 702.57611241217796, true},
+    {250, {72, 34}, 700.93457943925239, true},
+    {251, {73, 32}, 702.09790209790208, true},
+    {252, {74, 30}, 703.25581395348843, true},
+    {252, {73, 33}, 701.62412993039447, true},
+    {253, {74, 31}, 702.77777777777783, true},
+    {253, {73, 34}, 701.15473441108543, true},
+    {254, {74, 32}, 702.30414746543784, true},
+    {254, {73, 35}, 700.68965517241384, true},
+    {255, {74, 33}, 701.83486238532112, true},
+    {256, {75, 31}, 702.97482837528605, true},
+    {256, {74, 34}, 701.36986301369859, true},
+    {257, {75, 32}, 702.50569476082001, true},
+    {257, {74, 35}, 700.90909090909088, true},
+    {258, {75, 33}, 702.0408163265306, true},
+    {259, {76, 31}, 703.16742081447967, true},
+    {259, {75, 34}, 701.58013544018058, true},
+    {260, {76, 32}, 702.70270270270271, true},
+    {260, {75, 35}, 701.12359550561803, true},
+    {261, {76, 33}, 702.24215246636766, true},
+    {261, {75, 36}, 700.67114093959731, true},
+    {262, {76, 34}, 701.78571428571433, true},
+    {263, {77, 32}, 702.89532293986633, true},
+    {263, {76, 35}, 701.33333333333337, true},
+    {264, {77, 33}, 702.43902439024396, true},
+    {264, {76, 36}, 700.88495575221236, true},
+    {265, {77, 34}, 701.98675496688736, true},
+    {266, {78, 32}, 703.08370044052867, true},
+    {266, {77, 35}, 701.53846153846155, true},
+    {267, {78, 33}, 702.63157894736844, true},
+    {267, {77, 36}, 701.09409190371991, true},
+    {268, {78, 34}, 702.1834061135371, true},
+    {268, {77, 37}, 700.65359477124184, true},
+    {269, {78, 35}, 701.73913043478262, true},
+    {270, {79, 33}, 702.81995661605208, true},
+    {270, {78, 36}, 701.2987012987013, true},
+    {271, {79, 34}, 702.37580993520521, true},
+    {271, {78, 37}, 700.86206896551721, true},
+    {272, {79, 35}, 701.93548387096769, true},
+    {273, {80, 33}, 703.00429184549353, true},
+    {273, {79, 36}, 701.49892933618844, true},
+    {274, {80, 34}, 702.56410256410254, true},
+    {274, {79, 37}, 701.06609808102348, true},
+    {275, {80, 35}, 702.12765957446811, true},
+    {276, {81, 33}, 703.18471337579615, true},
+    {276, {80, 36}, 701.69491525423734, true},
+    {277, {81, 34}, 702.74841437632131, true},
+    {277, {80, 37}, 701.2658227848101, true},
+    {278, {81, 35}, 702.31578947368416, true},
+    {278, {80, 38}, 700.84033613445376, true},
+    {279, {81, 36}, 701.88679245283015, true},
+    {280, {82, 34}, 702.92887029288704, true},
+    {280, {81, 37}, 701.46137787056364, true},
+    {281, {82, 35}, 702.5, true},
+    {281, {81, 38}, 701.03950103950103, true},
+    {282, {82, 36}, 702.07468879668045, true},
+    {283, {83, 34}, 703.10559006211179, true},
+    {283, {82, 37}, 701.65289256198344, true},
+    {284, {83, 35}, 702.68041237113403, true},
+    {284, {82, 38}, 701.23456790123453, true},
+    {285, {83, 36}, 702.25872689938399, true},
+    {285, {82, 39}, 700.81967213114751, true},
+    {286, {83, 37}, 701.84049079754607, true},
+    {287, {84, 35}, 702.85714285714289, true},
+    {287, {83, 38}, 701.42566191446031, true},
+    {288, {84, 36}, 702.43902439024396, true},
+    {288, {83, 39}, 701.01419878296144, true},
+    {289, {84, 37}, 702.0242914979757, true},
+    {290, {85, 35}, 703.030303030303, true},
+    {290, {84, 38}, 701.61290322580646, true},
+    {291, {85, 36}, 702.61569416498992, true},
+    {291, {84, 39}, 701.20481927710841, true},
+    {292, {85, 37}, 702.20440881763523, true},
+    {292, {84, 40}, 700.79999999999995, true},
+    {293, {85, 38}, 701.79640718562871, true},
+    {294, {86, 36}, 702.78884462151393, true},
+    {294, {85, 39}, 701.39165009940359, true},
+    {295, {86, 37}, 702.38095238095241, true},
+    {295, {85, 40}, 700.99009900990097, true},
+    {296, {86, 38}, 701.97628458498025, true},
+    {297, {87, 36}, 702.95857988165676, true},
+    {297, {86, 39}, 701.57480314960628, true},
+    {298, {87, 37}, 702.55402750491157, true},
+    {298, {86, 40}, 701.17647058823525, true},
+    {299, {87, 38}, 702.15264187866933, true},
+    {300, {88, 36}, 703.125, true},
+};
@@ -0,0 +1,95 @@
+#include "../include/fft.h"
+#include "../include/types.h"
+#include <math.h>
+#include <stdlib.h>
+
+static const double FFT_TAU = 6.283185307179586;
+
+int fft_plan_create(int n, FFTPlan *out) {
+    if (n <= 0 || (n & (n - 1)))
+        return 1;
+
+    int half = n > 1 ? n / 2 : 1;
+    double *cos_table = malloc(half * sizeof(double));
+    double *sin_table = malloc(half * sizeof(double));
+    int *bitrev = malloc(n * sizeof(int));
+    if (!cos_table || !sin_table || !bitrev) {
+        free(cos_table);
+        free(sin_table);
+        free(bitrev);
+        return 1;
+    }
+
+    for (int k = 0; k < n / 2; k++) {
+        cos_table[k] = cos(FFT_TAU * k / n);
+        sin_table[k] = sin(FFT_TAU * k / n);
+    }
+    int bits = 0;
+    while (1 << bits < n)
+        bits++;
+    for (int i = 0; i < n; i++) {
+        int r = 0;
+        for (int b = 0; b < bits; b++)
+            r |= (i >> b & 1) << (bits - 1 - b);
+        bitrev[i] = r;
+    }
+
+    *out = (FFTPlan){.n = n,
+                     .cos_table = cos_table,
+                     .sin_table = sin_table,
+                     .bitrev = bitrev};
+    return 0;
+}
+
+void fft_plan_destroy(FFTPlan *p) {
+    free(p->cos_table);
+    free(p->sin_table);
+    free(p->bitrev);
+}
+
+// Iterative radix-2 decimation in time. sign is -1 for the forward transform
+// and 1 for the inverse.
+static void fft_transform(const FFTPlan *p, double re[], double im[],
+                          int sign) {
+    int n = p->n;
+    for (int i = 0; i < n; i++) {
+        int j = p->bitrev[i];
+        if (i < j) {
+            double t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
+
+    for (int len = 2; len <= n; len *= 2) {
+        int half = len / 2, stride = n / len;
+        for (int start = 0; start < n; start += len) {
+            for (int k = 0; k < half; k++) {
+                double wr = p->cos_table[k * stride];
+                double wi = sign * p->sin_table[k * stride];
+                int a = start + k, b = a + half;
+                double xr = re[b] * wr - im[b] * wi;
+                double xi = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - xr;
+                im[b] = im[a] - xi;
+                re[a] += xr;
+                im[a] += xi;
+            }
+        }
+    }
+}
+
+void fft_forward(const FFTPlan *p, double re[], double im[]) {
+    fft_transform(p, re, im, -1);
+}
+
+void fft_inverse(const FFTPlan *p, double re[], double im[]) {
+    fft_transform(p, re, im, 1);
+    for (int i = 0; i < p->n; i++) {
+        re[i] /= p->n;
+        im[i] /= p->n;
+    }
+}
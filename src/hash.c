@@ -0,0 +1,187 @@
+#include "../include/hash.h"
+#include "../include/types.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Slots are found by the low bits of a Pitch's hash, and hold a tag made from
+// the top 7 bits. Probing scans the tag array first, 64 slots to a cache line,
+// and only compares keys when a tag matches.
+
+static uint8_t hash_tag(uint64_t h) { return 0x80 | (uint8_t)(h >> 57); }
+
+// The slot holding p if it's in the map, otherwise -1 - the empty slot where it
+// would go.
+static int pitch_map_find(const PitchMap *m, Pitch p, uint64_t h) {
+    int mask = m->capacity - 1;
+    uint8_t tag = hash_tag(h);
+    for (int i = (int)(h & mask);; i = (i + 1) & mask) {
+        if (m->tags[i] == 0)
+            return -1 - i;
+        if (m->tags[i] == tag && m->keys[i].w == p.w && m->keys[i].h == p.h)
+            return i;
+    }
+}
+
+static int pitch_map_alloc(int capacity, PitchMap *out) {
+    uint8_t *tags = calloc(capacity, sizeof(uint8_t));
+    Pitch *keys = malloc(capacity * sizeof(Pitch));
+    PitchValue *values = malloc(capacity * sizeof(PitchValue));
+    if (!tags || !keys || !values) {
+        free(tags);
+        free(keys);
+        free(values);
+        return 1;
+    }
+    *out = (PitchMap){.len = 0,
+                      .capacity = capacity,
+                      .tags = tags,
+                      .keys = keys,
+                      .values = values};
+    return 0;
+}
+
+// The most Pitches a map holds, which keeps every slot count (at most 2^29)
+// within an int.
+enum { PITCH_MAP_MAX_LEN = 1 << 28 };
+
+// Keeps the map at most 3/4 full, so probe runs stay short. len must be at
+// most PITCH_MAP_MAX_LEN.
+static int slots_for(int len) {
+    int capacity = 8;
+    while (capacity / 4 * 3 < len)
+        capacity *= 2;
+    return capacity;
+}
+
+// Makes room for len Pitches in total, rehashing into a bigger table if
+// needed. len is a long long so that callers can add to m->len freely.
+static int pitch_map_reserve(PitchMap *m, long long len) {
+    if (len > PITCH_MAP_MAX_LEN)
+        return 1;
+    int capacity = slots_for((int)len);
+    if (capacity <= m->capacity)
+        return 0;
+    PitchMap bigger;
+    if (pitch_map_alloc(capacity, &bigger))
+        return 1;
+    for (int i = 0; i < m->capacity; i++) {
+        if (!m->tags[i])
+            continue;
+        Pitch key = m->keys[i];
+        int j = -1 - pitch_map_find(&bigger, key, pitch_hash(key));
+        bigger.tags[j] = m->tags[i];
+        bigger.keys[j] = m->keys[i];
+        bigger.values[j] = m->values[i];
+    }
+    bigger.len = m->len;
+    pitch_map_destroy(m);
+    *m = bigger;
+    return 0;
+}
+
+int pitch_map_create(int capacity, PitchMap *out) {
+    if (capacity < 0 || capacity > PITCH_MAP_MAX_LEN)
+        return 1;
+    return pitch_map_alloc(slots_for(capacity), out);
+}
+
+void pitch_map_destroy(PitchMap *m) {
+    free(m->tags);
+    free(m->keys);
+    free(m->values);
+}
+
+void pitch_map_clear(PitchMap *m) {
+    memset(m->tags, 0, m->capacity);
+    m->len = 0;
+}
+
+PitchValue *pitch_map_get(const PitchMap *m, Pitch p) {
+    int i = pitch_map_find(m, p, pitch_hash(p));
+    return i < 0 ? NULL : &m->values[i];
+}
+
+PitchValue *pitch_map_slot(PitchMap *m, Pitch p) {
+    uint64_t h = pitch_hash(p);
+    int i = pitch_map_find(m, p, h);
+    if (i >= 0)
+        return &m->values[i];
+    if (m->capacity / 4 * 3 < m->len + 1) {
+        if (pitch_map_reserve(m, m->len + 1LL))
+            return NULL;
+        i = pitch_map_find(m, p, h);
+    }
+    i = -1 - i;
+    m->tags[i] = hash_tag(h);
+    m->keys[i] = p;
+    m->values[i] = (PitchValue){0};
+    m->len++;
+    return &m->values[i];
+}
+
+int pitch_map_put(PitchMap *m, Pitch p, PitchValue v) {
+    PitchValue *slot = pitch_map_slot(m, p);
+    if (!slot)
+        return 1;
+    *slot = v;
+    return 0;
+}
+
+// Linear probing can't just empty a slot, or it would cut the probe runs of
+// keys stored after it. Instead each later key in the run moves back into the
+// hole if that doesn't take it before its home slot.
+bool pitch_map_remove(PitchMap *m, Pitch p) {
+    int i = pitch_map_find(m, p, pitch_hash(p));
+    if (i < 0)
+        return false;
+    int mask = m->capacity - 1;
+    for (int j = (i + 1) & mask; m->tags[j]; j = (j + 1) & mask) {
+        int home = (int)(pitch_hash(m->keys[j]) & mask);
+        // whether home lies cyclically in (i, j], so the key must stay put
+        bool stays =
+            i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (stays)
+            continue;
+        m->tags[i] = m->tags[j];
+        m->keys[i] = m->keys[j];
+        m->values[i] = m->values[j];
+        i = j;
+    }
+    m->tags[i] = 0;
+    m->len--;
+    return true;
+}
+
+int pitch_map_put_all(PitchMap *m, const Pitch keys[],
+                      const PitchValue values[], int len) {
+    if (len > 0 && pitch_map_reserve(m, (long long)m->len + len))
+        return 1;
+    for (int i = 0; i < len; i++)
+        if (pitch_map_put(m, keys[i], values[i]))
+            return 1;
+    return 0;
+}
+
+int pitch_map_increment_all(PitchMap *m, const Pitch keys[], int len) {
+    for (int i = 0; i < len; i++) {
+        PitchValue *slot = pitch_map_slot(m, keys[i]);
+        if (!slot)
+            return 1;
+        slot->i++;
+    }
+    return 0;
+}
+
+bool pitch_map_next(const PitchMap *m, int *pos, Pitch *key,
+                    PitchValue *value) {
+    for (; *pos < m->capacity; (*pos)++) {
+        if (!m->tags[*pos])
+            continue;
+        *key = m->keys[*pos];
+        if (value)
+            *value = m->values[*pos];
+        (*pos)++;
+        return true;
+    }
+    return false;
+}
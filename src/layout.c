@@ -0,0 +1,93 @@
+#include "../include/layout.h"
+#include "../include/map.h"
+#include "../include/types.h"
+#include <math.h>
+
+int keyboard_layout_create(Map2D layout, Pitch anchor, MapVec anchor_pos,
+                           KeyboardLayout *out) {
+    double det = layout.m00 * layout.m11 - layout.m01 * layout.m10;
+    if (det == 0 || !isfinite(det))
+        return 1;
+    *out = (KeyboardLayout){
+        .to_screen = layout,
+        .from_screen = (Map2D){layout.m11 / det, -layout.m01 / det,
+                               -layout.m10 / det, layout.m00 / det},
+        .anchor = anchor,
+        .anchor_pos = anchor_pos,
+    };
+    return 0;
+}
+
+void keyboard_key_centers(const KeyboardLayout *L, const Pitch p[], int len,
+                          double x[], double y[]) {
+    Map2D T = L->to_screen;
+    double x0 = L->anchor_pos.x - T.m00 * L->anchor.w - T.m01 * L->anchor.h;
+    double y0 = L->anchor_pos.y - T.m10 * L->anchor.w - T.m11 * L->anchor.h;
+    for (int i = 0; i < len; i++) {
+        x[i] = x0 + T.m00 * p[i].w + T.m01 * p[i].h;
+        y[i] = y0 + T.m10 * p[i].w + T.m11 * p[i].h;
+    }
+}
+
+void keyboard_key_vertices(const KeyboardLayout *L, const Pitch p[], int len,
+                           double x[], double y[]) {
+    Map2D T = L->to_screen;
+    // Corners sit half a lattice step away along each basis vector.
+    double ax = T.m00 / 2, ay = T.m10 / 2;
+    double bx = T.m01 / 2, by = T.m11 / 2;
+    const double dx[4] = {-ax - bx, ax - bx, ax + bx, -ax + bx};
+    const double dy[4] = {-ay - by, ay - by, ay + by, -ay + by};
+    for (int i = 0; i < len; i++) {
+        MapVec c = keyboard_key_center(L, p[i]);
+        for (int k = 0; k < 4; k++) {
+            x[4 * i + k] = c.x + dx[k];
+            y[4 * i + k] = c.y + dy[k];
+        }
+    }
+}
+
+// Screen positions map back to fractional Pitch vectors, and rounding both
+// coordinates picks the parallelogram the position falls in.
+Pitch keyboard_hit_test(const KeyboardLayout *L, double x, double y) {
+    MapVec v = map_to_2d(
+        (MapVec){x - L->anchor_pos.x, y - L->anchor_pos.y}, L->from_screen);
+    return (Pitch){L->anchor.w + (int)floor(v.x + 0.5),
+                   L->anchor.h + (int)floor(v.y + 0.5)};
+}
+
+void keyboard_hit_test_batch(const KeyboardLayout *L, const double x[],
+                             const double y[], int len, Pitch out[]) {
+    for (int i = 0; i < len; i++)
+        out[i] = keyboard_hit_test(L, x[i], y[i]);
+}
+
+int keyboard_visible_keys(const KeyboardLayout *L, double x0, double y0,
+                          double x1, double y1, Pitch out[], int cap) {
+    double xlo = fmin(x0, x1), xhi = fmax(x0, x1);
+    double ylo = fmin(y0, y1), yhi = fmax(y0, y1);
+
+    // The rectangle's corners bound the Pitch vectors worth checking.
+    double wlo = INFINITY, whi = -INFINITY, hlo = INFINITY, hhi = -INFINITY;
+    const double cx[4] = {xlo, xhi, xhi, xlo}, cy[4] = {ylo, ylo, yhi, yhi};
+    for (int k = 0; k < 4; k++) {
+        MapVec v = map_to_2d(
+            (MapVec){cx[k] - L->anchor_pos.x, cy[k] - L->anchor_pos.y},
+            L->from_screen);
+        wlo = fmin(wlo, v.x), whi = fmax(whi, v.x);
+        hlo = fmin(hlo, v.y), hhi = fmax(hhi, v.y);
+    }
+
+    int count = 0;
+    for (int h = (int)ceil(hlo); h <= (int)floor(hhi); h++) {
+        for (int w = (int)ceil(wlo); w <= (int)floor(whi); w++) {
+            Pitch p = {L->anchor.w + w, L->anchor.h + h};
+            MapVec c = keyboard_key_center(L, p);
+            if (c.x < xlo || c.x > xhi || c.y < ylo || c.y > yhi)
+                continue;
+            if (count < cap)
+                out[count] = p;
+            count++;
+        }
+    }
+    return count;
+}
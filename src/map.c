@@ -1,6 +1,7 @@
 #include "../include/map.h"
 #include "../include/constants.h"
 #include "../include/interval.h"
+#include "../include/pitch.h"
 #include "../include/types.h"
 #include <math.h>
 
@@ -19,10 +20,20 @@ int tuning_map_from_fifth(double fifth, Pitch ref_pitch, double ref_freq,
     return 0;
 }
 
+const EDOCatalogEntry *edo_catalog_lookup(int edo) {
+    if (edo < 1 || edo > EDO_CATALOG_MAX)
+        return NULL;
+    return &EDO_CATALOG[edo];
+}
+
 int tuning_map_from_edo(int edo, Pitch ref_pitch, double ref_freq,
                        TuningMap *out) {
+    const EDOCatalogEntry *entry = edo_catalog_lookup(edo);
+    if (entry)
+        return tuning_map_from_fifth(entry->fifth, ref_pitch, ref_freq, out);
+
     int fifth_steps = round(log2(1.5) * edo);
-    double fifth = (float)fifth_steps * 1200 / edo;
+    double fifth = (double)fifth_steps * 1200 / edo;
     return tuning_map_from_fifth(fifth, ref_pitch, ref_freq, out);
 }
 
@@ -30,6 +41,31 @@ double to_cents(Interval m, TuningMap T) {
     return map_to_1d(map_to_2d((MapVec){m.w, m.h}, GENERATORS_TO), T.centmap);
 }
 
+// Cents are linear in (w, h), so the matrix is the n x 2 matrix of Intervals
+// times the 2 x k matrix of step sizes. Tunings are taken a tile at a time so
+// their step sizes stay in L1 while every row streams past, and the inner
+// loop runs along a row of out, so it vectorizes.
+void cents_matrix(const Interval m[], const double ref[], int n,
+                  const TuningMap T[], int k, double out[]) {
+    enum { TILE = 64 };
+    double whole[TILE], half[TILE];
+
+    for (int j0 = 0; j0 < k; j0 += TILE) {
+        int jn = k - j0 < TILE ? k - j0 : TILE;
+        for (int j = 0; j < jn; j++) {
+            Map1D steps = map_compose_1d_2d(T[j0 + j].centmap, GENERATORS_TO);
+            whole[j] = steps.m0;
+            half[j] = steps.m1;
+        }
+        for (int i = 0; i < n; i++) {
+            double w = m[i].w, h = m[i].h, r = ref ? ref[i] : 0;
+            double *row = out + (long)i * k + j0;
+            for (int j = 0; j < jn; j++)
+                row[j] = w * whole[j] + h * half[j] - r;
+        }
+    }
+}
+
 double to_ratio(Interval m, TuningMap T) {
     return pow(2, to_cents(m, T) / 1200);
 }
@@ -38,7 +74,128 @@ double to_hz(Pitch p, TuningMap T) {
     return T.ref_freq * to_ratio(interval_between(T.ref_pitch, p), T);
 }
 
+// Spellings in order of preference, as chromas relative to a key's diatonic
+// window (see degree_alteration): the 7 diatonic notes, then alternately
+// lowered and raised further and further from the window.
+static int spelling_rank(int i) {
+    if (i < 7)
+        return i;
+    return (i - 7) % 2 == 0 ? -((i - 7) / 2 + 1) : 7 + (i - 7) / 2;
+}
+
+// pitch_from_hz chooses between the first 17 spellings, which are exactly the
+// ones degree_alteration doesn't consider foreign. Each repeats every octave,
+// so the candidates within an octave are sorted once by their position in it,
+// and a frequency is rounded to the lattice by reducing it to the octave and
+// finding its two neighbours there: no per-candidate loop at query time.
+// Spellings that sound the same (to within rounding) keep only the preferred
+// one, and preferred spellings win ties between neighbours too.
+typedef struct {
+    int len;
+    Pitch base[17];   // sorted by pos, in the octave above the reference Pitch
+    double pos[17];   // cents of each base Pitch above the reference Pitch
+    int rank[17];     // index in spelling_rank order, lower is preferred
+    double ref_freq;
+    double octave;
+} Quantizer;
+
+static Quantizer quantizer_create(TuningMap T, const TonalContext *key) {
+    // C major's offset is MAJOR - pitch_chroma(C) == MAJOR.
+    int offset = key ? key->chroma_offset : MAJOR;
+    Map1D steps = map_compose_1d_2d(T.centmap, GENERATORS_TO);
+    Quantizer q = {.ref_freq = T.ref_freq, .octave = T.centmap.m1};
+    for (int i = 0; i < 17; i++) {
+        int chroma = spelling_rank(i) - offset;
+        Pitch p = {3 * chroma, chroma};
+        Interval m = interval_between(T.ref_pitch, p);
+        double cents = steps.m0 * m.w + steps.m1 * m.h;
+        int oct = (int)floor(cents / q.octave);
+        p = transpose_real(p, (Interval){-5 * oct, -2 * oct});
+        cents -= oct * q.octave;
+
+        // insert in order of position, dropping enharmonic duplicates
+        int j = q.len;
+        while (j > 0 && q.pos[j - 1] > cents + 1e-6)
+            j--;
+        if (j > 0 && q.pos[j - 1] >= cents - 1e-6)
+            continue; // a preferred spelling already sounds here
+        for (int k = q.len; k > j; k--) {
+            q.base[k] = q.base[k - 1];
+            q.pos[k] = q.pos[k - 1];
+            q.rank[k] = q.rank[k - 1];
+        }
+        q.base[j] = p;
+        q.pos[j] = cents;
+        q.rank[j] = i;
+        q.len++;
+    }
+    return q;
+}
+
+static Pitch quantize(const Quantizer *q, double hz, double *cents) {
+    double c = q->octave * log2(hz / q->ref_freq);
+    double oct = floor(c / q->octave);
+    double x = c - oct * q->octave;
+
+    // the first candidate above x, and the one below it, wrapping around the
+    // octave at either end
+    int lo = 0, hi = q->len;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (q->pos[mid] <= x)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    int above = lo % q->len, below = (lo + q->len - 1) % q->len;
+    double above_oct = oct + (lo == q->len);
+    double below_oct = oct - (lo == 0);
+    double up = q->pos[above] + above_oct * q->octave - c;
+    double down = c - q->pos[below] - below_oct * q->octave;
+
+    // a little slack so that rounding error can't break an enharmonic tie
+    bool take_above = fabs(up - down) <= 1e-6 ? q->rank[above] < q->rank[below]
+                                               : up < down;
+    int best = take_above ? above : below;
+    int n = (int)(take_above ? above_oct : below_oct);
+    if (cents)
+        *cents = take_above ? -up : down;
+    return transpose_real(q->base[best], (Interval){5 * n, 2 * n});
+}
+
+int pitch_from_hz(double hz, TuningMap T, const TonalContext *key, Pitch *out,
+                  double *cents) {
+    if (!(hz > 0) || !isfinite(hz))
+        return 1;
+    Quantizer q = quantizer_create(T, key);
+    *out = quantize(&q, hz, cents);
+    return 0;
+}
+
+int pitches_from_hz(const double hz[], int len, TuningMap T,
+                    const TonalContext *key, Pitch out[], double cents[]) {
+    Quantizer q = quantizer_create(T, key);
+    int skipped = 0;
+    for (int i = 0; i < len; i++) {
+        if (!(hz[i] > 0) || !isfinite(hz[i])) {
+            skipped++;
+            continue;
+        }
+        out[i] = quantize(&q, hz[i], cents ? cents + i : NULL);
+    }
+    return skipped;
+}
+
 int create_edo_map(int edo, EDOMap *out) {
+    const EDOCatalogEntry *entry = edo_catalog_lookup(edo);
+    if (entry) {
+        if (!entry->valid)
+            return 1;
+        *out = entry->map;
+        return 0;
+    }
+
+    // Keep in step with tools/gen_edo_catalog.c.
     int fifth_steps = (int)round(log2(1.5) * edo);
     double fifth = (double)fifth_steps * 1200 / edo;
     if (!fifth_supports_diatonic(fifth))
@@ -49,3 +206,75 @@ int create_edo_map(int edo, EDOMap *out) {
     *out = (EDOMap){whole, half};
     return 0;
 }
+
+HeightMap height_map_from_tuning(TuningMap T) {
+    double octave = T.centmap.m1;
+    double x = T.centmap.m0 / octave;
+
+    // Walk the convergents of fifth/octave looking for the smallest EDO whose
+    // fifth matches. Any EDO fifth this close to ours must be a convergent
+    // (Legendre's theorem), so nothing below 1200 notes is missed.
+    long long h2 = 0, h1 = 1, k2 = 1, k1 = 0;
+    double r = x;
+    while (1) {
+        double a = floor(r);
+        long long h = (long long)a * h1 + h2;
+        long long k = (long long)a * k1 + k2;
+        if (k > 1200)
+            break;
+        if (fabs(x * k - h) * octave <= 1e-4 * k)
+            return (HeightMap){.m0 = 2 * h - k,
+                               .m1 = 3 * k - 5 * h,
+                               .scale = k / octave};
+        if (r - a < 1e-12)
+            break;
+        r = 1 / (r - a);
+        h2 = h1, h1 = h;
+        k2 = k1, k1 = k;
+    }
+
+    double scale = 1048576.0; // 2^20 units per cent
+    Map1D steps = map_compose_1d_2d(T.centmap, GENERATORS_TO);
+    return (HeightMap){.m0 = llround(steps.m0 * scale),
+                       .m1 = llround(steps.m1 * scale),
+                       .scale = scale};
+}
+
+int edo_speller_create(int edo, TonalContext key, EDOSpeller *out) {
+    EDOMap map;
+    if (create_edo_map(edo, &map))
+        return 1;
+
+    // Spellings are walked in an unbroken chain of fifths, which reaches
+    // every step exactly once in its first edo links unless the fifth shares a
+    // factor with the EDO, in which case some steps have no spelling at all.
+    int a = 3 * map.m0 + map.m1, b = edo;
+    while (b) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    if (a != 1)
+        return 1;
+
+    Pitch *spellings = malloc(edo * sizeof(Pitch));
+    if (!spellings)
+        return 1;
+    for (int i = 0; i < edo; i++) {
+        int chroma = spelling_rank(i) - key.chroma_offset;
+        Pitch p = {3 * chroma, chroma};
+        int n = pitch_to_number(p, map);
+        int step = (n % edo + edo) % edo;
+        int octaves = (step - n) / edo;
+        spellings[step] = transpose_real(p, (Interval){5 * octaves,
+                                                       2 * octaves});
+    }
+
+    *out = (EDOSpeller){.edo = edo, .map = map, .spellings = spellings};
+    return 0;
+}
+
+void edo_speller_destroy(EDOSpeller *s) {
+    free(s->spellings);
+    s->spellings = NULL;
+}
@@ -0,0 +1,84 @@
+#include "../include/map.h"
+#include "../include/morph.h"
+#include "../include/types.h"
+#include <math.h>
+#include <stdlib.h>
+
+int tuning_morph_create(TuningMap from, TuningMap to, int blocks, int voices,
+                        TuningMorph *out) {
+    if (blocks < 0 || voices <= 0)
+        return 1;
+
+    double *hz = calloc(voices, sizeof(double));
+    double *step = malloc(voices * sizeof(double));
+    double *target = calloc(voices, sizeof(double));
+    if (!hz || !step || !target) {
+        free(hz);
+        free(step);
+        free(target);
+        return 1;
+    }
+    for (int v = 0; v < voices; v++)
+        step[v] = 1;
+
+    *out = (TuningMorph){.from = from,
+                         .to = to,
+                         .blocks = blocks,
+                         .elapsed = 0,
+                         .len = voices,
+                         .hz = hz,
+                         .step = step,
+                         .target = target};
+    return 0;
+}
+
+void tuning_morph_destroy(TuningMorph *m) {
+    free(m->hz);
+    free(m->step);
+    free(m->target);
+}
+
+// A voice's log-frequency moves the same distance every block, so its
+// frequency is multiplied by the same factor every block: the per-block
+// interval between its two tunings.
+int tuning_morph_voice_on(TuningMorph *m, int voice, Pitch p) {
+    if (voice < 0 || voice >= m->len)
+        return 1;
+
+    double target = to_hz(p, m->to);
+    m->target[voice] = target;
+    if (m->elapsed == m->blocks) {
+        m->hz[voice] = target;
+        m->step[voice] = 1;
+        return 0;
+    }
+    double octaves = log2(target / to_hz(p, m->from));
+    m->hz[voice] =
+        target * exp2(octaves * (m->elapsed - m->blocks) / m->blocks);
+    m->step[voice] = exp2(octaves / m->blocks);
+    return 0;
+}
+
+int tuning_morph_voice_off(TuningMorph *m, int voice) {
+    if (voice < 0 || voice >= m->len)
+        return 1;
+    m->hz[voice] = 0;
+    m->step[voice] = 1;
+    m->target[voice] = 0;
+    return 0;
+}
+
+void tuning_morph_advance(TuningMorph *m, double hz[]) {
+    int n = m->len;
+    if (m->elapsed < m->blocks && ++m->elapsed == m->blocks) {
+        for (int v = 0; v < n; v++) {
+            m->hz[v] = m->target[v];
+            m->step[v] = 1;
+        }
+    } else {
+        for (int v = 0; v < n; v++)
+            m->hz[v] *= m->step[v];
+    }
+    for (int v = 0; v < n; v++)
+        hz[v] = m->hz[v];
+}
@@ -0,0 +1,171 @@
+#include "../include/optimize.h"
+#include "../include/constants.h"
+#include "../include/map.h"
+#include "../include/parallel.h"
+#include "../include/types.h"
+#include <math.h>
+
+// Every Interval is x fifths plus y octaves (see GENERATORS_TO), so its error
+// in a tuning with a fifth of F cents is linear in F:
+//     e = x * F + (1200 * y - just)
+// Least squares error is then a quadratic in F, fully described by a handful
+// of sums that only need computing once.
+typedef struct {
+    double xx, xc, cc, total;
+} FitSums;
+
+static double fit_offset(Interval m, double just) {
+    return 1200 * map_to_2d((MapVec){m.w, m.h}, GENERATORS_TO).y - just;
+}
+
+static double fit_chroma(Interval m) {
+    return map_to_2d((MapVec){m.w, m.h}, GENERATORS_TO).x;
+}
+
+static FitSums fit_sums(const Interval m[], const double just[],
+                        const double weight[], int len) {
+    FitSums s = {0, 0, 0, 0};
+    for (int i = 0; i < len; i++) {
+        double w = weight ? weight[i] : 1;
+        double x = fit_chroma(m[i]), c = fit_offset(m[i], just[i]);
+        s.xx += w * x * x;
+        s.xc += w * x * c;
+        s.cc += w * c * c;
+        s.total += w;
+    }
+    return s;
+}
+
+static double least_squares_error(FitSums s, double fifth) {
+    double e = (fifth * fifth * s.xx + 2 * fifth * s.xc + s.cc) / s.total;
+    return sqrt(e > 0 ? e : 0);
+}
+
+static double minimax_error(const Interval m[], const double just[],
+                            const double weight[], int len, double fifth) {
+    double worst = 0;
+    for (int i = 0; i < len; i++) {
+        if (weight && !(weight[i] > 0))
+            continue;
+        double e = fabs(fit_chroma(m[i]) * fifth + fit_offset(m[i], just[i]));
+        worst = e > worst ? e : worst;
+    }
+    return worst;
+}
+
+int optimal_fifth(const Interval m[], const double just[],
+                  const double weight[], int len, enum FitCriterion criterion,
+                  double *out, double *error) {
+    FitSums s = fit_sums(m, just, weight, len);
+    if (!(s.xx > 0))
+        return 1;
+
+    double lo = 1200.0 * 4 / 7, hi = 1200.0 * 3 / 5;
+    double fifth;
+    if (criterion == LEAST_SQUARES) {
+        // Minimum of the quadratic, clamped to the diatonic range.
+        fifth = -s.xc / s.xx;
+        fifth = fifth < lo ? lo : fifth > hi ? hi : fifth;
+    } else {
+        // The worst error is convex in the fifth, so ternary search finds
+        // its minimum; 200 rounds shrink the range below a double's
+        // precision.
+        for (int i = 0; i < 200; i++) {
+            double a = lo + (hi - lo) / 3, b = hi - (hi - lo) / 3;
+            if (minimax_error(m, just, weight, len, a) <
+                minimax_error(m, just, weight, len, b))
+                hi = b;
+            else
+                lo = a;
+        }
+        fifth = (lo + hi) / 2;
+    }
+
+    *out = fifth;
+    if (error)
+        *error = criterion == LEAST_SQUARES
+                     ? least_squares_error(s, fifth)
+                     : minimax_error(m, just, weight, len, fifth);
+    return 0;
+}
+
+// optimal_edo's scan, split into chunks of the EDO range that may run on
+// separate threads. Each chunk keeps its own best, and the bests are compared
+// in order afterwards so ties still go to the smaller EDO.
+typedef struct {
+    const Interval *m;
+    const double *just, *weight;
+    int len, min_edo;
+    enum FitCriterion criterion;
+    FitSums s;
+    int best[PARALLEL_MAX_THREADS]; // per chunk
+    double best_error[PARALLEL_MAX_THREADS];
+} EDOScan;
+
+static void edo_scan(void *ctx, int chunk, long start, long end) {
+    EDOScan *scan = ctx;
+    int best = 0;
+    double best_error = INFINITY;
+    for (int edo = scan->min_edo + start; edo < scan->min_edo + end; edo++) {
+        double fifth;
+        const EDOCatalogEntry *entry = edo_catalog_lookup(edo);
+        if (entry) {
+            if (!entry->valid)
+                continue;
+            fifth = entry->fifth;
+        } else {
+            EDOMap T;
+            if (create_edo_map(edo, &T))
+                continue;
+            fifth = (double)(3 * T.m0 + T.m1) * 1200 / edo;
+        }
+
+        double e = scan->criterion == LEAST_SQUARES
+                       ? least_squares_error(scan->s, fifth)
+                       : minimax_error(scan->m, scan->just, scan->weight,
+                                       scan->len, fifth);
+        if (e < best_error) {
+            best = edo;
+            best_error = e;
+        }
+    }
+    scan->best[chunk] = best;
+    scan->best_error[chunk] = best_error;
+}
+
+int optimal_edo(const Interval m[], const double just[], const double weight[],
+                int len, int min_edo, int max_edo, enum FitCriterion criterion,
+                int *out, double *error) {
+    FitSums s = fit_sums(m, just, weight, len);
+    if (!(s.xx > 0))
+        return 1;
+
+    EDOScan scan = {.m = m,
+                    .just = just,
+                    .weight = weight,
+                    .len = len,
+                    .min_edo = min_edo < 1 ? 1 : min_edo,
+                    .criterion = criterion,
+                    .s = s};
+    long edos = max_edo >= scan.min_edo ? max_edo - scan.min_edo + 1 : 0;
+    // enough EDOs per thread to be worth starting it: about 2^16 Intervals
+    long grain =
+        criterion == LEAST_SQUARES ? 1 << 16 : (1 << 16) / (len + 1) + 1;
+    parallel_for(edos, grain, edo_scan, &scan);
+
+    int best = 0;
+    double best_error = INFINITY;
+    for (int i = 0; i < parallel_chunks(edos, grain); i++) {
+        if (scan.best[i] && scan.best_error[i] < best_error) {
+            best = scan.best[i];
+            best_error = scan.best_error[i];
+        }
+    }
+    if (!best)
+        return 1;
+
+    *out = best;
+    if (error)
+        *error = best_error;
+    return 0;
+}
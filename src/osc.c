@@ -0,0 +1,97 @@
+#include "../include/osc.h"
+#include "../include/map.h"
+#include "../include/types.h"
+#include <math.h>
+#include <stdlib.h>
+
+int osc_bank_create(TuningMap T, double sample_rate, int voices, OscBank *out) {
+    if (voices <= 0 || !(sample_rate > 0) || isinf(sample_rate))
+        return 1;
+
+    double *inc = calloc(voices, sizeof(double));
+    double *target = calloc(voices, sizeof(double));
+    double *ratio = malloc(voices * sizeof(double));
+    int *remaining = calloc(voices, sizeof(int));
+    if (!inc || !target || !ratio || !remaining) {
+        free(inc);
+        free(target);
+        free(ratio);
+        free(remaining);
+        return 1;
+    }
+    for (int v = 0; v < voices; v++)
+        ratio[v] = 1;
+
+    *out = (OscBank){.T = T,
+                     .sample_rate = sample_rate,
+                     .len = voices,
+                     .inc = inc,
+                     .target = target,
+                     .ratio = ratio,
+                     .remaining = remaining};
+    return 0;
+}
+
+void osc_bank_destroy(OscBank *b) {
+    free(b->inc);
+    free(b->target);
+    free(b->ratio);
+    free(b->remaining);
+}
+
+int osc_bank_set(OscBank *b, int voice, Pitch p) {
+    return osc_bank_glide(b, voice, p, 0);
+}
+
+int osc_bank_glide(OscBank *b, int voice, Pitch p, int samples) {
+    if (voice < 0 || voice >= b->len)
+        return 1;
+
+    double target = to_hz(p, b->T) / b->sample_rate;
+    b->target[voice] = target;
+    if (samples <= 0 || b->inc[voice] == 0) {
+        b->inc[voice] = target;
+        b->ratio[voice] = 1;
+        b->remaining[voice] = 0;
+    } else {
+        b->ratio[voice] = pow(target / b->inc[voice], 1.0 / samples);
+        b->remaining[voice] = samples;
+    }
+    return 0;
+}
+
+// The block is cut wherever a glide ends. Within each piece every voice takes
+// the same path, inc *= ratio (steady voices have a ratio of exactly 1), so the
+// inner loop runs across contiguous voice arrays and vectorizes. Glides that
+// end on a cut are snapped onto their target, so rounding never accumulates.
+void osc_bank_render(OscBank *b, int frames, double out[]) {
+    int n = b->len;
+    double *inc = b->inc;
+    const double *ratio = b->ratio;
+
+    for (int i = 0; i < frames;) {
+        int piece = frames - i;
+        for (int v = 0; v < n; v++)
+            if (b->remaining[v] && b->remaining[v] < piece)
+                piece = b->remaining[v];
+
+        for (int end = i + piece; i < end; i++) {
+            double *row = out + (long)i * n;
+            for (int v = 0; v < n; v++) {
+                inc[v] *= ratio[v];
+                row[v] = inc[v];
+            }
+        }
+
+        for (int v = 0; v < n; v++) {
+            if (!b->remaining[v])
+                continue;
+            b->remaining[v] -= piece;
+            if (!b->remaining[v]) {
+                inc[v] = b->target[v];
+                b->ratio[v] = 1;
+                out[(long)(i - 1) * n + v] = inc[v];
+            }
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#include "../include/packed.h"
+#include "../include/pitch.h"
+#include "../include/types.h"
+
+int pitches_to_pitch16(const Pitch arr[], int len, Pitch16 out[]) {
+    int skipped = 0;
+    for (int i = 0; i < len; i++)
+        skipped += pitch16_from_pitch(arr[i], &out[i]);
+    return skipped;
+}
+
+void pitches_from_pitch16(const Pitch16 arr[], int len, Pitch out[]) {
+    for (int i = 0; i < len; i++)
+        out[i] = pitch16_to_pitch(arr[i]);
+}
+
+void pitches16_transpose(Pitch16 arr[], int len, Pitch16 m) {
+    for (int i = 0; i < len; i++)
+        arr[i] = pitch16_transpose(arr[i], m);
+}
+
+void pitches16_intervals(const Pitch16 p[], const Pitch16 q[], int len,
+                         Pitch16 out[]) {
+    for (int i = 0; i < len; i++)
+        out[i] = pitch16_interval(p[i], q[i]);
+}
+
+void pitches16_to_standard(const Pitch16 arr[], int len, StandardPitch out[]) {
+    for (int i = 0; i < len; i++)
+        out[i] = (StandardPitch){.letter = pitch16_letter(arr[i]),
+                                 .accidental = pitch16_accidental(arr[i]),
+                                 .octave = pitch16_octave(arr[i])};
+}
+
+int pitch_buffer_from_pitch16(PitchBuffer *b, const Pitch16 arr[], int len) {
+    if (len < 0 || len > b->capacity)
+        return 1;
+    for (int i = 0; i < len; i++) {
+        b->w[i] = pitch16_w(arr[i]);
+        b->h[i] = pitch16_h(arr[i]);
+    }
+    b->len = len;
+    return 0;
+}
+
+int pitch_buffer_to_pitch16(const PitchBuffer *b, Pitch16 out[]) {
+    int skipped = 0;
+    for (int i = 0; i < b->len; i++)
+        skipped += pitch16_from_pitch((Pitch){b->w[i], b->h[i]}, &out[i]);
+    return skipped;
+}
@@ -0,0 +1,77 @@
+#include "../include/parallel.h"
+#include <stdbool.h>
+#ifdef MEANTONAL_THREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#ifdef MEANTONAL_THREADS
+static int parallel_cores = 1;
+static pthread_once_t parallel_once = PTHREAD_ONCE_INIT;
+
+static void parallel_count_cores(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    parallel_cores = n < 1                      ? 1
+                     : n > PARALLEL_MAX_THREADS ? PARALLEL_MAX_THREADS
+                                                : (int)n;
+}
+#endif
+
+int parallel_threads(void) {
+#ifdef MEANTONAL_THREADS
+    pthread_once(&parallel_once, parallel_count_cores);
+    return parallel_cores;
+#else
+    return 1;
+#endif
+}
+
+int parallel_chunks(long len, long grain) {
+    long n = grain > 0 ? len / grain : len;
+    int threads = parallel_threads();
+    return n < 1 ? 1 : n > threads ? threads : (int)n;
+}
+
+typedef struct {
+    void (*body)(void *ctx, int chunk, long start, long end);
+    void *ctx;
+    int chunk;
+    long start, end;
+} ParallelTask;
+
+#ifdef MEANTONAL_THREADS
+static void *parallel_run(void *arg) {
+    ParallelTask *t = arg;
+    t->body(t->ctx, t->chunk, t->start, t->end);
+    return NULL;
+}
+#endif
+
+void parallel_for(long len, long grain,
+                  void (*body)(void *ctx, int chunk, long start, long end),
+                  void *ctx) {
+    int n = parallel_chunks(len, grain);
+    ParallelTask tasks[PARALLEL_MAX_THREADS];
+    for (int i = 0; i < n; i++)
+        tasks[i] = (ParallelTask){body, ctx, i, (long)((long long)i * len / n),
+                                  (long)((long long)(i + 1) * len / n)};
+#ifdef MEANTONAL_THREADS
+    // Chunk 0 runs here while the others get a thread each. A chunk whose
+    // thread can't be started runs here too, once chunk 0 is done.
+    pthread_t threads[PARALLEL_MAX_THREADS];
+    bool started[PARALLEL_MAX_THREADS] = {false};
+    for (int i = 1; i < n; i++)
+        started[i] =
+            pthread_create(&threads[i], NULL, parallel_run, &tasks[i]) == 0;
+    parallel_run(&tasks[0]);
+    for (int i = 1; i < n; i++) {
+        if (started[i])
+            pthread_join(threads[i], NULL);
+        else
+            parallel_run(&tasks[i]);
+    }
+#else
+    for (int i = 0; i < n; i++)
+        body(ctx, i, tasks[i].start, tasks[i].end);
+#endif
+}
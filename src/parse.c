@@ -144,14 +144,11 @@ int pitch_from_relative_lily(
     out->w += acc;
     out->h -= acc;
 
-    while (steps_between((Pitch){out->w, out->h}, ctx->previous) > 3) {
-        out->w += 5;
-        out->h += 2;
-    }
-    while (steps_between((Pitch){out->w, out->h}, ctx->previous) < -3) {
-        out->w -= 5;
-        out->h -= 2;
-    }
+    // the octave that lands within a 4th of the previous note
+    int octaves =
+        floor_div7(steps_between((Pitch){out->w, out->h}, ctx->previous) + 3);
+    out->w += 5 * octaves;
+    out->h += 2 * octaves;
 
     int oct = 0;
     while (*p == '\'' || *p == ',') {
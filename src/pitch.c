@@ -1,20 +1,65 @@
 #include "../include/pitch.h"
 #include "../include/interval.h"
 #include "../include/map.h"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 Pitch pitch_from_chroma(int chroma, int octave) {
-    Pitch p = {0, 0};
-    p.w += chroma * 3;
-    p.h += chroma;
-    while (pitch_octave(p) > octave) {
-        p.w -= 5;
-        p.h -= 2;
+    Pitch p = {chroma * 3, chroma};
+    int octaves = octave - pitch_octave(p);
+    return (Pitch){.w = p.w + 5 * octaves, .h = p.h + 2 * octaves};
+}
+
+// With AVX2, 8 Pitches at a time are loaded as two vectors of interleaved w
+// and h, multiplied by {m0, m1, m0, m1, ...}, and added pairwise. The pairwise
+// add works within 128-bit halves, so a 64-bit permute puts the 8 numbers back
+// in order.
+void pitches_to_numbers(const Pitch arr[], int len, EDOMap T, int out[]) {
+    int i = 0;
+#ifdef __AVX2__
+    __m256i m = _mm256_setr_epi32(T.m0, T.m1, T.m0, T.m1, T.m0, T.m1, T.m0,
+                                  T.m1);
+    for (; i + 8 <= len; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(arr + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(arr + i + 4));
+        __m256i n = _mm256_hadd_epi32(_mm256_mullo_epi32(a, m),
+                                      _mm256_mullo_epi32(b, m));
+        _mm256_storeu_si256((__m256i *)(out + i),
+                            _mm256_permute4x64_epi64(n, 0xd8));
     }
-    while (pitch_octave(p) < octave) {
-        p.w += 5;
-        p.h += 2;
+#endif
+    for (; i < len; i++)
+        out[i] = T.m0 * arr[i].w + T.m1 * arr[i].h;
+}
+
+void pitches_from_numbers(const int arr[], int len, const EDOSpeller *s,
+                          Pitch out[]) {
+    for (int i = 0; i < len; i++)
+        out[i] = pitch_from_number(arr[i], s);
+}
+
+Pitch pitches_from_intervals(Pitch start, const Interval m[], int len,
+                             Pitch out[]) {
+    for (int i = 0; i < len; i++)
+        out[i] = start = transpose_real(start, m[i]);
+    return start;
+}
+
+void intervals_from_pitches(Pitch start, const Pitch arr[], int len,
+                            Interval out[]) {
+    for (int i = 0; i < len; i++) {
+        Pitch p = arr[i];
+        out[i] = interval_between(start, p);
+        start = p;
     }
-    return p;
+}
+
+Interval intervals_sum(const Interval m[], int len) {
+    Interval sum = {0, 0};
+    for (int i = 0; i < len; i++)
+        sum = transpose_real(sum, m[i]);
+    return sum;
 }
 
 bool pitch_audible(Pitch p, TuningMap T) {
@@ -25,57 +70,278 @@ bool pitch_audible(Pitch p, TuningMap T) {
 }
 
 Pitch pitch_highest(Pitch arr[], int len, TuningMap T) {
-    Pitch highest = arr[0];
+    return arr[pitch_highest_index(arr, len, height_map_from_tuning(T))];
+}
+
+Pitch pitch_lowest(Pitch arr[], int len, TuningMap T) {
+    return arr[pitch_lowest_index(arr, len, height_map_from_tuning(T))];
+}
+
+void pitch_heights(const Pitch arr[], int len, HeightMap H, long long out[]) {
+    for (int i = 0; i < len; i++)
+        out[i] = pitch_height(arr[i], H);
+}
+
+// Both searches reduce to the extreme height first, in a loop with no
+// data-dependent branches so it vectorizes, then settle enharmonic ties
+// among the (usually very few) Pitches at that height.
+int pitch_highest_index(const Pitch arr[], int len, HeightMap H) {
+    if (len <= 0)
+        return -1;
+    long long top = pitch_height(arr[0], H);
     for (int i = 1; i < len; i++) {
-        if (to_hz(arr[i], T) > to_hz(highest, T))
-            highest = arr[i];
-        else if (to_hz(arr[i], T) == to_hz(highest, T) &&
-                 steps_between(arr[i], highest) < 0)
-            highest = arr[i];
+        long long x = pitch_height(arr[i], H);
+        top = x > top ? x : top;
     }
-    return highest;
+
+    int best = -1;
+    for (int i = 0; i < len; i++) {
+        if (pitch_height(arr[i], H) != top)
+            continue;
+        if (best < 0 || steps_between(arr[i], arr[best]) < 0)
+            best = i;
+    }
+    return best;
 }
 
-Pitch pitch_lowest(Pitch arr[], int len, TuningMap T) {
-    Pitch lowest = arr[0];
+int pitch_lowest_index(const Pitch arr[], int len, HeightMap H) {
+    if (len <= 0)
+        return -1;
+    long long bottom = pitch_height(arr[0], H);
     for (int i = 1; i < len; i++) {
-        if (to_hz(arr[i], T) < to_hz(lowest, T))
-            lowest = arr[i];
-        else if (to_hz(arr[i], T) == to_hz(lowest, T) &&
-                 steps_between(arr[i], lowest) > 0)
-            lowest = arr[i];
+        long long x = pitch_height(arr[i], H);
+        bottom = x < bottom ? x : bottom;
+    }
+
+    int best = -1;
+    for (int i = 0; i < len; i++) {
+        if (pitch_height(arr[i], H) != bottom)
+            continue;
+        if (best < 0 || steps_between(arr[i], arr[best]) > 0)
+            best = i;
+    }
+    return best;
+}
+
+// Heapsort: O(n log n) with no allocation, and no comparator callback to
+// thread the HeightMap through.
+static void sift_down(Pitch arr[], int root, int len, HeightMap H) {
+    while (2 * root + 1 < len) {
+        int child = 2 * root + 1;
+        if (child + 1 < len &&
+            pitches_compare_height(arr[child + 1], arr[child], H) > 0)
+            child++;
+        if (pitches_compare_height(arr[child], arr[root], H) <= 0)
+            return;
+        Pitch tmp = arr[root];
+        arr[root] = arr[child];
+        arr[child] = tmp;
+        root = child;
+    }
+}
+
+void pitch_sort(Pitch arr[], int len, HeightMap H) {
+    for (int i = len / 2 - 1; i >= 0; i--)
+        sift_down(arr, i, len, H);
+    for (int end = len - 1; end > 0; end--) {
+        Pitch tmp = arr[0];
+        arr[0] = arr[end];
+        arr[end] = tmp;
+        sift_down(arr, 0, end, H);
+    }
+}
+
+// Anything pitches_compare_height leaves tied is broken by index, making the
+// order total so the unstable heapsort still produces a stable ranking.
+static int index_compare(const Pitch arr[], int i, int j, HeightMap H) {
+    int c = pitches_compare_height(arr[i], arr[j], H);
+    return c ? c : (i > j) - (i < j);
+}
+
+static void sift_down_index(const Pitch arr[], int idx[], int root, int len,
+                            HeightMap H) {
+    while (2 * root + 1 < len) {
+        int child = 2 * root + 1;
+        if (child + 1 < len &&
+            index_compare(arr, idx[child + 1], idx[child], H) > 0)
+            child++;
+        if (index_compare(arr, idx[child], idx[root], H) <= 0)
+            return;
+        int tmp = idx[root];
+        idx[root] = idx[child];
+        idx[child] = tmp;
+        root = child;
     }
-    return lowest;
 }
 
-double oriented_ratio_between(Pitch p, Pitch q, TuningMap T) {
-    double x = to_ratio(interval_between(p, q), T);
-    double y = to_ratio(interval_between(q, p), T);
-    return x >= y ? x : y;
+void pitch_argsort(const Pitch arr[], int len, HeightMap H, int out[]) {
+    for (int i = 0; i < len; i++)
+        out[i] = i;
+    for (int i = len / 2 - 1; i >= 0; i--)
+        sift_down_index(arr, out, i, len, H);
+    for (int end = len - 1; end > 0; end--) {
+        int tmp = out[0];
+        out[0] = out[end];
+        out[end] = tmp;
+        sift_down_index(arr, out, 0, end, H);
+    }
 }
 
 Pitch pitch_nearest(Pitch p, Pitch arr[], int len, TuningMap T) {
-    double smallest_ratio = oriented_ratio_between(p, arr[0], T);
+    HeightMap H = height_map_from_tuning(T);
+    long long height = pitch_height(p, H);
 
+    int closest = 0;
+    long long best_dist = llabs(pitch_height(arr[0], H) - height);
+    int best_steps = abs(steps_between(p, arr[0]));
     for (int i = 1; i < len; i++) {
-        double x = oriented_ratio_between(p, arr[i], T);
-        if (x < smallest_ratio)
-            smallest_ratio = x;
+        long long dist = llabs(pitch_height(arr[i], H) - height);
+        int steps = abs(steps_between(p, arr[i]));
+        if (dist < best_dist || (dist == best_dist && steps < best_steps)) {
+            closest = i;
+            best_dist = dist;
+            best_steps = steps;
+        }
+    }
+    return arr[closest];
+}
+
+typedef struct {
+    long long height;
+    Pitch p;
+    int order;
+} IndexEntry;
+
+static int index_entry_compare(const void *a, const void *b) {
+    const IndexEntry *x = a, *y = b;
+    if (x->height != y->height)
+        return x->height > y->height ? 1 : -1;
+    int sx = x->p.w + x->p.h, sy = y->p.w + y->p.h;
+    if (sx != sy)
+        return sx > sy ? 1 : -1;
+    return (x->order > y->order) - (x->order < y->order);
+}
+
+int nearest_index_create(const Pitch arr[], int len, TuningMap T,
+                         NearestIndex *out) {
+    if (len <= 0)
+        return 1;
+
+    IndexEntry *entries = malloc(len * sizeof(IndexEntry));
+    long long *heights = malloc(len * sizeof(long long));
+    Pitch *pitches = malloc(len * sizeof(Pitch));
+    int *order = malloc(len * sizeof(int));
+    if (!entries || !heights || !pitches || !order) {
+        free(entries);
+        free(heights);
+        free(pitches);
+        free(order);
+        return 1;
     }
 
-    Pitch candidates[len];
-    int candidates_len = 0;
+    HeightMap H = height_map_from_tuning(T);
+    for (int i = 0; i < len; i++)
+        entries[i] = (IndexEntry){pitch_height(arr[i], H), arr[i], i};
+    qsort(entries, len, sizeof(IndexEntry), index_entry_compare);
+
+    // A candidate with the same height and steps as an earlier one can never
+    // win a query, so only the first of each is kept.
+    int n = 0;
     for (int i = 0; i < len; i++) {
-        if (oriented_ratio_between(p, arr[i], T) == smallest_ratio)
-            candidates[candidates_len++] = arr[i];
+        if (n > 0 && heights[n - 1] == entries[i].height &&
+            steps_between(pitches[n - 1], entries[i].p) == 0)
+            continue;
+        heights[n] = entries[i].height;
+        pitches[n] = entries[i].p;
+        order[n] = entries[i].order;
+        n++;
+    }
+    free(entries);
+
+    *out = (NearestIndex){.H = H,
+                          .len = n,
+                          .heights = heights,
+                          .pitches = pitches,
+                          .order = order};
+    return 0;
+}
+
+void nearest_index_destroy(NearestIndex *ix) {
+    free(ix->heights);
+    free(ix->pitches);
+    free(ix->order);
+    ix->heights = NULL;
+    ix->pitches = NULL;
+    ix->order = NULL;
+    ix->len = 0;
+}
+
+// First position in [lo, hi) whose height is >= height.
+static int lower_height(const NearestIndex *ix, int lo, int hi,
+                        long long height) {
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (ix->heights[mid] < height)
+            lo = mid + 1;
+        else
+            hi = mid;
     }
+    return lo;
+}
 
-    Pitch closest = candidates[0];
-    for (int i = 1; i < candidates_len; i++) {
-        if (abs(steps_between(p, candidates[i])) <
-            abs(steps_between(p, closest)))
-            closest = candidates[i];
+// Within the run [lo, hi) of equal heights, the position whose steps are
+// closest to p's, with ties going to the earlier candidate.
+static int closest_in_run(const NearestIndex *ix, int lo, int hi, Pitch p) {
+    int steps = p.w + p.h;
+    int a = lo, b = hi;
+    while (a < b) {
+        int mid = a + (b - a) / 2;
+        if (ix->pitches[mid].w + ix->pitches[mid].h < steps)
+            a = mid + 1;
+        else
+            b = mid;
     }
+    if (a == hi)
+        return a - 1;
+    if (a == lo)
+        return a;
+    int above = abs(steps_between(p, ix->pitches[a]));
+    int below = abs(steps_between(p, ix->pitches[a - 1]));
+    if (above != below)
+        return above < below ? a : a - 1;
+    return ix->order[a] < ix->order[a - 1] ? a : a - 1;
+}
+
+int nearest_index_query(const NearestIndex *ix, Pitch p) {
+    if (ix->len <= 0)
+        return -1;
+    long long height = pitch_height(p, ix->H);
+    int pos = lower_height(ix, 0, ix->len, height);
+
+    int above = -1, below = -1;
+    if (pos < ix->len) {
+        long long h = ix->heights[pos];
+        above = closest_in_run(ix, pos, lower_height(ix, pos, ix->len, h + 1),
+                               p);
+    }
+    if (pos > 0) {
+        long long h = ix->heights[pos - 1];
+        below = closest_in_run(ix, lower_height(ix, 0, pos, h), pos, p);
+    }
+
+    if (below < 0)
+        return ix->order[above];
+    if (above < 0)
+        return ix->order[below];
 
-    return closest;
+    long long da = ix->heights[above] - height;
+    long long db = height - ix->heights[below];
+    if (da != db)
+        return ix->order[da < db ? above : below];
+    int sa = abs(steps_between(p, ix->pitches[above]));
+    int sb = abs(steps_between(p, ix->pitches[below]));
+    if (sa != sb)
+        return ix->order[sa < sb ? above : below];
+    return ix->order[above] < ix->order[below] ? ix->order[above]
+                                               : ix->order[below];
 }
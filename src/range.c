@@ -0,0 +1,136 @@
+#include "../include/range.h"
+#include "../include/constants.h"
+#include "../include/map.h"
+#include "../include/pitch.h"
+#include "../include/types.h"
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+
+// Heights are (to within rounding) cents above the Pitch (0, 0) times the
+// HeightMap's scale, so a frequency's height comes from its cents above the
+// reference Pitch. That estimate is then nudged until the bound agrees with
+// to_hz at the Pitches of neighbouring heights, which matters for EDO heights,
+// where a Pitch exactly on a bound is common.
+
+static double height_of_hz(double hz, TuningMap T, HeightMap H) {
+    Map1D cents = map_compose_1d_2d(T.centmap, GENERATORS_TO);
+    double ref = cents.m0 * T.ref_pitch.w + cents.m1 * T.ref_pitch.h;
+    return (ref + 1200 * log2(hz / T.ref_freq)) * H.scale;
+}
+
+// A Pitch of the given height, if the HeightMap is an EDO's; fixed-point
+// heights have no such Pitch in general, and are left as estimated.
+static bool pitch_of_height(long long height, HeightMap H, Pitch *out) {
+    // m0 and m1 of an EDO HeightMap are the sizes of whole and half steps
+    long long a = H.m0, b = H.m1;
+    if (H.scale >= 1048576.0 || a <= 0 || b <= 0)
+        return false;
+    // solve a * w + b * h = height with extended Euclid
+    long long x0 = 1, y0 = 0, x1 = 0, y1 = 1;
+    while (b) {
+        long long q = a / b, t = a - q * b;
+        a = b, b = t;
+        t = x0 - q * x1, x0 = x1, x1 = t;
+        t = y0 - q * y1, y0 = y1, y1 = t;
+    }
+    if (a != 1)
+        return false;
+    // Adding (m1, -m0) keeps the height and moves the chroma by a whole EDO,
+    // so pick the solution spelled nearest C, whose frequency in a tuning only
+    // approximated by the EDO is closest to the EDO's.
+    long long w = x0 * height, h = y0 * height, edo = 5 * H.m0 + 2 * H.m1;
+    long long k = (2 * w - 5 * h + edo / 2) / edo;
+    k -= (2 * w - 5 * h + edo / 2) % edo < 0;
+    *out = (Pitch){(int)(w - k * H.m1), (int)(h + k * H.m0)};
+    return true;
+}
+
+int pitch_range_from_hz(double lo_hz, double hi_hz, TuningMap T,
+                        PitchRange *out) {
+    if (!(lo_hz > 0) || !isfinite(hi_hz) || !(hi_hz >= lo_hz))
+        return 1;
+    HeightMap H = height_map_from_tuning(T);
+    long long lo = (long long)ceil(height_of_hz(lo_hz, T, H));
+    long long hi = (long long)floor(height_of_hz(hi_hz, T, H));
+    Pitch p;
+    while (pitch_of_height(lo - 1, H, &p) && to_hz(p, T) >= lo_hz)
+        lo--;
+    while (pitch_of_height(lo, H, &p) && to_hz(p, T) < lo_hz)
+        lo++;
+    while (pitch_of_height(hi + 1, H, &p) && to_hz(p, T) <= hi_hz)
+        hi++;
+    while (pitch_of_height(hi, H, &p) && to_hz(p, T) > hi_hz)
+        hi--;
+    *out = (PitchRange){.H = H, .lo = lo, .hi = hi};
+    return 0;
+}
+
+PitchRange pitch_range_from_pitches(Pitch lo, Pitch hi, TuningMap T) {
+    HeightMap H = height_map_from_tuning(T);
+    return (PitchRange){
+        .H = H, .lo = pitch_height(lo, H), .hi = pitch_height(hi, H)};
+}
+
+PitchRange pitch_range_audible(TuningMap T) {
+    PitchRange r;
+    pitch_range_from_hz(20.0, 20000.0, T, &r);
+    return r;
+}
+
+int pitches_in_range(const Pitch arr[], int len, PitchRange r, bool out[]) {
+    int count = 0;
+    for (int i = 0; i < len; i++)
+        count += out[i] = pitch_in_range(arr[i], r);
+    return count;
+}
+
+int pitches_filter_range(const Pitch arr[], int len, PitchRange r,
+                         Pitch out[]) {
+    int count = 0;
+    for (int i = 0; i < len; i++) {
+        Pitch p = arr[i];
+        if (pitch_in_range(p, r))
+            out[count++] = p;
+    }
+    return count;
+}
+
+// A Pitch with at most k sharps or flats has a chroma from -7k - 1 to 7k + 5,
+// and every Pitch of one chroma is an octave apart from the next. Moving one
+// Pitch of each chroma into the octave starting at r.lo and sorting them gives
+// the order for every octave of the range, so listing is then a matter of
+// stepping through that octave over and over, an octave higher each time.
+int pitch_range_spellings(PitchRange r, int max_accidental, Pitch out[],
+                          int capacity, int *total) {
+    if (capacity < 0 || max_accidental < 0 || max_accidental > 100000)
+        return 1;
+    int len = 14 * max_accidental + 7;
+    Pitch *octave = malloc(len * sizeof(Pitch));
+    if (!octave)
+        return 1;
+    long long span = pitch_height((Pitch){5, 2}, r.H);
+    long long count = 0;
+    for (int i = 0; i < len; i++) {
+        int chroma = i - 7 * max_accidental - 1;
+        Pitch p = {3 * chroma, chroma};
+        // the fewest octaves that bring p up to r.lo, which may be negative
+        long long below = r.lo - pitch_height(p, r.H);
+        long long n = below / span + (below % span > 0);
+        octave[i] = (Pitch){(int)(p.w + 5 * n), (int)(p.h + 2 * n)};
+        long long height = pitch_height(octave[i], r.H);
+        if (height <= r.hi)
+            count += (r.hi - height) / span + 1;
+    }
+    if (count > INT_MAX) {
+        free(octave);
+        return 1;
+    }
+    pitch_sort(octave, len, r.H);
+    for (int i = 0, n = 0; i < count && i < capacity; n++)
+        for (int j = 0; j < len && i < count && i < capacity; j++, i++)
+            out[i] = (Pitch){octave[j].w + 5 * n, octave[j].h + 2 * n};
+    free(octave);
+    *total = (int)count;
+    return 0;
+}
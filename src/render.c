@@ -0,0 +1,207 @@
+#include "../include/map.h"
+#include "../include/parallel.h"
+#include "../include/render.h"
+#include "../include/types.h"
+#include "../include/wav.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Samples are rendered in blocks, each starting from a phase computed from
+// scratch, so the loop inside a block carries no dependency between samples.
+// Blocks are counted from the note's start, so a sample comes out the same
+// however the range around it is split.
+enum { RENDER_BLOCK = 256 };
+
+// Ranges longer than this are split between threads (see parallel.h).
+enum { RENDER_SLICE = 16384 };
+
+// note_renderer_write_wav renders this many samples at a time, enough to give
+// every thread a slice.
+enum { RENDER_WAV_BLOCK = 1 << 18 };
+
+static const double RENDER_TAU = 6.283185307179586;
+
+void wavetable_harmonics(float table[], int len, const double amps[],
+                         int harmonics) {
+    for (int i = 0; i < len; i++) {
+        double x = 0;
+        for (int k = 0; k < harmonics; k++)
+            x += amps[k] * sin(RENDER_TAU * (k + 1) * i / len);
+        table[i] = x;
+    }
+}
+
+typedef struct {
+    long start;
+    int order;
+} RenderOnset;
+
+static int render_onset_compare(const void *a, const void *b) {
+    const RenderOnset *x = a, *y = b;
+    if (x->start != y->start)
+        return x->start > y->start ? 1 : -1;
+    return x->order - y->order;
+}
+
+int note_renderer_create(const NoteEvent notes[], int len, TuningMap T,
+                         int sample_rate, const float table[], int table_len,
+                         NoteRenderer *out) {
+    if (sample_rate <= 0 || table_len <= 0 || (table_len & (table_len - 1)))
+        return 1;
+
+    int n = len > 0 ? len : 0;
+    RenderOnset *onsets = malloc((n ? n : 1) * sizeof(RenderOnset));
+    float *copy = malloc(table_len * sizeof(float));
+    long *start = malloc((n ? n : 1) * sizeof(long));
+    long *length = malloc((n ? n : 1) * sizeof(long));
+    double *inc = malloc((n ? n : 1) * sizeof(double));
+    float *gain = malloc((n ? n : 1) * sizeof(float));
+    if (!onsets || !copy || !start || !length || !inc || !gain) {
+        free(onsets);
+        free(copy);
+        free(start);
+        free(length);
+        free(inc);
+        free(gain);
+        return 1;
+    }
+    memcpy(copy, table, table_len * sizeof(float));
+
+    for (int i = 0; i < n; i++)
+        onsets[i] = (RenderOnset){lround(notes[i].onset * sample_rate), i};
+    qsort(onsets, n, sizeof(RenderOnset), render_onset_compare);
+
+    long longest = 0;
+    for (int i = 0; i < n; i++) {
+        const NoteEvent *e = notes + onsets[i].order;
+        long samples = lround(e->duration * sample_rate);
+        start[i] = onsets[i].start;
+        length[i] = samples > 0 ? samples : 0;
+        inc[i] = to_hz(e->pitch, T) * table_len / sample_rate;
+        gain[i] = e->velocity;
+        longest = length[i] > longest ? length[i] : longest;
+    }
+    free(onsets);
+
+    *out = (NoteRenderer){.sample_rate = sample_rate,
+                          .table_len = table_len,
+                          .table = copy,
+                          .len = n,
+                          .start = start,
+                          .length = length,
+                          .inc = inc,
+                          .gain = gain,
+                          .longest = longest};
+    return 0;
+}
+
+void note_renderer_destroy(NoteRenderer *r) {
+    free(r->table);
+    free(r->start);
+    free(r->length);
+    free(r->inc);
+    free(r->gain);
+}
+
+long note_renderer_frames(const NoteRenderer *r) {
+    long end = 0;
+    for (int i = 0; i < r->len; i++)
+        if (r->start[i] + r->length[i] > end)
+            end = r->start[i] + r->length[i];
+    return end;
+}
+
+// Adds samples [from, to) of note i, all within the note, to out, where out[0]
+// is sample origin.
+static void render_note(const NoteRenderer *r, int i, long from, long to,
+                        long origin, float out[]) {
+    int mask = r->table_len - 1;
+    const float *table = r->table;
+    double inc = r->inc[i];
+    float fade = 0.005f * r->sample_rate;
+    float length = r->length[i];
+
+    for (long b = from; b < to;) {
+        long t0 = b - r->start[i];
+        int skip = t0 % RENDER_BLOCK;
+        int n = to - b < RENDER_BLOCK - skip ? to - b : RENDER_BLOCK - skip;
+        double phase = fmod(inc * (t0 - skip), r->table_len);
+        float *o = out + (b - origin);
+        for (int k = 0; k < n; k++) {
+            double ph = phase + (skip + k) * inc;
+            long idx = (long)ph;
+            float frac = ph - idx;
+            float x0 = table[idx & mask], x1 = table[(idx + 1) & mask];
+            float t = t0 + k;
+            float env = fminf(1, fminf(t, length - t) / fade);
+            o[k] += r->gain[i] * env * (x0 + frac * (x1 - x0));
+        }
+        b += n;
+    }
+}
+
+// Notes are sorted by onset, so the notes sounding in a range are found by
+// binary search, starting from the latest onset that could still reach it.
+static void render_range(const NoteRenderer *r, long start, long frames,
+                         float out[]) {
+    long end = start + frames;
+    for (long i = 0; i < frames; i++)
+        out[i] = 0;
+
+    int lo = 0, hi = r->len;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (r->start[mid] + r->longest <= start)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    for (int i = lo; i < r->len && r->start[i] < end; i++) {
+        long from = r->start[i] > start ? r->start[i] : start;
+        long to = r->start[i] + r->length[i];
+        to = to < end ? to : end;
+        if (from < to)
+            render_note(r, i, from, to, start, out);
+    }
+}
+
+typedef struct {
+    const NoteRenderer *r;
+    long start;
+    float *out;
+} RenderSlices;
+
+static void render_slice(void *ctx, int chunk, long start, long end) {
+    (void)chunk;
+    RenderSlices *s = ctx;
+    render_range(s->r, s->start + start, end - start, s->out + start);
+}
+
+void note_renderer_render(const NoteRenderer *r, long start, long frames,
+                          float out[]) {
+    RenderSlices s = {r, start, out};
+    parallel_for(frames > 0 ? frames : 0, RENDER_SLICE, render_slice, &s);
+}
+
+int note_renderer_write_wav(const NoteRenderer *r, const char *path) {
+    WavWriter w;
+    if (wav_writer_open(path, 1, r->sample_rate, &w))
+        return 1;
+
+    float *block = malloc(RENDER_WAV_BLOCK * sizeof(float));
+    if (!block) {
+        wav_writer_close(&w);
+        return 1;
+    }
+    long frames = note_renderer_frames(r);
+    int err = 0;
+    for (long i = 0; i < frames && !err; i += RENDER_WAV_BLOCK) {
+        long n = frames - i < RENDER_WAV_BLOCK ? frames - i : RENDER_WAV_BLOCK;
+        note_renderer_render(r, i, n, block);
+        err = wav_writer_write(&w, block, n);
+    }
+    free(block);
+    return wav_writer_close(&w) || err;
+}
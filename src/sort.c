@@ -0,0 +1,143 @@
+#include "../include/sort.h"
+#include "../include/types.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Each Pitch gets a 64-bit key: its EDO number in the high half and its
+// diatonic steps in the low half, both with the sign bit flipped so that
+// unsigned order matches signed order. Sorting the keys a byte at a time from
+// the lowest byte up, stably, sorts by both at once.
+
+static uint64_t radix_key(int w, int h, EDOMap T) {
+    uint32_t number = (uint32_t)(T.m0 * w + T.m1 * h) ^ 0x80000000u;
+    uint32_t steps = (uint32_t)(w + h) ^ 0x80000000u;
+    return (uint64_t)number << 32 | steps;
+}
+
+// Bits needed to write x in binary.
+static int bit_width(uint32_t x) {
+    int bits = 0;
+    for (; x; x >>= 1)
+        bits++;
+    return bits;
+}
+
+// Ranks the len keys at the start of keys, which must have room for 2 * len,
+// writing the index of each key in sorted order to out.
+static int radix_rank(uint64_t keys[], int len, int out[]) {
+    int *order = malloc(2 * (size_t)len * sizeof(int));
+    if (!order)
+        return 1;
+
+    // Measured from their smallest values, the numbers and steps of real
+    // music only take a few bits each, so packing them together leaves a much
+    // shorter key.
+    uint32_t number_lo = UINT32_MAX, steps_lo = UINT32_MAX;
+    uint32_t number_hi = 0, steps_hi = 0;
+    for (int i = 0; i < len; i++) {
+        uint32_t number = (uint32_t)(keys[i] >> 32), steps = (uint32_t)keys[i];
+        number_lo = number < number_lo ? number : number_lo;
+        number_hi = number > number_hi ? number : number_hi;
+        steps_lo = steps < steps_lo ? steps : steps_lo;
+        steps_hi = steps > steps_hi ? steps : steps_hi;
+    }
+    int steps_bits = bit_width(steps_hi - steps_lo);
+    int bytes = (bit_width(number_hi - number_lo) + steps_bits + 7) / 8;
+
+    // one pass over the keys counts every byte at once
+    int counts[8][256];
+    memset(counts, 0, sizeof(counts));
+    for (int i = 0; i < len; i++) {
+        uint64_t number = (uint32_t)(keys[i] >> 32) - number_lo;
+        keys[i] = number << steps_bits | ((uint32_t)keys[i] - steps_lo);
+        order[i] = i;
+        for (int b = 0; b < bytes; b++)
+            counts[b][keys[i] >> (8 * b) & 0xff]++;
+    }
+
+    uint64_t *src_keys = keys, *dst_keys = keys + len;
+    int *src_order = order, *dst_order = order + len;
+    for (int b = 0; b < bytes; b++) {
+        // a byte every key shares can't change the order
+        if (counts[b][src_keys[0] >> (8 * b) & 0xff] == len)
+            continue;
+        int start[256], total = 0;
+        for (int d = 0; d < 256; d++) {
+            start[d] = total;
+            total += counts[b][d];
+        }
+        for (int i = 0; i < len; i++) {
+            int j = start[src_keys[i] >> (8 * b) & 0xff]++;
+            dst_keys[j] = src_keys[i];
+            dst_order[j] = src_order[i];
+        }
+        uint64_t *k = src_keys;
+        src_keys = dst_keys;
+        dst_keys = k;
+        int *o = src_order;
+        src_order = dst_order;
+        dst_order = o;
+    }
+    memcpy(out, src_order, len * sizeof(int));
+    free(order);
+    return 0;
+}
+
+int pitch_radix_argsort(const Pitch arr[], int len, EDOMap T, int out[]) {
+    if (len <= 0)
+        return 0;
+    uint64_t *keys = malloc(2 * (size_t)len * sizeof(uint64_t));
+    if (!keys)
+        return 1;
+    for (int i = 0; i < len; i++)
+        keys[i] = radix_key(arr[i].w, arr[i].h, T);
+    int failed = radix_rank(keys, len, out);
+    free(keys);
+    return failed;
+}
+
+int pitch_radix_sort(Pitch arr[], int len, EDOMap T) {
+    if (len <= 1)
+        return 0;
+    int *order = malloc(len * sizeof(int));
+    Pitch *copy = malloc(len * sizeof(Pitch));
+    if (!order || !copy || pitch_radix_argsort(arr, len, T, order)) {
+        free(order);
+        free(copy);
+        return 1;
+    }
+    memcpy(copy, arr, len * sizeof(Pitch));
+    for (int i = 0; i < len; i++)
+        arr[i] = copy[order[i]];
+    free(order);
+    free(copy);
+    return 0;
+}
+
+int pitch_buffer_radix_sort(PitchBuffer *b, EDOMap T) {
+    int len = b->len;
+    if (len <= 1)
+        return 0;
+    uint64_t *keys = malloc(2 * (size_t)len * sizeof(uint64_t));
+    int *order = malloc(len * sizeof(int));
+    int *copy = malloc(2 * (size_t)len * sizeof(int));
+    int failed = !keys || !order || !copy;
+    if (!failed) {
+        for (int i = 0; i < len; i++)
+            keys[i] = radix_key(b->w[i], b->h[i], T);
+        failed = radix_rank(keys, len, order);
+    }
+    if (!failed) {
+        memcpy(copy, b->w, len * sizeof(int));
+        memcpy(copy + len, b->h, len * sizeof(int));
+        for (int i = 0; i < len; i++) {
+            b->w[i] = copy[order[i]];
+            b->h[i] = copy[len + order[i]];
+        }
+    }
+    free(keys);
+    free(order);
+    free(copy);
+    return failed;
+}
@@ -46,8 +46,8 @@ TonalContext context_from_chroma(int chroma, enum Mode mode) {
 
     out.mode = mode;
     out.chroma_offset = mode - chroma;
-    out.tonic.letter = (chroma * 4 % 7 + 9) % 7;
-    out.tonic.accidental = ++chroma < 0 ? chroma / 7 - 1 : chroma / 7;
+    out.tonic.letter = floor_mod7(chroma * 4 + 2);
+    out.tonic.accidental = floor_div7(chroma + 1);
 
     return out;
 }
@@ -76,17 +76,11 @@ enum Alteration degree_alteration(Pitch p, TonalContext key) {
     return FOREIGN_DEG_SHARP;
 }
 
+// Each chromatic step (-1, 1) moves the chroma down 7 fifths, so the number of
+// steps to take is how many 7s the chroma is above the diatonic window.
 Pitch snap_diatonic(Pitch p, TonalContext key) {
-    while (degree_alteration(p, key) > DIATONIC_DEG) {
-        p.w--;
-        p.h++;
-    }
-    while (degree_alteration(p, key) < DIATONIC_DEG) {
-        p.w++;
-        p.h--;
-    }
-
-    return p;
+    int steps = floor_div7(pitch_chroma(p) + key.chroma_offset);
+    return (Pitch){.w = p.w - steps, .h = p.h + steps};
 }
 
 Pitch transpose_diatonic(Pitch p, int interval, TonalContext key) {
@@ -0,0 +1,140 @@
+#include "../include/fft.h"
+#include "../include/map.h"
+#include "../include/track.h"
+#include "../include/types.h"
+#include <stdlib.h>
+
+int pitch_tracker_create(int sample_rate, int window, int hop,
+                         double threshold, PitchTracker *out) {
+    if (sample_rate <= 0 || hop <= 0 || window < 8 || (window & (window - 1)))
+        return 1;
+
+    FFTPlan fft;
+    if (fft_plan_create(window, &fft))
+        return 1;
+    double *re = malloc(window * sizeof(double));
+    double *im = malloc(window * sizeof(double));
+    double *energy = malloc((window + 1) * sizeof(double));
+    double *diff = malloc(window / 2 * sizeof(double));
+    if (!re || !im || !energy || !diff) {
+        free(re);
+        free(im);
+        free(energy);
+        free(diff);
+        fft_plan_destroy(&fft);
+        return 1;
+    }
+
+    *out = (PitchTracker){.sample_rate = sample_rate,
+                          .window = window,
+                          .hop = hop,
+                          .threshold = threshold,
+                          .fft = fft,
+                          .re = re,
+                          .im = im,
+                          .energy = energy,
+                          .diff = diff};
+    return 0;
+}
+
+void pitch_tracker_destroy(PitchTracker *t) {
+    fft_plan_destroy(&t->fft);
+    free(t->re);
+    free(t->im);
+    free(t->energy);
+    free(t->diff);
+}
+
+// d(tau) before normalisation, from the energies and correlation that
+// pitch_tracker_difference leaves behind.
+static double pitch_tracker_raw(const PitchTracker *t, int tau) {
+    int L = t->window / 2;
+    const double *E = t->energy;
+    double d = E[L] + (E[tau + L] - E[tau]) - 2 * t->re[tau];
+    return d > 0 ? d : 0;
+}
+
+// The YIN difference function compares the first half of the frame, x[0..L),
+// with the frame delayed by each lag tau < L:
+//     d(tau) = sum (x[j] - x[j + tau])^2
+//            = E(0) + E(tau) - 2 * sum x[j] x[j + tau]
+// where E(tau) is the energy of x[tau..tau + L), read off running sums. The
+// cross term is a correlation, done with one complex FFT of length window by
+// packing the frame and its first half as the real and imaginary parts.
+// j + tau never reaches window, so the circular correlation doesn't wrap.
+static void pitch_tracker_difference(PitchTracker *t, const float x[]) {
+    int n = t->window, L = n / 2;
+    double *re = t->re, *im = t->im, *E = t->energy;
+
+    E[0] = 0;
+    for (int j = 0; j < n; j++) {
+        re[j] = x[j];
+        im[j] = j < L ? x[j] : 0;
+        E[j + 1] = E[j] + (double)x[j] * x[j];
+    }
+    fft_forward(&t->fft, re, im);
+
+    // Unpack both spectra: X = (Z[k] + conj Z[n-k]) / 2 is the frame's and
+    // Y = (Z[k] - conj Z[n-k]) / 2i its first half's. conj(Y) * X is the
+    // spectrum of the correlation, and it's Hermitian, so only k <= n / 2 is
+    // worked out.
+    for (int k = 0; k <= n / 2; k++) {
+        int m = (n - k) & (n - 1);
+        double xr = (re[k] + re[m]) / 2, xi = (im[k] - im[m]) / 2;
+        double yr = (im[k] + im[m]) / 2, yi = (re[m] - re[k]) / 2;
+        double cr = xr * yr + xi * yi, ci = xi * yr - xr * yi;
+        re[k] = cr;
+        im[k] = ci;
+        re[m] = cr;
+        im[m] = -ci;
+    }
+    fft_inverse(&t->fft, re, im);
+
+    // Cumulative mean normalisation, so the threshold doesn't depend on level
+    // and lag 0 can't win.
+    double sum = 0;
+    t->diff[0] = 1;
+    for (int tau = 1; tau < L; tau++) {
+        double d = pitch_tracker_raw(t, tau);
+        sum += d;
+        t->diff[tau] = sum > 0 ? d * tau / sum : 1;
+    }
+}
+
+double pitch_tracker_frame(PitchTracker *t, const float frame[]) {
+    pitch_tracker_difference(t, frame);
+    int L = t->window / 2;
+    const double *d = t->diff;
+
+    // The first dip below the threshold, followed down to its minimum.
+    int tau = 2;
+    while (tau < L - 1 && d[tau] >= t->threshold)
+        tau++;
+    if (tau >= L - 1)
+        return 0;
+    while (tau + 1 < L - 1 && d[tau + 1] < d[tau])
+        tau++;
+
+    // Parabolic interpolation between neighbouring lags, on the raw
+    // difference function, which normalisation would skew.
+    double a = pitch_tracker_raw(t, tau - 1), b = pitch_tracker_raw(t, tau),
+           c = pitch_tracker_raw(t, tau + 1);
+    double curve = a - 2 * b + c;
+    double shift = curve > 0 ? (a - c) / (2 * curve) : 0;
+    return t->sample_rate / (tau + shift);
+}
+
+long pitch_tracker_frames(const PitchTracker *t, long len) {
+    return len < t->window ? 0 : (len - t->window) / t->hop + 1;
+}
+
+long pitch_tracker_run(PitchTracker *t, const float samples[], long len,
+                       double hz[], const TuningMap *T,
+                       const TonalContext *key, Pitch out[]) {
+    long frames = pitch_tracker_frames(t, len);
+    for (long i = 0; i < frames; i++)
+        hz[i] = pitch_tracker_frame(t, samples + i * t->hop);
+    if (T)
+        pitches_from_hz(hz, frames, *T, key, out, NULL);
+    return frames;
+}
@@ -0,0 +1,194 @@
+#include "../include/types.h"
+#include "../include/wav.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// WAV fields are little-endian whatever the host is, so they're written a
+// byte at a time.
+static void wav_put16(unsigned char *buf, uint16_t x) {
+    buf[0] = x & 0xff;
+    buf[1] = x >> 8;
+}
+
+static void wav_put32(unsigned char *buf, uint32_t x) {
+    wav_put16(buf, x & 0xffff);
+    wav_put16(buf + 2, x >> 16);
+}
+
+static int wav_write_header(WavWriter *w) {
+    uint32_t data_bytes = (uint32_t)(w->frames * w->channels * 2);
+    unsigned char h[44] = "RIFF\0\0\0\0WAVEfmt ";
+    wav_put32(h + 4, 36 + data_bytes);
+    wav_put32(h + 16, 16);
+    wav_put16(h + 20, 1); // PCM
+    wav_put16(h + 22, w->channels);
+    wav_put32(h + 24, w->sample_rate);
+    wav_put32(h + 28, w->sample_rate * w->channels * 2);
+    wav_put16(h + 32, w->channels * 2);
+    wav_put16(h + 34, 16);
+    h[36] = 'd', h[37] = 'a', h[38] = 't', h[39] = 'a';
+    wav_put32(h + 40, data_bytes);
+    return fseek(w->file, 0, SEEK_SET) != 0 ||
+           fwrite(h, 1, sizeof(h), w->file) != sizeof(h);
+}
+
+int wav_writer_open(const char *path, int channels, int sample_rate,
+                    WavWriter *out) {
+    if (channels <= 0 || sample_rate <= 0)
+        return 1;
+    FILE *file = fopen(path, "wb");
+    if (!file)
+        return 1;
+    *out = (WavWriter){.file = file,
+                       .channels = channels,
+                       .sample_rate = sample_rate,
+                       .frames = 0};
+    if (wav_write_header(out)) {
+        fclose(file);
+        return 1;
+    }
+    return 0;
+}
+
+int wav_writer_write(WavWriter *w, const float samples[], long frames) {
+    unsigned char buf[4096];
+    long len = frames * w->channels;
+    for (long i = 0; i < len;) {
+        int n = 0;
+        for (; n < (int)sizeof(buf) && i < len; n += 2, i++) {
+            float x = samples[i];
+            // NaN fails every comparison, so it's silenced before clipping
+            x = x != x ? 0 : x > 1 ? 1 : x < -1 ? -1 : x;
+            wav_put16(buf + n, (uint16_t)(int16_t)(x * 32767));
+        }
+        if (fwrite(buf, 1, n, w->file) != (size_t)n)
+            return 1;
+    }
+    w->frames += frames;
+    return 0;
+}
+
+int wav_writer_close(WavWriter *w) {
+    int err = wav_write_header(w);
+    return fclose(w->file) != 0 || err;
+}
+
+static uint32_t wav_get16(const unsigned char *buf) {
+    return buf[0] | buf[1] << 8;
+}
+
+static uint32_t wav_get32(const unsigned char *buf) {
+    return wav_get16(buf) | wav_get16(buf + 2) << 16;
+}
+
+// Decodes one little-endian sample to the range -1 to 1.
+static double wav_sample(const unsigned char *b, int format, int bits) {
+    if (format == 3) {
+        union {
+            uint32_t i;
+            float f;
+        } x32 = {wav_get32(b)};
+        if (bits == 32)
+            return x32.f;
+        union {
+            uint64_t i;
+            double f;
+        } x64 = {x32.i | (uint64_t)wav_get32(b + 4) << 32};
+        return x64.f;
+    }
+    switch (bits) {
+    case 8:
+        return (b[0] - 128) / 128.0;
+    case 16:
+        return (int16_t)wav_get16(b) / 32768.0;
+    case 24:
+        return (int32_t)(wav_get32((unsigned char[4]){0, b[0], b[1], b[2]})) /
+               2147483648.0;
+    default:
+        return (int32_t)wav_get32(b) / 2147483648.0;
+    }
+}
+
+int wav_read(const char *path, AudioBuffer *out) {
+    FILE *file = fopen(path, "rb");
+    if (!file)
+        return 1;
+
+    unsigned char h[12], chunk[8], fmt[40];
+    int format = 0, channels = 0, sample_rate = 0, bits = 0;
+    unsigned char *data = NULL;
+    uint32_t data_bytes = 0;
+    if (fread(h, 1, 12, file) != 12 || memcmp(h, "RIFF", 4) ||
+        memcmp(h + 8, "WAVE", 4)) {
+        fclose(file);
+        return 1;
+    }
+
+    // Chunks can come in any order, and unknown ones are skipped. Chunk sizes
+    // are padded to an even number of bytes. The data chunk is only located
+    // here, and read once the fmt chunk has been seen, wherever that is.
+    long data_at = -1;
+    bool have_fmt = false;
+    while (!(have_fmt && data_at >= 0) && fread(chunk, 1, 8, file) == 8) {
+        uint32_t size = wav_get32(chunk + 4);
+        long next = ftell(file) + size + (size & 1);
+        if (!memcmp(chunk, "fmt ", 4) && size >= 16 && !have_fmt) {
+            uint32_t n = size < sizeof(fmt) ? size : sizeof(fmt);
+            if (fread(fmt, 1, n, file) != n)
+                break;
+            format = wav_get16(fmt);
+            channels = wav_get16(fmt + 2);
+            sample_rate = wav_get32(fmt + 4);
+            bits = wav_get16(fmt + 14);
+            if (format == 0xfffe && n >= 26) // WAVE_FORMAT_EXTENSIBLE
+                format = wav_get16(fmt + 24);
+            have_fmt = true;
+        } else if (!memcmp(chunk, "data", 4) && data_at < 0) {
+            data_at = ftell(file);
+            data_bytes = size;
+        }
+        if (fseek(file, next, SEEK_SET))
+            break;
+    }
+    if (have_fmt && channels && data_at >= 0 &&
+        !fseek(file, data_at, SEEK_SET)) {
+        data = malloc(data_bytes ? data_bytes : 1);
+        if (data && fread(data, 1, data_bytes, file) != data_bytes) {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+
+    bool supported = (format == 1 && (bits == 8 || bits == 16 || bits == 24 ||
+                                      bits == 32)) ||
+                     (format == 3 && (bits == 32 || bits == 64));
+    if (!data || !supported || sample_rate <= 0) {
+        free(data);
+        return 1;
+    }
+
+    int frame_bytes = channels * bits / 8;
+    long frames = data_bytes / frame_bytes;
+    float *samples = malloc((frames ? frames : 1) * sizeof(float));
+    if (!samples) {
+        free(data);
+        return 1;
+    }
+    for (long i = 0; i < frames; i++) {
+        double x = 0;
+        for (int c = 0; c < channels; c++)
+            x += wav_sample(data + i * frame_bytes + c * bits / 8, format,
+                            bits);
+        samples[i] = x / channels;
+    }
+    free(data);
+
+    *out = (AudioBuffer){
+        .samples = samples, .frames = frames, .sample_rate = sample_rate};
+    return 0;
+}
+
+void audio_buffer_destroy(AudioBuffer *a) { free(a->samples); }
@@ -0,0 +1,62 @@
+#include "../include/width.h"
+#include "../include/types.h"
+#include <limits.h>
+
+// Converting between widths checks each step against the narrower type's
+// range, compared as long long so no comparison is out of range for its type.
+#define MEANTONAL_WIDTH_DEFINE(P, T, W, pre, MIN, MAX)                         \
+    int pre##_pitches_from_pitches(const Pitch arr[], int len, P out[]) {      \
+        int skipped = 0;                                                       \
+        for (int i = 0; i < len; i++) {                                        \
+            long long w = arr[i].w, h = arr[i].h;                              \
+            if (w < MIN || w > MAX || h < MIN || h > MAX)                      \
+                skipped++;                                                     \
+            else                                                               \
+                out[i] = (P){.w = (T)w, .h = (T)h};                            \
+        }                                                                      \
+        return skipped;                                                        \
+    }                                                                          \
+    int pre##_pitches_to_pitches(const P arr[], int len, Pitch out[]) {        \
+        int skipped = 0;                                                       \
+        for (int i = 0; i < len; i++) {                                        \
+            long long w = arr[i].w, h = arr[i].h;                              \
+            if (w < INT_MIN || w > INT_MAX || h < INT_MIN || h > INT_MAX)      \
+                skipped++;                                                     \
+            else                                                               \
+                out[i] = (Pitch){.w = (int)w, .h = (int)h};                    \
+        }                                                                      \
+        return skipped;                                                        \
+    }                                                                          \
+    void pre##_pitches_transpose(P arr[], int len, P m) {                      \
+        for (int i = 0; i < len; i++)                                          \
+            arr[i] = pre##_transpose_real(arr[i], m);                          \
+    }                                                                          \
+    void pre##_pitches_intervals(const P p[], const P q[], int len, P out[]) { \
+        for (int i = 0; i < len; i++)                                          \
+            out[i] = pre##_interval_between(p[i], q[i]);                       \
+    }                                                                          \
+    void pre##_pitches_chromas(const P arr[], int len, W out[]) {              \
+        for (int i = 0; i < len; i++)                                          \
+            out[i] = pre##_pitch_chroma(arr[i]);                               \
+    }                                                                          \
+    void pre##_pitches_letters(const P arr[], int len, int out[]) {            \
+        for (int i = 0; i < len; i++)                                          \
+            out[i] = pre##_pitch_letter(arr[i]);                               \
+    }                                                                          \
+    void pre##_pitches_accidentals(const P arr[], int len, W out[]) {          \
+        for (int i = 0; i < len; i++)                                          \
+            out[i] = pre##_pitch_accidental(arr[i]);                           \
+    }                                                                          \
+    void pre##_pitches_octaves(const P arr[], int len, W out[]) {              \
+        for (int i = 0; i < len; i++)                                          \
+            out[i] = pre##_pitch_octave(arr[i]);                               \
+    }                                                                          \
+    void pre##_pitches_heights(const P arr[], int len, HeightMap H,            \
+                               long long out[]) {                              \
+        for (int i = 0; i < len; i++)                                          \
+            out[i] = pre##_pitch_height(arr[i], H);                            \
+    }
+
+MEANTONAL_WIDTH_DEFINE(PitchI16, int16_t, int, i16, INT16_MIN, INT16_MAX)
+MEANTONAL_WIDTH_DEFINE(PitchI32, int32_t, long long, i32, INT32_MIN, INT32_MAX)
+MEANTONAL_WIDTH_DEFINE(PitchI64, int64_t, long long, i64, LLONG_MIN, LLONG_MAX)
@@ -0,0 +1,51 @@
+#include "../include/interval.h"
+#include "../include/map.h"
+#include "../include/pitch.h"
+#include "../include/types.h"
+#include "../include/zone.h"
+#include <limits.h>
+#include <stdlib.h>
+
+int zone_map_create(const Pitch roots[], int len, TuningMap T, Pitch lo,
+                    Pitch hi, ZoneMap *out) {
+    long long width = (long long)hi.w - lo.w + 1;
+    long long height = (long long)hi.h - lo.h + 1;
+    // zone_map_lookup indexes the table with a long
+    if (len <= 0 || width <= 0 || height <= 0 || width > INT_MAX ||
+        height > INT_MAX || width * height > LONG_MAX / (long)sizeof(double))
+        return 1;
+
+    NearestIndex ix;
+    if (nearest_index_create(roots, len, T, &ix))
+        return 1;
+    int *root = malloc(width * height * sizeof(int));
+    double *ratio = malloc(width * height * sizeof(double));
+    if (!root || !ratio) {
+        free(root);
+        free(ratio);
+        nearest_index_destroy(&ix);
+        return 1;
+    }
+
+    for (int w = 0; w < width; w++) {
+        for (int h = 0; h < height; h++) {
+            Pitch p = {lo.w + w, lo.h + h};
+            long i = (long)w * height + h;
+            root[i] = nearest_index_query(&ix, p);
+            ratio[i] = to_ratio(interval_between(roots[root[i]], p), T);
+        }
+    }
+    nearest_index_destroy(&ix);
+
+    *out = (ZoneMap){.lo = lo,
+                     .width = width,
+                     .height = height,
+                     .root = root,
+                     .ratio = ratio};
+    return 0;
+}
+
+void zone_map_destroy(ZoneMap *z) {
+    free(z->root);
+    free(z->ratio);
+}
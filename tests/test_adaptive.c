@@ -0,0 +1,96 @@
+#include "../include/adaptive.h"
+#include "../include/constants.h"
+#include "../include/map.h"
+#include "../include/parse.h"
+#include "test_framework.h"
+#include <math.h>
+
+static void chord_from_spn(char *names[], int len, Pitch out[]) {
+    for (int i = 0; i < len; i++)
+        pitch_from_spn(names[i], out + i);
+}
+
+static AdaptiveTuner tuner_12tet(double max_drift) {
+    Pitch c4;
+    pitch_from_spn("C4", &c4);
+    TuningMap T;
+    tuning_map_from_edo(12, c4, CONCERT_C4, &T);
+    AdaptiveTuner t;
+    adaptive_tuner_create(T, max_drift, &t);
+    return t;
+}
+
+void test_adaptive_tuner_create(void) {
+    Pitch c4;
+    pitch_from_spn("C4", &c4);
+    TuningMap T;
+    tuning_map_from_edo(12, c4, CONCERT_C4, &T);
+    AdaptiveTuner t;
+    ASSERT_EQ(adaptive_tuner_create(T, 0, &t), 0);
+    ASSERT_EQ(adaptive_tuner_create(T, -1, &t), 1);
+    ASSERT_EQ(adaptive_tuner_create(T, INFINITY, &t), 1);
+    ASSERT_EQ(adaptive_tuner_create(T, NAN, &t), 1);
+}
+
+void test_adaptive_tuner_update(void) {
+    AdaptiveTuner t = tuner_12tet(0);
+    char *names[3] = {"C4", "E4", "G4"};
+    Pitch chord[3];
+    chord_from_spn(names, 3, chord);
+    double out[3];
+
+    ASSERT_EQ(adaptive_tuner_update(&t, chord, 3, out), 0);
+    // Pure 5/4 and 3/2 above C, with the chord centred on the base tuning.
+    ASSERT_EQ(round((out[1] - out[0]) * 100),
+              round((1200 * log2(5.0 / 4) - 400) * 100));
+    ASSERT_EQ(round((out[2] - out[0]) * 100),
+              round((1200 * log2(3.0 / 2) - 700) * 100));
+    ASSERT_EQ(round((out[0] + out[1] + out[2]) * 100), 0);
+
+    // A lone note stays put, and bad lengths are rejected.
+    ASSERT_EQ(adaptive_tuner_update(&t, chord, 1, out), 0);
+    ASSERT_EQ(round(out[0] * 100), 0);
+    ASSERT_EQ(adaptive_tuner_update(&t, chord, ADAPTIVE_MAX_VOICES + 1, out),
+              1);
+    ASSERT_EQ(adaptive_tuner_update(&t, chord, -1, out), 1);
+}
+
+void test_adaptive_tuner_drift(void) {
+    // I-vi-ii-V-I with held common tones drops by a syntonic comma (21.5¢)
+    // each time round if nothing stops it.
+    char *progression[5][3] = {{"C4", "E4", "G4"},
+                               {"C4", "E4", "A4"},
+                               {"D4", "F4", "A4"},
+                               {"D4", "G4", "B4"},
+                               {"C4", "E4", "G4"}};
+    double out[3];
+    Pitch chord[3];
+
+    AdaptiveTuner pumped = tuner_12tet(100);
+    for (int i = 0; i < 5; i++) {
+        chord_from_spn(progression[i], 3, chord);
+        adaptive_tuner_update(&pumped, chord, 3, out);
+    }
+    ASSERT_EQ(round(pumped.drift), round(-1200 * log2(81.0 / 80)));
+
+    AdaptiveTuner bounded = tuner_12tet(5);
+    for (int i = 0; i < 5; i++) {
+        chord_from_spn(progression[i], 3, chord);
+        adaptive_tuner_update(&bounded, chord, 3, out);
+        ASSERT_EQ(fabs(bounded.drift) <= 5, true);
+        ASSERT_EQ(fabs((out[0] + out[1] + out[2]) / 3 - bounded.drift) < 1e-9,
+                  true);
+    }
+    ASSERT_EQ(round(bounded.drift), -5);
+
+    adaptive_tuner_reset(&bounded);
+    chord_from_spn(progression[0], 3, chord);
+    adaptive_tuner_update(&bounded, chord, 3, out);
+    ASSERT_EQ(round((out[0] + out[1] + out[2]) * 100), 0);
+}
+
+void test_adaptive_functions(void) {
+    RUN_TESTS(test_adaptive_tuner_create);
+    RUN_TESTS(test_adaptive_tuner_update);
+    RUN_TESTS(test_adaptive_tuner_drift);
+}
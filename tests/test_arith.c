@@ -0,0 +1,212 @@
+#include "../include/arith.h"
+#include "../include/buffer.h"
+#include "../include/interval.h"
+#include "../include/pitch.h"
+#include "../include/tonality.h"
+#include "test_framework.h"
+#include <limits.h>
+
+// The classifiers as they were originally defined with signed division, to
+// check the division-free versions against.
+
+static int ref_letter(Pitch p) { return ((p.w + p.h + 2) % 7 + 7) % 7; }
+
+static int base_accidental(Pitch p) {
+    int chroma = pitch_chroma(p) + 1;
+    return chroma < 0 ? chroma / 7 - 1 : chroma / 7;
+}
+
+static int base_octave(Pitch p) {
+    return p.w + p.h < 0 ? (p.w + p.h) / 7 - 2 : (p.w + p.h) / 7 - 1;
+}
+
+// Those two were off by one at negative multiples of 7: Fb4 came out as a
+// double flat and C-2 in octave -3. pitch_accidental and pitch_octave floor
+// instead (since the PitchBuffer kernels), which is the original result plus
+// one there and the same everywhere else.
+
+static bool negative_multiple_of_7(int x) { return x < 0 && x % 7 == 0; }
+
+static int ref_accidental(Pitch p) {
+    return base_accidental(p) + negative_multiple_of_7(pitch_chroma(p) + 1);
+}
+
+static int ref_octave(Pitch p) {
+    return base_octave(p) + negative_multiple_of_7(p.w + p.h);
+}
+
+static int ref_pc12(Pitch p) { return (2 * p.w + p.h) % 12; }
+
+static int ref_degree(Pitch p, TonalContext key) {
+    return ((p.w + p.h - key.tonic.letter + 2) % 7 + 7) % 7;
+}
+
+static bool ref_enharmonic(Pitch m, Pitch n, int edo) {
+    return (pitch_chroma(m) % edo + edo) % edo ==
+           (pitch_chroma(n) % edo + edo) % edo;
+}
+
+static int ref_floor_div(long long x, int d) {
+    return (int)(x < 0 ? (x - d + 1) / d : x / d);
+}
+
+// Every Pitch with whole and half steps from -SPAN to SPAN.
+enum { SPAN = 1024, SIDE = 2 * SPAN + 1 };
+
+void test_floor_div(void) {
+    int same = 1;
+    for (int x = -(1 << 20); x <= 1 << 20; x++) {
+        same &= floor_div7(x) == ref_floor_div(x, 7);
+        same &= floor_mod7(x) == x - 7 * ref_floor_div(x, 7);
+        same &= floor_div12(x) == ref_floor_div(x, 12);
+        same &= trunc_mod12(x) == x % 12;
+    }
+    ASSERT_EQ(same, 1);
+
+    // every int, sampled, out to both ends
+    same = 1;
+    for (long long x = INT_MIN; x <= INT_MAX; x += 9973) {
+        same &= floor_div7((int)x) == ref_floor_div(x, 7);
+        same &= floor_mod7((int)x) == x - 7LL * ref_floor_div(x, 7);
+        same &= floor_div12((int)x) == ref_floor_div(x, 12);
+        same &= floor_mod12((int)x) == x - 12LL * ref_floor_div(x, 12);
+        same &= trunc_mod12((int)x) == x % 12;
+    }
+    int ends[] = {INT_MIN, INT_MIN + 1, INT_MAX - 1, INT_MAX};
+    for (int i = 0; i < 4; i++) {
+        same &= floor_div7(ends[i]) == ref_floor_div(ends[i], 7);
+        same &= floor_mod7(ends[i]) ==
+                ends[i] - 7LL * ref_floor_div(ends[i], 7);
+        same &= floor_div12(ends[i]) == ref_floor_div(ends[i], 12);
+        same &= floor_mod12(ends[i]) ==
+                ends[i] - 12LL * ref_floor_div(ends[i], 12);
+        same &= trunc_mod12(ends[i]) == ends[i] % 12;
+    }
+    ASSERT_EQ(same, 1);
+
+    // Pitches far from 0 still classify like the old definitions.
+    ASSERT_EQ(pitch_accidental((Pitch){0, 200000000}), -142857143);
+    ASSERT_EQ(pitch_pc12((Pitch){-300000000, 0}), 0);
+    ASSERT_EQ(pitch_octave((Pitch){1000000000, 1000000000}), 285714284);
+}
+
+void test_pitch_classifiers_exhaustive(void) {
+    int same = 1;
+    for (int w = -SPAN; w <= SPAN; w++) {
+        for (int h = -SPAN; h <= SPAN; h++) {
+            Pitch p = {w, h};
+            same &= pitch_letter(p) == ref_letter(p);
+            same &= pitch_accidental(p) == ref_accidental(p);
+            same &= pitch_octave(p) == ref_octave(p);
+            same &= pitch_pc12(p) == ref_pc12(p);
+            same &= interval_pc12(p) == ref_pc12(p);
+        }
+    }
+    ASSERT_EQ(same, 1);
+}
+
+void test_degree_number_exhaustive(void) {
+    int same = 1;
+    for (int chroma = -15; chroma <= 15; chroma++) {
+        TonalContext key = context_from_chroma(chroma, MAJOR);
+        for (int w = -SPAN; w <= SPAN; w += 3)
+            for (int h = -SPAN; h <= SPAN; h++)
+                same &= (int)degree_number((Pitch){w, h}, key) ==
+                        ref_degree((Pitch){w, h}, key);
+    }
+    ASSERT_EQ(same, 1);
+}
+
+void test_enharmonic_exhaustive(void) {
+    int edos[] = {1, 5, 7, 12, 19, 31, 53};
+    int same = 1;
+    for (int i = 0; i < 7; i++) {
+        for (int w = -SPAN; w <= SPAN; w += 5) {
+            for (int h = -SPAN; h <= SPAN; h += 3) {
+                Pitch p = {w, h}, q = {h, w};
+                same &= pitches_enharmonic(p, q, edos[i]) ==
+                        ref_enharmonic(p, q, edos[i]);
+                same &= intervals_enharmonic(p, q, edos[i]) ==
+                        ref_enharmonic(p, q, edos[i]);
+            }
+        }
+    }
+    ASSERT_EQ(same, 1);
+}
+
+// The batch kernels, one row of the grid at a time (SIDE leaves a remainder
+// after the vector loops).
+void test_buffer_classifiers_exhaustive(void) {
+    static int out[SIDE];
+    static bool enh[SIDE];
+    PitchBuffer p, q;
+    pitch_buffer_create(SIDE, &p);
+    pitch_buffer_create(SIDE, &q);
+    p.len = q.len = SIDE;
+    TonalContext key = context_from_chroma(-4, MINOR);
+    int same = 1;
+    for (int w = -SPAN; w <= SPAN; w++) {
+        for (int i = 0; i < SIDE; i++) {
+            p.w[i] = w;
+            p.h[i] = i - SPAN;
+            q.w[i] = i - SPAN;
+            q.h[i] = -w;
+        }
+#define CHECK_ROW(kernel, ref)                                                 \
+    kernel(&p, out);                                                           \
+    for (int i = 0; i < SIDE; i++)                                             \
+        same &= out[i] == ref((Pitch){p.w[i], p.h[i]})
+
+        CHECK_ROW(pitch_buffer_letters, ref_letter);
+        CHECK_ROW(pitch_buffer_accidentals, ref_accidental);
+        CHECK_ROW(pitch_buffer_octaves, ref_octave);
+        CHECK_ROW(pitch_buffer_pc12s, ref_pc12);
+#undef CHECK_ROW
+
+        pitch_buffer_degrees(&p, key, out);
+        for (int i = 0; i < SIDE; i++)
+            same &= out[i] == ref_degree((Pitch){p.w[i], p.h[i]}, key);
+
+        int edo = 12 + (w & 63);
+        pitch_buffer_enharmonic(&p, &q, edo, enh);
+        for (int i = 0; i < SIDE; i++)
+            same &= enh[i] == ref_enharmonic((Pitch){p.w[i], p.h[i]},
+                                             (Pitch){q.w[i], q.h[i]}, edo);
+    }
+    ASSERT_EQ(same, 1);
+
+    // Far from 0 the vector lanes and the scalar tail agree too.
+    unsigned seed = 9;
+    for (int i = 0; i < SIDE; i++) {
+        seed = seed * 1103515245 + 12345;
+        p.w[i] = (int)(seed >> 3) - (1 << 28);
+        seed = seed * 1103515245 + 12345;
+        p.h[i] = (int)(seed >> 3) - (1 << 28);
+    }
+    same = 1;
+#define CHECK_FAR(kernel, scalar)                                              \
+    kernel(&p, out);                                                           \
+    for (int i = 0; i < SIDE; i++)                                             \
+        same &= out[i] == scalar((Pitch){p.w[i], p.h[i]})
+
+    CHECK_FAR(pitch_buffer_letters, pitch_letter);
+    CHECK_FAR(pitch_buffer_accidentals, pitch_accidental);
+    CHECK_FAR(pitch_buffer_octaves, pitch_octave);
+    CHECK_FAR(pitch_buffer_pc12s, pitch_pc12);
+#undef CHECK_FAR
+    ASSERT_EQ(same, 1);
+
+    ASSERT_EQ(pitch_buffer_enharmonic(&p, &q, 0, enh), 1);
+    q.len--;
+    ASSERT_EQ(pitch_buffer_enharmonic(&p, &q, 12, enh), 1);
+    pitch_buffer_destroy(&p);
+    pitch_buffer_destroy(&q);
+}
+
+void test_arith_functions(void) {
+    RUN_TESTS(test_floor_div);
+    RUN_TESTS(test_pitch_classifiers_exhaustive);
+    RUN_TESTS(test_degree_number_exhaustive);
+    RUN_TESTS(test_enharmonic_exhaustive);
+    RUN_TESTS(test_buffer_classifiers_exhaustive);
+}
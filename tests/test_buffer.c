@@ -0,0 +1,214 @@
+#include "../include/buffer.h"
+#include "../include/interval.h"
+#include "../include/pitch.h"
+#include "test_framework.h"
+
+// Enough Pitches to exercise the vector loops and leave a remainder, spread
+// over negative and positive whole and half steps.
+enum { LEN = 1003 };
+static Pitch pitches[LEN];
+
+static void fill_pitches(void) {
+    unsigned seed = 7;
+    for (int i = 0; i < LEN; i++) {
+        seed = seed * 1103515245 + 12345;
+        pitches[i].w = (int)(seed >> 16 & 0xff) - 128;
+        seed = seed * 1103515245 + 12345;
+        pitches[i].h = (int)(seed >> 16 & 0xff) - 128;
+    }
+}
+
+static PitchBuffer filled_buffer(void) {
+    fill_pitches();
+    PitchBuffer b;
+    pitch_buffer_create(LEN, &b);
+    pitch_buffer_from_pitches(&b, pitches, LEN);
+    return b;
+}
+
+void test_pitch_buffer_create(void) {
+    PitchBuffer b;
+    ASSERT_EQ(pitch_buffer_create(-1, &b), 1);
+    ASSERT_EQ(pitch_buffer_create(0, &b), 0);
+    pitch_buffer_destroy(&b);
+    ASSERT_EQ(pitch_buffer_create(10, &b), 0);
+    ASSERT_EQ((long)b.w % 32, 0);
+    ASSERT_EQ((long)b.h % 32, 0);
+    ASSERT_EQ(b.len, 0);
+
+    Pitch arr[11] = {{0, 0}};
+    ASSERT_EQ(pitch_buffer_from_pitches(&b, arr, 11), 1);
+    ASSERT_EQ(pitch_buffer_from_pitches(&b, arr, 10), 0);
+    ASSERT_EQ(b.len, 10);
+    pitch_buffer_destroy(&b);
+}
+
+void test_pitch_buffer_round_trip(void) {
+    PitchBuffer b = filled_buffer();
+    static Pitch out[LEN];
+    pitch_buffer_to_pitches(&b, out);
+    int same = 1;
+    for (int i = 0; i < LEN; i++)
+        same &= pitches_equal(out[i], pitches[i]);
+    ASSERT_EQ(same, 1);
+    pitch_buffer_destroy(&b);
+}
+
+void test_pitch_buffer_transforms(void) {
+    PitchBuffer b = filled_buffer();
+    Interval m = {3, -2};
+    MirrorAxis a = {7, 5};
+    pitch_buffer_transpose(&b, m);
+    int same = 1;
+    for (int i = 0; i < LEN; i++)
+        same &= pitches_equal((Pitch){b.w[i], b.h[i]},
+                              transpose_real(pitches[i], m));
+    ASSERT_EQ(same, 1);
+
+    pitch_buffer_from_pitches(&b, pitches, LEN);
+    pitch_buffer_invert(&b, a);
+    same = 1;
+    for (int i = 0; i < LEN; i++)
+        same &= pitches_equal((Pitch){b.w[i], b.h[i]},
+                              pitch_invert(pitches[i], a));
+    ASSERT_EQ(same, 1);
+
+    // Intervals from each Pitch to its inversion.
+    PitchBuffer p, out;
+    pitch_buffer_create(LEN, &p);
+    pitch_buffer_create(LEN, &out);
+    pitch_buffer_from_pitches(&p, pitches, LEN);
+    ASSERT_EQ(pitch_buffer_intervals(&p, &b, &out), 0);
+    ASSERT_EQ(out.len, LEN);
+    same = 1;
+    for (int i = 0; i < LEN; i++)
+        same &= pitches_equal(
+            (Interval){out.w[i], out.h[i]},
+            interval_between(pitches[i], pitch_invert(pitches[i], a)));
+    ASSERT_EQ(same, 1);
+
+    p.len--;
+    ASSERT_EQ(pitch_buffer_intervals(&p, &b, &out), 1);
+    pitch_buffer_destroy(&p);
+    pitch_buffer_destroy(&out);
+    pitch_buffer_destroy(&b);
+}
+
+void test_pitch_buffer_classifiers(void) {
+    PitchBuffer b = filled_buffer();
+    static int out[LEN];
+    static StandardPitch standard[LEN];
+    int same;
+
+#define CHECK_CLASSIFIER(batch, scalar)                                        \
+    batch(&b, out);                                                            \
+    same = 1;                                                                  \
+    for (int i = 0; i < LEN; i++)                                              \
+        same &= out[i] == scalar(pitches[i]);                                  \
+    ASSERT_EQ(same, 1)
+
+    CHECK_CLASSIFIER(pitch_buffer_chromas, pitch_chroma);
+    CHECK_CLASSIFIER(pitch_buffer_midis, pitch_midi);
+    CHECK_CLASSIFIER(pitch_buffer_letters, pitch_letter);
+    CHECK_CLASSIFIER(pitch_buffer_accidentals, pitch_accidental);
+    CHECK_CLASSIFIER(pitch_buffer_octaves, pitch_octave);
+#undef CHECK_CLASSIFIER
+
+    pitch_buffer_to_standard(&b, standard);
+    same = 1;
+    for (int i = 0; i < LEN; i++) {
+        StandardPitch s = pitch_to_standard(pitches[i]);
+        same &= standard[i].letter == s.letter &&
+                standard[i].accidental == s.accidental &&
+                standard[i].octave == s.octave;
+    }
+    ASSERT_EQ(same, 1);
+    pitch_buffer_destroy(&b);
+}
+
+void test_pitch_buffer_scan(void) {
+    fill_pitches(); // used as Intervals
+    static Pitch melody[LEN];
+    Pitch start = {25, 10};
+    Pitch last = pitches_from_intervals(start, pitches, LEN, melody);
+
+    PitchBuffer b;
+    pitch_buffer_create(LEN, &b);
+    pitch_buffer_from_pitches(&b, pitches, LEN);
+    Interval sum = pitch_buffer_sum(&b);
+    ASSERT_EQ(pitches_equal(sum, intervals_sum(pitches, LEN)), 1);
+    ASSERT_EQ(pitches_equal(pitch_buffer_scan(&b, start), last), 1);
+    int same = 1;
+    for (int i = 0; i < LEN; i++)
+        same &= pitches_equal((Pitch){b.w[i], b.h[i]}, melody[i]);
+    ASSERT_EQ(same, 1);
+
+    pitch_buffer_differences(&b, start);
+    same = 1;
+    for (int i = 0; i < LEN; i++)
+        same &= pitches_equal((Pitch){b.w[i], b.h[i]}, pitches[i]);
+    ASSERT_EQ(same, 1);
+
+    // decoded in three chunks, each started from the sums before it, as
+    // separate threads would
+    int cut[4] = {0, 333, 700, LEN};
+    Pitch starts[3] = {start};
+    for (int c = 0; c < 2; c++) {
+        PitchBuffer chunk = {b.w + cut[c], b.h + cut[c], cut[c + 1] - cut[c],
+                             cut[c + 1] - cut[c]};
+        starts[c + 1] = transpose_real(starts[c], pitch_buffer_sum(&chunk));
+    }
+    for (int c = 0; c < 3; c++) {
+        PitchBuffer chunk = {b.w + cut[c], b.h + cut[c], cut[c + 1] - cut[c],
+                             cut[c + 1] - cut[c]};
+        pitch_buffer_scan(&chunk, starts[c]);
+    }
+    same = 1;
+    for (int i = 0; i < LEN; i++)
+        same &= pitches_equal((Pitch){b.w[i], b.h[i]}, melody[i]);
+    ASSERT_EQ(same, 1);
+
+    b.len = 0;
+    ASSERT_EQ(pitches_equal(pitch_buffer_scan(&b, start), start), 1);
+    pitch_buffer_destroy(&b);
+}
+
+void test_pitch_buffer_scan_long(void) {
+    // Long enough to be split over threads, when there are any.
+    enum { LONG = (1 << 20) + 5 };
+    static Pitch steps[LONG], melody[LONG];
+    unsigned seed = 11;
+    for (int i = 0; i < LONG; i++) {
+        seed = seed * 1103515245 + 12345;
+        steps[i].w = (int)(seed >> 16 & 7) - 3;
+        seed = seed * 1103515245 + 12345;
+        steps[i].h = (int)(seed >> 16 & 7) - 3;
+    }
+    Pitch start = {25, 10};
+    Pitch last = pitches_from_intervals(start, steps, LONG, melody);
+
+    PitchBuffer b;
+    ASSERT_EQ(pitch_buffer_create(LONG, &b), 0);
+    pitch_buffer_from_pitches(&b, steps, LONG);
+    ASSERT_EQ(pitches_equal(pitch_buffer_scan(&b, start), last), 1);
+    int same = 1;
+    for (int i = 0; i < LONG; i++)
+        same &= pitches_equal((Pitch){b.w[i], b.h[i]}, melody[i]);
+    ASSERT_EQ(same, 1);
+
+    pitch_buffer_differences(&b, start);
+    same = 1;
+    for (int i = 0; i < LONG; i++)
+        same &= pitches_equal((Pitch){b.w[i], b.h[i]}, steps[i]);
+    ASSERT_EQ(same, 1);
+    pitch_buffer_destroy(&b);
+}
+
+void test_buffer_functions(void) {
+    RUN_TESTS(test_pitch_buffer_create);
+    RUN_TESTS(test_pitch_buffer_round_trip);
+    RUN_TESTS(test_pitch_buffer_transforms);
+    RUN_TESTS(test_pitch_buffer_classifiers);
+    RUN_TESTS(test_pitch_buffer_scan);
+    RUN_TESTS(test_pitch_buffer_scan_long);
+}
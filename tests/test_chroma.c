@@ -0,0 +1,136 @@
+#include "../include/chroma.h"
+#include "../include/map.h"
+#include "../include/parse.h"
+#include "../include/pitch.h"
+#include "test_framework.h"
+#include <math.h>
+
+enum { RATE = 44100, WINDOW = 8192, LEN = 44100 / 2 };
+static float signal[LEN];
+
+static void fill_notes(const Pitch notes[], int len, TuningMap T) {
+    for (int i = 0; i < LEN; i++) {
+        double x = 0;
+        for (int j = 0; j < len; j++)
+            x += sin(6.283185307179586 * to_hz(notes[j], T) * i / RATE);
+        signal[i] = x / len;
+    }
+}
+
+// The class with the most energy, as a chroma.
+static int loudest(const Chromagram *c, const double energy[]) {
+    int best = 0;
+    for (int i = 1; i < c->classes; i++)
+        if (energy[i] > energy[best])
+            best = i;
+    return c->chroma_min + best;
+}
+
+void test_chromagram_create(void) {
+    TuningMap T;
+    tuning_map_from_edo(12, (Pitch){0, 0}, 440, &T);
+    Chromagram c;
+    ASSERT_EQ(chromagram_create(T, RATE, 1000, 512, -7, 7, 50, 5000, &c), 1);
+    ASSERT_EQ(chromagram_create(T, RATE, 4096, 0, -7, 7, 50, 5000, &c), 1);
+    ASSERT_EQ(chromagram_create(T, RATE, 4096, 512, 7, -7, 50, 5000, &c), 1);
+    ASSERT_EQ(chromagram_create(T, RATE, 4096, 512, -7, 7, 500, 50, &c), 1);
+    ASSERT_EQ(chromagram_create(T, RATE, 4096, 512, -7, 7, 50, 5000, &c), 0);
+    ASSERT_EQ(c.classes, 15);
+    // Every bin in range belongs to exactly one run.
+    int bins = 0;
+    for (int r = 0; r < c.runs; r++)
+        bins += c.run_end[r] - c.run_start[r];
+    ASSERT_EQ(bins, (int)floor(5000.0 * 4096 / RATE) -
+                        (int)ceil(50.0 * 4096 / RATE) + 1);
+    ASSERT_EQ(c.class_runs[c.classes], c.runs);
+    chromagram_destroy(&c);
+}
+
+void test_chromagram_frame(void) {
+    Pitch a4;
+    pitch_from_spn("A4", &a4);
+    TuningMap T;
+    tuning_map_from_fifth(1200 * log2(5) / 4, a4, 440, &T);
+    Chromagram c;
+    chromagram_create(T, RATE, WINDOW, 2048, -9, 9, 60, 4000, &c);
+    double energy[19];
+
+    // In quarter-comma meantone C# and Db are 41 cents apart, so they land in
+    // different classes.
+    Pitch notes[3];
+    char *sharp[3] = {"A3", "C#4", "E4"};
+    for (int i = 0; i < 3; i++)
+        pitch_from_spn(sharp[i], notes + i);
+    fill_notes(notes + 1, 1, T);
+    chromagram_frame(&c, signal, energy);
+    ASSERT_EQ(loudest(&c, energy), 7);
+
+    Pitch db4;
+    pitch_from_spn("Db4", &db4);
+    fill_notes(&db4, 1, T);
+    chromagram_frame(&c, signal, energy);
+    ASSERT_EQ(loudest(&c, energy), -5);
+
+    // An A major triad's three classes are its three loudest.
+    fill_notes(notes, 3, T);
+    chromagram_frame(&c, signal, energy);
+    double quietest = fmin(energy[3 + 9], fmin(energy[7 + 9], energy[4 + 9]));
+    int others_quieter = 1;
+    for (int i = 0; i < 19; i++)
+        if (i != 3 + 9 && i != 7 + 9 && i != 4 + 9)
+            others_quieter &= energy[i] < quietest;
+    ASSERT_EQ(others_quieter, 1);
+    chromagram_destroy(&c);
+}
+
+void test_chromagram_run(void) {
+    Pitch a4;
+    pitch_from_spn("A4", &a4);
+    TuningMap T;
+    tuning_map_from_edo(12, a4, 440, &T);
+    Chromagram c;
+    chromagram_create(T, RATE, WINDOW, 4096, -6, 6, 60, 4000, &c);
+    fill_notes(&a4, 1, T);
+
+    long frames = chromagram_frames(&c, LEN);
+    ASSERT_EQ(frames, (LEN - WINDOW) / 4096 + 1);
+    double out[13 * 8];
+    ASSERT_EQ(chromagram_run(&c, signal, LEN, out), frames);
+    int all_a = 1;
+    for (long i = 0; i < frames; i++)
+        all_a &= loudest(&c, out + i * 13) == 3;
+    ASSERT_EQ(all_a, 1);
+
+    // In 12-EDO G# and Ab are the same bins; the sharper one is further
+    // from C, so Ab gets them.
+    Pitch gs4;
+    pitch_from_spn("G#4", &gs4);
+    fill_notes(&gs4, 1, T);
+    chromagram_frame(&c, signal, out);
+    ASSERT_EQ(loudest(&c, out), -4);
+    ASSERT_EQ(out[8 + 6], 0);
+    chromagram_destroy(&c);
+
+    // With a short hop there are enough frames to split over threads; every
+    // frame still matches chromagram_frame exactly.
+    chromagram_create(T, RATE, WINDOW, 512, -6, 6, 60, 4000, &c);
+    fill_notes(&a4, 1, T);
+    frames = chromagram_frames(&c, LEN);
+    ASSERT_EQ(frames, (LEN - WINDOW) / 512 + 1);
+    static double many[13 * 32], one[13];
+    ASSERT_EQ(chromagram_run(&c, signal, LEN, many), frames);
+    int same = 1;
+    for (long i = 0; i < frames; i++) {
+        chromagram_frame(&c, signal + i * 512, one);
+        for (int k = 0; k < 13; k++)
+            same &= many[i * 13 + k] == one[k];
+    }
+    ASSERT_EQ(same, 1);
+    chromagram_destroy(&c);
+}
+
+void test_chroma_functions(void) {
+    RUN_TESTS(test_chromagram_create);
+    RUN_TESTS(test_chromagram_frame);
+    RUN_TESTS(test_chromagram_run);
+}
@@ -0,0 +1,53 @@
+#include "../include/fft.h"
+#include "test_framework.h"
+#include <math.h>
+
+void test_fft_plan_create(void) {
+    FFTPlan p;
+    ASSERT_EQ(fft_plan_create(12, &p), 1);
+    ASSERT_EQ(fft_plan_create(0, &p), 1);
+    ASSERT_EQ(fft_plan_create(1, &p), 0);
+    fft_plan_destroy(&p);
+    ASSERT_EQ(fft_plan_create(64, &p), 0);
+    ASSERT_EQ(p.n, 64);
+    ASSERT_EQ(p.bitrev[1], 32);
+    fft_plan_destroy(&p);
+}
+
+void test_fft_forward(void) {
+    enum { N = 32 };
+    double re[N], im[N], x[N], y[N];
+    for (int j = 0; j < N; j++) {
+        x[j] = re[j] = sin(j * 1.7) + 0.25 * j;
+        y[j] = im[j] = cos(j * j * 0.3);
+    }
+    FFTPlan p;
+    fft_plan_create(N, &p);
+    fft_forward(&p, re, im);
+
+    // Matches the DFT computed the slow way.
+    int close = 1;
+    for (int k = 0; k < N; k++) {
+        double sr = 0, si = 0;
+        for (int j = 0; j < N; j++) {
+            double a = -6.283185307179586 * j * k / N;
+            sr += x[j] * cos(a) - y[j] * sin(a);
+            si += x[j] * sin(a) + y[j] * cos(a);
+        }
+        close &= fabs(sr - re[k]) < 1e-9 && fabs(si - im[k]) < 1e-9;
+    }
+    ASSERT_EQ(close, 1);
+
+    // And the inverse undoes it.
+    fft_inverse(&p, re, im);
+    close = 1;
+    for (int j = 0; j < N; j++)
+        close &= fabs(re[j] - x[j]) < 1e-12 && fabs(im[j] - y[j]) < 1e-12;
+    ASSERT_EQ(close, 1);
+    fft_plan_destroy(&p);
+}
+
+void test_fft_functions(void) {
+    RUN_TESTS(test_fft_plan_create);
+    RUN_TESTS(test_fft_forward);
+}
@@ -0,0 +1,143 @@
+#include "../include/hash.h"
+#include "../include/pitch.h"
+#include "test_framework.h"
+#include <limits.h>
+
+void test_pitch_hash(void) {
+    ASSERT_EQ(pitch_hash((Pitch){25, 10}) == pitch_hash((Pitch){25, 10}), 1);
+    ASSERT_EQ(pitch_hash((Pitch){25, 10}) == pitch_hash((Pitch){10, 25}), 0);
+    ASSERT_EQ(interval_hash((Interval){2, 0}) == pitch_hash((Pitch){2, 0}), 1);
+
+    // Nearby Pitches spread evenly over the low bits used to index tables:
+    // 64 x 64 Pitches into 256 buckets should put about 16 in each.
+    int buckets[256] = {0};
+    for (int w = -32; w < 32; w++)
+        for (int h = -32; h < 32; h++)
+            buckets[pitch_hash((Pitch){w, h}) & 255]++;
+    int fullest = 0;
+    for (int i = 0; i < 256; i++)
+        fullest = buckets[i] > fullest ? buckets[i] : fullest;
+    ASSERT_EQ(fullest < 40, 1);
+
+    StandardPitch s = {2, -1, 4}, t = {2, -1, 4}, u = {2, 4, -1};
+    ASSERT_EQ(standard_pitch_hash(s) == standard_pitch_hash(t), 1);
+    ASSERT_EQ(standard_pitch_hash(s) == standard_pitch_hash(u), 0);
+}
+
+void test_pitch_map_basics(void) {
+    PitchMap m;
+    ASSERT_EQ(pitch_map_create(-1, &m), 1);
+    ASSERT_EQ(pitch_map_create(0, &m), 0);
+    ASSERT_EQ(pitch_map_get(&m, (Pitch){25, 10}) == NULL, 1);
+    ASSERT_EQ(pitch_map_put(&m, (Pitch){25, 10}, (PitchValue){.d = 261.63}), 0);
+    ASSERT_EQ(pitch_map_get(&m, (Pitch){25, 10})->d == 261.63, 1);
+    ASSERT_EQ(pitch_map_put(&m, (Pitch){25, 10}, (PitchValue){.i = 7}), 0);
+    ASSERT_EQ(pitch_map_get(&m, (Pitch){25, 10})->i, 7);
+    ASSERT_EQ(m.len, 1);
+
+    ASSERT_EQ(pitch_map_slot(&m, (Pitch){27, 10})->i, 0);
+    pitch_map_slot(&m, (Pitch){27, 10})->i += 3;
+    ASSERT_EQ(pitch_map_get(&m, (Pitch){27, 10})->i, 3);
+    ASSERT_EQ(m.len, 2);
+
+    ASSERT_EQ(pitch_map_remove(&m, (Pitch){25, 10}), true);
+    ASSERT_EQ(pitch_map_remove(&m, (Pitch){25, 10}), false);
+    ASSERT_EQ(pitch_map_get(&m, (Pitch){25, 10}) == NULL, 1);
+    ASSERT_EQ(pitch_map_get(&m, (Pitch){27, 10})->i, 3);
+
+    pitch_map_clear(&m);
+    ASSERT_EQ(m.len, 0);
+    ASSERT_EQ(pitch_map_get(&m, (Pitch){27, 10}) == NULL, 1);
+    pitch_map_destroy(&m);
+}
+
+// Random inserts and removals, checked against a plain array over a small
+// range of Pitches so removals keep hitting long probe runs.
+void test_pitch_map_churn(void) {
+    enum { SPAN = 40 };
+    static long long ref[SPAN][SPAN];
+    static bool present[SPAN][SPAN];
+    PitchMap m;
+    pitch_map_create(4, &m);
+    unsigned seed = 11;
+    int same = 1, len = 0;
+    for (int step = 0; step < 200000; step++) {
+        seed = seed * 1103515245 + 12345;
+        int w = (seed >> 8) % SPAN, h = (seed >> 18) % SPAN;
+        Pitch p = {w - SPAN / 2, h - SPAN / 2};
+        if (seed >> 30 == 0) {
+            same &= pitch_map_remove(&m, p) == present[w][h];
+            len -= present[w][h];
+            present[w][h] = false;
+        } else {
+            PitchValue *v = pitch_map_slot(&m, p);
+            if (!present[w][h])
+                ref[w][h] = 0;
+            len += !present[w][h];
+            present[w][h] = true;
+            v->i += step;
+            ref[w][h] += step;
+        }
+    }
+    for (int w = 0; w < SPAN; w++) {
+        for (int h = 0; h < SPAN; h++) {
+            Pitch p = {w - SPAN / 2, h - SPAN / 2};
+            PitchValue *v = pitch_map_get(&m, p);
+            same &= (v != NULL) == present[w][h];
+            same &= !v || v->i == ref[w][h];
+        }
+    }
+    ASSERT_EQ(same, 1);
+    ASSERT_EQ(m.len, len);
+    pitch_map_destroy(&m);
+}
+
+void test_pitch_map_bulk(void) {
+    enum { LEN = 5000 };
+    static Pitch keys[LEN];
+    static PitchValue values[LEN];
+    for (int i = 0; i < LEN; i++) {
+        keys[i] = (Pitch){i % 50, i % 7}; // 350 distinct Pitches
+        values[i].i = i;
+    }
+    PitchMap m;
+    pitch_map_create(0, &m);
+    ASSERT_EQ(pitch_map_put_all(&m, keys, values, LEN), 0);
+    ASSERT_EQ(m.len, 350);
+    ASSERT_EQ(pitch_map_get(&m, (Pitch){3, 3})->i, 4903); // the last one
+
+    pitch_map_clear(&m);
+    ASSERT_EQ(pitch_map_increment_all(&m, keys, LEN), 0);
+    ASSERT_EQ(pitch_map_increment_all(&m, keys, 10), 0);
+    ASSERT_EQ(pitch_map_get(&m, (Pitch){0, 0})->i, 16);
+    ASSERT_EQ(pitch_map_get(&m, (Pitch){20, 6})->i, 15);
+
+    int pos = 0, visited = 0;
+    long long total = 0;
+    Pitch key;
+    PitchValue value;
+    while (pitch_map_next(&m, &pos, &key, &value)) {
+        visited++;
+        total += value.i;
+    }
+    ASSERT_EQ(visited, 350);
+    ASSERT_EQ(total, LEN + 10);
+
+    // More Pitches than a map holds are refused up front, before any is read
+    // and without m->len + len overflowing; the map is left as it was.
+    ASSERT_EQ(pitch_map_create((1 << 28) + 1, &m), 1);
+    pitch_map_clear(&m);
+    ASSERT_EQ(pitch_map_put(&m, (Pitch){1, 1}, (PitchValue){.i = 1}), 0);
+    ASSERT_EQ(pitch_map_put_all(&m, keys, values, INT_MAX), 1);
+    ASSERT_EQ(pitch_map_put_all(&m, keys, values, 1 << 28), 1);
+    ASSERT_EQ(m.len, 1);
+    ASSERT_EQ(pitch_map_get(&m, (Pitch){1, 1})->i, 1);
+    pitch_map_destroy(&m);
+}
+
+void test_hash_functions(void) {
+    RUN_TESTS(test_pitch_hash);
+    RUN_TESTS(test_pitch_map_basics);
+    RUN_TESTS(test_pitch_map_churn);
+    RUN_TESTS(test_pitch_map_bulk);
+}
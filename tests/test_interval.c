@@ -126,6 +126,33 @@ void test_intervals_enharmonic(void) {
     ASSERT_EQ(intervals_enharmonic(m, n, 12), false);
 }
 
+void test_interval_simple(void) {
+    Interval m;
+    interval_from_name("M10", &m);
+    ASSERT_EQ(interval_simple(m).w, 2);
+    ASSERT_EQ(interval_simple(m).h, 0);
+    interval_from_name("-m17", &m);
+    ASSERT_EQ(interval_simple(m).w, -1);
+    ASSERT_EQ(interval_simple(m).h, -1);
+    interval_from_name("P8", &m);
+    ASSERT_EQ(interval_simple(m).w, 0);
+    ASSERT_EQ(interval_simple(m).h, 0);
+
+    // the same as reducing an octave at a time
+    int same = 1;
+    for (int w = -200; w <= 200; w++) {
+        for (int h = -200; h <= 200; h++) {
+            Interval n = {w, h};
+            while (n.w + n.h >= 7)
+                n = (Interval){n.w - 5, n.h - 2};
+            while (n.w + n.h <= -7)
+                n = (Interval){n.w + 5, n.h + 2};
+            same &= intervals_equal(interval_simple((Interval){w, h}), n);
+        }
+    }
+    ASSERT_EQ(same, 1);
+}
+
 void test_stepspan(void) {
     Interval m;
     interval_from_spn("C4", "E4", &m);
@@ -292,6 +319,7 @@ void test_interval_functions(void) {
     RUN_TESTS(test_interval_tonal);
     RUN_TESTS(test_intervals_equal);
     RUN_TESTS(test_intervals_enharmonic);
+    RUN_TESTS(test_interval_simple);
     RUN_TESTS(test_stepspan);
     RUN_TESTS(test_interval_quality);
     RUN_TESTS(test_transpose_real);
@@ -0,0 +1,114 @@
+#include "../include/constants.h"
+#include "../include/layout.h"
+#include "../include/parse.h"
+#include "../include/pitch.h"
+#include "test_framework.h"
+
+// Wicki-Hayden on a square grid 40 units apart, with C4 at the origin.
+static KeyboardLayout wicki_layout(void) {
+    Map2D grid = {40, 0, 0, 40};
+    Pitch c4;
+    pitch_from_spn("C4", &c4);
+    KeyboardLayout L;
+    keyboard_layout_create(map_compose_2d_2d(grid, WICKI_TO), c4,
+                           (MapVec){0, 0}, &L);
+    return L;
+}
+
+static void assert_hit(const KeyboardLayout *L, double x, double y,
+                       char *expected) {
+    Pitch p;
+    pitch_from_spn(expected, &p);
+    ASSERT_EQ(pitches_equal(keyboard_hit_test(L, x, y), p), true);
+}
+
+void test_keyboard_layout_create(void) {
+    KeyboardLayout L;
+    Pitch p = {0, 0};
+    ASSERT_EQ(keyboard_layout_create(WICKI_TO, p, (MapVec){0, 0}, &L), 0);
+    ASSERT_EQ(keyboard_layout_create((Map2D){1, 2, 2, 4}, p, (MapVec){0, 0},
+                                     &L),
+              1);
+}
+
+void test_keyboard_key_centers(void) {
+    KeyboardLayout L = wicki_layout();
+    char *names[3] = {"C4", "D4", "G4"};
+    Pitch arr[3];
+    for (int i = 0; i < 3; i++)
+        pitch_from_spn(names[i], arr + i);
+
+    double x[3], y[3];
+    keyboard_key_centers(&L, arr, 3, x, y);
+    ASSERT_EQ(x[0], 0);
+    ASSERT_EQ(y[0], 0);
+    ASSERT_EQ(x[1], 40);
+    ASSERT_EQ(y[1], 0);
+    ASSERT_EQ(x[2], 0);
+    ASSERT_EQ(y[2], 40);
+
+    MapVec c = keyboard_key_center(&L, arr[1]);
+    ASSERT_EQ(c.x, 40);
+    ASSERT_EQ(c.y, 0);
+}
+
+void test_keyboard_key_vertices(void) {
+    KeyboardLayout L = wicki_layout();
+    Pitch arr[2];
+    pitch_from_spn("C4", arr);
+    pitch_from_spn("D4", arr + 1);
+
+    double x[8], y[8];
+    keyboard_key_vertices(&L, arr, 2, x, y);
+    // Corners average out to the centre, and points just inside C4's
+    // corners (C4 is centred on the origin) still hit C4.
+    ASSERT_EQ(x[4] + x[5] + x[6] + x[7], 4 * 40);
+    ASSERT_EQ(y[4] + y[5] + y[6] + y[7], 0);
+    for (int k = 0; k < 4; k++) {
+        Pitch p = keyboard_hit_test(&L, 0.99 * x[k], 0.99 * y[k]);
+        ASSERT_EQ(pitches_equal(p, arr[0]), true);
+    }
+}
+
+void test_keyboard_hit_test(void) {
+    KeyboardLayout L = wicki_layout();
+    assert_hit(&L, 0, 0, "C4");
+    assert_hit(&L, 19, 0, "C4");
+    assert_hit(&L, 21, 0, "D4");
+    assert_hit(&L, 38, 3, "D4");
+    assert_hit(&L, 0, 41, "G4");
+    assert_hit(&L, -40, -40, "Eb3");
+
+    double x[3] = {0, 40, 0}, y[3] = {0, 0, 40};
+    Pitch out[3];
+    keyboard_hit_test_batch(&L, x, y, 3, out);
+    char *names[3] = {"C4", "D4", "G4"};
+    for (int i = 0; i < 3; i++) {
+        Pitch p;
+        pitch_from_spn(names[i], &p);
+        ASSERT_EQ(pitches_equal(out[i], p), true);
+    }
+}
+
+void test_keyboard_visible_keys(void) {
+    KeyboardLayout L = wicki_layout();
+    Pitch out[16];
+    ASSERT_EQ(keyboard_visible_keys(&L, -50, -50, 50, 50, out, 16), 9);
+    // Every key listed hits itself.
+    for (int i = 0; i < 9; i++) {
+        MapVec c = keyboard_key_center(&L, out[i]);
+        ASSERT_EQ(pitches_equal(keyboard_hit_test(&L, c.x, c.y), out[i]),
+                  true);
+    }
+    // The count doesn't depend on how much room there is.
+    ASSERT_EQ(keyboard_visible_keys(&L, 50, 50, -50, -50, out, 2), 9);
+    ASSERT_EQ(keyboard_visible_keys(&L, 1, 1, 2, 2, out, 16), 0);
+}
+
+void test_layout_functions(void) {
+    RUN_TESTS(test_keyboard_layout_create);
+    RUN_TESTS(test_keyboard_key_centers);
+    RUN_TESTS(test_keyboard_key_vertices);
+    RUN_TESTS(test_keyboard_hit_test);
+    RUN_TESTS(test_keyboard_visible_keys);
+}
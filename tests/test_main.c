@@ -6,6 +6,25 @@ void test_tonality_functions(void);
 void test_map_functions(void);
 void test_parse_functions(void);
 void test_pc_set_functions(void);
+void test_layout_functions(void);
+void test_optimize_functions(void);
+void test_adaptive_functions(void);
+void test_osc_functions(void);
+void test_morph_functions(void);
+void test_render_functions(void);
+void test_zone_functions(void);
+void test_fft_functions(void);
+void test_wav_functions(void);
+void test_track_functions(void);
+void test_chroma_functions(void);
+void test_buffer_functions(void);
+void test_arith_functions(void);
+void test_packed_functions(void);
+void test_width_functions(void);
+void test_hash_functions(void);
+void test_sort_functions(void);
+void test_range_functions(void);
+void test_parallel_functions(void);
 
 int main(void) {
     RUN_GROUP(test_pitch_functions);
@@ -14,6 +33,25 @@ int main(void) {
     RUN_GROUP(test_map_functions);
     RUN_GROUP(test_parse_functions);
     RUN_GROUP(test_pc_set_functions);
+    RUN_GROUP(test_layout_functions);
+    RUN_GROUP(test_optimize_functions);
+    RUN_GROUP(test_adaptive_functions);
+    RUN_GROUP(test_osc_functions);
+    RUN_GROUP(test_morph_functions);
+    RUN_GROUP(test_render_functions);
+    RUN_GROUP(test_zone_functions);
+    RUN_GROUP(test_fft_functions);
+    RUN_GROUP(test_wav_functions);
+    RUN_GROUP(test_track_functions);
+    RUN_GROUP(test_chroma_functions);
+    RUN_GROUP(test_buffer_functions);
+    RUN_GROUP(test_arith_functions);
+    RUN_GROUP(test_packed_functions);
+    RUN_GROUP(test_width_functions);
+    RUN_GROUP(test_hash_functions);
+    RUN_GROUP(test_sort_functions);
+    RUN_GROUP(test_range_functions);
+    RUN_GROUP(test_parallel_functions);
 
     TEST_RESULTS();
     return tests_failed != 0;
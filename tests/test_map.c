@@ -1,8 +1,12 @@
 #include "../include/constants.h"
+#include "../include/interval.h"
 #include "../include/map.h"
 #include "../include/parse.h"
 #include "../include/pitch.h"
+#include "../include/tonality.h"
 #include "test_framework.h"
+#include <limits.h>
+#include <math.h>
 
 void test_map_to_2d(void) {
     MapVec u = {1, 0};
@@ -93,6 +97,315 @@ void test_tuning_map_from_edo_rejects_bad_edo(void) {
     ASSERT_EQ(tuning_map_from_edo(4, ref, 440, &T), 1);
 }
 
+void test_height_map_from_tuning(void) {
+    Pitch ref;
+    pitch_from_spn("A4", &ref);
+    TuningMap T;
+
+    // EDO fifths give heights in EDO steps, matching create_edo_map.
+    tuning_map_from_edo(12, ref, 440, &T);
+    HeightMap H = height_map_from_tuning(T);
+    ASSERT_EQ(H.m0, 2);
+    ASSERT_EQ(H.m1, 1);
+    tuning_map_from_edo(31, ref, 440, &T);
+    H = height_map_from_tuning(T);
+    ASSERT_EQ(H.m0, 5);
+    ASSERT_EQ(H.m1, 3);
+    tuning_map_from_fifth(700, ref, 440, &T);
+    H = height_map_from_tuning(T);
+    ASSERT_EQ(H.m0, 2);
+    ASSERT_EQ(H.m1, 1);
+
+    // Anything else falls back to fixed-point cents.
+    tuning_map_from_fifth(696.5784284662087, ref, 440, &T);
+    H = height_map_from_tuning(T);
+    ASSERT_EQ(H.scale == 1048576.0, true);
+    ASSERT_EQ(llabs(H.m0 - llround(193.1568569324174 * H.scale)) <= 1, true);
+}
+
+static void assert_from_hz(double hz, TuningMap T, const TonalContext *key,
+                           char *expected) {
+    Pitch p, q;
+    pitch_from_spn(expected, &q);
+    ASSERT_EQ(pitch_from_hz(hz, T, key, &p, NULL), 0);
+    ASSERT_EQ(pitches_equal(p, q), true);
+}
+
+void test_pitch_from_hz(void) {
+    Pitch ref;
+    pitch_from_spn("A4", &ref);
+    TuningMap T;
+    tuning_map_from_edo(12, ref, 440, &T);
+
+    Pitch p;
+    double cents;
+    ASSERT_EQ(pitch_from_hz(440, T, NULL, &p, &cents), 0);
+    ASSERT_EQ(pitches_equal(p, ref), true);
+    ASSERT_EQ(fabs(cents) < 1e-9, true);
+    ASSERT_EQ(pitch_from_hz(445, T, NULL, &p, &cents), 0);
+    ASSERT_EQ(pitches_equal(p, ref), true);
+    ASSERT_EQ((int)round(cents * 100), 1956);
+
+    // Round trips through to_hz across a range of octaves.
+    char *names[6] = {"C-1", "C4", "F#4", "Bb4", "Eb7", "B9"};
+    for (int i = 0; i < 6; i++) {
+        Pitch q;
+        pitch_from_spn(names[i], &q);
+        assert_from_hz(to_hz(q, T), T, NULL, names[i]);
+    }
+
+    // Enharmonic ties follow the key.
+    assert_from_hz(277.1826309768721, T, NULL, "C#4");
+    assert_from_hz(415.3046975799451, T, NULL, "Ab4");
+    TonalContext key;
+    context_from_str("D", MAJOR, &key);
+    assert_from_hz(415.3046975799451, T, &key, "G#4");
+    context_from_str("F", MINOR, &key);
+    assert_from_hz(277.1826309768721, T, &key, "Db4");
+
+    // In 31-EDO the spellings are distinct, so the frequency decides.
+    tuning_map_from_edo(31, ref, 440, &T);
+    Pitch db4;
+    pitch_from_spn("Db4", &db4);
+    assert_from_hz(to_hz(db4, T), T, NULL, "Db4");
+
+    ASSERT_EQ(pitch_from_hz(0, T, NULL, &p, NULL), 1);
+    ASSERT_EQ(pitch_from_hz(-440, T, NULL, &p, NULL), 1);
+    ASSERT_EQ(pitch_from_hz(NAN, T, NULL, &p, NULL), 1);
+    ASSERT_EQ(pitch_from_hz(INFINITY, T, NULL, &p, NULL), 1);
+}
+
+// pitch_from_hz as a search: try the nearest octave of each of the 17
+// spellings in order of preference, and keep the closest.
+static Pitch from_hz_by_search(double hz, TuningMap T, int offset,
+                               double *cents) {
+    double octave = T.centmap.m1, c = octave * log2(hz / T.ref_freq);
+    Pitch best = {0, 0};
+    double best_dev = 0;
+    for (int i = 0; i < 17; i++) {
+        int rank = i < 7                ? i
+                   : (i - 7) % 2 == 0 ? -((i - 7) / 2 + 1)
+                                        : 7 + (i - 7) / 2;
+        int chroma = rank - offset;
+        Pitch p = {3 * chroma, chroma};
+        double base = to_cents(interval_between(T.ref_pitch, p), T);
+        double oct = round((c - base) / octave);
+        double dev = c - base - oct * octave;
+        if (i == 0 || fabs(dev) < fabs(best_dev) - 1e-6) {
+            best = transpose_real(p, (Interval){5 * (int)oct, 2 * (int)oct});
+            best_dev = dev;
+        }
+    }
+    *cents = best_dev;
+    return best;
+}
+
+void test_pitch_from_hz_matches_search(void) {
+    Pitch a4 = {29, 11};
+    TuningMap maps[4];
+    tuning_map_from_edo(12, a4, 440, &maps[0]);
+    tuning_map_from_edo(31, a4, 440, &maps[1]);
+    tuning_map_from_edo(19, (Pitch){25, 10}, 261.63, &maps[2]);
+    tuning_map_from_fifth(1200 * log2(5) / 4, a4, 440, &maps[3]);
+    int same = 1;
+    for (int t = 0; t < 4; t++) {
+        for (int chroma = -9; chroma <= 9; chroma++) {
+            TonalContext key = context_from_chroma(chroma, chroma & 1 ? MINOR
+                                                                      : MAJOR);
+            // a frequency every cent from 20Hz to 20kHz, plus every
+            // Pitch the search could return exactly
+            for (double hz = 20; hz < 20000; hz *= pow(2, 1 / 1200.0)) {
+                Pitch p, q;
+                double cp, cq;
+                pitch_from_hz(hz, maps[t], &key, &p, &cp);
+                q = from_hz_by_search(hz, maps[t], key.chroma_offset, &cq);
+                same &= pitches_equal(p, q) && fabs(cp - cq) < 1e-6;
+            }
+            for (int w = -5; w < 80; w++) {
+                for (int h = -5; h < 40; h++) {
+                    double hz = to_hz((Pitch){w, h}, maps[t]), cp, cq;
+                    Pitch p, q;
+                    pitch_from_hz(hz, maps[t], &key, &p, &cp);
+                    q = from_hz_by_search(hz, maps[t], key.chroma_offset, &cq);
+                    same &= pitches_equal(p, q);
+                }
+            }
+        }
+    }
+    ASSERT_EQ(same, 1);
+}
+
+void test_pitches_from_hz(void) {
+    Pitch ref;
+    pitch_from_spn("A4", &ref);
+    TuningMap T;
+    tuning_map_from_edo(12, ref, 440, &T);
+
+    double hz[4] = {440, 0, 880, 261.6255653005986};
+    Pitch out[4] = {{0, 0}, {-1, -1}, {0, 0}, {0, 0}};
+    double cents[4];
+    ASSERT_EQ(pitches_from_hz(hz, 4, T, NULL, out, cents), 1);
+
+    char *names[4] = {"A4", NULL, "A5", "C4"};
+    for (int i = 0; i < 4; i++) {
+        if (!names[i])
+            continue;
+        Pitch q;
+        pitch_from_spn(names[i], &q);
+        ASSERT_EQ(pitches_equal(out[i], q), true);
+        ASSERT_EQ(fabs(cents[i]) < 1e-6, true);
+    }
+    // Skipped frames are left alone.
+    ASSERT_EQ(out[1].w, -1);
+}
+
+void test_pitches_to_numbers(void) {
+    char *names[5] = {"C4", "C#4", "Db4", "B3", "C-1"};
+    Pitch arr[5];
+    for (int i = 0; i < 5; i++)
+        pitch_from_spn(names[i], arr + i);
+
+    EDOMap T;
+    create_edo_map(31, &T);
+    int out[5];
+    pitches_to_numbers(arr, 5, T, out);
+    for (int i = 0; i < 5; i++)
+        ASSERT_EQ(out[i], pitch_to_number(arr[i], T));
+    ASSERT_EQ(out[0], 155);
+    ASSERT_EQ(out[4], 0);
+
+    // Enough Pitches for the vector loop and a remainder.
+    Pitch many[203];
+    int numbers[203];
+    for (int i = 0; i < 203; i++)
+        many[i] = (Pitch){i * 7 % 61 - 30, i * 11 % 37 - 18};
+    pitches_to_numbers(many, 203, T, numbers);
+    int same = 1;
+    for (int i = 0; i < 203; i++)
+        same &= numbers[i] == pitch_to_number(many[i], T);
+    ASSERT_EQ(same, 1);
+}
+
+void test_edo_speller(void) {
+    TonalContext key;
+    context_from_str("C", MAJOR, &key);
+    EDOSpeller s;
+    ASSERT_EQ(edo_speller_create(12, key, &s), 0);
+
+    char *c_major[13] = {"C4", "C#4", "D4", "Eb4", "E4",  "F4", "F#4",
+                         "G4", "Ab4", "A4", "Bb4", "B4", "C5"};
+    for (int i = 0; i < 13; i++) {
+        Pitch q;
+        pitch_from_spn(c_major[i], &q);
+        ASSERT_EQ(pitches_equal(pitch_from_number(60 + i, &s), q), true);
+    }
+    Pitch q;
+    pitch_from_spn("B-2", &q);
+    ASSERT_EQ(pitches_equal(pitch_from_number(-1, &s), q), true);
+    pitch_from_spn("C-2", &q);
+    ASSERT_EQ(pitches_equal(pitch_from_number(-12, &s), q), true);
+    // The lowest number still spells a Pitch that numbers back to it.
+    ASSERT_EQ(pitch_to_number(pitch_from_number(INT_MIN, &s), s.map), INT_MIN);
+    ASSERT_EQ(pitch_to_number(pitch_from_number(INT_MAX, &s), s.map), INT_MAX);
+    edo_speller_destroy(&s);
+
+    // Spellings follow the key.
+    context_from_str("E", MAJOR, &key);
+    edo_speller_create(12, key, &s);
+    pitch_from_spn("D#4", &q);
+    ASSERT_EQ(pitches_equal(pitch_from_number(63, &s), q), true);
+    edo_speller_destroy(&s);
+
+    // Every step of 31-EDO round trips through its spelling.
+    context_from_str("C", MAJOR, &key);
+    ASSERT_EQ(edo_speller_create(31, key, &s), 0);
+    int numbers[93];
+    Pitch spelled[93];
+    for (int i = 0; i < 93; i++)
+        numbers[i] = i - 31;
+    pitches_from_numbers(numbers, 93, &s, spelled);
+    int mismatches = 0;
+    for (int i = 0; i < 93; i++)
+        mismatches += pitch_to_number(spelled[i], s.map) != numbers[i];
+    ASSERT_EQ(mismatches, 0);
+    pitch_from_spn("Db4", &q);
+    ASSERT_EQ(pitches_equal(pitch_from_number(158, &s), q), true);
+    pitch_from_spn("C#4", &q);
+    ASSERT_EQ(pitches_equal(pitch_from_number(157, &s), q), true);
+    edo_speller_destroy(&s);
+
+    // 35-EDO's fifth is 7-EDO's, which can't reach most of its steps.
+    ASSERT_EQ(edo_speller_create(35, key, &s), 1);
+    ASSERT_EQ(edo_speller_create(4, key, &s), 1);
+}
+
+void test_edo_catalog_lookup(void) {
+    const EDOCatalogEntry *e = edo_catalog_lookup(12);
+    ASSERT_EQ(e != NULL, true);
+    ASSERT_EQ(e->fifth_steps, 7);
+    ASSERT_EQ(e->map.m0, 2);
+    ASSERT_EQ(e->map.m1, 1);
+    ASSERT_EQ(e->fifth == 700, true);
+    ASSERT_EQ(e->valid, true);
+    ASSERT_EQ(edo_catalog_lookup(4)->valid, false);
+    ASSERT_EQ(edo_catalog_lookup(0) == NULL, true);
+    ASSERT_EQ(edo_catalog_lookup(EDO_CATALOG_MAX + 1) == NULL, true);
+
+    // The generated table must agree with deriving every entry afresh.
+    int mismatches = 0;
+    for (int edo = 1; edo <= EDO_CATALOG_MAX; edo++) {
+        e = edo_catalog_lookup(edo);
+        int fifth_steps = (int)round(log2(1.5) * edo);
+        double fifth = (double)fifth_steps * 1200 / edo;
+        bool valid = fifth >= 1200.0 * 4 / 7 && fifth <= 1200.0 * 3 / 5;
+        mismatches += e->fifth_steps != fifth_steps || e->fifth != fifth ||
+                      e->valid != valid;
+        if (valid)
+            mismatches +=
+                e->map.m0 != ((fifth_steps * 2) % edo + edo) % edo ||
+                e->map.m1 != ((fifth_steps * -5) % edo + edo) % edo;
+    }
+    ASSERT_EQ(mismatches, 0);
+
+    // Beyond the catalog, EDOs are still derived on the fly.
+    EDOMap T;
+    ASSERT_EQ(create_edo_map(1200, &T), 0);
+    ASSERT_EQ(5 * T.m0 + 2 * T.m1, 1200);
+}
+
+void test_cents_matrix(void) {
+    Pitch ref;
+    pitch_from_spn("A4", &ref);
+    // More tunings than fit in one tile.
+    enum { K = 70 };
+    TuningMap T[K];
+    for (int j = 0; j < K; j++)
+        tuning_map_from_fifth(690 + j * 0.4, ref, 440, &T[j]);
+    tuning_map_from_edo(12, ref, 440, &T[0]);
+
+    char *names[4] = {"P5", "M3", "-m6", "A4"};
+    Interval m[4];
+    for (int i = 0; i < 4; i++)
+        interval_from_name(names[i], &m[i]);
+
+    double out[4 * K];
+    cents_matrix(m, NULL, 4, T, K, out);
+    int mismatches = 0;
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < K; j++)
+            mismatches += fabs(out[i * K + j] - to_cents(m[i], T[j])) > 1e-9;
+    ASSERT_EQ(mismatches, 0);
+    ASSERT_EQ((int)round(out[0]), 700);
+    ASSERT_EQ((int)round(out[K]), 400);
+
+    // Deviation from just: the 12-EDO major third is ~13.7 cents sharp.
+    double just[4] = {1200 * log2(1.5), 1200 * log2(1.25),
+                      -1200 * log2(1.6), 1200 * log2(45.0 / 32)};
+    cents_matrix(m, just, 4, T, K, out);
+    ASSERT_EQ((int)round(out[K] * 10), 137);
+    ASSERT_EQ((int)round(out[0] * 10), -20);
+}
+
 void test_map_functions(void) {
     RUN_TESTS(test_map_to_2d);
     RUN_TESTS(test_map_to_1d);
@@ -101,4 +414,12 @@ void test_map_functions(void) {
     RUN_TESTS(test_create_edo_map_rejects_bad_edo);
     RUN_TESTS(test_tuning_map_from_fifth_rejects_bad_fifth);
     RUN_TESTS(test_tuning_map_from_edo_rejects_bad_edo);
+    RUN_TESTS(test_height_map_from_tuning);
+    RUN_TESTS(test_pitch_from_hz);
+    RUN_TESTS(test_pitch_from_hz_matches_search);
+    RUN_TESTS(test_pitches_from_hz);
+    RUN_TESTS(test_pitches_to_numbers);
+    RUN_TESTS(test_edo_speller);
+    RUN_TESTS(test_edo_catalog_lookup);
+    RUN_TESTS(test_cents_matrix);
 }
@@ -0,0 +1,77 @@
+#include "../include/map.h"
+#include "../include/morph.h"
+#include "../include/parse.h"
+#include "test_framework.h"
+#include <math.h>
+
+static TuningMorph edo12_to_meantone(int blocks, int voices) {
+    Pitch a4;
+    pitch_from_spn("A4", &a4);
+    TuningMap from, to;
+    tuning_map_from_edo(12, a4, 440, &from);
+    tuning_map_from_fifth(1200 * log2(5) / 4, a4, 440, &to);
+    TuningMorph m;
+    tuning_morph_create(from, to, blocks, voices, &m);
+    return m;
+}
+
+void test_tuning_morph_create(void) {
+    TuningMap T;
+    tuning_map_from_edo(12, (Pitch){0, 0}, 440, &T);
+    TuningMorph m;
+    ASSERT_EQ(tuning_morph_create(T, T, -1, 4, &m), 1);
+    ASSERT_EQ(tuning_morph_create(T, T, 10, 0, &m), 1);
+    ASSERT_EQ(tuning_morph_create(T, T, 10, 4, &m), 0);
+    ASSERT_EQ(m.hz[0], 0);
+    ASSERT_EQ(tuning_morph_voice_on(&m, 4, (Pitch){0, 0}), 1);
+    ASSERT_EQ(tuning_morph_voice_off(&m, -1), 1);
+    tuning_morph_destroy(&m);
+}
+
+void test_tuning_morph_advance(void) {
+    TuningMorph m = edo12_to_meantone(10, 3);
+    Pitch e5, c5;
+    pitch_from_spn("E5", &e5);
+    pitch_from_spn("C5", &c5);
+    double start = to_hz(e5, m.from), end = to_hz(e5, m.to);
+
+    ASSERT_EQ(tuning_morph_voice_on(&m, 0, e5), 0);
+    ASSERT_EQ(m.hz[0] == start, true);
+
+    double hz[3];
+    for (int i = 0; i < 5; i++)
+        tuning_morph_advance(&m, hz);
+    // Halfway in cents is the geometric mean.
+    ASSERT_EQ(round(hz[0] * 1e6), round(sqrt(start * end) * 1e6));
+    ASSERT_EQ(hz[2], 0);
+
+    // Voices starting mid-morph join at the current position.
+    tuning_morph_voice_on(&m, 1, c5);
+    ASSERT_EQ(round(m.hz[1] * 1e6),
+              round(sqrt(to_hz(c5, m.from) * to_hz(c5, m.to)) * 1e6));
+
+    for (int i = 0; i < 5; i++)
+        tuning_morph_advance(&m, hz);
+    ASSERT_EQ(hz[0] == end, true);
+    ASSERT_EQ(hz[1] == to_hz(c5, m.to), true);
+    tuning_morph_advance(&m, hz);
+    ASSERT_EQ(hz[0] == end, true);
+
+    tuning_morph_voice_off(&m, 0);
+    tuning_morph_advance(&m, hz);
+    ASSERT_EQ(hz[0], 0);
+    tuning_morph_destroy(&m);
+
+    // A morph of 0 blocks is already over.
+    m = edo12_to_meantone(0, 1);
+    tuning_morph_voice_on(&m, 0, e5);
+    ASSERT_EQ(m.hz[0] == end, true);
+    tuning_morph_advance(&m, hz);
+    ASSERT_EQ(hz[0] == end, true);
+    tuning_morph_destroy(&m);
+}
+
+void test_morph_functions(void) {
+    RUN_TESTS(test_tuning_morph_create);
+    RUN_TESTS(test_tuning_morph_advance);
+}
@@ -0,0 +1,82 @@
+#include "../include/optimize.h"
+#include "../include/interval.h"
+#include "test_framework.h"
+#include <math.h>
+
+static void intervals_from_names(char *names[], int len, Interval out[]) {
+    for (int i = 0; i < len; i++)
+        interval_from_name(names[i], out + i);
+}
+
+void test_optimal_fifth(void) {
+    char *names[3] = {"M3", "P5", "P8"};
+    Interval m[3];
+    intervals_from_names(names, 3, m);
+    double just[3] = {1200 * log2(5.0 / 4), 1200 * log2(3.0 / 2), 1200};
+    double fifth, error;
+
+    // Pure major thirds only: quarter-comma meantone.
+    double thirds_only[3] = {1, 0, 0};
+    ASSERT_EQ(optimal_fifth(m, just, thirds_only, 3, LEAST_SQUARES, &fifth,
+                            &error),
+              0);
+    ASSERT_EQ(round(fifth * 1000), round(1200 * log2(5) / 4 * 1000));
+    ASSERT_EQ(round(error * 1000), 0);
+
+    // Pure fifths only: Pythagorean tuning.
+    double fifths_only[3] = {0, 3, 1};
+    ASSERT_EQ(optimal_fifth(m, just, fifths_only, 3, LEAST_SQUARES, &fifth,
+                            NULL),
+              0);
+    ASSERT_EQ(round(fifth * 1000), round(just[1] * 1000));
+
+    // Equal weights pull the fifth most of the way to the thirds, since a
+    // major third is four fifths.
+    ASSERT_EQ(optimal_fifth(m, just, NULL, 3, LEAST_SQUARES, &fifth, &error),
+              0);
+    ASSERT_EQ(round(fifth * 100), 69689);
+
+    // Minimax balances the two errors: F - 701.96 = 2786.31 - 4F.
+    ASSERT_EQ(optimal_fifth(m, just, NULL, 3, MINIMAX, &fifth, &error), 0);
+    ASSERT_EQ(round(fifth * 100), 69765);
+    ASSERT_EQ(round(error * 100), round((just[1] - fifth) * 100));
+
+    // Octaves alone don't depend on the fifth.
+    double octaves_only[3] = {0, 0, 1};
+    ASSERT_EQ(optimal_fifth(m, just, octaves_only, 3, MINIMAX, &fifth, NULL),
+              1);
+}
+
+void test_optimal_edo(void) {
+    char *names[2] = {"M3", "P5"};
+    Interval m[2];
+    intervals_from_names(names, 2, m);
+    double just[2] = {1200 * log2(5.0 / 4), 1200 * log2(3.0 / 2)};
+    int edo;
+    double error;
+
+    ASSERT_EQ(optimal_edo(m, just, NULL, 2, 5, 30, LEAST_SQUARES, &edo,
+                          &error),
+              0);
+    ASSERT_EQ(edo, 19);
+    // 43-EDO's fifth is within 0.02 cents of the minimax fifth.
+    ASSERT_EQ(optimal_edo(m, just, NULL, 2, 1, 60, MINIMAX, &edo, &error), 0);
+    ASSERT_EQ(edo, 43);
+
+    // Thirds only: 31-EDO is the closest to quarter-comma meantone below 40.
+    double thirds_only[2] = {1, 0};
+    ASSERT_EQ(optimal_edo(m, just, thirds_only, 2, 1, 40, MINIMAX, &edo,
+                          &error),
+              0);
+    ASSERT_EQ(edo, 31);
+
+    // EDOs below 5 have no diatonic scale, so there's nothing to choose from.
+    ASSERT_EQ(optimal_edo(m, just, NULL, 2, 1, 4, LEAST_SQUARES, &edo,
+                          &error),
+              1);
+}
+
+void test_optimize_functions(void) {
+    RUN_TESTS(test_optimal_fifth);
+    RUN_TESTS(test_optimal_edo);
+}
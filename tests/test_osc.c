@@ -0,0 +1,91 @@
+#include "../include/map.h"
+#include "../include/osc.h"
+#include "../include/parse.h"
+#include "test_framework.h"
+#include <math.h>
+
+static OscBank a440_bank(int voices) {
+    Pitch a4;
+    pitch_from_spn("A4", &a4);
+    TuningMap T;
+    tuning_map_from_edo(12, a4, 440, &T);
+    OscBank b;
+    osc_bank_create(T, 44100, voices, &b);
+    return b;
+}
+
+void test_osc_bank_create(void) {
+    TuningMap T;
+    tuning_map_from_edo(12, (Pitch){0, 0}, 440, &T);
+    OscBank b;
+    ASSERT_EQ(osc_bank_create(T, 44100, 0, &b), 1);
+    ASSERT_EQ(osc_bank_create(T, 0, 4, &b), 1);
+    ASSERT_EQ(osc_bank_create(T, INFINITY, 4, &b), 1);
+    ASSERT_EQ(osc_bank_create(T, 44100, 4, &b), 0);
+    ASSERT_EQ(b.len, 4);
+    ASSERT_EQ(b.inc[3], 0);
+    osc_bank_destroy(&b);
+}
+
+void test_osc_bank_set(void) {
+    OscBank b = a440_bank(2);
+    Pitch a4, e5;
+    pitch_from_spn("A4", &a4);
+    pitch_from_spn("E5", &e5);
+    ASSERT_EQ(osc_bank_set(&b, 0, a4), 0);
+    ASSERT_EQ(osc_bank_set(&b, 2, a4), 1);
+    ASSERT_EQ(osc_bank_set(&b, -1, a4), 1);
+    // Gliding from silence jumps.
+    ASSERT_EQ(osc_bank_glide(&b, 1, e5, 100), 0);
+
+    double out[8];
+    osc_bank_render(&b, 4, out);
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQ(out[2 * i] == 440.0 / 44100, true);
+        ASSERT_EQ(round(out[2 * i + 1] * 44100 * 1000), 659255);
+    }
+    osc_bank_destroy(&b);
+}
+
+void test_osc_bank_glide(void) {
+    OscBank b = a440_bank(3);
+    Pitch a4, a5, e5;
+    pitch_from_spn("A4", &a4);
+    pitch_from_spn("A5", &a5);
+    pitch_from_spn("E5", &e5);
+    osc_bank_set(&b, 0, a4);
+    osc_bank_set(&b, 1, a5);
+    osc_bank_set(&b, 2, a4);
+    osc_bank_glide(&b, 0, a5, 100);
+    osc_bank_glide(&b, 1, a4, 30);
+
+    // Render in blocks that don't line up with either glide.
+    double out[3 * 128];
+    osc_bank_render(&b, 64, out);
+    osc_bank_render(&b, 64, out + 3 * 64);
+
+    // Linear in cents along the way, exactly on target at the end.
+    ASSERT_EQ(round(out[3 * 49] * 44100 * 1000),
+              round(440 * pow(2, 50.0 / 100) * 1000));
+    ASSERT_EQ(out[3 * 99] == 880.0 / 44100, true);
+    ASSERT_EQ(out[3 * 127] == 880.0 / 44100, true);
+    ASSERT_EQ(out[3 * 29 + 1] == 440.0 / 44100, true);
+    ASSERT_EQ(out[3 * 127 + 1] == 440.0 / 44100, true);
+    for (int i = 0; i < 128; i++)
+        ASSERT_EQ(out[3 * i + 2] == 440.0 / 44100, true);
+
+    // A new glide starts from wherever the voice has got to.
+    osc_bank_glide(&b, 2, e5, 10);
+    osc_bank_glide(&b, 2, a5, 10);
+    osc_bank_render(&b, 10, out);
+    ASSERT_EQ(round(out[3 * 4 + 2] * 44100 * 1000),
+              round(440 * pow(2, 5.0 / 10) * 1000));
+    ASSERT_EQ(out[3 * 9 + 2] == 880.0 / 44100, true);
+    osc_bank_destroy(&b);
+}
+
+void test_osc_functions(void) {
+    RUN_TESTS(test_osc_bank_create);
+    RUN_TESTS(test_osc_bank_set);
+    RUN_TESTS(test_osc_bank_glide);
+}
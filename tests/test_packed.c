@@ -0,0 +1,144 @@
+#include "../include/buffer.h"
+#include "../include/interval.h"
+#include "../include/packed.h"
+#include "../include/pitch.h"
+#include "test_framework.h"
+
+// Whole and half steps to try in each lane, including both ends of the range.
+static const int steps[] = {-32768, -32767, -1000, -7, -1, 0,
+                            1,      6,      999,   32766, 32767};
+enum { STEPS = sizeof(steps) / sizeof(steps[0]) };
+
+// Wraps x into -32768 to 32767, as int16_t arithmetic does.
+static int wrap16(int x) { return ((x + 32768) & 0xffff) - 32768; }
+
+void test_pitch16_round_trip(void) {
+    int same = 1;
+    for (int i = 0; i < STEPS; i++) {
+        for (int j = 0; j < STEPS; j++) {
+            Pitch p = {steps[i], steps[j]};
+            Pitch16 x = 0;
+            same &= pitch16_from_pitch(p, &x) == 0;
+            same &= pitches_equal(pitch16_to_pitch(x), p);
+        }
+    }
+    ASSERT_EQ(same, 1);
+
+    Pitch16 x = 0;
+    ASSERT_EQ(pitch16_from_pitch((Pitch){32768, 0}, &x), 1);
+    ASSERT_EQ(pitch16_from_pitch((Pitch){0, -32769}, &x), 1);
+    ASSERT_EQ(x, 0);
+    ASSERT_EQ(pitch16_from_pitch((Pitch){25, 10}, &x), 0);
+    ASSERT_EQ(x, 10 << 16 | 25);
+}
+
+void test_pitch16_arithmetic(void) {
+    int same = 1;
+    for (int i = 0; i < STEPS * STEPS; i++) {
+        for (int j = 0; j < STEPS * STEPS; j++) {
+            Pitch p = {steps[i / STEPS], steps[i % STEPS]};
+            Pitch q = {steps[j % STEPS], steps[j / STEPS]};
+            Pitch16 x = 0, y = 0;
+            pitch16_from_pitch(p, &x);
+            pitch16_from_pitch(q, &y);
+
+            Pitch sum = pitch16_to_pitch(pitch16_transpose(x, y));
+            same &= sum.w == wrap16(p.w + q.w) && sum.h == wrap16(p.h + q.h);
+            Pitch diff = pitch16_to_pitch(pitch16_interval(x, y));
+            same &= diff.w == wrap16(q.w - p.w) && diff.h == wrap16(q.h - p.h);
+            Pitch inv = pitch16_to_pitch(pitch16_invert(x, y));
+            same &= pitches_equal(inv, diff);
+        }
+    }
+    ASSERT_EQ(same, 1);
+}
+
+void test_pitch16_classifiers(void) {
+    int same = 1;
+    for (int w = -32768; w <= 32767; w += 7) {
+        for (int h = -32768; h <= 32767; h += 257) {
+            Pitch p = {w, h};
+            Pitch16 x = 0;
+            pitch16_from_pitch(p, &x);
+            same &= pitch16_chroma(x) == pitch_chroma(p);
+            same &= pitch16_letter(x) == pitch_letter(p);
+            same &= pitch16_accidental(x) == pitch_accidental(p);
+            same &= pitch16_octave(x) == pitch_octave(p);
+            same &= pitch16_midi(x) == pitch_midi(p);
+        }
+    }
+    ASSERT_EQ(same, 1);
+}
+
+void test_pitch16_batch(void) {
+    enum { LEN = 100 };
+    Pitch arr[LEN + 1], back[LEN];
+    Pitch16 packed[LEN + 1], moved[LEN], between[LEN];
+    for (int i = 0; i < LEN; i++)
+        arr[i] = (Pitch){i * 13 - 600, 300 - i * 7};
+    arr[LEN] = (Pitch){40000, 0};
+
+    ASSERT_EQ(pitches_to_pitch16(arr, LEN + 1, packed), 1);
+    pitches_from_pitch16(packed, LEN, back);
+    int same = 1;
+    for (int i = 0; i < LEN; i++)
+        same &= pitches_equal(back[i], arr[i]);
+    ASSERT_EQ(same, 1);
+
+    Interval m = {3, -2};
+    Pitch16 m16 = 0;
+    pitch16_from_pitch(m, &m16);
+    for (int i = 0; i < LEN; i++)
+        moved[i] = packed[i];
+    pitches16_transpose(moved, LEN, m16);
+    pitches16_intervals(packed, moved, LEN, between);
+    same = 1;
+    for (int i = 0; i < LEN; i++) {
+        same &= pitches_equal(pitch16_to_pitch(moved[i]),
+                              transpose_real(arr[i], m));
+        same &= pitches_equal(pitch16_to_pitch(between[i]), m);
+    }
+    ASSERT_EQ(same, 1);
+
+    StandardPitch standard[LEN];
+    pitches16_to_standard(packed, LEN, standard);
+    same = 1;
+    for (int i = 0; i < LEN; i++) {
+        StandardPitch s = pitch_to_standard(arr[i]);
+        same &= standard[i].letter == s.letter &&
+                standard[i].accidental == s.accidental &&
+                standard[i].octave == s.octave;
+    }
+    ASSERT_EQ(same, 1);
+}
+
+void test_pitch16_buffer(void) {
+    enum { LEN = 50 };
+    Pitch16 packed[LEN], out[LEN];
+    for (int i = 0; i < LEN; i++)
+        pitch16_from_pitch((Pitch){i - 25, 2 * i - 30000}, &packed[i]);
+
+    PitchBuffer b;
+    pitch_buffer_create(LEN, &b);
+    ASSERT_EQ(pitch_buffer_from_pitch16(&b, packed, LEN + 1), 1);
+    ASSERT_EQ(pitch_buffer_from_pitch16(&b, packed, LEN), 0);
+    ASSERT_EQ(b.len, LEN);
+    ASSERT_EQ(b.h[0], -30000);
+    ASSERT_EQ(pitch_buffer_to_pitch16(&b, out), 0);
+    int same = 1;
+    for (int i = 0; i < LEN; i++)
+        same &= out[i] == packed[i];
+    ASSERT_EQ(same, 1);
+
+    pitch_buffer_transpose(&b, (Interval){0, -2771});
+    ASSERT_EQ(pitch_buffer_to_pitch16(&b, out), 2); // h of -32771 and -32769
+    pitch_buffer_destroy(&b);
+}
+
+void test_packed_functions(void) {
+    RUN_TESTS(test_pitch16_round_trip);
+    RUN_TESTS(test_pitch16_arithmetic);
+    RUN_TESTS(test_pitch16_classifiers);
+    RUN_TESTS(test_pitch16_batch);
+    RUN_TESTS(test_pitch16_buffer);
+}
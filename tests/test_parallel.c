@@ -0,0 +1,46 @@
+#include "../include/parallel.h"
+#include "test_framework.h"
+
+typedef struct {
+    int hits[1000];
+    long start[64], end[64];
+} Coverage;
+
+static void cover(void *ctx, int chunk, long start, long end) {
+    Coverage *c = ctx;
+    c->start[chunk] = start;
+    c->end[chunk] = end;
+    for (long i = start; i < end; i++)
+        c->hits[i]++;
+}
+
+void test_parallel_chunks(void) {
+    int threads = parallel_threads();
+    ASSERT_EQ(threads >= 1 && threads <= 64, 1);
+    ASSERT_EQ(parallel_chunks(0, 10), 1);
+    ASSERT_EQ(parallel_chunks(9, 10), 1);
+    ASSERT_EQ(parallel_chunks(20, 10), threads < 2 ? threads : 2);
+    ASSERT_EQ(parallel_chunks(1L << 30, 1), threads);
+}
+
+void test_parallel_for(void) {
+    // Every item is visited exactly once, by contiguous chunks in order.
+    static Coverage c;
+    for (long len = 0; len <= 1000; len += 37) {
+        c = (Coverage){0};
+        int n = parallel_chunks(len, 3);
+        parallel_for(len, 3, cover, &c);
+        int same = 1;
+        for (long i = 0; i < len; i++)
+            same &= c.hits[i] == 1;
+        same &= c.start[0] == 0 && c.end[n - 1] == len;
+        for (int i = 1; i < n; i++)
+            same &= c.start[i] == c.end[i - 1] && c.start[i] < c.end[i];
+        ASSERT_EQ(same, 1);
+    }
+}
+
+void test_parallel_functions(void) {
+    RUN_TESTS(test_parallel_chunks);
+    RUN_TESTS(test_parallel_for);
+}
@@ -1,5 +1,6 @@
 
 #include "../include/parse.h"
+#include "../include/pitch.h"
 #include "test_framework.h"
 #include <stdio.h>
 
@@ -122,6 +123,24 @@ void test_pitch_from_relative_lily(void) {
     pitch_from_relative_lily(&ctx, "c'", &out); // back to middle c
     ASSERT_EQ(out.w, 25);
     ASSERT_EQ(out.h, 10);
+
+    // However far away the previous note is, every letter lands within a 4th
+    // of it, in one step.
+    const char *names[] = {"ceses", "des", "e", "fis", "gisis", "a", "b"};
+    int near = 1;
+    for (int octave = -1000; octave <= 1000; octave += 37) {
+        for (int i = 0; i < 7; i++) {
+            Pitch q;
+            pitch_from_lily(names[i], &q);
+            ctx.previous = (Pitch){p.w + 5 * octave + i, p.h + 2 * octave};
+            pitch_from_relative_lily(&ctx, names[i], &out);
+            int steps = steps_between(out, (Pitch){p.w + 5 * octave + i,
+                                                   p.h + 2 * octave});
+            near &= -3 <= steps && steps <= 3;
+            near &= pitch_chroma(out) == pitch_chroma(q);
+        }
+    }
+    ASSERT_EQ(near, 1);
 }
 
 void test_pitch_from_helmholtz(void) {
@@ -239,6 +258,16 @@ void test_pitch_spn(void) {
     flagged = pitch_spn(p, buf);
     ASSERT_STR_EQ(buf, "ERR");
     ASSERT_EQ(flagged, true);
+
+    // Chromas and step counts at negative multiples of 7 round-trip: these
+    // once came back as "Fbb4", "Fbbb4" and "C-3".
+    const char *edges[] = {"Fb4", "Fbb4", "C-2", "Fb-2", "Cb-1", "Fb-9"};
+    for (int i = 0; i < 6; i++) {
+        pitch_from_spn(edges[i], &p);
+        flagged = pitch_spn(p, buf);
+        ASSERT_STR_EQ(buf, edges[i]);
+        ASSERT_EQ(flagged, false);
+    }
 }
 
 void test_pitch_lily(void) {
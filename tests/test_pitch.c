@@ -96,6 +96,11 @@ void test_pitch_accidental(void) {
     ASSERT_EQ(pitch_accidental(p), 3);
     pitch_from_spn("Cbbbb5", &p);
     ASSERT_EQ(pitch_accidental(p), -4);
+    // Chromas one below a multiple of 7.
+    pitch_from_spn("Fb4", &p);
+    ASSERT_EQ(pitch_accidental(p), -1);
+    pitch_from_spn("Fbb4", &p);
+    ASSERT_EQ(pitch_accidental(p), -2);
 }
 
 void test_pitch_octave(void) {
@@ -110,6 +115,11 @@ void test_pitch_octave(void) {
     ASSERT_EQ(pitch_octave(p), 6);
     pitch_from_spn("G-9", &p);
     ASSERT_EQ(pitch_octave(p), -9);
+    // Step counts that are negative multiples of 7.
+    pitch_from_spn("C-2", &p);
+    ASSERT_EQ(pitch_octave(p), -2);
+    pitch_from_spn("C-3", &p);
+    ASSERT_EQ(pitch_octave(p), -3);
 }
 
 void test_pitch_to_standard(void) {
@@ -142,6 +152,42 @@ void test_pitch_from_chroma(void) {
     p = pitch_from_chroma(4, 4);
     ASSERT_EQ(p.w, 27);
     ASSERT_EQ(p.h, 10);
+
+    // far from C4 it takes no longer, and lands in the same place as stepping
+    // octave by octave would
+    p = pitch_from_chroma(-1000, 100000);
+    ASSERT_EQ(pitch_octave(p), 100000);
+    ASSERT_EQ(pitch_chroma(p), -1000);
+    int same = 1;
+    for (int chroma = -50; chroma <= 50; chroma++) {
+        for (int octave = -30; octave <= 30; octave++) {
+            Pitch q = {chroma * 3, chroma};
+            while (pitch_octave(q) > octave)
+                q = (Pitch){q.w - 5, q.h - 2};
+            while (pitch_octave(q) < octave)
+                q = (Pitch){q.w + 5, q.h + 2};
+            same &= pitches_equal(pitch_from_chroma(chroma, octave), q);
+        }
+    }
+    ASSERT_EQ(same, 1);
+}
+
+void test_pitches_from_intervals(void) {
+    // C4 D4 E4 C4 G3
+    Interval steps[5] = {{0, 0}, {1, 0}, {1, 0}, {-2, 0}, {-2, -1}};
+    Pitch melody[5];
+    Pitch last = pitches_from_intervals((Pitch){25, 10}, steps, 5, melody);
+    ASSERT_EQ(pitches_equal(melody[0], (Pitch){25, 10}), 1);
+    ASSERT_EQ(pitches_equal(melody[2], (Pitch){27, 10}), 1);
+    ASSERT_EQ(pitches_equal(melody[4], (Pitch){23, 9}), 1);
+    ASSERT_EQ(pitches_equal(last, melody[4]), 1);
+    ASSERT_EQ(pitches_equal(intervals_sum(steps, 5), (Interval){-2, -1}), 1);
+
+    intervals_from_pitches((Pitch){25, 10}, melody, 5, melody);
+    int same = 1;
+    for (int i = 0; i < 5; i++)
+        same &= pitches_equal(melody[i], steps[i]);
+    ASSERT_EQ(same, 1);
 }
 
 void test_pitch_audible(void) {
@@ -264,6 +310,163 @@ void test_pitch_nearest(void) {
     ASSERT_EQ(pitches_equal(q, nearest), true);
 }
 
+void test_pitch_height(void) {
+    Pitch reference;
+    pitch_from_spn("A4", &reference);
+    TuningMap T;
+    tuning_map_from_edo(12, reference, 440, &T);
+    HeightMap H = height_map_from_tuning(T);
+
+    Pitch p, q;
+    pitch_from_spn("C4", &p);
+    ASSERT_EQ(pitch_height(p, H), 60);
+    pitch_from_spn("C#4", &p);
+    pitch_from_spn("Db4", &q);
+    ASSERT_EQ(pitch_height(p, H) == pitch_height(q, H), true);
+
+    tuning_map_from_edo(31, reference, 440, &T);
+    H = height_map_from_tuning(T);
+    ASSERT_EQ(pitch_height(p, H) < pitch_height(q, H), true);
+    pitch_from_spn("Ex4", &p);
+    pitch_from_spn("Gbb4", &q);
+    ASSERT_EQ(pitch_height(p, H) == pitch_height(q, H), true);
+
+    // 1/4-comma meantone isn't an EDO, so nothing is enharmonic.
+    tuning_map_from_fifth(696.5784284662087, reference, 440, &T);
+    H = height_map_from_tuning(T);
+    ASSERT_EQ(pitch_height(p, H) < pitch_height(q, H), true);
+}
+
+void test_pitches_compare_height(void) {
+    Pitch reference;
+    pitch_from_spn("A4", &reference);
+    TuningMap T;
+    tuning_map_from_edo(12, reference, 440, &T);
+    HeightMap H = height_map_from_tuning(T);
+
+    Pitch p, q;
+    pitch_from_spn("D4", &p);
+    pitch_from_spn("C4", &q);
+    ASSERT_EQ(pitches_compare_height(p, q, H), 1);
+    ASSERT_EQ(pitches_compare_height(q, p, H), -1);
+    ASSERT_EQ(pitches_compare_height(p, p, H), 0);
+
+    // Enharmonic ties are settled by diatonic steps.
+    pitch_from_spn("C#4", &p);
+    pitch_from_spn("Db4", &q);
+    ASSERT_EQ(pitches_compare_height(p, q, H), -1);
+    ASSERT_EQ(pitches_compare_height(q, p, H), 1);
+}
+
+void test_pitch_highest_lowest_index(void) {
+    char *names[10] = {"B#3", "C4", "D4",  "D#4", "Eb4",
+                       "E4",  "F4", "Ex4", "F#4", "Gb4"};
+    Pitch arr[10];
+    for (int i = 0; i < 10; i++) {
+        pitch_from_spn(names[i], arr + i);
+    }
+
+    Pitch reference;
+    pitch_from_spn("A4", &reference);
+    TuningMap T;
+    tuning_map_from_edo(12, reference, 440, &T);
+    HeightMap H = height_map_from_tuning(T);
+    ASSERT_EQ(pitch_highest_index(arr, 10, H), 9);
+    ASSERT_EQ(pitch_lowest_index(arr, 10, H), 0);
+
+    // D#4/Eb4 tie in 12-EDO, but D#4 sits above Eb4 in 53-EDO.
+    Pitch pair[2] = {arr[4], arr[3]};
+    ASSERT_EQ(pitch_highest_index(pair, 2, H), 0);
+    ASSERT_EQ(pitch_lowest_index(pair, 2, H), 1);
+    tuning_map_from_edo(53, reference, 440, &T);
+    H = height_map_from_tuning(T);
+    ASSERT_EQ(pitch_highest_index(pair, 2, H), 1);
+    ASSERT_EQ(pitch_lowest_index(pair, 2, H), 0);
+
+    // Identical Pitches resolve to the first occurrence.
+    Pitch same[3] = {arr[2], arr[2], arr[2]};
+    ASSERT_EQ(pitch_highest_index(same, 3, H), 0);
+    ASSERT_EQ(pitch_lowest_index(same, 3, H), 0);
+    ASSERT_EQ(pitch_highest_index(same, 0, H), -1);
+}
+
+void test_pitch_sort(void) {
+    char *names[8] = {"F#4", "C4", "Gb4", "Eb4", "C5", "D#4", "B3", "E4"};
+    char *sorted[8] = {"B3", "C4", "D#4", "Eb4", "E4", "F#4", "Gb4", "C5"};
+    Pitch arr[8];
+    for (int i = 0; i < 8; i++) {
+        pitch_from_spn(names[i], arr + i);
+    }
+
+    Pitch reference;
+    pitch_from_spn("A4", &reference);
+    TuningMap T;
+    tuning_map_from_edo(12, reference, 440, &T);
+    HeightMap H = height_map_from_tuning(T);
+
+    int idx[8];
+    pitch_argsort(arr, 8, H, idx);
+    pitch_sort(arr, 8, H);
+    for (int i = 0; i < 8; i++) {
+        Pitch p;
+        pitch_from_spn(sorted[i], &p);
+        ASSERT_EQ(pitches_equal(arr[i], p), true);
+        ASSERT_STR_EQ(names[idx[i]], sorted[i]);
+    }
+}
+
+void test_nearest_index(void) {
+    char *names[10] = {"B#3", "C4", "D4",  "D#4", "Eb4",
+                       "E4",  "F4", "Ex4", "F#4", "Gb4"};
+    Pitch arr[10];
+    for (int i = 0; i < 10; i++) {
+        pitch_from_spn(names[i], arr + i);
+    }
+
+    Pitch reference;
+    pitch_from_spn("A4", &reference);
+    TuningMap T;
+    tuning_map_from_edo(12, reference, 440, &T);
+
+    NearestIndex ix;
+    ASSERT_EQ(nearest_index_create(arr, 0, T, &ix), 1);
+    ASSERT_EQ(nearest_index_create(arr, 10, T, &ix), 0);
+    Pitch p;
+    pitch_from_spn("Gbb4", &p);
+    ASSERT_EQ(nearest_index_query(&ix, p), 6);
+    pitch_from_spn("C2", &p);
+    ASSERT_EQ(nearest_index_query(&ix, p), 0);
+    pitch_from_spn("C7", &p);
+    ASSERT_EQ(nearest_index_query(&ix, p), 9);
+    nearest_index_destroy(&ix);
+    ASSERT_EQ(nearest_index_query(&ix, p), -1);
+
+    tuning_map_from_edo(31, reference, 440, &T);
+    nearest_index_create(arr, 10, T, &ix);
+    pitch_from_spn("Gbb4", &p);
+    ASSERT_EQ(nearest_index_query(&ix, p), 7);
+    nearest_index_destroy(&ix);
+
+    // Agrees with pitch_nearest everywhere, including equidistant and
+    // enharmonic ties, in EDO and non-EDO tunings alike.
+    double fifths[3] = {700, 1200.0 * 18 / 31, 696.5784284662087};
+    for (int t = 0; t < 3; t++) {
+        tuning_map_from_fifth(fifths[t], reference, 440, &T);
+        nearest_index_create(arr, 10, T, &ix);
+        int mismatches = 0;
+        for (int w = 20; w < 32; w++) {
+            for (int h = 5; h < 15; h++) {
+                Pitch q = {w, h};
+                Pitch expected = pitch_nearest(q, arr, 10, T);
+                Pitch found = arr[nearest_index_query(&ix, q)];
+                mismatches += !pitches_equal(expected, found);
+            }
+        }
+        ASSERT_EQ(mismatches, 0);
+        nearest_index_destroy(&ix);
+    }
+}
+
 void test_pitch_functions(void) {
     RUN_TESTS(test_pitch_chroma);
     RUN_TESTS(test_steps_between);
@@ -276,9 +479,15 @@ void test_pitch_functions(void) {
     RUN_TESTS(test_pitch_to_standard);
     RUN_TESTS(test_pitch_from_standard);
     RUN_TESTS(test_pitch_from_chroma);
+    RUN_TESTS(test_pitches_from_intervals);
     RUN_TESTS(test_pitch_audible);
     RUN_TESTS(test_pitch_invert);
     RUN_TESTS(test_pitch_highest);
     RUN_TESTS(test_pitch_lowest);
     RUN_TESTS(test_pitch_nearest);
+    RUN_TESTS(test_pitch_height);
+    RUN_TESTS(test_pitches_compare_height);
+    RUN_TESTS(test_pitch_highest_lowest_index);
+    RUN_TESTS(test_pitch_sort);
+    RUN_TESTS(test_nearest_index);
 }
@@ -0,0 +1,202 @@
+#include "../include/buffer.h"
+#include "../include/constants.h"
+#include "../include/map.h"
+#include "../include/pitch.h"
+#include "../include/range.h"
+#include "test_framework.h"
+#include <math.h>
+
+// Every Pitch in a rectangle of the lattice from about C-4 to C12, with many
+// sharps and flats, which runs off both ends of the audible range.
+enum { GRID = 128 * 64 };
+static Pitch grid[GRID];
+
+static void fill_grid(void) {
+    int n = 0;
+    for (int w = -40; w < 88; w++)
+        for (int h = -16; h < 48; h++)
+            grid[n++] = (Pitch){w, h};
+}
+
+void test_pitch_range_audible(void) {
+    fill_grid();
+    Pitch c4 = {25, 10}, a4 = {29, 11};
+    TuningMap maps[5];
+    tuning_map_from_edo(12, c4, CONCERT_C4, &maps[0]);
+    tuning_map_from_edo(31, a4, 440, &maps[1]);
+    tuning_map_from_edo(53, (Pitch){0, 0}, 16.0, &maps[2]);
+    // 696.578 is close enough to 789-EDO to get its heights, while true
+    // quarter-comma meantone gets fixed-point ones.
+    tuning_map_from_fifth(696.578, a4, 440, &maps[3]);
+    tuning_map_from_fifth(1200 * log2(5) / 4, a4, 440, &maps[4]);
+    for (int t = 0; t < 5; t++) {
+        PitchRange r = pitch_range_audible(maps[t]);
+        int same = 1, count = 0;
+        for (int i = 0; i < GRID; i++) {
+            bool audible = pitch_audible(grid[i], maps[t]);
+            same &= pitch_in_range(grid[i], r) == audible;
+            count += audible;
+        }
+        ASSERT_EQ(same, 1);
+        bool in[GRID];
+        ASSERT_EQ(pitches_in_range(grid, GRID, r, in), count);
+        ASSERT_EQ(count > 0 && count < GRID, 1);
+        ASSERT_EQ(pitch_in_range(a4, r), 1);
+    }
+}
+
+void test_pitch_range_from_hz(void) {
+    TuningMap T;
+    tuning_map_from_edo(12, (Pitch){29, 11}, 440, &T);
+    PitchRange r;
+    ASSERT_EQ(pitch_range_from_hz(0, 440, T, &r), 1);
+    ASSERT_EQ(pitch_range_from_hz(440, 220, T, &r), 1);
+    ASSERT_EQ(pitch_range_from_hz(NAN, 440, T, &r), 1);
+    ASSERT_EQ(pitch_range_from_hz(220, INFINITY, T, &r), 1);
+
+    // Bounds landing exactly on a Pitch include it, and its enharmonics.
+    ASSERT_EQ(pitch_range_from_hz(220, 440, T, &r), 0);
+    ASSERT_EQ(pitch_in_range((Pitch){24, 9}, r), 1);  // A3
+    ASSERT_EQ(pitch_in_range((Pitch){29, 11}, r), 1); // A4
+    ASSERT_EQ(pitch_in_range((Pitch){30, 9}, r), 1);  // G##4
+    ASSERT_EQ(pitch_in_range((Pitch){28, 13}, r), 1); // Bbb4
+    ASSERT_EQ(pitch_in_range((Pitch){29, 12}, r), 0); // Bb4
+    ASSERT_EQ(pitch_in_range((Pitch){23, 10}, r), 0); // Ab3
+
+    // A range too narrow to hold any Pitch.
+    ASSERT_EQ(pitch_range_from_hz(441, 442, T, &r), 0);
+    ASSERT_EQ(r.lo > r.hi, 1);
+    ASSERT_EQ(pitch_in_range((Pitch){29, 11}, r), 0);
+}
+
+void test_pitch_range_filter(void) {
+    fill_grid();
+    TuningMap T;
+    tuning_map_from_fifth(697, (Pitch){29, 11}, 440, &T);
+    Pitch lo = {22, 8}, hi = {32, 12}; // E3 to E5
+    PitchRange r = pitch_range_from_pitches(lo, hi, T);
+    ASSERT_EQ(pitch_in_range(lo, r), 1);
+    ASSERT_EQ(pitch_in_range(hi, r), 1);
+    ASSERT_EQ(pitch_in_range((Pitch){21, 9}, r), 0);  // Eb3
+    ASSERT_EQ(pitch_in_range((Pitch){33, 11}, r), 0); // E#5
+
+    static Pitch arr[GRID];
+    static bool in[GRID];
+    int count = pitches_in_range(grid, GRID, r, in);
+    for (int i = 0; i < GRID; i++)
+        arr[i] = grid[i];
+    ASSERT_EQ(pitches_filter_range(arr, GRID, r, arr), count);
+    int same = 1;
+    for (int i = 0, j = 0; i < GRID; i++) {
+        double f = to_hz(grid[i], T);
+        same &= in[i] == (f >= to_hz(lo, T) && f <= to_hz(hi, T));
+        if (in[i])
+            same &= pitches_equal(arr[j++], grid[i]);
+    }
+    ASSERT_EQ(same, 1);
+
+    // Only the Pitches in range are written, so out can be sized to fit them:
+    // the Pitch after the one kept is left alone.
+    PitchRange a4 =
+        pitch_range_from_pitches((Pitch){29, 11}, (Pitch){29, 11}, T);
+    Pitch only[2] = {{29, 11}, {5, 2}}; // A4, C0
+    Pitch kept[2] = {{0, 0}, {-1, -1}};
+    ASSERT_EQ(pitches_filter_range(only, 2, a4, kept), 1);
+    ASSERT_EQ(pitches_equal(kept[0], (Pitch){29, 11}), 1);
+    ASSERT_EQ(pitches_equal(kept[1], (Pitch){-1, -1}), 1);
+
+    // The buffer versions agree, on both the AVX2 and scalar paths.
+    PitchBuffer b;
+    static bool bin[GRID];
+    pitch_buffer_create(GRID, &b);
+    pitch_buffer_from_pitches(&b, grid, GRID);
+    ASSERT_EQ(pitch_buffer_in_range(&b, r, bin), count);
+    same = 1;
+    for (int i = 0; i < GRID; i++)
+        same &= bin[i] == in[i];
+    ASSERT_EQ(same, 1);
+    ASSERT_EQ(pitch_buffer_filter_range(&b, r), count);
+    ASSERT_EQ(b.len, count);
+    same = 1;
+    for (int i = 0; i < count; i++)
+        same &= pitches_equal((Pitch){b.w[i], b.h[i]}, arr[i]);
+    ASSERT_EQ(same, 1);
+
+    PitchRange wide = r;
+    wide.H.m0 = (long long)1 << 40;
+    wide.lo = wide.hi = ((long long)1 << 40) * 25 + wide.H.m1 * 10;
+    pitch_buffer_from_pitches(&b, grid, GRID);
+    ASSERT_EQ(pitch_buffer_in_range(&b, wide, bin), 1);
+    pitch_buffer_destroy(&b);
+}
+
+// The brute-force listing pitch_range_spellings replaces: every Pitch in a
+// rectangle of the lattice, filtered by to_hz and sorted.
+static int spellings_by_search(double lo_hz, double hi_hz, TuningMap T, int k,
+                               Pitch out[]) {
+    int len = 0;
+    for (int w = -100; w < 200; w++)
+        for (int h = -100; h < 200; h++) {
+            Pitch p = {w, h};
+            int accidental = pitch_accidental(p);
+            double f = to_hz(p, T);
+            if (accidental >= -k && accidental <= k && f >= lo_hz && f <= hi_hz)
+                out[len++] = p;
+        }
+    pitch_sort(out, len, height_map_from_tuning(T));
+    return len;
+}
+
+void test_pitch_range_spellings(void) {
+    static Pitch expected[4096], out[4096];
+    Pitch a4 = {29, 11};
+    TuningMap maps[4];
+    tuning_map_from_edo(12, a4, 440, &maps[0]);
+    tuning_map_from_edo(31, a4, 440, &maps[1]);
+    tuning_map_from_fifth(696.578, a4, 440, &maps[2]);
+    tuning_map_from_fifth(1200 * log2(5) / 4, a4, 440, &maps[3]);
+    int total;
+    for (int t = 0; t < 4; t++)
+        for (int k = 0; k < 4; k++) {
+            PitchRange r;
+            double lo = 100 + 37 * k, hi = 3000;
+            pitch_range_from_hz(lo, hi, maps[t], &r);
+            int len = spellings_by_search(lo, hi, maps[t], k, expected);
+            ASSERT_EQ(pitch_range_spellings(r, k, out, 4096, &total), 0);
+            ASSERT_EQ(total, len);
+            int same = 1;
+            for (int i = 0; i < len; i++)
+                same &= pitches_equal(out[i], expected[i]);
+            ASSERT_EQ(same, 1);
+        }
+
+    // The first octave of C4 to C6 in 12-EDO, with no accidentals allowed.
+    PitchRange r = pitch_range_from_pitches((Pitch){25, 10}, (Pitch){35, 14},
+                                            maps[0]);
+    ASSERT_EQ(pitch_range_spellings(r, 0, out, 7, &total), 0);
+    ASSERT_EQ(total, 15);
+    ASSERT_EQ(pitches_equal(out[0], (Pitch){25, 10}), 1); // C4
+    ASSERT_EQ(pitches_equal(out[6], (Pitch){30, 11}), 1); // B4
+
+    // Single sharps and flats: B#3 and C4 tie, so go in step order.
+    ASSERT_EQ(pitch_range_spellings(r, 1, out, 3, &total), 0);
+    ASSERT_EQ(total, 44);
+    ASSERT_EQ(pitches_equal(out[0], (Pitch){26, 8}), 1);  // B#3
+    ASSERT_EQ(pitches_equal(out[1], (Pitch){25, 10}), 1); // C4
+    ASSERT_EQ(pitches_equal(out[2], (Pitch){26, 9}), 1);  // C#4
+
+    ASSERT_EQ(pitch_range_spellings(r, 0, NULL, 0, &total), 0);
+    ASSERT_EQ(total, 15);
+    ASSERT_EQ(pitch_range_spellings(r, -1, out, 7, &total), 1);
+    ASSERT_EQ(pitch_range_spellings(r, 0, out, -1, &total), 1);
+    r.lo = -((long long)1 << 40);
+    r.hi = (long long)1 << 40;
+    ASSERT_EQ(pitch_range_spellings(r, 0, NULL, 0, &total), 1);
+}
+
+void test_range_functions(void) {
+    RUN_TESTS(test_pitch_range_audible);
+    RUN_TESTS(test_pitch_range_from_hz);
+    RUN_TESTS(test_pitch_range_filter);
+    RUN_TESTS(test_pitch_range_spellings);
+}
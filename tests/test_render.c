@@ -0,0 +1,98 @@
+#include "../include/map.h"
+#include "../include/parse.h"
+#include "../include/render.h"
+#include "test_framework.h"
+#include <math.h>
+
+static float sine[1024];
+
+static NoteRenderer a440_renderer(const NoteEvent notes[], int len) {
+    Pitch a4;
+    pitch_from_spn("A4", &a4);
+    TuningMap T;
+    tuning_map_from_edo(12, a4, 440, &T);
+    double amps[1] = {1};
+    wavetable_harmonics(sine, 1024, amps, 1);
+    NoteRenderer r;
+    note_renderer_create(notes, len, T, 44100, sine, 1024, &r);
+    return r;
+}
+
+void test_note_renderer_create(void) {
+    TuningMap T;
+    tuning_map_from_edo(12, (Pitch){0, 0}, 440, &T);
+    NoteEvent e = {{25, 10}, 0, 1, 1};
+    NoteRenderer r;
+    ASSERT_EQ(note_renderer_create(&e, 1, T, 44100, sine, 1000, &r), 1);
+    ASSERT_EQ(note_renderer_create(&e, 1, T, 0, sine, 1024, &r), 1);
+    ASSERT_EQ(note_renderer_create(&e, 0, T, 44100, sine, 1024, &r), 0);
+    ASSERT_EQ(note_renderer_frames(&r), 0);
+    note_renderer_destroy(&r);
+}
+
+void test_note_renderer_render(void) {
+    NoteEvent notes[2];
+    pitch_from_spn("E5", &notes[0].pitch);
+    pitch_from_spn("A4", &notes[1].pitch);
+    notes[0] = (NoteEvent){notes[0].pitch, 0.5, 0.5, 0.25};
+    notes[1] = (NoteEvent){notes[1].pitch, 0, 1, 0.5};
+    NoteRenderer r = a440_renderer(notes, 2);
+    ASSERT_EQ(note_renderer_frames(&r), 44100);
+    // Sorted by onset.
+    ASSERT_EQ(r.start[0], 0);
+    ASSERT_EQ(r.start[1], 22050);
+
+    static float whole[44100], pieces[44100];
+    note_renderer_render(&r, 0, 44100, whole);
+
+    // Away from the fades, the A4 plays a 440Hz sine at half volume.
+    for (int i = 1000; i < 22050; i += 997)
+        ASSERT_EQ(round(whole[i] * 1000),
+                  round(0.5 * sin(6.283185307179586 * 440 * i / 44100) * 1000));
+    ASSERT_EQ(whole[0], 0);
+
+    // Ranges render exactly the same samples however the file is split up.
+    for (long i = 0; i < 44100; i += 1000) {
+        long n = 44100 - i < 1000 ? 44100 - i : 1000;
+        note_renderer_render(&r, i, n, pieces + i);
+    }
+    int same = 1;
+    for (int i = 0; i < 44100; i++)
+        same &= whole[i] == pieces[i];
+    ASSERT_EQ(same, 1);
+
+    // Nothing sounds after the last note.
+    float after[16];
+    note_renderer_render(&r, 44100, 16, after);
+    ASSERT_EQ(after[15], 0);
+    note_renderer_destroy(&r);
+}
+
+void test_note_renderer_write_wav(void) {
+    NoteEvent e = {{0, 0}, 0, 0.01, 1};
+    pitch_from_spn("A4", &e.pitch);
+    NoteRenderer r = a440_renderer(&e, 1);
+    ASSERT_EQ(note_renderer_write_wav(&r, "test_render.wav"), 0);
+
+    FILE *f = fopen("test_render.wav", "rb");
+    unsigned char h[44];
+    ASSERT_EQ(fread(h, 1, 44, f), 44);
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    remove("test_render.wav");
+
+    ASSERT_EQ(memcmp(h, "RIFF", 4), 0);
+    ASSERT_EQ(memcmp(h + 8, "WAVEfmt ", 8), 0);
+    ASSERT_EQ(h[22], 1); // mono
+    ASSERT_EQ(h[24] | h[25] << 8 | h[26] << 16, 44100);
+    ASSERT_EQ(h[40] | h[41] << 8, 441 * 2); // data bytes
+    ASSERT_EQ(size, 44 + 441 * 2);
+    note_renderer_destroy(&r);
+}
+
+void test_render_functions(void) {
+    RUN_TESTS(test_note_renderer_create);
+    RUN_TESTS(test_note_renderer_render);
+    RUN_TESTS(test_note_renderer_write_wav);
+}
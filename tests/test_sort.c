@@ -0,0 +1,89 @@
+#include "../include/buffer.h"
+#include "../include/map.h"
+#include "../include/pitch.h"
+#include "../include/sort.h"
+#include "test_framework.h"
+
+enum { LEN = 3000 };
+static Pitch pitches[LEN];
+
+// Mostly ordinary Pitches with many enharmonic and exact duplicates, plus a
+// few far away so that every byte of the keys gets sorted on.
+static void fill_pitches(void) {
+    unsigned seed = 5;
+    for (int i = 0; i < LEN; i++) {
+        seed = seed * 1103515245 + 12345;
+        pitches[i].w = (int)(seed >> 16) % 40 - 10;
+        seed = seed * 1103515245 + 12345;
+        pitches[i].h = (int)(seed >> 16) % 20 - 5;
+    }
+    pitches[7] = (Pitch){1 << 24, -(1 << 22)};
+    pitches[8] = (Pitch){-(1 << 24), 1 << 22};
+}
+
+// Whether i comes before j in the order pitch_radix_argsort should produce.
+static bool ranks_before(int i, int j, EDOMap T) {
+    Pitch p = pitches[i], q = pitches[j];
+    int x = pitch_to_number(p, T), y = pitch_to_number(q, T);
+    if (x != y)
+        return x < y;
+    if (p.w + p.h != q.w + q.h)
+        return p.w + p.h < q.w + q.h;
+    return i < j;
+}
+
+void test_pitch_radix_argsort(void) {
+    fill_pitches();
+    static int out[LEN];
+    EDOMap T;
+    int edos[] = {12, 31, 53};
+    for (int e = 0; e < 3; e++) {
+        create_edo_map(edos[e], &T);
+        ASSERT_EQ(pitch_radix_argsort(pitches, LEN, T, out), 0);
+        int sorted = 1;
+        for (int i = 0; i + 1 < LEN; i++)
+            sorted &= ranks_before(out[i], out[i + 1], T);
+        ASSERT_EQ(sorted, 1);
+    }
+    ASSERT_EQ(pitch_radix_argsort(pitches, 0, T, out), 0);
+}
+
+void test_pitch_radix_sort(void) {
+    fill_pitches();
+    static int order[LEN];
+    static Pitch arr[LEN];
+    EDOMap T;
+    create_edo_map(31, &T);
+    pitch_radix_argsort(pitches, LEN, T, order);
+    for (int i = 0; i < LEN; i++)
+        arr[i] = pitches[i];
+    ASSERT_EQ(pitch_radix_sort(arr, LEN, T), 0);
+    int same = 1;
+    for (int i = 0; i < LEN; i++)
+        same &= pitches_equal(arr[i], pitches[order[i]]);
+    ASSERT_EQ(same, 1);
+
+    // C#4 before Db4 in 12-EDO, both after C4
+    Pitch three[3] = {{25, 11}, {26, 9}, {25, 10}};
+    create_edo_map(12, &T);
+    pitch_radix_sort(three, 3, T);
+    ASSERT_EQ(pitches_equal(three[0], (Pitch){25, 10}), 1);
+    ASSERT_EQ(pitches_equal(three[1], (Pitch){26, 9}), 1);
+    ASSERT_EQ(pitches_equal(three[2], (Pitch){25, 11}), 1);
+
+    PitchBuffer b;
+    pitch_buffer_create(LEN, &b);
+    pitch_buffer_from_pitches(&b, pitches, LEN);
+    create_edo_map(31, &T);
+    ASSERT_EQ(pitch_buffer_radix_sort(&b, T), 0);
+    same = 1;
+    for (int i = 0; i < LEN; i++)
+        same &= pitches_equal((Pitch){b.w[i], b.h[i]}, pitches[order[i]]);
+    ASSERT_EQ(same, 1);
+    pitch_buffer_destroy(&b);
+}
+
+void test_sort_functions(void) {
+    RUN_TESTS(test_pitch_radix_argsort);
+    RUN_TESTS(test_pitch_radix_sort);
+}
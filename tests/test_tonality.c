@@ -26,6 +26,12 @@ void test_context_from_chroma(void) {
     k = context_from_chroma(-6, MAJOR);
     ASSERT_EQ(k.tonic.letter, 6);
     ASSERT_EQ(k.tonic.accidental, -1);
+    k = context_from_chroma(-8, MAJOR); // Fb
+    ASSERT_EQ(k.tonic.letter, 5);
+    ASSERT_EQ(k.tonic.accidental, -1);
+    k = context_from_chroma(-15, MAJOR); // Fbb
+    ASSERT_EQ(k.tonic.letter, 5);
+    ASSERT_EQ(k.tonic.accidental, -2);
 }
 
 void test_context_from_pitch(void) {
@@ -140,6 +146,23 @@ void test_snap_diatonic(void) {
     pitch_from_spn("Db4", &q);
     ASSERT_EQ(snap_diatonic(p, k).w, q.w);
     ASSERT_EQ(snap_diatonic(p, k).h, q.h);
+
+    // the same as stepping a chromatic semitone at a time
+    int same = 1;
+    for (int chroma = -10; chroma <= 10; chroma++) {
+        k = context_from_chroma(chroma, DORIAN);
+        for (int w = -100; w <= 100; w++) {
+            for (int h = -100; h <= 100; h++) {
+                Pitch r = {w, h};
+                while (degree_alteration(r, k) > DIATONIC_DEG)
+                    r = (Pitch){r.w - 1, r.h + 1};
+                while (degree_alteration(r, k) < DIATONIC_DEG)
+                    r = (Pitch){r.w + 1, r.h - 1};
+                same &= pitches_equal(snap_diatonic((Pitch){w, h}, k), r);
+            }
+        }
+    }
+    ASSERT_EQ(same, 1);
 }
 
 void test_transpose_diatonic(void) {
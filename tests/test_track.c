@@ -0,0 +1,102 @@
+#include "../include/map.h"
+#include "../include/parse.h"
+#include "../include/pitch.h"
+#include "../include/tonality.h"
+#include "../include/track.h"
+#include "test_framework.h"
+#include <math.h>
+
+enum { RATE = 44100, LEN = 44100 / 4 };
+static float signal[LEN];
+
+// A sawtooth-like tone with a weak fundamental, the usual trap for
+// autocorrelation trackers.
+static void fill_tone(double hz, int harmonics) {
+    for (int i = 0; i < LEN; i++) {
+        double x = 0;
+        for (int k = 1; k <= harmonics; k++)
+            x += (k == 1 ? 0.3 : 1.0) / k *
+                 sin(6.283185307179586 * k * hz * i / RATE);
+        signal[i] = 0.5 * x;
+    }
+}
+
+void test_pitch_tracker_create(void) {
+    PitchTracker t;
+    ASSERT_EQ(pitch_tracker_create(RATE, 1000, 256, 0.1, &t), 1);
+    ASSERT_EQ(pitch_tracker_create(RATE, 2048, 0, 0.1, &t), 1);
+    ASSERT_EQ(pitch_tracker_create(0, 2048, 256, 0.1, &t), 1);
+    ASSERT_EQ(pitch_tracker_create(RATE, 2048, 256, 0.1, &t), 0);
+    ASSERT_EQ(pitch_tracker_frames(&t, 2047), 0);
+    ASSERT_EQ(pitch_tracker_frames(&t, 2048), 1);
+    ASSERT_EQ(pitch_tracker_frames(&t, 2048 + 512), 3);
+    pitch_tracker_destroy(&t);
+}
+
+void test_pitch_tracker_frame(void) {
+    PitchTracker t;
+    pitch_tracker_create(RATE, 2048, 256, 0.1, &t);
+
+    double tones[4] = {55, 110, 440, 1567.98};
+    for (int i = 0; i < 4; i++) {
+        fill_tone(tones[i], 8);
+        double hz = pitch_tracker_frame(&t, signal + 1000);
+        ASSERT_EQ(fabs(1200 * log2(hz / tones[i])) < 1, true);
+    }
+
+    for (int i = 0; i < LEN; i++)
+        signal[i] = 0;
+    ASSERT_EQ(pitch_tracker_frame(&t, signal), 0);
+
+    // Noise has no period.
+    unsigned seed = 1;
+    for (int i = 0; i < LEN; i++) {
+        seed = seed * 1103515245 + 12345;
+        signal[i] = (seed >> 16 & 0x7fff) / 16384.0 - 1;
+    }
+    ASSERT_EQ(pitch_tracker_frame(&t, signal), 0);
+    pitch_tracker_destroy(&t);
+}
+
+void test_pitch_tracker_run(void) {
+    Pitch a4, db4, cs4;
+    pitch_from_spn("A4", &a4);
+    pitch_from_spn("Db4", &db4);
+    pitch_from_spn("C#4", &cs4);
+    TuningMap T;
+    tuning_map_from_edo(12, a4, 440, &T);
+
+    PitchTracker t;
+    pitch_tracker_create(RATE, 2048, 512, 0.1, &t);
+    long frames = pitch_tracker_frames(&t, LEN);
+    double hz[32];
+    Pitch out[32];
+
+    // A slightly flat C#/Db is spelled to suit the key.
+    fill_tone(to_hz(cs4, T) * 0.995, 8);
+    ASSERT_EQ(pitch_tracker_run(&t, signal, LEN, hz, &T, NULL, out), frames);
+    int spelled = 1;
+    for (long i = 0; i < frames; i++)
+        spelled &= pitches_equal(out[i], cs4);
+    ASSERT_EQ(spelled, 1);
+
+    TonalContext key;
+    context_from_str("Ab", MAJOR, &key);
+    pitch_tracker_run(&t, signal, LEN, hz, &T, &key, out);
+    spelled = 1;
+    for (long i = 0; i < frames; i++)
+        spelled &= pitches_equal(out[i], db4);
+    ASSERT_EQ(spelled, 1);
+
+    // Frequencies alone.
+    ASSERT_EQ(pitch_tracker_run(&t, signal, LEN, hz, NULL, NULL, NULL),
+              frames);
+    ASSERT_EQ(fabs(1200 * log2(hz[frames - 1] / to_hz(cs4, T))) < 10, true);
+    pitch_tracker_destroy(&t);
+}
+
+void test_track_functions(void) {
+    RUN_TESTS(test_pitch_tracker_create);
+    RUN_TESTS(test_pitch_tracker_frame);
+    RUN_TESTS(test_pitch_tracker_run);
+}
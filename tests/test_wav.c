@@ -0,0 +1,80 @@
+#include "../include/wav.h"
+#include "test_framework.h"
+#include <math.h>
+
+void test_wav_round_trip(void) {
+    float stereo[2 * 100];
+    for (int i = 0; i < 100; i++) {
+        stereo[2 * i] = sinf(i * 0.1f);
+        stereo[2 * i + 1] = i < 50 ? 0.5f : 2.0f; // clipped to 1
+    }
+    stereo[2 * 10 + 1] = NAN; // written as silence
+    WavWriter w;
+    ASSERT_EQ(wav_writer_open("test_wav.wav", 2, 48000, &w), 0);
+    ASSERT_EQ(wav_writer_write(&w, stereo, 60), 0);
+    ASSERT_EQ(wav_writer_write(&w, stereo + 120, 40), 0);
+    ASSERT_EQ(wav_writer_close(&w), 0);
+
+    AudioBuffer audio;
+    ASSERT_EQ(wav_read("test_wav.wav", &audio), 0);
+    remove("test_wav.wav");
+    ASSERT_EQ(audio.frames, 100);
+    ASSERT_EQ(audio.sample_rate, 48000);
+    // Channels are mixed down to mono.
+    int close = 1;
+    for (int i = 0; i < 100; i++) {
+        float right = i == 10 ? 0.0f : i < 50 ? 0.5f : 1.0f;
+        float expected = (sinf(i * 0.1f) + right) / 2;
+        close &= fabsf(audio.samples[i] - expected) < 1e-4f;
+    }
+    ASSERT_EQ(close, 1);
+    audio_buffer_destroy(&audio);
+}
+
+void test_wav_read_chunk_order(void) {
+    // A data chunk before the fmt chunk, with an odd-sized chunk (and its pad
+    // byte) between them: two 16-bit mono samples, 0.5 and -0.5.
+    static const unsigned char bytes[] = {
+        'R', 'I', 'F', 'F', 52,  0,   0,   0,   'W', 'A', 'V', 'E',
+        'd', 'a', 't', 'a', 4,   0,   0,   0,   0,   64,  0,   192,
+        'j', 'u', 'n', 'k', 3,   0,   0,   0,   1,   2,   3,   0,
+        'f', 'm', 't', ' ', 16,  0,   0,   0,   1,   0,   1,   0,
+        64,  31,  0,   0,   128, 62,  0,   0,   2,   0,   16,  0};
+    FILE *f = fopen("test_wav.wav", "wb");
+    fwrite(bytes, 1, sizeof(bytes), f);
+    fclose(f);
+    AudioBuffer audio;
+    ASSERT_EQ(wav_read("test_wav.wav", &audio), 0);
+    remove("test_wav.wav");
+    ASSERT_EQ(audio.frames, 2);
+    ASSERT_EQ(audio.sample_rate, 8000);
+    ASSERT_EQ(audio.samples[0] == 0.5f && audio.samples[1] == -0.5f, 1);
+    audio_buffer_destroy(&audio);
+
+    // Without any fmt chunk there's nothing to read the data as.
+    f = fopen("test_wav.wav", "wb");
+    fwrite(bytes, 1, 36, f);
+    fclose(f);
+    ASSERT_EQ(wav_read("test_wav.wav", &audio), 1);
+    remove("test_wav.wav");
+}
+
+void test_wav_read_errors(void) {
+    AudioBuffer audio;
+    ASSERT_EQ(wav_read("does_not_exist.wav", &audio), 1);
+
+    FILE *f = fopen("test_wav.wav", "wb");
+    fwrite("RIFF\4\0\0\0AVI LIST", 1, 16, f);
+    fclose(f);
+    ASSERT_EQ(wav_read("test_wav.wav", &audio), 1);
+    remove("test_wav.wav");
+
+    WavWriter w;
+    ASSERT_EQ(wav_writer_open("test_wav.wav", 0, 48000, &w), 1);
+}
+
+void test_wav_functions(void) {
+    RUN_TESTS(test_wav_round_trip);
+    RUN_TESTS(test_wav_read_chunk_order);
+    RUN_TESTS(test_wav_read_errors);
+}
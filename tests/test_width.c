@@ -0,0 +1,143 @@
+#include "../include/interval.h"
+#include "../include/map.h"
+#include "../include/pitch.h"
+#include "../include/width.h"
+#include "test_framework.h"
+
+// Each width must agree with the int functions wherever both can hold the
+// Pitches involved.
+#define CHECK_WIDTH(P, T, pre, span)                                           \
+    do {                                                                       \
+        int same = 1;                                                          \
+        Interval m = {3, -2};                                                  \
+        P wm = {3, -2};                                                        \
+        for (int w = -(span); w <= (span); w += 3) {                           \
+            for (int h = -(span); h <= (span); h += 5) {                       \
+                Pitch p = {w, h}, q = {h, w};                                  \
+                P wp = {(T)w, (T)h}, wq = {(T)h, (T)w};                        \
+                same &= pre##_pitch_chroma(wp) == pitch_chroma(p);             \
+                same &= pre##_pitch_letter(wp) == pitch_letter(p);             \
+                same &= pre##_pitch_accidental(wp) == pitch_accidental(p);     \
+                same &= pre##_pitch_octave(wp) == pitch_octave(p);             \
+                same &= pre##_pitch_midi(wp) == pitch_midi(p);                 \
+                same &= pre##_pitch_pc12(wp) == pitch_pc12(p);                 \
+                same &= pre##_steps_between(wp, wq) == steps_between(p, q);    \
+                same &= pre##_pitches_enharmonic(wp, wq, 31) ==                \
+                        pitches_enharmonic(p, q, 31);                          \
+                same &= pre##_stepspan(wp) == stepspan(p);                     \
+                Pitch r = transpose_real(p, m);                                \
+                P wr = pre##_transpose_real(wp, wm);                           \
+                same &= wr.w == r.w && wr.h == r.h;                            \
+                Interval n = interval_simple(interval_between(p, q));          \
+                P wn = pre##_interval_simple(pre##_interval_between(wp, wq));  \
+                same &= wn.w == n.w && wn.h == n.h;                            \
+                n = interval_times(intervals_subtract(p, q), 3);               \
+                wn = pre##_interval_times(pre##_intervals_subtract(wp, wq), 3);\
+                same &= wn.w == n.w && wn.h == n.h;                            \
+            }                                                                  \
+        }                                                                      \
+        ASSERT_EQ(same, 1);                                                    \
+    } while (0)
+
+void test_width_inline(void) {
+    CHECK_WIDTH(PitchI16, int16_t, i16, 3000);
+    CHECK_WIDTH(PitchI32, int32_t, i32, 3000);
+    CHECK_WIDTH(PitchI64, int64_t, i64, 3000);
+}
+
+void test_width_extremes(void) {
+    // i16 classifiers see the whole int16 range without overflowing
+    PitchI16 p = {INT16_MIN, INT16_MAX};
+    ASSERT_EQ(i16_pitch_chroma(p), 2 * -32768 - 5 * 32767);
+    ASSERT_EQ(i16_pitch_octave(p), -1 - 1);
+
+    // so do i32 classifiers, over the whole int32 range
+    PitchI32 r = {INT32_MAX, INT32_MIN};
+    ASSERT_EQ(i32_pitch_chroma(r) == 2 * (long long)INT32_MAX +
+                                         5 * -(long long)INT32_MIN,
+              1);
+    ASSERT_EQ(i32_pitch_accidental(r) ==
+                  floor_div7_ll(i32_pitch_chroma(r) + 1),
+              1);
+    ASSERT_EQ(i32_pitch_octave(r), -1 - 1);
+    long long midi = 2 * (long long)INT32_MAX + INT32_MIN;
+    ASSERT_EQ(i32_pitch_midi(r) == midi, 1);
+    ASSERT_EQ(i32_pitch_pc12(r), (int)(midi % 12));
+    PitchI32 big = {INT32_MAX, INT32_MAX};
+    ASSERT_EQ(i32_pitch_octave(big) == 2 * (long long)INT32_MAX / 7 - 1, 1);
+    ASSERT_EQ(i32_pitch_letter(big), (int)((2 * (long long)INT32_MAX + 2) % 7));
+
+    // and vector results that don't fit wrap
+    PitchI32 top = i32_transpose_real(big, (PitchI32){1, 0});
+    ASSERT_EQ(top.w == INT32_MIN && top.h == INT32_MAX, 1);
+    PitchI32 neg = i32_interval_negate((PitchI32){INT32_MIN, 0});
+    ASSERT_EQ(neg.w == INT32_MIN, 1);
+
+    // i64 keeps going where int would overflow
+    PitchI64 q = {(int64_t)1 << 40, 0};
+    ASSERT_EQ(i64_pitch_chroma(q) == (long long)1 << 41, 1);
+    ASSERT_EQ(i64_pitch_octave(q) == ((long long)1 << 40) / 7 - 1, 1);
+    ASSERT_EQ(i64_pitch_letter(q), (int)((((long long)1 << 40) + 2) % 7));
+    PitchI64 far = {-((int64_t)5 << 40), -((int64_t)2 << 40)};
+    ASSERT_EQ(i64_pitch_octave(far) == -((long long)1 << 40) - 1, 1);
+    ASSERT_EQ(i64_pitch_letter(far), 2);
+    ASSERT_EQ(i64_pitch_accidental(far), 0);
+    PitchI64 simple = i64_interval_simple(far);
+    ASSERT_EQ(simple.w == 0 && simple.h == 0, 1);
+}
+
+void test_width_batch(void) {
+    enum { LEN = 40 };
+    Pitch arr[LEN], back[LEN];
+    PitchI16 narrow[LEN], between[LEN];
+    PitchI64 wide[LEN];
+    for (int i = 0; i < LEN; i++)
+        arr[i] = (Pitch){i * 9 - 200, 150 - i * 4};
+    arr[LEN - 1] = (Pitch){40000, 0};
+
+    ASSERT_EQ(i16_pitches_from_pitches(arr, LEN, narrow), 1);
+    ASSERT_EQ(i16_pitches_to_pitches(narrow, LEN - 1, back), 0);
+    ASSERT_EQ(i64_pitches_from_pitches(arr, LEN, wide), 0);
+    wide[0].w = (int64_t)1 << 40;
+    ASSERT_EQ(i64_pitches_to_pitches(wide, LEN, back), 1);
+    int same = 1;
+    for (int i = 1; i < LEN; i++)
+        same &= pitches_equal(back[i], arr[i]);
+    ASSERT_EQ(same, 1);
+
+    int letters[LEN], accidentals[LEN], octaves[LEN], chromas[LEN];
+    long long heights[LEN];
+    TuningMap T;
+    tuning_map_from_edo(31, (Pitch){25, 10}, 261.63, &T);
+    HeightMap H = height_map_from_tuning(T);
+    i16_pitches_letters(narrow, LEN - 1, letters);
+    i16_pitches_accidentals(narrow, LEN - 1, accidentals);
+    i16_pitches_octaves(narrow, LEN - 1, octaves);
+    i16_pitches_chromas(narrow, LEN - 1, chromas);
+    i16_pitches_heights(narrow, LEN - 1, H, heights);
+    same = 1;
+    for (int i = 0; i < LEN - 1; i++) {
+        same &= letters[i] == pitch_letter(arr[i]);
+        same &= accidentals[i] == pitch_accidental(arr[i]);
+        same &= octaves[i] == pitch_octave(arr[i]);
+        same &= chromas[i] == pitch_chroma(arr[i]);
+        same &= heights[i] == pitch_height(arr[i], H);
+    }
+    ASSERT_EQ(same, 1);
+
+    PitchI16 moved[LEN];
+    for (int i = 0; i < LEN - 1; i++)
+        moved[i] = narrow[i];
+    i16_pitches_transpose(moved, LEN - 1, (PitchI16){5, 2});
+    i16_pitches_intervals(narrow, moved, LEN - 1, between);
+    same = 1;
+    for (int i = 0; i < LEN - 1; i++)
+        same &= between[i].w == 5 && between[i].h == 2;
+    ASSERT_EQ(same, 1);
+}
+
+void test_width_functions(void) {
+    RUN_TESTS(test_width_inline);
+    RUN_TESTS(test_width_extremes);
+    RUN_TESTS(test_width_batch);
+}
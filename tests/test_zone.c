@@ -0,0 +1,78 @@
+#include "../include/interval.h"
+#include "../include/map.h"
+#include "../include/parse.h"
+#include "../include/pitch.h"
+#include "../include/zone.h"
+#include "test_framework.h"
+#include <limits.h>
+#include <math.h>
+
+void test_zone_map_create(void) {
+    TuningMap T;
+    tuning_map_from_edo(12, (Pitch){25, 10}, 261.6256, &T);
+    Pitch root = {25, 10};
+    ZoneMap z;
+    ASSERT_EQ(zone_map_create(&root, 0, T, (Pitch){0, 0}, (Pitch){1, 1}, &z),
+              1);
+    ASSERT_EQ(zone_map_create(&root, 1, T, (Pitch){1, 0}, (Pitch){0, 1}, &z),
+              1);
+    ASSERT_EQ(zone_map_create(&root, 1, T, (Pitch){0, 0}, (Pitch){60, 25}, &z),
+              0);
+    ASSERT_EQ(z.width, 61);
+    ASSERT_EQ(z.height, 26);
+    zone_map_destroy(&z);
+
+    // Windows too wide for an int, or with more Pitches than a long indexes.
+    ASSERT_EQ(zone_map_create(&root, 1, T, (Pitch){INT_MIN, 0},
+                              (Pitch){INT_MAX, 0}, &z),
+              1);
+    ASSERT_EQ(zone_map_create(&root, 1, T, (Pitch){0, 0},
+                              (Pitch){INT_MAX - 1, INT_MAX - 1}, &z),
+              1);
+}
+
+void test_zone_map_lookup(void) {
+    Pitch c4;
+    pitch_from_spn("C4", &c4);
+    TuningMap T;
+    tuning_map_from_fifth(1200 * log2(5) / 4, c4, 261.6256, &T);
+
+    char *names[4] = {"C3", "F#3", "C4", "G4"};
+    Pitch roots[4];
+    for (int i = 0; i < 4; i++)
+        pitch_from_spn(names[i], roots + i);
+    ZoneMap z;
+    zone_map_create(roots, 4, T, (Pitch){0, 0}, (Pitch){60, 25}, &z);
+
+    // Every Pitch in the window agrees with pitch_nearest and to_ratio.
+    int agree = 1;
+    for (int w = 0; w <= 60; w++) {
+        for (int h = 0; h <= 25; h++) {
+            Pitch p = {w, h};
+            double ratio = 0;
+            int i = zone_map_lookup(&z, p, &ratio);
+            Pitch q = pitch_nearest(p, roots, 4, T);
+            agree &= pitches_equal(roots[i], q);
+            agree &= fabs(ratio - to_ratio(interval_between(q, p), T)) < 1e-12;
+        }
+    }
+    ASSERT_EQ(agree, 1);
+
+    // A quarter-comma meantone whole tone is half a pure major third.
+    Pitch d4;
+    pitch_from_spn("D4", &d4);
+    double ratio = 0;
+    ASSERT_EQ(zone_map_lookup(&z, d4, &ratio), 2);
+    ASSERT_EQ(round(ratio * 1e6), round(sqrt(1.25) * 1e6));
+    ASSERT_EQ(zone_map_lookup(&z, d4, NULL), 2);
+
+    ASSERT_EQ(zone_map_lookup(&z, (Pitch){-1, 0}, &ratio), -1);
+    ASSERT_EQ(zone_map_lookup(&z, (Pitch){0, 26}, &ratio), -1);
+    ASSERT_EQ(zone_map_lookup(&z, (Pitch){61, 25}, &ratio), -1);
+    zone_map_destroy(&z);
+}
+
+void test_zone_functions(void) {
+    RUN_TESTS(test_zone_map_create);
+    RUN_TESTS(test_zone_map_lookup);
+}
@@ -0,0 +1,31 @@
+// Generates src/edo_catalog.c. Run `make catalog` after changing anything
+// here, or the EDO derivation in src/map.c, so the two stay in step.
+#include <math.h>
+#include <stdio.h>
+
+static const int max_edo = 512;
+
+int main(void) {
+    printf("// Generated by tools/gen_edo_catalog.c. Do not edit by hand, run\n");
+    printf("// `make catalog` instead.\n");
+    printf("#include \"../include/constants.h\"\n\n");
+    printf("const int EDO_CATALOG_MAX = %d;\n\n", max_edo);
+    printf("const EDOCatalogEntry EDO_CATALOG[] = {\n");
+    printf("    {0, {0, 0}, 0, false},\n");
+
+    for (int edo = 1; edo <= max_edo; edo++) {
+        // Same derivation as create_edo_map.
+        int fifth_steps = (int)round(log2(1.5) * edo);
+        double fifth = (double)fifth_steps * 1200 / edo;
+        int valid = fifth >= (1200.0 * 4 / 7) && fifth <= (1200.0 * 3 / 5);
+        int whole = 0, half = 0;
+        if (valid) {
+            whole = ((fifth_steps * 2) % edo + edo) % edo;
+            half = ((fifth_steps * -5) % edo + edo) % edo;
+        }
+        printf("    {%d, {%d, %d}, %.17g, %s},\n", fifth_steps, whole, half,
+               fifth, valid ? "true" : "false");
+    }
+    printf("};\n");
+    return 0;
+}